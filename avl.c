@@ -7,6 +7,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
 
 /* Δομή πολίτη */
 typedef struct {
@@ -16,20 +18,181 @@ typedef struct {
     int annual_income;
 } Citizen;
 
-/* Δομή κόμβου δέντρου */
+/* Δομή κόμβου δέντρου - τα πεδία της αναζήτησης (key, παιδιά) προηγούνται
+ * ώστε να βρίσκονται στην ίδια cache line με την αρχή του ονόματος */
 typedef struct Node {
-    Citizen data;
+    uint64_t key; /* Πρόθεμα 8 bytes του full_name */
     struct Node *left;
     struct Node *right;
     int height;
+    int size;     /* Κόμβοι του υποδέντρου (για rank/select) */
     char color;
+    Citizen data;
 } Node;
 
+/* ---------- Κλειδιά σύγκρισης ---------- */
+
+/* Κάθε κόμβος κρατά τα πρώτα 8 bytes του full_name ως big-endian ακέραιο.
+ * Η σύγκριση ακεραίων δίνει την ίδια διάταξη με την strcmp, οπότε η strcmp
+ * καλείται (από το 9ο byte) μόνο όταν τα προθέματα ταυτίζονται. */
+static inline uint64_t key_prefix(const char *name) {
+    uint64_t k = 0;
+    int i = 0;
+    for (; i < 8 && name[i]; i++)
+        k = (k << 8) | (unsigned char)name[i];
+    return i ? k << (8 * (8 - i)) : 0;
+}
+
+static inline int key_cmp(uint64_t ka, const char *a, uint64_t kb, const char *b) {
+    if (ka != kb)
+        return ka < kb ? -1 : 1;
+    if ((ka & 0xFF) == 0)
+        return 0; /* όνομα μικρότερο των 8 bytes: ίσα */
+    return strcmp(a + 8, b + 8);
+}
+
+/* ---------- Δεξαμενή κόμβων (arena) ---------- */
+
+/* Οι κόμβοι μπορούν να δεσμεύονται από μια arena: κόβονται διαδοχικά από
+ * slabs του 1 MiB, οι διαγραμμένοι κόμβοι μπαίνουν σε free list και όλο
+ * το δέντρο ελευθερώνεται με pool_reset/pool_destroy χωρίς διάσχιση. */
+
+#define POOL_SLAB_BYTES (1u << 20)
+#define POOL_SLAB_HEADER 64
+
+typedef struct PoolSlab {
+    struct PoolSlab *next;
+} PoolSlab;
+
+typedef struct {
+    size_t node_size;
+    PoolSlab *head, *cur;   /* λίστα slabs και τρέχον slab */
+    char *bump, *end;       /* ελεύθερη περιοχή τρέχοντος slab */
+    void *free_list;        /* κόμβοι που επιστράφηκαν με pool_free */
+    size_t live, slabs;
+} NodePool;
+
+/* Αρχικοποίηση arena για κόμβους μεγέθους node_size */
+void pool_init(NodePool *p, size_t node_size) {
+    memset(p, 0, sizeof(*p));
+    p->node_size = (node_size + 7) & ~(size_t)7;
+}
+
+/* Μετάβαση στο επόμενο slab (επαναχρησιμοποίηση μετά από reset ή νέο) */
+static int pool_next_slab(NodePool *p) {
+    PoolSlab *s = p->cur ? p->cur->next : p->head;
+    if (!s) {
+        s = (PoolSlab*)malloc(POOL_SLAB_BYTES);
+        if (!s)
+            return 0;
+        s->next = NULL;
+        if (p->cur)
+            p->cur->next = s;
+        else
+            p->head = s;
+        p->slabs++;
+    }
+    p->cur = s;
+    p->bump = (char*)s + POOL_SLAB_HEADER;
+    p->end = (char*)s + POOL_SLAB_BYTES;
+    return 1;
+}
+
+/* Δέσμευση κόμβου: πρώτα από τη free list, αλλιώς από το τρέχον slab */
+void* pool_alloc(NodePool *p) {
+    void *n = p->free_list;
+    if (n) {
+        p->free_list = *(void**)n;
+        p->live++;
+        return n;
+    }
+    if ((size_t)(p->end - p->bump) < p->node_size && !pool_next_slab(p))
+        return NULL;
+    n = p->bump;
+    p->bump += p->node_size;
+    p->live++;
+    return n;
+}
+
+/* Επιστροφή κόμβου στη free list */
+void pool_free(NodePool *p, void *n) {
+    *(void**)n = p->free_list;
+    p->free_list = n;
+    p->live--;
+}
+
+/* Ελευθέρωση όλων των κόμβων - τα slabs κρατιούνται για επαναχρησιμοποίηση */
+void pool_reset(NodePool *p) {
+    p->cur = NULL;
+    p->bump = p->end = NULL;
+    p->free_list = NULL;
+    p->live = 0;
+}
+
+/* Επιστροφή όλων των slabs στο σύστημα */
+void pool_destroy(NodePool *p) {
+    PoolSlab *s = p->head;
+    while (s) {
+        PoolSlab *next = s->next;
+        free(s);
+        s = next;
+    }
+    pool_init(p, p->node_size);
+}
+
+/* Ενεργή arena του δέντρου (NULL = malloc/free) */
+static NodePool *node_pool = NULL;
+
+/* Επιλογή arena για τις επόμενες εισαγωγές/διαγραφές */
+void use_node_pool(NodePool *pool) {
+    node_pool = pool;
+}
+
+/* Λογιστική μνήμης για κόμβους με malloc: ζωντανοί κόμβοι και bytes.
+ * Με arena τα ίδια στοιχεία δίνουν τα live, node_size και slabs της NodePool. */
+static size_t live_nodes = 0;
+static size_t live_bytes = 0;
+
+/* Επιστρέφει το πλήθος και τα bytes των κόμβων που δεν έχουν ελευθερωθεί */
+void tree_memory(size_t *nodes, size_t *bytes) {
+    *nodes = live_nodes;
+    *bytes = live_bytes;
+}
+
+static void* node_alloc(size_t size) {
+    if (node_pool)
+        return pool_alloc(node_pool);
+    void *n = malloc(size);
+    if (n) {
+        live_nodes++;
+        live_bytes += size;
+    }
+    return n;
+}
+
+static void node_free(void *n) {
+    if (node_pool) {
+        pool_free(node_pool, n);
+        return;
+    }
+    live_nodes--;
+    live_bytes -= sizeof(Node);
+    free(n);
+}
+
+/* Μέγιστο ύψος AVL ~ 1.44 log2(n) - 64 επίπεδα αρκούν για κάθε n */
+#define AVL_MAX_DEPTH 64
+
 /* Επιστρέφει το ύψος ενός κόμβου */
 int height(Node *n) {
     return n ? n->height : 0;
 }
 
+/* Επιστρέφει το πλήθος κόμβων του υποδέντρου */
+int subtree_size(Node *n) {
+    return n ? n->size : 0;
+}
+
 /* Επιστρέφει το μεγαλύτερο από δύο ακέραιους */
 int max(int a, int b) {
     return (a > b) ? a : b;
@@ -40,17 +203,19 @@ int get_balance(Node *n) {
     return n ? height(n->left) - height(n->right) : 0;
 }
 
-/* Δημιουργία νέου κόμβου */
-Node* create_node(Citizen data) {
-    Node *node = (Node*)malloc(sizeof(Node));
+/* Δημιουργία νέου κόμβου - η εγγραφή αντιγράφεται μία φορά, εδώ */
+Node* create_node(const Citizen *data) {
+    Node *node = (Node*)node_alloc(sizeof(Node));
     if (!node) {
         printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
         return NULL;
     }
-    node->data = data;
+    node->key = key_prefix(data->full_name);
+    node->data = *data;
     node->left = NULL;
     node->right = NULL;
     node->height = 1;
+    node->size = 1;
     node->color = 'R';
     return node;
 }
@@ -63,9 +228,11 @@ Node* rotate_right(Node *y) {
     x->right = y;
     y->left = T2;
 
-    /* Ενημέρωση υψών */
+    /* Ενημέρωση υψών και μεγεθών - το x παίρνει το μέγεθος του y */
     y->height = max(height(y->left), height(y->right)) + 1;
     x->height = max(height(x->left), height(x->right)) + 1;
+    x->size = y->size;
+    y->size = subtree_size(y->left) + subtree_size(y->right) + 1;
 
     return x;
 }
@@ -78,53 +245,74 @@ Node* rotate_left(Node *x) {
     y->left = x;
     x->right = T2;
 
-    /* Ενημέρωση υψών */
+    /* Ενημέρωση υψών και μεγεθών - το y παίρνει το μέγεθος του x */
     x->height = max(height(x->left), height(x->right)) + 1;
     y->height = max(height(y->left), height(y->right)) + 1;
+    y->size = x->size;
+    x->size = subtree_size(x->left) + subtree_size(x->right) + 1;
 
     return y;
 }
 
-/* Εισαγωγή κόμβου στο AVL δέντρο */
-Node* insert_avl(Node *root, Citizen data) {
-    /* Κανονική εισαγωγή BST */
-    if (root == NULL)
-        return create_node(data);
-
-    int cmp = strcmp(data.full_name, root->data.full_name);
-    if (cmp < 0)
-        root->left = insert_avl(root->left, data);
-    else if (cmp > 0)
-        root->right = insert_avl(root->right, data);
-    else
-        return root; /* Διπλότυπο - δεν εισάγεται */
-
-    /* Ενημέρωση ύψους */
+/* Εξισορρόπηση κόμβου μετά από εισαγωγή ή διαγραφή σε κάποιο υποδέντρο του:
+ * ενημέρωση ύψους και περιστροφές - επιστρέφει τη νέα ρίζα του υποδέντρου */
+static Node* rebalance(Node *root) {
     root->height = max(height(root->left), height(root->right)) + 1;
-
-    /* Έλεγχος ισορροπίας και περιστροφές */
+    root->size = subtree_size(root->left) + subtree_size(root->right) + 1;
     int balance = get_balance(root);
 
-    /* Περίπτωση Αριστερά-Αριστερά (Left-Left) */
-    if (balance > 1 && strcmp(data.full_name, root->left->data.full_name) < 0)
+    if (balance > 1) {
+        /* Αριστερά-Δεξιά: πρώτα αριστερή περιστροφή στο αριστερό παιδί */
+        if (get_balance(root->left) < 0)
+            root->left = rotate_left(root->left);
+        /* Αριστερά-Αριστερά */
         return rotate_right(root);
-
-    /* Περίπτωση Δεξιά-Δεξιά (Right-Right) */
-    if (balance < -1 && strcmp(data.full_name, root->right->data.full_name) > 0)
+    }
+    if (balance < -1) {
+        /* Δεξιά-Αριστερά: πρώτα δεξιά περιστροφή στο δεξί παιδί */
+        if (get_balance(root->right) > 0)
+            root->right = rotate_right(root->right);
+        /* Δεξιά-Δεξιά */
         return rotate_left(root);
+    }
+    return root;
+}
 
-    /* Περίπτωση Αριστερά-Δεξιά (Left-Right) */
-    if (balance > 1 && strcmp(data.full_name, root->left->data.full_name) > 0) {
-        root->left = rotate_left(root->left);
-        return rotate_right(root);
+/* Ανάβαση στο μονοπάτι (στοίβα συνδέσμων) από κάτω προς τα πάνω - οι
+ * περιστροφές σταματούν στον πρώτο κόμβο που μετά την εξισορρόπηση κρατά το
+ * ίδιο ύψος, ενώ τα μεγέθη ενημερώνονται μέχρι τη ρίζα */
+static void rebalance_path(Node **path[], int depth) {
+    while (depth > 0) {
+        Node **link = path[--depth];
+        int old_height = (*link)->height;
+        *link = rebalance(*link);
+        if ((*link)->height == old_height)
+            break;
     }
+    while (depth > 0) {
+        Node *node = *path[--depth];
+        node->size = subtree_size(node->left) + subtree_size(node->right) + 1;
+    }
+}
 
-    /* Περίπτωση Δεξιά-Αριστερά (Right-Left) */
-    if (balance < -1 && strcmp(data.full_name, root->right->data.full_name) < 0) {
-        root->right = rotate_right(root->right);
-        return rotate_left(root);
+/* Εισαγωγή κόμβου στο AVL δέντρο (επαναληπτική, με ρητή στοίβα μονοπατιού) */
+Node* insert_avl(Node *root, const Citizen *data) {
+    uint64_t key = key_prefix(data->full_name);
+    Node **path[AVL_MAX_DEPTH];
+    int depth = 0;
+    Node **link = &root;
+
+    /* Κανονική εισαγωγή BST - κρατάμε κάθε σύνδεσμο του μονοπατιού */
+    while (*link != NULL) {
+        int cmp = key_cmp(key, data->full_name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0)
+            return root; /* Διπλότυπο - δεν εισάγεται */
+        path[depth++] = link;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
     }
+    *link = create_node(data);
 
+    rebalance_path(path, depth);
     return root;
 }
 
@@ -135,81 +323,169 @@ Node* find_min(Node *root) {
     return root;
 }
 
-/* Διαγραφή κόμβου από το AVL δέντρο */
-Node* delete_avl(Node *root, char *name) {
-    if (root == NULL)
-        return NULL;
+/* Διαγραφή κόμβου από το AVL δέντρο (επαναληπτική, με ρητή στοίβα μονοπατιού) */
+Node* delete_avl(Node *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    Node **path[AVL_MAX_DEPTH];
+    int depth = 0;
+    Node **link = &root;
+
+    while (*link != NULL) {
+        int cmp = key_cmp(key, name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0)
+            break;
+        path[depth++] = link;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
 
-    int cmp = strcmp(name, root->data.full_name);
-    if (cmp < 0)
-        root->left = delete_avl(root->left, name);
-    else if (cmp > 0)
-        root->right = delete_avl(root->right, name);
-    else {
-        /* Βρέθηκε ο κόμβος προς διαγραφή */
-        if (root->left == NULL || root->right == NULL) {
-            Node *temp = root->left ? root->left : root->right;
-            if (temp == NULL) {
-                /* Κόμβος χωρίς παιδιά */
-                temp = root;
-                root = NULL;
-            } else {
-                /* Κόμβος με ένα παιδί */
-                *root = *temp;
-            }
-            free(temp);
-        } else {
-            /* Κόμβος με δύο παιδιά - αντικατάσταση με inorder successor */
-            Node *successor = find_min(root->right);
-            root->data = successor->data;
-            root->right = delete_avl(root->right, successor->data.full_name);
+    Node *target = *link;
+    if (target == NULL)
+        return root; /* Δεν βρέθηκε */
+
+    if (target->left == NULL || target->right == NULL) {
+        /* Κόμβος με 0 ή 1 παιδί - το παιδί παίρνει τη θέση του */
+        *link = target->left ? target->left : target->right;
+    } else {
+        /* Κόμβος με δύο παιδιά - ο inorder successor αποσυνδέεται και παίρνει
+         * τη θέση του κόμβου. Ο σύνδεσμος &target->right στη στοίβα γίνεται
+         * &successor->right, αφού ο target δεν ανήκει πια στο δέντρο. */
+        int target_depth = depth;
+        path[depth++] = link;
+        Node **succ_link = &target->right;
+        while ((*succ_link)->left != NULL) {
+            path[depth++] = succ_link;
+            succ_link = &(*succ_link)->left;
         }
+        Node *successor = *succ_link;
+        *succ_link = successor->right;
+        successor->left = target->left;
+        successor->right = target->right;
+        successor->height = target->height;
+        *link = successor;
+        if (depth > target_depth + 1)
+            path[target_depth + 1] = &successor->right;
     }
+    node_free(target);
 
-    if (root == NULL)
-        return NULL;
+    rebalance_path(path, depth);
+    return root;
+}
 
-    /* Ενημέρωση ύψους */
-    root->height = max(height(root->left), height(root->right)) + 1;
+/* Αναζήτηση κόμβου με βάση το όνομα (επαναληπτική) */
+Node* search(Node *root, const char *name) {
+    uint64_t key = key_prefix(name);
 
-    /* Εξισορρόπηση */
-    int balance = get_balance(root);
+    while (root != NULL) {
+        int cmp = key_cmp(key, name, root->key, root->data.full_name);
+        if (cmp == 0)
+            return root;
+        root = (cmp < 0) ? root->left : root->right;
+    }
+    return NULL;
+}
 
-    /* Αριστερά-Αριστερά */
-    if (balance > 1 && get_balance(root->left) >= 0)
-        return rotate_right(root);
+/* ---------- Ομαδική αναζήτηση ---------- */
 
-    /* Αριστερά-Δεξιά */
-    if (balance > 1 && get_balance(root->left) < 0) {
-        root->left = rotate_left(root->left);
-        return rotate_right(root);
-    }
+#define BATCH_GROUP 16     /* αναζητήσεις σε εξέλιξη ταυτόχρονα */
 
-    /* Δεξιά-Δεξιά */
-    if (balance < -1 && get_balance(root->right) <= 0)
-        return rotate_left(root);
+typedef struct {
+    Node *node;
+    uint64_t key;
+    int idx;
+} BatchState;
+
+/* Η επόμενη αναζήτηση στη θέση st - 0 αν δεν υπάρχουν άλλες */
+static int batch_next(BatchState *st, Node *root, const char *const *names, int n, int *next) {
+    if (*next >= n)
+        return 0;
+    st->node = root;
+    st->key = key_prefix(names[*next]);
+    st->idx = (*next)++;
+    return 1;
+}
 
-    /* Δεξιά-Αριστερά */
-    if (balance < -1 && get_balance(root->right) > 0) {
-        root->right = rotate_right(root->right);
-        return rotate_left(root);
+/* Ομαδική αναζήτηση με AMAC (όπως η bst_search_batch του benchmark.c):
+ * out[i] ο κόμβος του names[i] ή NULL */
+void search_batch(Node *root, const char *const *names, int n, Node **out) {
+    BatchState st[BATCH_GROUP];
+    int next = 0, active = 0;
+    while (active < BATCH_GROUP && batch_next(&st[active], root, names, n, &next))
+        active++;
+
+    while (active > 0) {
+        for (int s = 0; s < active;) {
+            Node *x = st[s].node;
+            int cmp = 0;
+            if (x != NULL)
+                cmp = key_cmp(st[s].key, names[st[s].idx], x->key, x->data.full_name);
+            if (cmp != 0) {
+                x = (cmp < 0) ? x->left : x->right;
+                __builtin_prefetch(x);
+                st[s++].node = x;
+                continue;
+            }
+            out[st[s].idx] = x;
+            if (!batch_next(&st[s], root, names, n, &next))
+                st[s] = st[--active];
+        }
     }
+}
 
-    return root;
+/* ---------- Μαζική κατασκευή ---------- */
+
+/* Αλφαβητική σειρά και, για ίδια ονόματα, σειρά εμφάνισης στον πίνακα */
+static int compare_citizen_ptr(const void *a, const void *b) {
+    const Citizen *x = *(const Citizen* const*)a;
+    const Citizen *y = *(const Citizen* const*)b;
+    int cmp = strcmp(x->full_name, y->full_name);
+    if (cmp != 0)
+        return cmp;
+    return (x > y) - (x < y);
 }
 
-/* Αναζήτηση κόμβου με βάση το όνομα */
-Node* search(Node *root, char *name) {
-    if (root == NULL)
+/* Ταξινόμηση (αν ο πίνακας δεν είναι ήδη ταξινομημένος) και αφαίρεση
+ * διπλοτύπων - κρατείται η πρώτη εμφάνιση, όπως στην εισαγωγή */
+static int sort_unique(Citizen citizens[], int count, Citizen ***out) {
+    Citizen **v = (Citizen**)malloc((count > 0 ? count : 1) * sizeof(Citizen*));
+    int sorted = 1;
+    for (int i = 0; i < count; i++) {
+        v[i] = &citizens[i];
+        if (i > 0 && strcmp(citizens[i - 1].full_name, citizens[i].full_name) > 0)
+            sorted = 0;
+    }
+    if (!sorted)
+        qsort(v, count, sizeof(Citizen*), compare_citizen_ptr);
+
+    int m = 0;
+    for (int i = 0; i < count; i++)
+        if (m == 0 || strcmp(v[m - 1]->full_name, v[i]->full_name) != 0)
+            v[m++] = v[i];
+    *out = v;
+    return m;
+}
+
+/* Ρίζα κάθε υποδέντρου είναι το μεσαίο στοιχείο, οπότε τα μεγέθη αδελφών
+ * υποδέντρων διαφέρουν το πολύ κατά 1 και τα ύψη επίσης */
+static Node* build_range(Citizen **v, int lo, int hi) {
+    if (lo > hi)
         return NULL;
+    int mid = lo + (hi - lo) / 2;
+    Node *node = create_node(v[mid]);
+    node->left = build_range(v, lo, mid - 1);
+    node->right = build_range(v, mid + 1, hi);
+    node->height = max(height(node->left), height(node->right)) + 1;
+    node->size = hi - lo + 1;
+    return node;
+}
 
-    int cmp = strcmp(name, root->data.full_name);
-    if (cmp == 0)
-        return root;
-    else if (cmp < 0)
-        return search(root->left, name);
-    else
-        return search(root->right, name);
+/* Κατασκευή έγκυρου AVL δέντρου από πίνακα πολιτών σε O(n) μετά την
+ * ταξινόμηση - χωρίς περιστροφές */
+Node* build_avl(Citizen citizens[], int count) {
+    Citizen **v;
+    int m = sort_unique(citizens, count, &v);
+    Node *root = build_range(v, 0, m - 1);
+    free(v);
+    return root;
 }
 
 /* Inorder traversal - εκτύπωση σε αλφαβητική σειρά */
@@ -234,9 +510,397 @@ void traversal_to_file(Node *root, FILE *fp) {
 
 /* Απελευθέρωση μνήμης δέντρου */
 void free_tree(Node *root) {
+    /* Χωρίς αναδρομή: δεξιές περιστροφές ως τη δεξιά ράχη, όπως στο bst.c */
+    while (root != NULL) {
+        Node *next = root->left;
+        if (next != NULL) {
+            root->left = next->right;
+            next->right = root;
+        } else {
+            next = root->right;
+            node_free(root);
+        }
+        root = next;
+    }
+}
+
+/* ---------- Διατεταγμένη προσπέλαση ---------- */
+
+/* Iterator με ρητή στοίβα: η στοίβα κρατά τους προγόνους που απομένουν να
+ * επισκεφθούμε (αυτούς από τους οποίους κατεβήκαμε αριστερά). Το ύψος του
+ * AVL είναι λογαριθμικό, οπότε αρκεί σταθερή στοίβα AVL_MAX_DEPTH θέσεων. */
+typedef struct {
+    Node *stack[AVL_MAX_DEPTH];
+    int top;
+} TreeIter;
+
+/* Τοποθέτηση στο πρώτο όνομα >= lo (NULL = στην αρχή) σε O(log n) */
+void iter_seek(TreeIter *it, Node *root, const char *lo) {
+    it->top = 0;
+    uint64_t key = lo ? key_prefix(lo) : 0;
+
+    while (root != NULL) {
+        if (lo == NULL || key_cmp(key, lo, root->key, root->data.full_name) <= 0) {
+            it->stack[it->top++] = root;
+            root = root->left;
+        } else {
+            root = root->right;
+        }
+    }
+}
+
+/* Επόμενος κόμβος σε αλφαβητική σειρά ή NULL στο τέλος */
+Node* iter_next(TreeIter *it) {
+    if (it->top == 0)
+        return NULL;
+    Node *node = it->stack[--it->top];
+    for (Node *x = node->right; x != NULL; x = x->left)
+        it->stack[it->top++] = x;
+    return node;
+}
+
+/* Αντιγραφή των εγγραφών με lo <= όνομα <= hi (NULL = χωρίς όριο) στο out,
+ * έως limit - επιστρέφει το πλήθος τους */
+int range_query(Node *root, const char *lo, const char *hi, Citizen *out, int limit) {
+    TreeIter it;
+    int count = 0;
+    uint64_t key = hi ? key_prefix(hi) : 0;
+    iter_seek(&it, root, lo);
+
+    Node *node;
+    while (count < limit && (node = iter_next(&it)) != NULL) {
+        if (hi && key_cmp(key, hi, node->key, node->data.full_name) < 0)
+            break;
+        out[count++] = node->data;
+    }
+    return count;
+}
+
+/* Αντιγραφή των εγγραφών που το όνομά τους αρχίζει από prefix στο out, έως
+ * limit - επιστρέφει το πλήθος τους */
+int prefix_query(Node *root, const char *prefix, Citizen *out, int limit) {
+    TreeIter it;
+    int count = 0;
+    size_t len = strlen(prefix);
+    iter_seek(&it, root, prefix);
+
+    Node *node;
+    while (count < limit && (node = iter_next(&it)) != NULL) {
+        if (strncmp(node->data.full_name, prefix, len) != 0)
+            break;
+        out[count++] = node->data;
+    }
+    return count;
+}
+
+/* ---------- Στατιστικά διάταξης ---------- */
+
+/* Κάθε κόμβος κρατά το μέγεθος του υποδέντρου του, οπότε η θέση ενός
+ * ονόματος και ο k-οστός κόμβος βρίσκονται με μία κατάβαση, σε O(log n). */
+
+/* Πλήθος ονομάτων < name ή, με inclusive = 1, <= name */
+static int count_below(Node *root, const char *name, int inclusive) {
+    uint64_t key = key_prefix(name);
+    int count = 0;
+
+    while (root != NULL) {
+        int cmp = key_cmp(key, name, root->key, root->data.full_name);
+        if (cmp == 0)
+            return count + subtree_size(root->left) + inclusive;
+        if (cmp < 0) {
+            root = root->left;
+        } else {
+            count += subtree_size(root->left) + 1;
+            root = root->right;
+        }
+    }
+    return count;
+}
+
+/* Θέση του name σε αλφαβητική σειρά (0 = πρώτο) - αν δεν υπάρχει, η θέση
+ * στην οποία θα έμπαινε */
+int rank(Node *root, const char *name) {
+    return count_below(root, name, 0);
+}
+
+/* Ο k-οστός κόμβος σε αλφαβητική σειρά (k από 0) ή NULL αν k εκτός ορίων.
+ * Το εκατοστημόριο p είναι select_kth(root, p * (n - 1) / 100). */
+Node* select_kth(Node *root, int k) {
+    while (root != NULL) {
+        int left = subtree_size(root->left);
+        if (k == left)
+            return root;
+        if (k < left) {
+            root = root->left;
+        } else {
+            k -= left + 1;
+            root = root->right;
+        }
+    }
+    return NULL;
+}
+
+/* Πλήθος εγγραφών με lo <= όνομα <= hi */
+int count_range(Node *root, const char *lo, const char *hi) {
+    int count = count_below(root, hi, 1) - count_below(root, lo, 0);
+    return count > 0 ? count : 0;
+}
+
+/* ---------- Στιγμιότυπο σε αρχείο ---------- */
+
+/* Το δέντρο αποθηκεύεται χωρίς δείκτες: οι κόμβοι αριθμούνται σε in-order
+ * σειρά και παιδιά/γονέας είναι θέσεις 32-bit (SNAP_NONE για κενό). Το αρχείο
+ * έχει header 64 bytes (έκδοση, πλήθη, αθροίσματα ελέγχου), τον πίνακα
+ * κόμβων και, ευθυγραμμισμένο στα 64 bytes, τον πίνακα εγγραφών. Είναι ίδια
+ * μορφή με τα στιγμιότυπα του benchmark.c (σειρά bytes του host), οπότε η
+ * φόρτωση ξαναστήνει το δέντρο σε O(n) χωρίς συγκρίσεις και περιστροφές. */
+
+#define SNAP_MAGIC "CITZSNP1"
+#define SNAP_VERSION 1
+#define SNAP_KIND 1 /* AVL */
+#define SNAP_NONE UINT32_MAX
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint64_t count;
+    uint32_t root;
+    uint32_t height;
+    uint32_t node_size;
+    uint32_t record_size;
+    uint64_t file_size;
+    uint64_t data_checksum;   /* όλα τα bytes μετά το header */
+    uint64_t header_checksum; /* τα πρώτα 56 bytes του header */
+} SnapHeader;
+
+typedef struct {
+    uint64_t key;
+    uint32_t left, right, parent;
+    uint8_t height;
+    char color;
+    uint16_t pad;
+} SnapNode;
+
+static uint64_t snap_records_offset(uint64_t count) {
+    return (sizeof(SnapHeader) + count * sizeof(SnapNode) + 63) & ~(uint64_t)63;
+}
+
+/* Άθροισμα ελέγχου ανά λέξη 8 bytes (ίδιο με το generate_citizens.c) */
+static uint64_t snap_checksum(const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char*)data;
+    uint64_t h = 0x9E3779B97F4A7C15ULL, w;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        memcpy(&w, p + i, 8);
+        h ^= w * 0xBF58476D1CE4E5B9ULL;
+        h = ((h << 31) | (h >> 33)) * 0x94D049BB133111EBULL;
+    }
+    w = 0;
+    memcpy(&w, p + i, len - i);
+    h ^= w * 0xBF58476D1CE4E5B9ULL;
+    h = ((h << 31) | (h >> 33)) * 0x94D049BB133111EBULL;
+    h ^= len;
+    h += 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+static uint64_t count_nodes(Node *root) {
     if (root == NULL)
-        return;
-    free_tree(root->left);
-    free_tree(root->right);
-    free(root);
+        return 0;
+    return 1 + count_nodes(root->left) + count_nodes(root->right);
+}
+
+/* In-order γέμισμα των πινάκων - επιστρέφει τη θέση του κόμβου */
+static uint32_t snap_fill(Node *n, SnapNode *nodes, Citizen *recs, uint32_t *next, uint32_t depth, uint32_t *levels) {
+    if (n == NULL)
+        return SNAP_NONE;
+    uint32_t l = snap_fill(n->left, nodes, recs, next, depth + 1, levels);
+    uint32_t i = (*next)++;
+    uint32_t r = snap_fill(n->right, nodes, recs, next, depth + 1, levels);
+
+    nodes[i].key = n->key;
+    nodes[i].left = l;
+    nodes[i].right = r;
+    nodes[i].parent = SNAP_NONE; /* τον ορίζει ο γονέας */
+    nodes[i].height = (uint8_t)(n->height > 255 ? 255 : n->height);
+    nodes[i].color = 0;
+    recs[i] = n->data;
+    if (l != SNAP_NONE)
+        nodes[l].parent = i;
+    if (r != SNAP_NONE)
+        nodes[r].parent = i;
+    if (depth + 1 > *levels)
+        *levels = depth + 1;
+    return i;
+}
+
+/* Αποθήκευση του δέντρου στο path (μέσω path.tmp και μετονομασίας, ώστε ένα
+ * προηγούμενο στιγμιότυπο να μη μείνει ποτέ μισό). Επιστρέφει 0 ή -1. */
+int save_avl(Node *root, const char *path) {
+    uint64_t count = count_nodes(root);
+    if (count >= SNAP_NONE) {
+        printf("Σφάλμα: πάρα πολλοί κόμβοι για στιγμιότυπο\n");
+        return -1;
+    }
+    uint64_t rec_off = snap_records_offset(count);
+    size_t size = (size_t)(rec_off + count * sizeof(Citizen));
+    unsigned char *buf = (unsigned char*)calloc(1, size);
+    if (!buf) {
+        printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
+        return -1;
+    }
+
+    SnapHeader h;
+    memset(&h, 0, sizeof(h));
+    uint32_t next = 0, levels = 0;
+    h.root = snap_fill(root, (SnapNode*)(buf + sizeof(SnapHeader)), (Citizen*)(buf + rec_off), &next, 0, &levels);
+    memcpy(h.magic, SNAP_MAGIC, 8);
+    h.version = SNAP_VERSION;
+    h.kind = SNAP_KIND;
+    h.count = count;
+    h.height = levels;
+    h.node_size = sizeof(SnapNode);
+    h.record_size = sizeof(Citizen);
+    h.file_size = size;
+    h.data_checksum = snap_checksum(buf + sizeof(SnapHeader), size - sizeof(SnapHeader));
+    h.header_checksum = snap_checksum(&h, offsetof(SnapHeader, header_checksum));
+    memcpy(buf, &h, sizeof(h));
+
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *fp = fopen(tmp, "wb");
+    int ok = fp != NULL && fwrite(buf, 1, size, fp) == size;
+    if (fp != NULL && fclose(fp) != 0)
+        ok = 0;
+    free(buf);
+    if (!ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        printf("Σφάλμα: αποτυχία εγγραφής του %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/* Ανώτατο ύψος ισορροπημένου δέντρου n κόμβων: 2 log2(n+1) + 2 καλύπτει
+ * το AVL (~1.44 log2 n) και το Red-Black (2 log2(n+1)). Ένα μεγαλύτερο ύψος
+ * απορρίπτεται πριν την ανασύσταση, οπότε η αναδρομή της μένει ρηχή */
+static uint32_t snap_max_height(uint64_t count) {
+    uint32_t log2 = 0;
+    while ((count + 1) >> (log2 + 1))
+        log2++;
+    return 2 * log2 + 2;
+}
+
+/* Οι κόμβοι είναι αριθμημένοι in-order, άρα οι εγγραφές πρέπει να είναι
+ * αυστηρά αύξουσες, με τερματισμένα strings και σωστό πρόθεμα - έλεγχος σε
+ * O(n) πριν την ανασύσταση */
+static int snap_order_ok(const SnapNode *nodes, const Citizen *recs, uint64_t count) {
+    for (uint64_t i = 0; i < count; i++) {
+        const Citizen *c = &recs[i];
+        if (!memchr(c->full_name, 0, sizeof(c->full_name)) || !memchr(c->state, 0, sizeof(c->state)))
+            return 0;
+        if (nodes[i].key != key_prefix(c->full_name))
+            return 0;
+        if (i > 0 && key_cmp(nodes[i - 1].key, recs[i - 1].full_name, nodes[i].key, c->full_name) >= 0)
+            return 0;
+    }
+    return 1;
+}
+
+/* Ανασύσταση από τη ρίζα - κάθε σύνδεσμος ελέγχεται (θέση μέσα στο in-order
+ * διάστημα [lo, hi) του υποδέντρου, ίδιος γονέας και στις δύο πλευρές,
+ * βάθος έως το ύψος), άρα κάθε κόμβος επισκέπτεται το πολύ μία φορά και η
+ * θέση του είναι η in-order σειρά του. Ύψη και ισορροπία AVL ελέγχονται
+ * στην επιστροφή */
+static Node* snap_thaw(const SnapHeader *h, const SnapNode *nodes, const Citizen *recs, uint32_t i,
+                       uint32_t parent, uint32_t lo, uint32_t hi, uint32_t depth, uint64_t *made, int *bad) {
+    if (i == SNAP_NONE || *bad)
+        return NULL;
+    if (i < lo || i >= hi || nodes[i].parent != parent || depth >= h->height) {
+        *bad = 1;
+        return NULL;
+    }
+    Node *node = create_node(&recs[i]);
+    if (!node) {
+        *bad = 1;
+        return NULL;
+    }
+    node->height = nodes[i].height;
+    (*made)++;
+    node->left = snap_thaw(h, nodes, recs, nodes[i].left, i, lo, i, depth + 1, made, bad);
+    node->right = snap_thaw(h, nodes, recs, nodes[i].right, i, i + 1, hi, depth + 1, made, bad);
+    node->size = subtree_size(node->left) + subtree_size(node->right) + 1;
+    int hl = height(node->left), hr = height(node->right);
+    if (node->height != max(hl, hr) + 1 || hl - hr > 1 || hr - hl > 1)
+        *bad = 1;
+    return node;
+}
+
+/* Φόρτωση στιγμιοτύπου: έλεγχος header, μεγέθους και αθροίσματος ελέγχου,
+ * και μετά το δέντρο στο *root. Επιστρέφει το πλήθος κόμβων ή -1. */
+int load_avl(const char *path, Node **root) {
+    *root = NULL;
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        printf("Σφάλμα: δεν ανοίγει το %s\n", path);
+        return -1;
+    }
+    unsigned char *buf = NULL;
+    long size = -1;
+    if (fseek(fp, 0, SEEK_END) == 0)
+        size = ftell(fp);
+    if (size >= (long)sizeof(SnapHeader) && fseek(fp, 0, SEEK_SET) == 0) {
+        buf = (unsigned char*)malloc((size_t)size);
+        if (buf && fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+            free(buf);
+            buf = NULL;
+        }
+    }
+    fclose(fp);
+    if (!buf) {
+        printf("Σφάλμα: το %s δεν διαβάζεται\n", path);
+        return -1;
+    }
+
+    SnapHeader h;
+    memcpy(&h, buf, sizeof(h));
+    const char *why = NULL;
+    if (memcmp(h.magic, SNAP_MAGIC, 8) != 0 || h.kind != SNAP_KIND)
+        why = "δεν είναι στιγμιότυπο AVL";
+    else if (h.version != SNAP_VERSION)
+        why = "άγνωστη έκδοση μορφής";
+    else if (snap_checksum(&h, offsetof(SnapHeader, header_checksum)) != h.header_checksum)
+        why = "αλλοιωμένο header";
+    else if (h.node_size != sizeof(SnapNode) || h.record_size != sizeof(Citizen) || h.count > INT32_MAX)
+        why = "μη έγκυρο header";
+    else if (h.height > snap_max_height(h.count))
+        why = "ύψος μεγαλύτερο από ισορροπημένου δέντρου";
+    else if (h.file_size != (uint64_t)size || snap_records_offset(h.count) + h.count * sizeof(Citizen) != h.file_size)
+        why = "λάθος μέγεθος αρχείου";
+    else if (snap_checksum(buf + sizeof(SnapHeader), (size_t)size - sizeof(SnapHeader)) != h.data_checksum)
+        why = "λάθος άθροισμα ελέγχου δεδομένων";
+
+    uint64_t made = 0;
+    int bad = 0;
+    if (!why) {
+        const SnapNode *nodes = (const SnapNode*)(buf + sizeof(SnapHeader));
+        const Citizen *recs = (const Citizen*)(buf + snap_records_offset(h.count));
+        if (!snap_order_ok(nodes, recs, h.count))
+            why = "εγγραφές εκτός σειράς";
+        else
+            *root = snap_thaw(&h, nodes, recs, h.root, SNAP_NONE, 0, (uint32_t)h.count, 0, &made, &bad);
+        if (!why && (bad || made != h.count))
+            why = "μη έγκυρη δομή δέντρου";
+    }
+    free(buf);
+    if (why) {
+        free_tree(*root);
+        *root = NULL;
+        printf("Σφάλμα: %s: %s\n", path, why);
+        return -1;
+    }
+    return (int)made;
 }
@@ -1,20 +1,47 @@
 /*
  * benchmark.c
  * Μέτρηση και σύγκριση απόδοσης BST, AVL και Red-Black δέντρων
- * Εκτελεί insert, search, delete και υπολογίζει μέσο χρόνο σε 5 επαναλήψεις
+ * Εκτελεί insert, search, delete με χρονομέτρηση ανά λειτουργία και αναφέρει
+ * μέσο όρο, τυπική απόκλιση, διάμεσο, p99 και p99.9 (βλ. usage για τις παραμέτρους)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <errno.h>
 #include <time.h>
-#include <sys/time.h>
+#include <pthread.h>
+#include <math.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "citizens_bin.h"
+
+/* Τρέχων χρόνος σε ns από μονοτονικό ρολόι υψηλής ανάλυσης (δεν επηρεάζεται
+ * από αλλαγές της ώρας συστήματος, σε αντίθεση με το gettimeofday) */
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
 
 /* Επιστρέφει τρέχοντα χρόνο σε microseconds */
 double get_time_us(void) {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec * 1000000.0 + tv.tv_usec;
+    return now_ns() / 1000.0;
 }
 
 /* Συμπερίληψη υλοποιήσεων - κάθε αρχείο ορίζει τις δικές του συναρτήσεις */
@@ -29,39 +56,194 @@ typedef struct {
     int annual_income;
 } Citizen;
 
-/* Κόμβος BST/AVL */
+/* Κόμβος BST/AVL - τα πεδία της αναζήτησης (key, παιδιά) προηγούνται
+ * ώστε να βρίσκονται στην ίδια cache line με την αρχή του ονόματος */
 typedef struct BSTNode {
-    Citizen data;
+    uint64_t key;
     struct BSTNode *left;
     struct BSTNode *right;
     int height;
+    Citizen data;
 } BSTNode;
 
 /* Κόμβος Red-Black */
 typedef struct RBTNode {
-    Citizen data;
+    uint64_t key;
     struct RBTNode *left;
     struct RBTNode *right;
     struct RBTNode *parent;
     int height;
     char color;
+    Citizen data;
 } RBTNode;
 
+/* ============ Κλειδιά Σύγκρισης ============ */
+
+/* Κάθε κόμβος κρατά τα πρώτα 8 bytes του full_name ως big-endian ακέραιο.
+ * Η σύγκριση ακεραίων δίνει την ίδια διάταξη με την strcmp, οπότε η strcmp
+ * καλείται (από το 9ο byte) μόνο όταν τα προθέματα ταυτίζονται. */
+
+/* Μετρητές συγκρίσεων - μεταγλώττιση με -DKEY_STATS=0 για απενεργοποίηση */
+#ifndef KEY_STATS
+#define KEY_STATS 1
+#endif
+#if KEY_STATS
+/* Ανά νήμα, ώστε δέντρα σε διαφορετικά νήματα να μη γράφουν στην ίδια θέση */
+static __thread unsigned long long key_cmp_calls = 0;  /* συγκρίσεις κλειδιών */
+static __thread unsigned long long key_cmp_full = 0;   /* από αυτές, με strcmp */
+#define KEY_STAT(x) (x)
+#else
+#define KEY_STAT(x) ((void)0)
+#endif
+
+static inline uint64_t key_prefix(const char *name) {
+    uint64_t k = 0;
+    int i = 0;
+    for (; i < 8 && name[i]; i++) k = (k << 8) | (unsigned char)name[i];
+    return i ? k << (8 * (8 - i)) : 0;
+}
+
+static inline int key_cmp(uint64_t ka, const char *a, uint64_t kb, const char *b) {
+    KEY_STAT(key_cmp_calls++);
+    if (ka != kb) return ka < kb ? -1 : 1;
+    if ((ka & 0xFF) == 0) return 0;  /* όνομα μικρότερο των 8 bytes: ίσα */
+    KEY_STAT(key_cmp_full++);
+    return strcmp(a + 8, b + 8);
+}
+
+/* Ίδια σύγκριση χωρίς μετρητές, για τις δομές που τρέχουν σε πολλά νήματα
+ * ταυτόχρονα (εκεί οι μετρήσεις ανά νήμα δεν σημαίνουν κάτι) */
+static inline int key_cmp_mt(uint64_t ka, const char *a, uint64_t kb, const char *b) {
+    if (ka != kb) return ka < kb ? -1 : 1;
+    if ((ka & 0xFF) == 0) return 0;
+    return strcmp(a + 8, b + 8);
+}
+
+/* ============ Δεξαμενή Κόμβων (Arena) ============ */
+
+/* Κάθε δέντρο μπορεί να δεσμεύει κόμβους από δική του arena: οι κόμβοι
+ * κόβονται διαδοχικά από slabs του 1 MiB, οι διαγραμμένοι κόμβοι μπαίνουν
+ * σε free list και ολόκληρο το δέντρο ελευθερώνεται με pool_reset ή
+ * pool_destroy χωρίς διάσχιση. */
+
+#define POOL_SLAB_BYTES (1u << 20)
+#define POOL_SLAB_HEADER 64
+
+typedef struct PoolSlab {
+    struct PoolSlab *next;
+} PoolSlab;
+
+typedef struct {
+    size_t node_size;
+    PoolSlab *head, *cur;   /* λίστα slabs και τρέχον slab */
+    char *bump, *end;       /* ελεύθερη περιοχή τρέχοντος slab */
+    void *free_list;        /* κόμβοι που επιστράφηκαν με pool_free */
+    size_t live, slabs;
+} NodePool;
+
+void pool_init(NodePool *p, size_t node_size) {
+    memset(p, 0, sizeof(*p));
+    p->node_size = (node_size + 7) & ~(size_t)7;
+}
+
+/* Μετάβαση στο επόμενο slab (επαναχρησιμοποίηση μετά από reset ή νέο) */
+static int pool_next_slab(NodePool *p) {
+    PoolSlab *s = p->cur ? p->cur->next : p->head;
+    if (!s) {
+        s = (PoolSlab*)malloc(POOL_SLAB_BYTES);
+        if (!s) return 0;
+        s->next = NULL;
+        if (p->cur) p->cur->next = s; else p->head = s;
+        p->slabs++;
+    }
+    p->cur = s;
+    p->bump = (char*)s + POOL_SLAB_HEADER;
+    p->end = (char*)s + POOL_SLAB_BYTES;
+    return 1;
+}
+
+void* pool_alloc(NodePool *p) {
+    void *n = p->free_list;
+    if (n) { p->free_list = *(void**)n; p->live++; return n; }
+    if ((size_t)(p->end - p->bump) < p->node_size && !pool_next_slab(p)) return NULL;
+    n = p->bump;
+    p->bump += p->node_size;
+    p->live++;
+    return n;
+}
+
+void pool_free(NodePool *p, void *n) {
+    *(void**)n = p->free_list;
+    p->free_list = n;
+    p->live--;
+}
+
+/* Ελευθέρωση όλων των κόμβων - τα slabs κρατιούνται για επαναχρησιμοποίηση */
+void pool_reset(NodePool *p) {
+    p->cur = NULL;
+    p->bump = p->end = NULL;
+    p->free_list = NULL;
+    p->live = 0;
+}
+
+/* Επιστροφή όλων των slabs στο σύστημα */
+void pool_destroy(NodePool *p) {
+    PoolSlab *s = p->head;
+    while (s) { PoolSlab *next = s->next; free(s); s = next; }
+    pool_init(p, p->node_size);
+}
+
+/* Ενεργή arena ανά τύπο κόμβου και νήμα (NULL = malloc/free) */
+static __thread NodePool *bst_pool = NULL;
+static __thread NodePool *rbt_pool = NULL;
+
+/* Λογιστική μνήμης ανά τύπο κόμβου για κόμβους με malloc (με arena τα
+ * ίδια στοιχεία δίνουν τα live, node_size και slabs της NodePool) */
+typedef struct {
+    size_t live_nodes, live_bytes, peak_bytes;
+} MemStats;
+
+static MemStats bst_mem, rbt_mem;
+
+static void* node_alloc(NodePool *p, MemStats *m, size_t size) {
+    if (p) return pool_alloc(p);
+    void *n = malloc(size);
+    if (n) {
+        m->live_nodes++; m->live_bytes += size;
+        if (m->live_bytes > m->peak_bytes) m->peak_bytes = m->live_bytes;
+    }
+    return n;
+}
+
+static void node_free(NodePool *p, MemStats *m, void *n, size_t size) {
+    if (p) { pool_free(p, n); return; }
+    m->live_nodes--; m->live_bytes -= size;
+    free(n);
+}
+
 /* ============ BST Συναρτήσεις ============ */
 
-BSTNode* bst_create(Citizen data) {
-    BSTNode *n = (BSTNode*)malloc(sizeof(BSTNode));
-    n->data = data;
+/* Η εγγραφή αντιγράφεται μία φορά, απευθείας στον νέο κόμβο */
+BSTNode* bst_create(uint64_t key, const Citizen *c) {
+    BSTNode *n = (BSTNode*)node_alloc(bst_pool, &bst_mem, sizeof(BSTNode));
+    n->key = key;
+    n->data = *c;
     n->left = n->right = NULL;
     n->height = 1;
     return n;
 }
 
-BSTNode* bst_insert(BSTNode *root, Citizen data) {
-    if (!root) return bst_create(data);
-    int cmp = strcmp(data.full_name, root->data.full_name);
-    if (cmp < 0) root->left = bst_insert(root->left, data);
-    else if (cmp > 0) root->right = bst_insert(root->right, data);
+/* Επαναληπτικές λειτουργίες: κατάβαση με δείκτη στον σύνδεσμο (link) που θα
+ * αλλάξει, χωρίς αναδρομή και χωρίς αντιγραφή του Citizen ανά επίπεδο */
+BSTNode* bst_insert(BSTNode *root, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    BSTNode **link = &root;
+    while (*link) {
+        int cmp = key_cmp(key, c->full_name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0) return root;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+    *link = bst_create(key, c);
     return root;
 }
 
@@ -70,37 +252,103 @@ BSTNode* bst_find_min(BSTNode *root) {
     return root;
 }
 
-BSTNode* bst_delete(BSTNode *root, char *name) {
+/* Ο διάδοχος μετακινείται στη θέση του διαγραμμένου κόμβου (αλλαγή συνδέσμων,
+ * όχι αντιγραφή δεδομένων), οπότε οι υπόλοιποι κόμβοι δεν αλλάζουν διεύθυνση */
+BSTNode* bst_delete(BSTNode *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    BSTNode **link = &root;
+    while (*link) {
+        int cmp = key_cmp(key, name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0) break;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+    BSTNode *z = *link;
+    if (!z) return root;
+    if (!z->left) *link = z->right;
+    else if (!z->right) *link = z->left;
+    else {
+        BSTNode **sl = &z->right;
+        while ((*sl)->left) sl = &(*sl)->left;
+        BSTNode *s = *sl;
+        *sl = s->right;
+        s->left = z->left; s->right = z->right;
+        *link = s;
+    }
+    node_free(bst_pool, &bst_mem, z, sizeof(BSTNode));
+    return root;
+}
+
+BSTNode* bst_search(BSTNode *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    while (root) {
+        int cmp = key_cmp(key, name, root->key, root->data.full_name);
+        if (cmp == 0) return root;
+        root = (cmp < 0) ? root->left : root->right;
+    }
+    return NULL;
+}
+
+/* Χωρίς αναδρομή, γιατί το BST μιας ταξινομημένης εισόδου έχει βάθος n:
+ * δεξιά περιστροφή όσο η ρίζα έχει αριστερό παιδί, αλλιώς free και
+ * συνέχεια δεξιά - O(n), χωρίς στοίβα */
+void bst_free(BSTNode *root) {
+    while (root) {
+        BSTNode *next = root->left;
+        if (next) { root->left = next->right; next->right = root; }
+        else { next = root->right; node_free(bst_pool, &bst_mem, root, sizeof(BSTNode)); }
+        root = next;
+    }
+}
+
+/* Αναδρομικές εκδόσεις με Citizen by value - κρατιούνται για σύγκριση */
+static BSTNode* bst_insert_k(BSTNode *root, uint64_t key, Citizen data) {
+    if (!root) return bst_create(key, &data);
+    int cmp = key_cmp(key, data.full_name, root->key, root->data.full_name);
+    if (cmp < 0) root->left = bst_insert_k(root->left, key, data);
+    else if (cmp > 0) root->right = bst_insert_k(root->right, key, data);
+    return root;
+}
+
+BSTNode* bst_insert_rec(BSTNode *root, Citizen data) {
+    return bst_insert_k(root, key_prefix(data.full_name), data);
+}
+
+static BSTNode* bst_delete_k(BSTNode *root, uint64_t key, char *name) {
     if (!root) return NULL;
-    int cmp = strcmp(name, root->data.full_name);
-    if (cmp < 0) root->left = bst_delete(root->left, name);
-    else if (cmp > 0) root->right = bst_delete(root->right, name);
+    int cmp = key_cmp(key, name, root->key, root->data.full_name);
+    if (cmp < 0) root->left = bst_delete_k(root->left, key, name);
+    else if (cmp > 0) root->right = bst_delete_k(root->right, key, name);
     else {
-        if (!root->left) { BSTNode *t = root->right; free(root); return t; }
-        if (!root->right) { BSTNode *t = root->left; free(root); return t; }
+        if (!root->left) { BSTNode *t = root->right; node_free(bst_pool, &bst_mem, root, sizeof(BSTNode)); return t; }
+        if (!root->right) { BSTNode *t = root->left; node_free(bst_pool, &bst_mem, root, sizeof(BSTNode)); return t; }
         BSTNode *s = bst_find_min(root->right);
+        root->key = s->key;
         root->data = s->data;
-        root->right = bst_delete(root->right, s->data.full_name);
+        root->right = bst_delete_k(root->right, s->key, s->data.full_name);
     }
     return root;
 }
 
-BSTNode* bst_search(BSTNode *root, char *name) {
+BSTNode* bst_delete_rec(BSTNode *root, char *name) {
+    return bst_delete_k(root, key_prefix(name), name);
+}
+
+static BSTNode* bst_search_k(BSTNode *root, uint64_t key, char *name) {
     if (!root) return NULL;
-    int cmp = strcmp(name, root->data.full_name);
+    int cmp = key_cmp(key, name, root->key, root->data.full_name);
     if (cmp == 0) return root;
-    return (cmp < 0) ? bst_search(root->left, name) : bst_search(root->right, name);
+    return (cmp < 0) ? bst_search_k(root->left, key, name) : bst_search_k(root->right, key, name);
 }
 
-void bst_free(BSTNode *root) {
-    if (!root) return;
-    bst_free(root->left);
-    bst_free(root->right);
-    free(root);
+BSTNode* bst_search_rec(BSTNode *root, char *name) {
+    return bst_search_k(root, key_prefix(name), name);
 }
 
 /* ============ AVL Συναρτήσεις ============ */
 
+/* Μέγιστο ύψος AVL ~ 1.44 log2(n), άρα 64 επίπεδα αρκούν για κάθε n */
+#define AVL_MAX_DEPTH 64
+
 int avl_height(BSTNode *n) { return n ? n->height : 0; }
 int avl_max(int a, int b) { return a > b ? a : b; }
 int avl_balance(BSTNode *n) { return n ? avl_height(n->left) - avl_height(n->right) : 0; }
@@ -121,46 +369,127 @@ BSTNode* avl_rotate_left(BSTNode *x) {
     return y;
 }
 
-BSTNode* avl_insert(BSTNode *root, Citizen data) {
-    if (!root) return bst_create(data);
-    int cmp = strcmp(data.full_name, root->data.full_name);
-    if (cmp < 0) root->left = avl_insert(root->left, data);
-    else if (cmp > 0) root->right = avl_insert(root->right, data);
+/* Ενημέρωση ύψους και περιστροφή αν |balance| > 1 - επιστρέφει τη νέα ρίζα */
+static BSTNode* avl_rebalance(BSTNode *n) {
+    n->height = avl_max(avl_height(n->left), avl_height(n->right)) + 1;
+    int bal = avl_balance(n);
+    if (bal > 1) {
+        if (avl_balance(n->left) < 0) n->left = avl_rotate_left(n->left);
+        return avl_rotate_right(n);
+    }
+    if (bal < -1) {
+        if (avl_balance(n->right) > 0) n->right = avl_rotate_right(n->right);
+        return avl_rotate_left(n);
+    }
+    return n;
+}
+
+/* Επαναληπτική εισαγωγή: η στοίβα κρατά τους συνδέσμους του μονοπατιού και η
+ * επανεξισορρόπηση ανεβαίνει μέχρι τον πρώτο κόμβο που δεν αλλάζει ύψος */
+BSTNode* avl_insert(BSTNode *root, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    BSTNode **path[AVL_MAX_DEPTH];
+    int depth = 0;
+    BSTNode **link = &root;
+    while (*link) {
+        int cmp = key_cmp(key, c->full_name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0) return root;
+        path[depth++] = link;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+    *link = bst_create(key, c);
+    while (depth > 0) {
+        BSTNode **l = path[--depth];
+        int old = (*l)->height;
+        *l = avl_rebalance(*l);
+        if ((*l)->height == old) break;
+    }
+    return root;
+}
+
+/* Επαναληπτική διαγραφή: με δύο παιδιά ο διάδοχος παίρνει τη θέση του κόμβου
+ * και ο σύνδεσμος &z->right της στοίβας γίνεται &s->right */
+BSTNode* avl_delete(BSTNode *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    BSTNode **path[AVL_MAX_DEPTH];
+    int depth = 0;
+    BSTNode **link = &root;
+    while (*link) {
+        int cmp = key_cmp(key, name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0) break;
+        path[depth++] = link;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+    BSTNode *z = *link;
+    if (!z) return root;
+    if (!z->left || !z->right) *link = z->left ? z->left : z->right;
+    else {
+        int zi = depth;
+        path[depth++] = link;
+        BSTNode **sl = &z->right;
+        while ((*sl)->left) { path[depth++] = sl; sl = &(*sl)->left; }
+        BSTNode *s = *sl;
+        *sl = s->right;
+        s->left = z->left; s->right = z->right; s->height = z->height;
+        *link = s;
+        if (depth > zi + 1) path[zi + 1] = &s->right;
+    }
+    node_free(bst_pool, &bst_mem, z, sizeof(BSTNode));
+    while (depth > 0) {
+        BSTNode **l = path[--depth];
+        int old = (*l)->height;
+        *l = avl_rebalance(*l);
+        if ((*l)->height == old) break;
+    }
+    return root;
+}
+
+/* Αναδρομικές εκδόσεις με Citizen by value - κρατιούνται για σύγκριση */
+static BSTNode* avl_insert_k(BSTNode *root, uint64_t key, Citizen data) {
+    if (!root) return bst_create(key, &data);
+    int cmp = key_cmp(key, data.full_name, root->key, root->data.full_name);
+    if (cmp < 0) root->left = avl_insert_k(root->left, key, data);
+    else if (cmp > 0) root->right = avl_insert_k(root->right, key, data);
     else return root;
 
     root->height = avl_max(avl_height(root->left), avl_height(root->right)) + 1;
     int bal = avl_balance(root);
 
-    if (bal > 1 && strcmp(data.full_name, root->left->data.full_name) < 0)
+    if (bal > 1 && key_cmp(key, data.full_name, root->left->key, root->left->data.full_name) < 0)
         return avl_rotate_right(root);
-    if (bal < -1 && strcmp(data.full_name, root->right->data.full_name) > 0)
+    if (bal < -1 && key_cmp(key, data.full_name, root->right->key, root->right->data.full_name) > 0)
         return avl_rotate_left(root);
-    if (bal > 1 && strcmp(data.full_name, root->left->data.full_name) > 0) {
+    if (bal > 1 && key_cmp(key, data.full_name, root->left->key, root->left->data.full_name) > 0) {
         root->left = avl_rotate_left(root->left);
         return avl_rotate_right(root);
     }
-    if (bal < -1 && strcmp(data.full_name, root->right->data.full_name) < 0) {
+    if (bal < -1 && key_cmp(key, data.full_name, root->right->key, root->right->data.full_name) < 0) {
         root->right = avl_rotate_right(root->right);
         return avl_rotate_left(root);
     }
     return root;
 }
 
-BSTNode* avl_delete(BSTNode *root, char *name) {
+BSTNode* avl_insert_rec(BSTNode *root, Citizen data) {
+    return avl_insert_k(root, key_prefix(data.full_name), data);
+}
+
+static BSTNode* avl_delete_k(BSTNode *root, uint64_t key, char *name) {
     if (!root) return NULL;
-    int cmp = strcmp(name, root->data.full_name);
-    if (cmp < 0) root->left = avl_delete(root->left, name);
-    else if (cmp > 0) root->right = avl_delete(root->right, name);
+    int cmp = key_cmp(key, name, root->key, root->data.full_name);
+    if (cmp < 0) root->left = avl_delete_k(root->left, key, name);
+    else if (cmp > 0) root->right = avl_delete_k(root->right, key, name);
     else {
         if (!root->left || !root->right) {
             BSTNode *t = root->left ? root->left : root->right;
             if (!t) { t = root; root = NULL; }
             else { *root = *t; }
-            free(t);
+            node_free(bst_pool, &bst_mem, t, sizeof(BSTNode));
         } else {
             BSTNode *s = bst_find_min(root->right);
+            root->key = s->key;
             root->data = s->data;
-            root->right = avl_delete(root->right, s->data.full_name);
+            root->right = avl_delete_k(root->right, s->key, s->data.full_name);
         }
     }
     if (!root) return NULL;
@@ -181,14 +510,19 @@ BSTNode* avl_delete(BSTNode *root, char *name) {
     return root;
 }
 
+BSTNode* avl_delete_rec(BSTNode *root, char *name) {
+    return avl_delete_k(root, key_prefix(name), name);
+}
+
 /* ============ Red-Black Συναρτήσεις ============ */
 
-static RBTNode RBT_NIL_NODE = {{""}, NULL, NULL, NULL, 0, 'B'};
+static RBTNode RBT_NIL_NODE = {.color = 'B'};
 static RBTNode *RBT_NIL = &RBT_NIL_NODE;
 
-RBTNode* rbt_create(Citizen data) {
-    RBTNode *n = (RBTNode*)malloc(sizeof(RBTNode));
-    n->data = data;
+RBTNode* rbt_create(const Citizen *c) {
+    RBTNode *n = (RBTNode*)node_alloc(rbt_pool, &rbt_mem, sizeof(RBTNode));
+    n->key = key_prefix(c->full_name);
+    n->data = *c;
     n->left = n->right = RBT_NIL;
     n->parent = RBT_NIL;
     n->height = 1;
@@ -248,28 +582,33 @@ RBTNode* rbt_insert_fixup(RBTNode *root, RBTNode *z) {
     return root;
 }
 
-RBTNode* rbt_insert(RBTNode *root, Citizen data) {
-    RBTNode *z = rbt_create(data);
+RBTNode* rbt_insert(RBTNode *root, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
     RBTNode *y = RBT_NIL, *x = root ? root : RBT_NIL;
+    int cmp = 0;
     while (x != RBT_NIL) {
         y = x;
-        int cmp = strcmp(data.full_name, x->data.full_name);
+        cmp = key_cmp(key, c->full_name, x->key, x->data.full_name);
         if (cmp < 0) x = x->left;
         else if (cmp > 0) x = x->right;
-        else { free(z); return root; }
+        else return root;
     }
+    RBTNode *z = rbt_create(c);
     z->parent = y;
     if (y == RBT_NIL) root = z;
-    else if (strcmp(data.full_name, y->data.full_name) < 0) y->left = z;
+    else if (cmp < 0) y->left = z;
     else y->right = z;
     return rbt_insert_fixup(root, z);
 }
 
+/* Ο φρουρός RBT_NIL είναι κοινός για όλα τα δέντρα και δεν γράφεται ποτέ: ο
+ * γονέας του x στο delete περνά χωριστά (xp), ώστε δέντρα που ανήκουν σε
+ * διαφορετικά νήματα να αλλάζουν ταυτόχρονα */
 RBTNode* rbt_transplant(RBTNode *root, RBTNode *u, RBTNode *v) {
     if (u->parent == RBT_NIL) root = v;
     else if (u == u->parent->left) u->parent->left = v;
     else u->parent->right = v;
-    v->parent = u->parent;
+    if (v != RBT_NIL) v->parent = u->parent;
     return root;
 }
 
@@ -278,245 +617,7385 @@ RBTNode* rbt_find_min(RBTNode *root) {
     return root;
 }
 
-RBTNode* rbt_delete_fixup(RBTNode *root, RBTNode *x) {
+RBTNode* rbt_delete_fixup(RBTNode *root, RBTNode *x, RBTNode *xp) {
     while (x != root && x->color == 'B') {
-        if (x == x->parent->left) {
-            RBTNode *w = x->parent->right;
+        if (x == xp->left) {
+            RBTNode *w = xp->right;
             if (w->color == 'R') {
-                w->color = 'B'; x->parent->color = 'R';
-                root = rbt_rotate_left(root, x->parent); w = x->parent->right;
+                w->color = 'B'; xp->color = 'R';
+                root = rbt_rotate_left(root, xp); w = xp->right;
             }
             if (w->left->color == 'B' && w->right->color == 'B') {
-                w->color = 'R'; x = x->parent;
+                w->color = 'R'; x = xp; xp = x->parent;
             } else {
                 if (w->right->color == 'B') {
                     w->left->color = 'B'; w->color = 'R';
-                    root = rbt_rotate_right(root, w); w = x->parent->right;
+                    root = rbt_rotate_right(root, w); w = xp->right;
                 }
-                w->color = x->parent->color; x->parent->color = 'B';
-                w->right->color = 'B'; root = rbt_rotate_left(root, x->parent);
+                w->color = xp->color; xp->color = 'B';
+                w->right->color = 'B'; root = rbt_rotate_left(root, xp);
                 x = root;
             }
         } else {
-            RBTNode *w = x->parent->left;
+            RBTNode *w = xp->left;
             if (w->color == 'R') {
-                w->color = 'B'; x->parent->color = 'R';
-                root = rbt_rotate_right(root, x->parent); w = x->parent->left;
+                w->color = 'B'; xp->color = 'R';
+                root = rbt_rotate_right(root, xp); w = xp->left;
             }
             if (w->right->color == 'B' && w->left->color == 'B') {
-                w->color = 'R'; x = x->parent;
+                w->color = 'R'; x = xp; xp = x->parent;
             } else {
                 if (w->left->color == 'B') {
                     w->right->color = 'B'; w->color = 'R';
-                    root = rbt_rotate_left(root, w); w = x->parent->left;
+                    root = rbt_rotate_left(root, w); w = xp->left;
                 }
-                w->color = x->parent->color; x->parent->color = 'B';
-                w->left->color = 'B'; root = rbt_rotate_right(root, x->parent);
+                w->color = xp->color; xp->color = 'B';
+                w->left->color = 'B'; root = rbt_rotate_right(root, xp);
                 x = root;
             }
         }
     }
-    x->color = 'B';
+    if (x != RBT_NIL) x->color = 'B';
     return root;
 }
 
-RBTNode* rbt_delete(RBTNode *root, char *name) {
+RBTNode* rbt_delete(RBTNode *root, const char *name) {
+    uint64_t key = key_prefix(name);
     RBTNode *z = root ? root : RBT_NIL;
     while (z != RBT_NIL) {
-        int cmp = strcmp(name, z->data.full_name);
+        int cmp = key_cmp(key, name, z->key, z->data.full_name);
         if (cmp == 0) break;
         z = (cmp < 0) ? z->left : z->right;
     }
     if (z == RBT_NIL) return root;
 
-    RBTNode *y = z, *x;
+    RBTNode *y = z, *x, *xp = z->parent;
     char orig = y->color;
     if (z->left == RBT_NIL) { x = z->right; root = rbt_transplant(root, z, z->right); }
     else if (z->right == RBT_NIL) { x = z->left; root = rbt_transplant(root, z, z->left); }
     else {
         y = rbt_find_min(z->right); orig = y->color; x = y->right;
-        if (y->parent == z) { x->parent = y; }
-        else { root = rbt_transplant(root, y, y->right); y->right = z->right; y->right->parent = y; }
+        if (y->parent == z) xp = y;
+        else { xp = y->parent; root = rbt_transplant(root, y, y->right); y->right = z->right; y->right->parent = y; }
         root = rbt_transplant(root, z, y); y->left = z->left; y->left->parent = y; y->color = z->color;
     }
-    free(z);
-    if (orig == 'B') root = rbt_delete_fixup(root, x);
+    node_free(rbt_pool, &rbt_mem, z, sizeof(RBTNode));
+    if (orig == 'B') root = rbt_delete_fixup(root, x, xp);
     return root;
 }
 
-RBTNode* rbt_search(RBTNode *root, char *name) {
-    if (!root || root == RBT_NIL) return NULL;
-    int cmp = strcmp(name, root->data.full_name);
-    if (cmp == 0) return root;
-    return (cmp < 0) ? rbt_search(root->left, name) : rbt_search(root->right, name);
+RBTNode* rbt_search(RBTNode *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    while (root && root != RBT_NIL) {
+        int cmp = key_cmp(key, name, root->key, root->data.full_name);
+        if (cmp == 0) return root;
+        root = (cmp < 0) ? root->left : root->right;
+    }
+    return NULL;
 }
 
+/* Όπως το bst_free (οι δείκτες γονέα δεν ενημερώνονται) */
 void rbt_free(RBTNode *root) {
-    if (!root || root == RBT_NIL) return;
-    rbt_free(root->left);
-    rbt_free(root->right);
-    free(root);
+    while (root && root != RBT_NIL) {
+        RBTNode *next = root->left;
+        if (next && next != RBT_NIL) { root->left = next->right; next->right = root; }
+        else { next = root->right; node_free(rbt_pool, &rbt_mem, root, sizeof(RBTNode)); }
+        root = next;
+    }
 }
 
-/* ============ Φόρτωση Δεδομένων ============ */
+/* ============ Μαζική Κατασκευή ============ */
 
-#define MAX_CITIZENS 1000
+/* Κατασκευή ολόκληρου δέντρου από πίνακα πολιτών σε O(n) μετά την ταξινόμηση.
+ * Ο πίνακας ταξινομείται (ή ανιχνεύεται ότι είναι ήδη ταξινομημένος) και από
+ * κάθε ομάδα ίδιων ονομάτων κρατείται η πρώτη εμφάνιση, όπως κάνει και το
+ * insert που αγνοεί τα διπλότυπα. Η ρίζα κάθε υποδέντρου είναι το μεσαίο
+ * στοιχείο, οπότε τα μεγέθη αδελφών υποδέντρων διαφέρουν το πολύ κατά 1. */
 
-/* Ανάγνωση εγγραφών πολιτών από citizens.txt */
-int load_citizens(Citizen citizens[], int max) {
-    FILE *fp = fopen("citizens.txt", "r");
-    if (!fp) { printf("Σφάλμα: δεν ανοίγει το citizens.txt\n"); return 0; }
-    int count = 0;
-    char line[256];
-    while (count < max && fgets(line, sizeof(line), fp)) {
-        line[strcspn(line, "\r\n")] = '\0';
-        /* Ανάλυση γραμμής: όνομα,ηλικία,πολιτεία,εισόδημα */
-        char *token = strtok(line, ",");
-        if (!token) continue;
-        strncpy(citizens[count].full_name, token, 99);
-        token = strtok(NULL, ",");
-        if (token) citizens[count].age = atoi(token);
-        token = strtok(NULL, ",");
-        if (token) strncpy(citizens[count].state, token, 49);
-        token = strtok(NULL, ",");
-        if (token) citizens[count].annual_income = atoi(token);
-        count++;
+typedef struct {
+    uint64_t key;
+    Citizen *c;
+} BulkItem;
+
+/* Αλφαβητική σειρά και, για ίδια ονόματα, σειρά εμφάνισης στον πίνακα */
+static int bulk_item_cmp(const void *a, const void *b) {
+    const BulkItem *x = (const BulkItem*)a, *y = (const BulkItem*)b;
+    int cmp = key_cmp(x->key, x->c->full_name, y->key, y->c->full_name);
+    if (cmp) return cmp;
+    return (x->c > y->c) - (x->c < y->c);
+}
+
+/* Σταθερή LSD radix sort στα 8-byte προθέματα (8 περάσματα των 256 κάδων,
+ * όσα byte είναι ίδια σε όλα τα στοιχεία παραλείπονται). Μόνο οι ομάδες ίσων
+ * προθεμάτων χρειάζονται strcmp: οι μικρές με insertion sort, που είναι
+ * σταθερή, οι μεγάλες με qsort και τη σειρά εμφάνισης ως δεύτερο κριτήριο. */
+static void bulk_sort(BulkItem *v, int n) {
+    BulkItem *tmp = (BulkItem*)malloc(n * sizeof(BulkItem));
+    for (int shift = 0; shift < 64; shift += 8) {
+        int cnt[256] = {0};
+        for (int i = 0; i < n; i++) cnt[(v[i].key >> shift) & 0xFF]++;
+        if (cnt[(v[0].key >> shift) & 0xFF] == n) continue;
+        for (int b = 0, sum = 0; b < 256; b++) { int c = cnt[b]; cnt[b] = sum; sum += c; }
+        for (int i = 0; i < n; i++) tmp[cnt[(v[i].key >> shift) & 0xFF]++] = v[i];
+        memcpy(v, tmp, n * sizeof(BulkItem));
+    }
+    free(tmp);
+    for (int lo = 0, hi; lo < n; lo = hi) {
+        for (hi = lo + 1; hi < n && v[hi].key == v[lo].key; hi++);
+        if (hi - lo < 2 || (v[lo].key & 0xFF) == 0) continue;
+        if (hi - lo > 16) { qsort(v + lo, hi - lo, sizeof(BulkItem), bulk_item_cmp); continue; }
+        for (int i = lo + 1; i < hi; i++) {
+            BulkItem x = v[i];
+            int j = i;
+            for (; j > lo && strcmp(v[j - 1].c->full_name + 8, x.c->full_name + 8) > 0; j--) v[j] = v[j - 1];
+            v[j] = x;
+        }
     }
-    fclose(fp);
-    return count;
 }
 
-/* ============ Κύριο Πρόγραμμα Benchmark ============ */
+/* Στοιχεία με τα προθέματα στη σειρά του πίνακα - 1 στο *sorted αν είναι
+ * ήδη ταξινομημένα */
+static BulkItem* bulk_items(Citizen citizens[], int count, int *sorted) {
+    BulkItem *v = (BulkItem*)malloc((count ? count : 1) * sizeof(BulkItem));
+    *sorted = 1;
+    for (int i = 0; i < count; i++) {
+        v[i].key = key_prefix(citizens[i].full_name);
+        v[i].c = &citizens[i];
+        if (i > 0 && *sorted && key_cmp(v[i - 1].key, v[i - 1].c->full_name, v[i].key, v[i].c->full_name) > 0)
+            *sorted = 0;
+    }
+    return v;
+}
 
-#define RUNS 5
-#define SEARCH_DELETE_COUNT 100
+/* Κρατά την πρώτη εμφάνιση κάθε ονόματος σε ταξινομημένο πίνακα */
+static int bulk_unique(BulkItem *v, int count) {
+    int m = 0;
+    for (int i = 0; i < count; i++)
+        if (m == 0 || key_cmp(v[m - 1].key, v[m - 1].c->full_name, v[i].key, v[i].c->full_name) != 0)
+            v[m++] = v[i];
+    return m;
+}
 
-int main(void) {
-    Citizen citizens[MAX_CITIZENS];
-    int count = load_citizens(citizens, MAX_CITIZENS);
-    if (count == 0) return 1;
-    printf("Φορτώθηκαν %d εγγραφές πολιτών\n\n", count);
+/* Ταξινομημένα μοναδικά στοιχεία στο *out, επιστρέφει το πλήθος τους */
+int bulk_prepare(Citizen citizens[], int count, BulkItem **out) {
+    int sorted;
+    BulkItem *v = bulk_items(citizens, count, &sorted);
+    if (!sorted) bulk_sort(v, count);
+    *out = v;
+    return bulk_unique(v, count);
+}
 
-    /* Μεταβλητές χρόνου */
-    double bst_insert_time = 0, bst_search_time = 0, bst_delete_time = 0;
-    double avl_insert_time = 0, avl_search_time = 0, avl_delete_time = 0;
-    double rbt_insert_time = 0, rbt_search_time = 0, rbt_delete_time = 0;
+static BSTNode* bst_build_range(BulkItem *v, int lo, int hi) {
+    if (lo > hi) return NULL;
+    int mid = lo + (hi - lo) / 2;
+    BSTNode *n = bst_create(v[mid].key, v[mid].c);
+    n->left = bst_build_range(v, lo, mid - 1);
+    n->right = bst_build_range(v, mid + 1, hi);
+    n->height = avl_max(avl_height(n->left), avl_height(n->right)) + 1;
+    return n;
+}
 
-    srand((unsigned int)time(NULL));
+/* Το ισοζυγισμένο BST είναι και έγκυρο AVL με σωστά ύψη */
+BSTNode* bst_bulk_build(Citizen citizens[], int count) {
+    BulkItem *v;
+    int m = bulk_prepare(citizens, count, &v);
+    BSTNode *root = bst_build_range(v, 0, m - 1);
+    free(v);
+    return root;
+}
 
-    /* Επιλογή 100 τυχαίων ονομάτων για search και delete */
-    int indices[SEARCH_DELETE_COUNT];
-    for (int i = 0; i < SEARCH_DELETE_COUNT; i++)
-        indices[i] = rand() % count;
+BSTNode* avl_bulk_build(Citizen citizens[], int count) {
+    return bst_bulk_build(citizens, count);
+}
 
-    /* Εκτέλεση 5 επαναλήψεων */
-    for (int run = 0; run < RUNS; run++) {
-        double start, end;
-        BSTNode *bst_root = NULL;
-        BSTNode *avl_root = NULL;
-        RBTNode *rbt_root = NULL;
+/* Όλα τα φύλλα βρίσκονται στα δύο τελευταία επίπεδα. Οι κόμβοι του βαθύτερου
+ * επιπέδου (red_depth) χρωματίζονται κόκκινοι και οι υπόλοιποι μαύροι, οπότε
+ * κάθε μονοπάτι προς NIL περνά από τον ίδιο αριθμό μαύρων κόμβων. */
+static RBTNode* rbt_build_range(BulkItem *v, int lo, int hi, int depth, int red_depth, RBTNode *parent) {
+    if (lo > hi) return RBT_NIL;
+    int mid = lo + (hi - lo) / 2;
+    RBTNode *n = rbt_create(v[mid].c);
+    n->parent = parent;
+    n->color = (depth == red_depth) ? 'R' : 'B';
+    n->left = rbt_build_range(v, lo, mid - 1, depth + 1, red_depth, n);
+    n->right = rbt_build_range(v, mid + 1, hi, depth + 1, red_depth, n);
+    n->height = avl_max(n->left->height, n->right->height) + 1;
+    return n;
+}
 
-        printf("Επανάληψη %d/%d...\n", run + 1, RUNS);
+RBTNode* rbt_bulk_build(Citizen citizens[], int count) {
+    BulkItem *v;
+    int m = bulk_prepare(citizens, count, &v);
+    int height = 0;
+    while (((1LL << height) - 1) < m) height++;
+    /* Η ρίζα (βάθος 0) μένει πάντα μαύρη */
+    RBTNode *root = rbt_build_range(v, 0, m - 1, 0, height > 1 ? height - 1 : -1, RBT_NIL);
+    free(v);
+    return m ? root : NULL;
+}
 
-        /* --- BST Insert --- */
-        start = get_time_us();
-        for (int i = 0; i < count; i++)
-            bst_root = bst_insert(bst_root, citizens[i]);
-        end = get_time_us();
-        bst_insert_time += (end - start);
+/* ============ Παράλληλη Κατασκευή ============ */
 
-        /* --- AVL Insert --- */
-        start = get_time_us();
-        for (int i = 0; i < count; i++)
-            avl_root = avl_insert(avl_root, citizens[i]);
-        end = get_time_us();
-        avl_insert_time += (end - start);
+/* Ίδιο αποτέλεσμα με τη μαζική κατασκευή, σε πολλά νήματα: παράλληλη
+ * mergesort των στοιχείων (radix sort στα φύλλα, παράλληλη συγχώνευση με
+ * διαίρεση στη μέση και δυαδική αναζήτηση) και μετά fork-join κατασκευή: κάθε
+ * κόμβος φτιάχνει το αριστερό υποδέντρο ως εργασία που μπορεί να κλέψει άλλο
+ * νήμα και το δεξί μόνος του.
+ *
+ * Work stealing: κάθε νήμα έχει deque εργασιών, βάζει και παίρνει τις δικές
+ * του από το τέλος (LIFO, ζεστή cache) και όταν αδειάσει κλέβει από την αρχή
+ * τυχαίου άλλου νήματος (τις παλαιότερες, άρα τις μεγαλύτερες εργασίες). Όποιος
+ * περιμένει εργασία (ws_join) εκτελεί στο μεταξύ άλλες. Το νήμα που καλεί
+ * είναι η θέση 0 και η δεξαμενή έχει threads - 1 επιπλέον νήματα. */
+#define WS_MAX_THREADS 64
+#define PAR_CUTOFF 4096             /* στοιχεία κάτω από τα οποία η δουλειά γίνεται σειριακά */
 
-        /* --- RBT Insert --- */
-        start = get_time_us();
-        for (int i = 0; i < count; i++)
-            rbt_root = rbt_insert(rbt_root, citizens[i]);
-        end = get_time_us();
-        rbt_insert_time += (end - start);
+typedef struct WsTask {
+    void (*run)(struct WsTask *t);
+    int done;
+} WsTask;
 
-        /* --- BST Search --- */
-        start = get_time_us();
-        for (int i = 0; i < SEARCH_DELETE_COUNT; i++)
-            bst_search(bst_root, citizens[indices[i]].full_name);
-        end = get_time_us();
-        bst_search_time += (end - start);
+struct WsPool;
 
-        /* --- AVL Search --- */
-        start = get_time_us();
-        for (int i = 0; i < SEARCH_DELETE_COUNT; i++)
-            bst_search(avl_root, citizens[indices[i]].full_name);
-        end = get_time_us();
-        avl_search_time += (end - start);
+typedef struct {
+    pthread_mutex_t lock;
+    WsTask **buf;
+    int head, tail, cap;            /* κλοπή από το head, ο κάτοχος στο tail */
+    struct WsPool *pool;
+    char pad[64];
+} WsDeque;
 
-        /* --- RBT Search --- */
-        start = get_time_us();
-        for (int i = 0; i < SEARCH_DELETE_COUNT; i++)
-            rbt_search(rbt_root, citizens[indices[i]].full_name);
-        end = get_time_us();
-        rbt_search_time += (end - start);
+typedef struct WsPool {
+    int threads;
+    int stop;
+    WsDeque dq[WS_MAX_THREADS];
+    pthread_t th[WS_MAX_THREADS];
+} WsPool;
 
-        /* --- BST Delete --- */
-        start = get_time_us();
-        for (int i = 0; i < SEARCH_DELETE_COUNT; i++)
-            bst_root = bst_delete(bst_root, citizens[indices[i]].full_name);
-        end = get_time_us();
-        bst_delete_time += (end - start);
+static __thread int ws_self = 0;                /* θέση deque του νήματος */
+static __thread uint64_t ws_rng = 0;
 
-        /* --- AVL Delete --- */
-        start = get_time_us();
-        for (int i = 0; i < SEARCH_DELETE_COUNT; i++)
-            avl_root = avl_delete(avl_root, citizens[indices[i]].full_name);
-        end = get_time_us();
-        avl_delete_time += (end - start);
+static void ws_push(WsDeque *d, WsTask *t) {
+    pthread_mutex_lock(&d->lock);
+    if (d->tail == d->cap) {
+        if (d->head > 0) {
+            memmove(d->buf, d->buf + d->head, (d->tail - d->head) * sizeof(WsTask*));
+            d->tail -= d->head;
+            d->head = 0;
+        } else {
+            d->cap = d->cap ? d->cap * 2 : 64;
+            d->buf = (WsTask**)realloc(d->buf, d->cap * sizeof(WsTask*));
+        }
+    }
+    d->buf[d->tail++] = t;
+    pthread_mutex_unlock(&d->lock);
+}
 
-        /* --- RBT Delete --- */
-        start = get_time_us();
-        for (int i = 0; i < SEARCH_DELETE_COUNT; i++)
-            rbt_root = rbt_delete(rbt_root, citizens[indices[i]].full_name);
-        end = get_time_us();
-        rbt_delete_time += (end - start);
+static WsTask* ws_take(WsDeque *d, int steal) {
+    pthread_mutex_lock(&d->lock);
+    WsTask *t = NULL;
+    if (d->tail > d->head) t = steal ? d->buf[d->head++] : d->buf[--d->tail];
+    if (d->head == d->tail) d->head = d->tail = 0;
+    pthread_mutex_unlock(&d->lock);
+    return t;
+}
 
-        /* Απελευθέρωση μνήμης */
-        bst_free(bst_root);
-        bst_free(avl_root);
-        rbt_free(rbt_root);
+/* Πρώτα η δική μας deque, μετά ένας γύρος κλοπής από τυχαία θύματα */
+static WsTask* ws_find(WsPool *p) {
+    WsTask *t = ws_take(&p->dq[ws_self], 0);
+    if (!ws_rng) ws_rng = 0x9E3779B97F4A7C15ULL * (ws_self + 1);
+    for (int k = 0; !t && k < 2 * p->threads; k++) {
+        ws_rng ^= ws_rng << 13; ws_rng ^= ws_rng >> 7; ws_rng ^= ws_rng << 17;
+        int victim = (int)(ws_rng % (uint64_t)p->threads);
+        if (victim != ws_self) t = ws_take(&p->dq[victim], 1);
     }
+    return t;
+}
 
-    /* Υπολογισμός μέσου όρου (ήδη σε microseconds) */
-    bst_insert_time /= RUNS; bst_search_time /= RUNS; bst_delete_time /= RUNS;
-    avl_insert_time /= RUNS; avl_search_time /= RUNS; avl_delete_time /= RUNS;
-    rbt_insert_time /= RUNS; rbt_search_time /= RUNS; rbt_delete_time /= RUNS;
+static void ws_exec(WsTask *t) {
+    t->run(t);
+    __atomic_store_n(&t->done, 1, __ATOMIC_RELEASE);
+}
 
-    /* Εκτύπωση αποτελεσμάτων */
-    printf("\n========================================\n");
-    printf("       ΑΠΟΤΕΛΕΣΜΑΤΑ BENCHMARK\n");
-    printf("   (Μέσος όρος %d επαναλήψεων)\n", RUNS);
-    printf("========================================\n");
-    printf("%-12s %12s %12s %12s\n", "Operation", "BST (us)", "AVL (us)", "RBT (us)");
-    printf("----------------------------------------\n");
-    printf("%-12s %12.2f %12.2f %12.2f\n", "Insert", bst_insert_time, avl_insert_time, rbt_insert_time);
-    printf("%-12s %12.2f %12.2f %12.2f\n", "Search", bst_search_time, avl_search_time, rbt_search_time);
-    printf("%-12s %12.2f %12.2f %12.2f\n", "Delete", bst_delete_time, avl_delete_time, rbt_delete_time);
-    printf("========================================\n");
+static void* ws_worker(void *arg) {
+    WsDeque *d = (WsDeque*)arg;
+    WsPool *p = d->pool;
+    ws_self = (int)(d - p->dq);
+    int idle = 0;
+    while (!__atomic_load_n(&p->stop, __ATOMIC_ACQUIRE)) {
+        WsTask *t = ws_find(p);
+        if (t) { ws_exec(t); idle = 0; }
+        else if (++idle < 64) sched_yield();
+        else usleep(50);
+    }
+    return NULL;
+}
 
-    /* Εγγραφή αποτελεσμάτων σε results.txt */
-    FILE *fp = fopen("results.txt", "w");
-    if (fp) {
-        fprintf(fp, "Benchmark Results (Average of %d runs)\n", RUNS);
-        fprintf(fp, "Insert: %d records | Search: %d names | Delete: %d names\n\n", count, SEARCH_DELETE_COUNT, SEARCH_DELETE_COUNT);
-        fprintf(fp, "%-12s %12s %12s %12s\n", "Operation", "BST (us)", "AVL (us)", "RBT (us)");
-        fprintf(fp, "----------------------------------------------------\n");
-        fprintf(fp, "%-12s %12.2f %12.2f %12.2f\n", "Insert", bst_insert_time, avl_insert_time, rbt_insert_time);
-        fprintf(fp, "%-12s %12.2f %12.2f %12.2f\n", "Search", bst_search_time, avl_search_time, rbt_search_time);
-        fprintf(fp, "%-12s %12.2f %12.2f %12.2f\n", "Delete", bst_delete_time, avl_delete_time, rbt_delete_time);
+WsPool* ws_create(int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > WS_MAX_THREADS) threads = WS_MAX_THREADS;
+    WsPool *p = (WsPool*)calloc(1, sizeof(WsPool));
+    p->threads = threads;
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_init(&p->dq[i].lock, NULL);
+        p->dq[i].pool = p;
+    }
+    for (int i = 1; i < threads; i++) pthread_create(&p->th[i], NULL, ws_worker, &p->dq[i]);
+    return p;
+}
+
+void ws_destroy(WsPool *p) {
+    __atomic_store_n(&p->stop, 1, __ATOMIC_RELEASE);
+    for (int i = 1; i < p->threads; i++) pthread_join(p->th[i], NULL);
+    for (int i = 0; i < p->threads; i++) {
+        free(p->dq[i].buf);
+        pthread_mutex_destroy(&p->dq[i].lock);
+    }
+    free(p);
+}
+
+/* Η t μπορεί να εκτελεστεί από οποιοδήποτε νήμα ως το ws_join */
+static void ws_spawn(WsPool *p, WsTask *t) {
+    t->done = 0;
+    ws_push(&p->dq[ws_self], t);
+}
+
+static void ws_join(WsPool *p, WsTask *t) {
+    while (!__atomic_load_n(&t->done, __ATOMIC_ACQUIRE)) {
+        WsTask *o = ws_find(p);
+        if (o) ws_exec(o);
+        else sched_yield();
+    }
+}
+
+/* Συγχώνευση a και b στο out. Η bulk_item_cmp είναι ολική διάταξη (για ίδια
+ * ονόματα αποφασίζει η θέση στον πίνακα), οπότε το αποτέλεσμα είναι σταθερό
+ * με όποια σειρά κι αν μοιραστούν τα κομμάτια. */
+typedef struct {
+    WsTask task;
+    WsPool *pool;
+    const BulkItem *a, *b;
+    int na, nb;
+    BulkItem *out;
+} MergeTask;
+
+static void par_merge_run(WsTask *t) {
+    MergeTask *m = (MergeTask*)t;
+    const BulkItem *a = m->a, *b = m->b;
+    int na = m->na, nb = m->nb;
+    if (na + nb <= PAR_CUTOFF) {
+        int i = 0, j = 0, k = 0;
+        while (i < na && j < nb) m->out[k++] = bulk_item_cmp(&a[i], &b[j]) < 0 ? a[i++] : b[j++];
+        while (i < na) m->out[k++] = a[i++];
+        while (j < nb) m->out[k++] = b[j++];
+        return;
+    }
+    if (na < nb) { const BulkItem *x = a; a = b; b = x; int n = na; na = nb; nb = n; }
+    int ma = na / 2, lo = 0, hi = nb;
+    while (lo < hi) {                       /* πρώτο b[j] μετά το a[ma] */
+        int mid = lo + (hi - lo) / 2;
+        if (bulk_item_cmp(&b[mid], &a[ma]) < 0) lo = mid + 1; else hi = mid;
+    }
+    m->out[ma + lo] = a[ma];
+    MergeTask left = {{par_merge_run, 0}, m->pool, a, b, ma, lo, m->out};
+    MergeTask right = {{par_merge_run, 0}, m->pool, a + ma + 1, b + lo, na - ma - 1, nb - lo, m->out + ma + lo + 1};
+    ws_spawn(m->pool, &left.task);
+    par_merge_run(&right.task);
+    ws_join(m->pool, &left.task);
+}
+
+/* Ταξινόμηση του src - το αποτέλεσμα στο dst αν to_dst, αλλιώς στο src */
+typedef struct {
+    WsTask task;
+    WsPool *pool;
+    BulkItem *src, *dst;
+    int n, to_dst;
+} SortTask;
+
+static void par_sort_run(WsTask *t) {
+    SortTask *s = (SortTask*)t;
+    if (s->n <= PAR_CUTOFF) {
+        bulk_sort(s->src, s->n);
+        if (s->to_dst) memcpy(s->dst, s->src, s->n * sizeof(BulkItem));
+        return;
+    }
+    int h = s->n / 2;
+    /* Τα μισά ταξινομούνται στον άλλο πίνακα και συγχωνεύονται στον ζητούμενο */
+    SortTask left = {{par_sort_run, 0}, s->pool, s->src, s->dst, h, !s->to_dst};
+    SortTask right = {{par_sort_run, 0}, s->pool, s->src + h, s->dst + h, s->n - h, !s->to_dst};
+    ws_spawn(s->pool, &left.task);
+    par_sort_run(&right.task);
+    ws_join(s->pool, &left.task);
+    BulkItem *from = s->to_dst ? s->src : s->dst, *into = s->to_dst ? s->dst : s->src;
+    MergeTask m = {{par_merge_run, 0}, s->pool, from, from + h, h, s->n - h, into};
+    par_merge_run(&m.task);
+}
+
+/* Όπως η bulk_prepare, με παράλληλη ταξινόμηση */
+int bulk_prepare_parallel(WsPool *p, Citizen citizens[], int count, BulkItem **out) {
+    int sorted;
+    BulkItem *v = bulk_items(citizens, count, &sorted);
+    if (!sorted && count > 1) {
+        BulkItem *tmp = (BulkItem*)malloc(count * sizeof(BulkItem));
+        SortTask root = {{par_sort_run, 0}, p, v, tmp, count, 0};
+        ws_self = 0;
+        par_sort_run(&root.task);
+        free(tmp);
+    }
+    *out = v;
+    return bulk_unique(v, count);
+}
+
+/* Οι κόμβοι δεσμεύονται με malloc από κάθε νήμα (η arena δεν είναι ασφαλής
+ * για πολλά νήματα) και η λογιστική μνήμης ενημερώνεται μία φορά στο τέλος */
+static void par_account(MemStats *m, size_t nodes, size_t size) {
+    m->live_nodes += nodes;
+    m->live_bytes += nodes * size;
+    if (m->live_bytes > m->peak_bytes) m->peak_bytes = m->live_bytes;
+}
+
+typedef struct {
+    WsTask task;
+    WsPool *pool;
+    BulkItem *v;
+    int lo, hi, depth, red_depth;
+    RBTNode *parent;                /* μόνο για RBT */
+    void *root;
+} BuildTask;
+
+static BSTNode* par_bst_range(BulkItem *v, int lo, int hi) {
+    if (lo > hi) return NULL;
+    int mid = lo + (hi - lo) / 2;
+    BSTNode *n = (BSTNode*)malloc(sizeof(BSTNode));
+    n->key = v[mid].key;
+    n->data = *v[mid].c;
+    n->left = par_bst_range(v, lo, mid - 1);
+    n->right = par_bst_range(v, mid + 1, hi);
+    n->height = avl_max(avl_height(n->left), avl_height(n->right)) + 1;
+    return n;
+}
+
+static void par_bst_run(WsTask *t) {
+    BuildTask *b = (BuildTask*)t;
+    if (b->hi - b->lo < PAR_CUTOFF) { b->root = par_bst_range(b->v, b->lo, b->hi); return; }
+    int mid = b->lo + (b->hi - b->lo) / 2;
+    BSTNode *n = (BSTNode*)malloc(sizeof(BSTNode));
+    n->key = b->v[mid].key;
+    n->data = *b->v[mid].c;
+    BuildTask left = {{par_bst_run, 0}, b->pool, b->v, b->lo, mid - 1, 0, 0, NULL, NULL};
+    BuildTask right = {{par_bst_run, 0}, b->pool, b->v, mid + 1, b->hi, 0, 0, NULL, NULL};
+    ws_spawn(b->pool, &left.task);
+    par_bst_run(&right.task);
+    ws_join(b->pool, &left.task);
+    n->left = (BSTNode*)left.root;
+    n->right = (BSTNode*)right.root;
+    n->height = avl_max(avl_height(n->left), avl_height(n->right)) + 1;
+    b->root = n;
+}
+
+/* Χρωματισμός όπως στη rbt_build_range */
+static RBTNode* par_rbt_range(BulkItem *v, int lo, int hi, int depth, int red_depth, RBTNode *parent) {
+    if (lo > hi) return RBT_NIL;
+    int mid = lo + (hi - lo) / 2;
+    RBTNode *n = (RBTNode*)malloc(sizeof(RBTNode));
+    n->key = v[mid].key;
+    n->data = *v[mid].c;
+    n->parent = parent;
+    n->color = (depth == red_depth) ? 'R' : 'B';
+    n->left = par_rbt_range(v, lo, mid - 1, depth + 1, red_depth, n);
+    n->right = par_rbt_range(v, mid + 1, hi, depth + 1, red_depth, n);
+    n->height = avl_max(n->left->height, n->right->height) + 1;
+    return n;
+}
+
+static void par_rbt_run(WsTask *t) {
+    BuildTask *b = (BuildTask*)t;
+    if (b->hi - b->lo < PAR_CUTOFF) {
+        b->root = par_rbt_range(b->v, b->lo, b->hi, b->depth, b->red_depth, b->parent);
+        return;
+    }
+    int mid = b->lo + (b->hi - b->lo) / 2;
+    RBTNode *n = (RBTNode*)malloc(sizeof(RBTNode));
+    n->key = b->v[mid].key;
+    n->data = *b->v[mid].c;
+    n->parent = b->parent;
+    n->color = (b->depth == b->red_depth) ? 'R' : 'B';
+    BuildTask left = {{par_rbt_run, 0}, b->pool, b->v, b->lo, mid - 1, b->depth + 1, b->red_depth, n, NULL};
+    BuildTask right = {{par_rbt_run, 0}, b->pool, b->v, mid + 1, b->hi, b->depth + 1, b->red_depth, n, NULL};
+    ws_spawn(b->pool, &left.task);
+    par_rbt_run(&right.task);
+    ws_join(b->pool, &left.task);
+    n->left = (RBTNode*)left.root;
+    n->right = (RBTNode*)right.root;
+    n->height = avl_max(n->left->height, n->right->height) + 1;
+    b->root = n;
+}
+
+/* Με ενεργή arena (bst_pool/rbt_pool) γίνεται η σειριακή μαζική κατασκευή */
+BSTNode* avl_parallel_build(WsPool *p, Citizen citizens[], int count) {
+    if (bst_pool) return avl_bulk_build(citizens, count);
+    BulkItem *v;
+    int m = bulk_prepare_parallel(p, citizens, count, &v);
+    BuildTask root = {{par_bst_run, 0}, p, v, 0, m - 1, 0, 0, NULL, NULL};
+    par_bst_run(&root.task);
+    free(v);
+    par_account(&bst_mem, m, sizeof(BSTNode));
+    return (BSTNode*)root.root;
+}
+
+RBTNode* rbt_parallel_build(WsPool *p, Citizen citizens[], int count) {
+    if (rbt_pool) return rbt_bulk_build(citizens, count);
+    BulkItem *v;
+    int m = bulk_prepare_parallel(p, citizens, count, &v);
+    int height = 0;
+    while (((1LL << height) - 1) < m) height++;
+    BuildTask root = {{par_rbt_run, 0}, p, v, 0, m - 1, 0, height > 1 ? height - 1 : -1, RBT_NIL, NULL};
+    par_rbt_run(&root.task);
+    free(v);
+    par_account(&rbt_mem, m, sizeof(RBTNode));
+    return m ? (RBTNode*)root.root : NULL;
+}
+
+/* ============ Συμπαγείς Κόμβοι (32-bit θέσεις) ============ */
+
+/* Εναλλακτική διάταξη με τα μισά μεταδεδομένα ανά κόμβο: οι σύνδεσμοι είναι
+ * 32-bit θέσεις σε έναν πίνακα κόμβων (IndexPool) αντί για 64-bit pointers,
+ * το χρώμα του RBT είναι το πάνω bit της θέσης του γονέα (tag bit) και το AVL
+ * κρατά balance factor 2 bits στα πάνω bits του αριστερού παιδιού αντί για
+ * int ύψος. Η θέση 0 παίζει τον ρόλο του NULL και του μαύρου NIL του RBT.
+ * Ο πίνακας μεγαλώνει με realloc, οπότε δείκτες σε κόμβους δεν κρατιούνται
+ * πέρα από μια δέσμευση. */
+
+#define IPOOL_MAX_NODES (1u << 30)     /* 30 bits θέσης στο AVL */
+#define IPOOL_FULL UINT32_MAX           /* c*_insert: δεν χωρά άλλος κόμβος */
+
+typedef struct {
+    char *base;
+    size_t node_size;
+    uint32_t n, cap;        /* θέσεις σε χρήση (μαζί με τη 0) και χωρητικότητα */
+    uint32_t free_head;     /* αλυσίδα ελεύθερων θέσεων, 0 = κενή */
+} IndexPool;
+
+void ipool_init(IndexPool *p, size_t node_size) {
+    p->node_size = node_size;
+    p->cap = 1024;
+    p->base = (char*)calloc(p->cap, node_size);
+    p->n = 1;
+    p->free_head = 0;
+}
+
+/* Νέα θέση ή 0 (η θέση NULL) αν ο πίνακας έφτασε τις IPOOL_MAX_NODES θέσεις
+ * ή αποτύχει η realloc - ο πίνακας μένει τότε ως είχε */
+uint32_t ipool_alloc(IndexPool *p) {
+    if (p->free_head) {
+        uint32_t i = p->free_head;
+        memcpy(&p->free_head, p->base + (size_t)i * p->node_size, sizeof(uint32_t));
+        return i;
+    }
+    if (p->n == p->cap) {
+        if (p->cap >= IPOOL_MAX_NODES) return 0;
+        char *base = (char*)realloc(p->base, (size_t)p->cap * 2 * p->node_size);
+        if (!base) return 0;
+        p->base = base;
+        p->cap *= 2;
+    }
+    return p->n++;
+}
+
+void ipool_free(IndexPool *p, uint32_t i) {
+    memcpy(p->base + (size_t)i * p->node_size, &p->free_head, sizeof(uint32_t));
+    p->free_head = i;
+}
+
+void ipool_destroy(IndexPool *p) {
+    free(p->base);
+    p->base = NULL;
+    p->n = p->cap = p->free_head = 0;
+}
+
+/* ---- Συμπαγές BST: key + 2 x 32-bit παιδιά = 16 bytes μεταδεδομένα ---- */
+
+typedef struct {
+    uint64_t key;
+    uint32_t child[2];      /* [0] αριστερό, [1] δεξί */
+    Citizen data;
+} CBSTNode;
+
+#define CBST(p) ((CBSTNode*)(p)->base)
+
+/* Νέα ρίζα ή IPOOL_FULL, με το δέντρο αμετάβλητο, αν δεν χωρά ο κόμβος
+ * (το ίδιο και στα cavl_insert/crbt_insert) */
+uint32_t cbst_insert(IndexPool *p, uint32_t root, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    uint32_t parent = 0;
+    int cmp = 0;
+    for (uint32_t x = root; x; ) {
+        CBSTNode *n = &CBST(p)[x];
+        cmp = key_cmp(key, c->full_name, n->key, n->data.full_name);
+        if (cmp == 0) return root;
+        parent = x;
+        x = n->child[cmp > 0];
+    }
+    uint32_t z = ipool_alloc(p);
+    if (!z) return IPOOL_FULL;
+    CBSTNode *n = &CBST(p)[z];
+    n->key = key; n->child[0] = n->child[1] = 0; n->data = *c;
+    if (!parent) return z;
+    CBST(p)[parent].child[cmp > 0] = z;
+    return root;
+}
+
+uint32_t cbst_search(IndexPool *p, uint32_t root, const char *name) {
+    uint64_t key = key_prefix(name);
+    CBSTNode *N = CBST(p);
+    while (root) {
+        int cmp = key_cmp(key, name, N[root].key, N[root].data.full_name);
+        if (cmp == 0) return root;
+        root = N[root].child[cmp > 0];
+    }
+    return 0;
+}
+
+uint32_t cbst_delete(IndexPool *p, uint32_t root, const char *name) {
+    uint64_t key = key_prefix(name);
+    CBSTNode *N = CBST(p);
+    uint32_t *link = &root;
+    while (*link) {
+        int cmp = key_cmp(key, name, N[*link].key, N[*link].data.full_name);
+        if (cmp == 0) break;
+        link = &N[*link].child[cmp > 0];
+    }
+    uint32_t z = *link;
+    if (!z) return root;
+    if (!N[z].child[0]) *link = N[z].child[1];
+    else if (!N[z].child[1]) *link = N[z].child[0];
+    else {
+        uint32_t *sl = &N[z].child[1];
+        while (N[*sl].child[0]) sl = &N[*sl].child[0];
+        uint32_t s = *sl;
+        *sl = N[s].child[1];
+        N[s].child[0] = N[z].child[0]; N[s].child[1] = N[z].child[1];
+        *link = s;
+    }
+    ipool_free(p, z);
+    return root;
+}
+
+/* ---- Συμπαγές AVL: balance factor (-1, 0, +1) ως 2 bits στο child[0] ---- */
+
+typedef struct {
+    uint64_t key;
+    uint32_t child[2];      /* [0] αριστερό (πάνω 2 bits: balance + 1), [1] δεξί */
+    Citizen data;
+} CAVLNode;
+
+#define CAVL(p) ((CAVLNode*)(p)->base)
+#define CAVL_IDX_MASK 0x3FFFFFFFu
+
+static inline uint32_t cavl_child(const CAVLNode *n, int d) { return n->child[d] & CAVL_IDX_MASK; }
+static inline void cavl_set_child(CAVLNode *n, int d, uint32_t c) { n->child[d] = (n->child[d] & ~CAVL_IDX_MASK) | c; }
+/* balance = ύψος δεξιού - ύψος αριστερού υποδέντρου */
+static inline int cavl_bf(const CAVLNode *n) { return (int)(n->child[0] >> 30) - 1; }
+static inline void cavl_set_bf(CAVLNode *n, int bf) { n->child[0] = (n->child[0] & CAVL_IDX_MASK) | ((uint32_t)(bf + 1) << 30); }
+
+/* Περιστροφή του x προς την κατεύθυνση d (0 = αριστερή): ανεβαίνει το παιδί 1-d */
+static uint32_t cavl_rotate(CAVLNode *N, uint32_t x, int d) {
+    uint32_t z = cavl_child(&N[x], 1 - d);
+    cavl_set_child(&N[x], 1 - d, cavl_child(&N[z], d));
+    cavl_set_child(&N[z], d, x);
+    return z;
+}
+
+/* Εξισορρόπηση κόμβου με balance ±2 (δεν χωράει στα 2 bits, γι' αυτό δίνεται
+ * ως όρισμα). Επιστρέφει τη νέα ρίζα και στο *shrunk αν μειώθηκε το ύψος. */
+static uint32_t cavl_fix(CAVLNode *N, uint32_t x, int bf, int *shrunk) {
+    int h = bf > 0, sign = bf > 0 ? 1 : -1;
+    uint32_t z = cavl_child(&N[x], h);
+    int bz = cavl_bf(&N[z]);
+    if (bz == -sign) {
+        /* Διπλή περιστροφή: το εσωτερικό εγγόνι y γίνεται ρίζα */
+        uint32_t y = cavl_child(&N[z], 1 - h);
+        int by = cavl_bf(&N[y]);
+        cavl_set_child(&N[x], h, cavl_rotate(N, z, h));
+        cavl_rotate(N, x, 1 - h);
+        cavl_set_bf(&N[x], by == sign ? -sign : 0);
+        cavl_set_bf(&N[z], by == -sign ? sign : 0);
+        cavl_set_bf(&N[y], 0);
+        *shrunk = 1;
+        return y;
+    }
+    cavl_rotate(N, x, 1 - h);
+    if (bz == 0) {          /* μόνο σε διαγραφή: το ύψος δεν αλλάζει */
+        cavl_set_bf(&N[x], sign); cavl_set_bf(&N[z], -sign);
+        *shrunk = 0;
+    } else {
+        cavl_set_bf(&N[x], 0); cavl_set_bf(&N[z], 0);
+        *shrunk = 1;
+    }
+    return z;
+}
+
+static inline void cavl_link(CAVLNode *N, uint32_t *root, const uint32_t *idx, const int *dir, int i, uint32_t c) {
+    if (i < 0) *root = c;
+    else cavl_set_child(&N[idx[i]], dir[i], c);
+}
+
+uint32_t cavl_insert(IndexPool *p, uint32_t root, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    uint32_t idx[AVL_MAX_DEPTH];
+    int dir[AVL_MAX_DEPTH], depth = 0;
+    for (uint32_t x = root; x; ) {
+        CAVLNode *n = &CAVL(p)[x];
+        int cmp = key_cmp(key, c->full_name, n->key, n->data.full_name);
+        if (cmp == 0) return root;
+        idx[depth] = x; dir[depth++] = cmp > 0;
+        x = cavl_child(n, cmp > 0);
+    }
+    uint32_t z = ipool_alloc(p);
+    if (!z) return IPOOL_FULL;
+    CAVLNode *N = CAVL(p);
+    N[z].key = key; N[z].child[0] = N[z].child[1] = 0; N[z].data = *c;
+    cavl_set_bf(&N[z], 0);
+    cavl_link(N, &root, idx, dir, depth - 1, z);
+
+    /* Ανάβαση: το υποδέντρο στην κατεύθυνση dir ψήλωσε κατά 1 */
+    for (int i = depth - 1; i >= 0; i--) {
+        uint32_t x = idx[i];
+        int bf = cavl_bf(&N[x]) + (dir[i] ? 1 : -1);
+        if (bf == 0) { cavl_set_bf(&N[x], 0); break; }
+        if (bf == 1 || bf == -1) { cavl_set_bf(&N[x], bf); continue; }
+        int shrunk;
+        cavl_link(N, &root, idx, dir, i - 1, cavl_fix(N, x, bf, &shrunk));
+        break;
+    }
+    return root;
+}
+
+uint32_t cavl_search(IndexPool *p, uint32_t root, const char *name) {
+    uint64_t key = key_prefix(name);
+    CAVLNode *N = CAVL(p);
+    while (root) {
+        int cmp = key_cmp(key, name, N[root].key, N[root].data.full_name);
+        if (cmp == 0) return root;
+        root = cavl_child(&N[root], cmp > 0);
+    }
+    return 0;
+}
+
+uint32_t cavl_delete(IndexPool *p, uint32_t root, const char *name) {
+    uint64_t key = key_prefix(name);
+    CAVLNode *N = CAVL(p);
+    uint32_t idx[AVL_MAX_DEPTH];
+    int dir[AVL_MAX_DEPTH], depth = 0;
+    uint32_t t = root;
+    while (t) {
+        int cmp = key_cmp(key, name, N[t].key, N[t].data.full_name);
+        if (cmp == 0) break;
+        idx[depth] = t; dir[depth++] = cmp > 0;
+        t = cavl_child(&N[t], cmp > 0);
+    }
+    if (!t) return root;
+
+    uint32_t l = cavl_child(&N[t], 0), r = cavl_child(&N[t], 1);
+    if (!l || !r) {
+        cavl_link(N, &root, idx, dir, depth - 1, l ? l : r);
+    } else {
+        /* Ο διάδοχος s παίρνει τη θέση (και το balance) του t στο μονοπάτι */
+        int ti = depth;
+        idx[depth] = t; dir[depth++] = 1;
+        uint32_t s = r;
+        while (cavl_child(&N[s], 0)) { idx[depth] = s; dir[depth++] = 0; s = cavl_child(&N[s], 0); }
+        if (depth - 1 > ti) {
+            cavl_set_child(&N[idx[depth - 1]], 0, cavl_child(&N[s], 1));
+            cavl_set_child(&N[s], 1, r);
+        }
+        cavl_set_child(&N[s], 0, l);
+        cavl_set_bf(&N[s], cavl_bf(&N[t]));
+        cavl_link(N, &root, idx, dir, ti - 1, s);
+        idx[ti] = s;
+    }
+    ipool_free(p, t);
+
+    /* Ανάβαση: το υποδέντρο στην κατεύθυνση dir κόντυνε κατά 1 */
+    for (int i = depth - 1; i >= 0; i--) {
+        uint32_t x = idx[i];
+        int bf = cavl_bf(&N[x]) + (dir[i] ? -1 : 1);
+        if (bf == 1 || bf == -1) { cavl_set_bf(&N[x], bf); break; }
+        if (bf == 0) { cavl_set_bf(&N[x], 0); continue; }
+        int shrunk;
+        cavl_link(N, &root, idx, dir, i - 1, cavl_fix(N, x, bf, &shrunk));
+        if (!shrunk) break;
+    }
+    return root;
+}
+
+/* ---- Συμπαγές RBT: 3 x 32-bit σύνδεσμοι, χρώμα στο πάνω bit του parent ----
+ * key + 3 x 32-bit = 20 bytes, 24 μεταδεδομένα με το padding της
+ * στοίχισης 8 bytes του key */
+
+typedef struct {
+    uint64_t key;
+    uint32_t child[2];      /* [0] αριστερό, [1] δεξί */
+    uint32_t parent;        /* bit 31: 1 = κόκκινος */
+    Citizen data;
+} CRBTNode;
+
+#define CRBT(p) ((CRBTNode*)(p)->base)
+#define CRB_RED_BIT 0x80000000u
+
+static inline uint32_t crb_parent(const CRBTNode *N, uint32_t x) { return N[x].parent & ~CRB_RED_BIT; }
+static inline void crb_set_parent(CRBTNode *N, uint32_t x, uint32_t p) { N[x].parent = (N[x].parent & CRB_RED_BIT) | p; }
+static inline int crb_red(const CRBTNode *N, uint32_t x) { return (int)(N[x].parent >> 31); }
+static inline void crb_set_red(CRBTNode *N, uint32_t x, int red) { N[x].parent = (N[x].parent & ~CRB_RED_BIT) | ((uint32_t)red << 31); }
+
+static void crb_rotate_left(CRBTNode *N, uint32_t *root, uint32_t x) {
+    uint32_t y = N[x].child[1], px = crb_parent(N, x);
+    N[x].child[1] = N[y].child[0];
+    if (N[y].child[0]) crb_set_parent(N, N[y].child[0], x);
+    crb_set_parent(N, y, px);
+    if (!px) *root = y;
+    else if (x == N[px].child[0]) N[px].child[0] = y;
+    else N[px].child[1] = y;
+    N[y].child[0] = x;
+    crb_set_parent(N, x, y);
+}
+
+static void crb_rotate_right(CRBTNode *N, uint32_t *root, uint32_t y) {
+    uint32_t x = N[y].child[0], py = crb_parent(N, y);
+    N[y].child[0] = N[x].child[1];
+    if (N[x].child[1]) crb_set_parent(N, N[x].child[1], y);
+    crb_set_parent(N, x, py);
+    if (!py) *root = x;
+    else if (y == N[py].child[0]) N[py].child[0] = x;
+    else N[py].child[1] = x;
+    N[x].child[1] = y;
+    crb_set_parent(N, y, x);
+}
+
+uint32_t crbt_insert(IndexPool *p, uint32_t root, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    uint32_t y = 0;
+    int cmp = 0;
+    for (uint32_t x = root; x; ) {
+        CRBTNode *n = &CRBT(p)[x];
+        cmp = key_cmp(key, c->full_name, n->key, n->data.full_name);
+        if (cmp == 0) return root;
+        y = x;
+        x = n->child[cmp > 0];
+    }
+    uint32_t z = ipool_alloc(p);
+    if (!z) return IPOOL_FULL;
+    CRBTNode *N = CRBT(p);
+    N[z].key = key; N[z].child[0] = N[z].child[1] = 0; N[z].data = *c;
+    N[z].parent = y | CRB_RED_BIT;
+    if (!y) root = z;
+    else N[y].child[cmp > 0] = z;
+
+    while (crb_red(N, crb_parent(N, z))) {
+        uint32_t zp = crb_parent(N, z), g = crb_parent(N, zp);
+        if (zp == N[g].child[0]) {
+            uint32_t u = N[g].child[1];
+            if (crb_red(N, u)) {
+                crb_set_red(N, zp, 0); crb_set_red(N, u, 0); crb_set_red(N, g, 1);
+                z = g;
+            } else {
+                if (z == N[zp].child[1]) { z = zp; crb_rotate_left(N, &root, z); zp = crb_parent(N, z); }
+                crb_set_red(N, zp, 0); crb_set_red(N, g, 1);
+                crb_rotate_right(N, &root, g);
+            }
+        } else {
+            uint32_t u = N[g].child[0];
+            if (crb_red(N, u)) {
+                crb_set_red(N, zp, 0); crb_set_red(N, u, 0); crb_set_red(N, g, 1);
+                z = g;
+            } else {
+                if (z == N[zp].child[0]) { z = zp; crb_rotate_right(N, &root, z); zp = crb_parent(N, z); }
+                crb_set_red(N, zp, 0); crb_set_red(N, g, 1);
+                crb_rotate_left(N, &root, g);
+            }
+        }
+    }
+    crb_set_red(N, root, 0);
+    return root;
+}
+
+uint32_t crbt_search(IndexPool *p, uint32_t root, const char *name) {
+    uint64_t key = key_prefix(name);
+    CRBTNode *N = CRBT(p);
+    while (root) {
+        int cmp = key_cmp(key, name, N[root].key, N[root].data.full_name);
+        if (cmp == 0) return root;
+        root = N[root].child[cmp > 0];
+    }
+    return 0;
+}
+
+/* Ο NIL (θέση 0) αποκτά προσωρινά γονέα, όπως στο rbt_delete */
+static void crb_transplant(CRBTNode *N, uint32_t *root, uint32_t u, uint32_t v) {
+    uint32_t pu = crb_parent(N, u);
+    if (!pu) *root = v;
+    else if (u == N[pu].child[0]) N[pu].child[0] = v;
+    else N[pu].child[1] = v;
+    crb_set_parent(N, v, pu);
+}
+
+uint32_t crbt_delete(IndexPool *p, uint32_t root, const char *name) {
+    uint64_t key = key_prefix(name);
+    CRBTNode *N = CRBT(p);
+    uint32_t z = root;
+    while (z) {
+        int cmp = key_cmp(key, name, N[z].key, N[z].data.full_name);
+        if (cmp == 0) break;
+        z = N[z].child[cmp > 0];
+    }
+    if (!z) return root;
+
+    uint32_t y = z, x;
+    int y_red = crb_red(N, y);
+    if (!N[z].child[0]) { x = N[z].child[1]; crb_transplant(N, &root, z, x); }
+    else if (!N[z].child[1]) { x = N[z].child[0]; crb_transplant(N, &root, z, x); }
+    else {
+        y = N[z].child[1];
+        while (N[y].child[0]) y = N[y].child[0];
+        y_red = crb_red(N, y);
+        x = N[y].child[1];
+        if (crb_parent(N, y) == z) crb_set_parent(N, x, y);
+        else {
+            crb_transplant(N, &root, y, N[y].child[1]);
+            N[y].child[1] = N[z].child[1]; crb_set_parent(N, N[y].child[1], y);
+        }
+        crb_transplant(N, &root, z, y);
+        N[y].child[0] = N[z].child[0]; crb_set_parent(N, N[y].child[0], y);
+        crb_set_red(N, y, crb_red(N, z));
+    }
+    ipool_free(p, z);
+    if (y_red) { N[0].parent = 0; return root; }
+
+    while (x != root && !crb_red(N, x)) {
+        uint32_t xp = crb_parent(N, x);
+        if (x == N[xp].child[0]) {
+            uint32_t w = N[xp].child[1];
+            if (crb_red(N, w)) {
+                crb_set_red(N, w, 0); crb_set_red(N, xp, 1);
+                crb_rotate_left(N, &root, xp); w = N[xp].child[1];
+            }
+            if (!crb_red(N, N[w].child[0]) && !crb_red(N, N[w].child[1])) {
+                crb_set_red(N, w, 1); x = xp;
+            } else {
+                if (!crb_red(N, N[w].child[1])) {
+                    crb_set_red(N, N[w].child[0], 0); crb_set_red(N, w, 1);
+                    crb_rotate_right(N, &root, w); w = N[xp].child[1];
+                }
+                crb_set_red(N, w, crb_red(N, xp)); crb_set_red(N, xp, 0);
+                crb_set_red(N, N[w].child[1], 0);
+                crb_rotate_left(N, &root, xp); x = root;
+            }
+        } else {
+            uint32_t w = N[xp].child[0];
+            if (crb_red(N, w)) {
+                crb_set_red(N, w, 0); crb_set_red(N, xp, 1);
+                crb_rotate_right(N, &root, xp); w = N[xp].child[0];
+            }
+            if (!crb_red(N, N[w].child[1]) && !crb_red(N, N[w].child[0])) {
+                crb_set_red(N, w, 1); x = xp;
+            } else {
+                if (!crb_red(N, N[w].child[0])) {
+                    crb_set_red(N, N[w].child[1], 0); crb_set_red(N, w, 1);
+                    crb_rotate_left(N, &root, w); w = N[xp].child[0];
+                }
+                crb_set_red(N, w, crb_red(N, xp)); crb_set_red(N, xp, 0);
+                crb_set_red(N, N[w].child[0], 0);
+                crb_rotate_right(N, &root, xp); x = root;
+            }
+        }
+    }
+    crb_set_red(N, x, 0);
+    N[0].parent = 0;        /* ο NIL επιστρέφει καθαρός (μαύρος, χωρίς γονέα) */
+    return root;
+}
+
+/* ============ B+ Δέντρο ============ */
+
+/* B+ δέντρο με κλειδί το full_name. Κάθε κόμβος κρατά έως BPT_ORDER - 1
+ * κλειδιά: τα 8-byte προθέματα βρίσκονται συνεχόμενα στην αρχή του κόμβου
+ * (ευθυγραμμισμένου σε cache line), ώστε η αναζήτηση μέσα στον κόμβο να
+ * διαβάζει λίγες γραμμές και να αγγίζει το πλήρες όνομα μόνο σε ισοπαλία.
+ * Τα φύλλα δείχνουν στις εγγραφές και συνδέονται μεταξύ τους για διάσχιση.
+ * Οι εσωτερικοί κόμβοι κρατούν δικά τους αντίγραφα των διαχωριστικών. */
+
+#ifndef BPT_ORDER
+#define BPT_ORDER 16            /* μέγιστος αριθμός παιδιών εσωτερικού κόμβου */
+#endif
+#if BPT_ORDER < 4
+#error "BPT_ORDER πρέπει να είναι τουλάχιστον 4"
+#endif
+#define BPT_MAX_KEYS (BPT_ORDER - 1)
+#define BPT_MIN_KEYS ((BPT_ORDER - 1) / 2)
+#define BPT_MAX_DEPTH 64
+
+typedef struct BPTNode {
+    uint64_t keys[BPT_ORDER];   /* +1 θέση για προσωρινή υπερχείλιση */
+    int is_leaf;
+    int n;                      /* πλήθος κλειδιών */
+    union {
+        struct {
+            struct BPTNode *child[BPT_ORDER + 1];
+            char *sep[BPT_ORDER];
+        } in;
+        struct {
+            Citizen *rec[BPT_ORDER];
+            struct BPTNode *next;
+        } leaf;
+    } u;
+} BPTNode;
+
+static BPTNode* bpt_new_node(int is_leaf) {
+    void *mem;
+    if (posix_memalign(&mem, 64, sizeof(BPTNode))) return NULL;
+    BPTNode *n = (BPTNode*)mem;
+    n->is_leaf = is_leaf;
+    n->n = 0;
+    if (is_leaf) n->u.leaf.next = NULL;
+    return n;
+}
+
+/* Παιδί προς το οποίο κατεβαίνουμε: πλήθος διαχωριστικών <= όνομα */
+static inline int bpt_child_index(const BPTNode *x, uint64_t key, const char *name) {
+    int i = 0;
+    while (i < x->n && key_cmp(key, name, x->keys[i], x->u.in.sep[i]) >= 0) i++;
+    return i;
+}
+
+/* Θέση στο φύλλο: πρώτο κλειδί >= όνομα */
+static inline int bpt_leaf_pos(const BPTNode *x, uint64_t key, const char *name, int *found) {
+    for (int i = 0; i < x->n; i++) {
+        int cmp = key_cmp(key, name, x->keys[i], x->u.leaf.rec[i]->full_name);
+        if (cmp <= 0) { *found = (cmp == 0); return i; }
+    }
+    *found = 0;
+    return x->n;
+}
+
+BPTNode* bpt_insert(BPTNode *root, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    BPTNode *path[BPT_MAX_DEPTH];
+    int pidx[BPT_MAX_DEPTH], depth = 0;
+    if (!root) root = bpt_new_node(1);
+
+    BPTNode *x = root;
+    while (!x->is_leaf) {
+        int i = bpt_child_index(x, key, c->full_name);
+        path[depth] = x; pidx[depth++] = i;
+        x = x->u.in.child[i];
+    }
+    int found, pos = bpt_leaf_pos(x, key, c->full_name, &found);
+    if (found) return root;  /* Διπλότυπο - δεν εισάγεται */
+
+    Citizen *rec = (Citizen*)malloc(sizeof(Citizen));
+    *rec = *c;
+    memmove(&x->keys[pos + 1], &x->keys[pos], (x->n - pos) * sizeof(uint64_t));
+    memmove(&x->u.leaf.rec[pos + 1], &x->u.leaf.rec[pos], (x->n - pos) * sizeof(Citizen*));
+    x->keys[pos] = key; x->u.leaf.rec[pos] = rec; x->n++;
+    if (x->n <= BPT_MAX_KEYS) return root;
+
+    /* Διάσπαση φύλλου - το πρώτο κλειδί του δεξιού ανεβαίνει ως αντίγραφο */
+    BPTNode *right = bpt_new_node(1);
+    int half = x->n / 2;
+    right->n = x->n - half;
+    memcpy(right->keys, &x->keys[half], right->n * sizeof(uint64_t));
+    memcpy(right->u.leaf.rec, &x->u.leaf.rec[half], right->n * sizeof(Citizen*));
+    x->n = half;
+    right->u.leaf.next = x->u.leaf.next;
+    x->u.leaf.next = right;
+    uint64_t up_key = right->keys[0];
+    char *up_sep = strdup(right->u.leaf.rec[0]->full_name);
+    BPTNode *up_child = right;
+
+    /* Εισαγωγή διαχωριστικού στους προγόνους, με διάσπαση όπου γεμίζουν */
+    while (depth > 0) {
+        BPTNode *p = path[--depth];
+        int i = pidx[depth];
+        memmove(&p->keys[i + 1], &p->keys[i], (p->n - i) * sizeof(uint64_t));
+        memmove(&p->u.in.sep[i + 1], &p->u.in.sep[i], (p->n - i) * sizeof(char*));
+        memmove(&p->u.in.child[i + 2], &p->u.in.child[i + 1], (p->n - i) * sizeof(BPTNode*));
+        p->keys[i] = up_key; p->u.in.sep[i] = up_sep; p->u.in.child[i + 1] = up_child; p->n++;
+        if (p->n <= BPT_MAX_KEYS) return root;
+
+        /* Διάσπαση εσωτερικού κόμβου - το μεσαίο κλειδί ανεβαίνει */
+        BPTNode *r = bpt_new_node(0);
+        int mid = p->n / 2;
+        r->n = p->n - mid - 1;
+        memcpy(r->keys, &p->keys[mid + 1], r->n * sizeof(uint64_t));
+        memcpy(r->u.in.sep, &p->u.in.sep[mid + 1], r->n * sizeof(char*));
+        memcpy(r->u.in.child, &p->u.in.child[mid + 1], (r->n + 1) * sizeof(BPTNode*));
+        up_key = p->keys[mid]; up_sep = p->u.in.sep[mid];
+        p->n = mid;
+        up_child = r;
+    }
+
+    /* Διάσπαση ρίζας - το δέντρο ψηλώνει κατά ένα επίπεδο */
+    BPTNode *nr = bpt_new_node(0);
+    nr->n = 1;
+    nr->keys[0] = up_key; nr->u.in.sep[0] = up_sep;
+    nr->u.in.child[0] = root; nr->u.in.child[1] = up_child;
+    return nr;
+}
+
+/* Αφαίρεση του διαχωριστικού k και του παιδιού k + 1 από εσωτερικό κόμβο */
+static void bpt_remove_entry(BPTNode *p, int k) {
+    int tail = p->n - k - 1;
+    memmove(&p->keys[k], &p->keys[k + 1], tail * sizeof(uint64_t));
+    memmove(&p->u.in.sep[k], &p->u.in.sep[k + 1], tail * sizeof(char*));
+    memmove(&p->u.in.child[k + 1], &p->u.in.child[k + 2], tail * sizeof(BPTNode*));
+    p->n--;
+}
+
+/* Συγχώνευση φύλλου b στο αριστερό του a */
+static void bpt_merge_leaves(BPTNode *a, BPTNode *b) {
+    memcpy(&a->keys[a->n], b->keys, b->n * sizeof(uint64_t));
+    memcpy(&a->u.leaf.rec[a->n], b->u.leaf.rec, b->n * sizeof(Citizen*));
+    a->n += b->n;
+    a->u.leaf.next = b->u.leaf.next;
+    free(b);
+}
+
+/* Συγχώνευση εσωτερικού b στο a - το διαχωριστικό k του γονέα κατεβαίνει */
+static void bpt_merge_internal(BPTNode *a, BPTNode *p, int k, BPTNode *b) {
+    a->keys[a->n] = p->keys[k]; a->u.in.sep[a->n] = p->u.in.sep[k];
+    memcpy(&a->keys[a->n + 1], b->keys, b->n * sizeof(uint64_t));
+    memcpy(&a->u.in.sep[a->n + 1], b->u.in.sep, b->n * sizeof(char*));
+    memcpy(&a->u.in.child[a->n + 1], b->u.in.child, (b->n + 1) * sizeof(BPTNode*));
+    a->n += b->n + 1;
+    free(b);
+}
+
+BPTNode* bpt_delete(BPTNode *root, const char *name) {
+    if (!root) return NULL;
+    uint64_t key = key_prefix(name);
+    BPTNode *path[BPT_MAX_DEPTH];
+    int pidx[BPT_MAX_DEPTH], depth = 0;
+
+    BPTNode *x = root;
+    while (!x->is_leaf) {
+        int i = bpt_child_index(x, key, name);
+        path[depth] = x; pidx[depth++] = i;
+        x = x->u.in.child[i];
+    }
+    int found, pos = bpt_leaf_pos(x, key, name, &found);
+    if (!found) return root;  /* Δεν βρέθηκε */
+
+    free(x->u.leaf.rec[pos]);
+    memmove(&x->keys[pos], &x->keys[pos + 1], (x->n - pos - 1) * sizeof(uint64_t));
+    memmove(&x->u.leaf.rec[pos], &x->u.leaf.rec[pos + 1], (x->n - pos - 1) * sizeof(Citizen*));
+    x->n--;
+
+    /* Επανισορρόπηση από κάτω προς τα πάνω: δανεισμός ή συγχώνευση */
+    while (depth > 0 && x->n < BPT_MIN_KEYS) {
+        BPTNode *p = path[--depth];
+        int i = pidx[depth];
+        BPTNode *l = i > 0 ? p->u.in.child[i - 1] : NULL;
+        BPTNode *r = i < p->n ? p->u.in.child[i + 1] : NULL;
+
+        if (x->is_leaf) {
+            if (l && l->n > BPT_MIN_KEYS) {
+                memmove(&x->keys[1], x->keys, x->n * sizeof(uint64_t));
+                memmove(&x->u.leaf.rec[1], x->u.leaf.rec, x->n * sizeof(Citizen*));
+                x->keys[0] = l->keys[l->n - 1]; x->u.leaf.rec[0] = l->u.leaf.rec[l->n - 1];
+                x->n++; l->n--;
+                free(p->u.in.sep[i - 1]);
+                p->keys[i - 1] = x->keys[0]; p->u.in.sep[i - 1] = strdup(x->u.leaf.rec[0]->full_name);
+                return root;
+            }
+            if (r && r->n > BPT_MIN_KEYS) {
+                x->keys[x->n] = r->keys[0]; x->u.leaf.rec[x->n] = r->u.leaf.rec[0];
+                x->n++; r->n--;
+                memmove(r->keys, &r->keys[1], r->n * sizeof(uint64_t));
+                memmove(r->u.leaf.rec, &r->u.leaf.rec[1], r->n * sizeof(Citizen*));
+                free(p->u.in.sep[i]);
+                p->keys[i] = r->keys[0]; p->u.in.sep[i] = strdup(r->u.leaf.rec[0]->full_name);
+                return root;
+            }
+            if (l) { free(p->u.in.sep[i - 1]); bpt_merge_leaves(l, x); bpt_remove_entry(p, i - 1); }
+            else { free(p->u.in.sep[i]); bpt_merge_leaves(x, r); bpt_remove_entry(p, i); }
+        } else {
+            if (l && l->n > BPT_MIN_KEYS) {
+                /* Το διαχωριστικό του γονέα κατεβαίνει, το τελευταίο του l ανεβαίνει */
+                memmove(&x->keys[1], x->keys, x->n * sizeof(uint64_t));
+                memmove(&x->u.in.sep[1], x->u.in.sep, x->n * sizeof(char*));
+                memmove(&x->u.in.child[1], x->u.in.child, (x->n + 1) * sizeof(BPTNode*));
+                x->keys[0] = p->keys[i - 1]; x->u.in.sep[0] = p->u.in.sep[i - 1];
+                x->u.in.child[0] = l->u.in.child[l->n];
+                p->keys[i - 1] = l->keys[l->n - 1]; p->u.in.sep[i - 1] = l->u.in.sep[l->n - 1];
+                x->n++; l->n--;
+                return root;
+            }
+            if (r && r->n > BPT_MIN_KEYS) {
+                x->keys[x->n] = p->keys[i]; x->u.in.sep[x->n] = p->u.in.sep[i];
+                x->u.in.child[x->n + 1] = r->u.in.child[0];
+                p->keys[i] = r->keys[0]; p->u.in.sep[i] = r->u.in.sep[0];
+                x->n++; r->n--;
+                memmove(r->keys, &r->keys[1], r->n * sizeof(uint64_t));
+                memmove(r->u.in.sep, &r->u.in.sep[1], r->n * sizeof(char*));
+                memmove(r->u.in.child, &r->u.in.child[1], (r->n + 1) * sizeof(BPTNode*));
+                return root;
+            }
+            if (l) { bpt_merge_internal(l, p, i - 1, x); bpt_remove_entry(p, i - 1); }
+            else { bpt_merge_internal(x, p, i, r); bpt_remove_entry(p, i); }
+        }
+        x = p;
+    }
+
+    /* Άδεια ρίζα: το δέντρο χαμηλώνει ή αδειάζει */
+    if (root->n == 0) {
+        BPTNode *c = root->is_leaf ? NULL : root->u.in.child[0];
+        free(root);
+        return c;
+    }
+    return root;
+}
+
+Citizen* bpt_search(BPTNode *root, const char *name) {
+    if (!root) return NULL;
+    uint64_t key = key_prefix(name);
+    BPTNode *x = root;
+    while (!x->is_leaf) x = x->u.in.child[bpt_child_index(x, key, name)];
+    int found, pos = bpt_leaf_pos(x, key, name, &found);
+    return found ? x->u.leaf.rec[pos] : NULL;
+}
+
+void bpt_free(BPTNode *root) {
+    if (!root) return;
+    if (root->is_leaf) {
+        for (int i = 0; i < root->n; i++) free(root->u.leaf.rec[i]);
+    } else {
+        for (int i = 0; i < root->n; i++) free(root->u.in.sep[i]);
+        for (int i = 0; i <= root->n; i++) bpt_free(root->u.in.child[i]);
+    }
+    free(root);
+}
+
+/* ============ Διατεταγμένη Προσπέλαση ============ */
+
+/* Iterators για σάρωση σε αλφαβητική σειρά χωρίς αναδρομή και χωρίς
+ * εκτύπωση. BST/AVL: ρητή στοίβα με τους προγόνους που απομένουν (αυτούς
+ * από τους οποίους κατεβήκαμε αριστερά). RBT: ο διάδοχος από τους δείκτες
+ * γονέα, χωρίς στοίβα. B+: θέση σε φύλλο και η λίστα next. Η τοποθέτηση
+ * (seek) κοστίζει O(ύψος) και κάθε βήμα O(1) αποσβεσμένο, οπότε τα range και
+ * prefix ερωτήματα κοστίζουν O(log n + k) και γράφουν μόνο τις k εγγραφές
+ * στον buffer του καλούντος. */
+#define ITER_FIXED_DEPTH 64
+
+/* Σε εκφυλισμένο BST το βάθος φτάνει το n: πάνω από ITER_FIXED_DEPTH η
+ * στοίβα μεταφέρεται στον heap. Δεν αντιγράφεται (η stack δείχνει στο fixed).
+ * Αν αποτύχει η επέκταση της στοίβας ο iterator σημειώνεται failed και η
+ * bst_iter_next επιστρέφει NULL - ο καλών ελέγχει το failed στο τέλος. */
+typedef struct {
+    BSTNode **stack;
+    int top, cap;
+    int failed;
+    BSTNode *fixed[ITER_FIXED_DEPTH];
+} BSTIter;
+
+#define ITER_FAILED ((size_t)-1)        /* range/prefix: αποτυχία δέσμευσης */
+
+static int bst_iter_push(BSTIter *it, BSTNode *n) {
+    if (it->top == it->cap) {
+        BSTNode **s = (BSTNode**)malloc(2 * it->cap * sizeof(BSTNode*));
+        if (!s) { fprintf(stderr, "Σφάλμα: αποτυχία δέσμευσης μνήμης\n"); it->failed = 1; return 0; }
+        memcpy(s, it->stack, it->top * sizeof(BSTNode*));
+        if (it->stack != it->fixed) free(it->stack);
+        it->stack = s;
+        it->cap *= 2;
+    }
+    it->stack[it->top++] = n;
+    return 1;
+}
+
+/* Τοποθέτηση στο πρώτο όνομα >= lo (NULL = στην αρχή) */
+void bst_iter_seek(BSTIter *it, BSTNode *root, const char *lo) {
+    it->stack = it->fixed;
+    it->top = 0;
+    it->cap = ITER_FIXED_DEPTH;
+    it->failed = 0;
+    uint64_t key = lo ? key_prefix(lo) : 0;
+    while (root) {
+        if (!lo || key_cmp(key, lo, root->key, root->data.full_name) <= 0) {
+            if (!bst_iter_push(it, root)) return;
+            root = root->left;
+        } else root = root->right;
+    }
+}
+
+/* Επόμενος κόμβος ή NULL στο τέλος και σε αποτυχία (failed) */
+BSTNode* bst_iter_next(BSTIter *it) {
+    if (!it->top || it->failed) return NULL;
+    BSTNode *n = it->stack[--it->top];
+    for (BSTNode *x = n->right; x; x = x->left)
+        if (!bst_iter_push(it, x)) return NULL;
+    return n;
+}
+
+void bst_iter_done(BSTIter *it) {
+    if (it->stack != it->fixed) free(it->stack);
+    it->stack = it->fixed;
+    it->top = 0;
+}
+
+/* Πρώτος κόμβος με όνομα >= lo (NULL = ο μικρότερος) ή NULL */
+RBTNode* rbt_seek(RBTNode *root, const char *lo) {
+    RBTNode *found = NULL;
+    uint64_t key = lo ? key_prefix(lo) : 0;
+    while (root && root != RBT_NIL) {
+        if (!lo || key_cmp(key, lo, root->key, root->data.full_name) <= 0) {
+            found = root;
+            root = root->left;
+        } else root = root->right;
+    }
+    return found;
+}
+
+/* Διάδοχος ή NULL μετά τον τελευταίο */
+RBTNode* rbt_next(RBTNode *n) {
+    if (n->right != RBT_NIL) return rbt_find_min(n->right);
+    RBTNode *p = n->parent;
+    while (p != RBT_NIL && n == p->right) { n = p; p = p->parent; }
+    return p != RBT_NIL ? p : NULL;
+}
+
+typedef struct {
+    BPTNode *leaf;
+    int pos;
+} BPTIter;
+
+void bpt_iter_seek(BPTIter *it, BPTNode *root, const char *lo) {
+    it->pos = 0;
+    if (!root || !lo) {
+        while (root && !root->is_leaf) root = root->u.in.child[0];
+        it->leaf = root;
+        return;
+    }
+    uint64_t key = key_prefix(lo);
+    while (!root->is_leaf) root = root->u.in.child[bpt_child_index(root, key, lo)];
+    int found;
+    it->leaf = root;
+    it->pos = bpt_leaf_pos(root, key, lo, &found);
+}
+
+Citizen* bpt_iter_next(BPTIter *it) {
+    while (it->leaf && it->pos == it->leaf->n) { it->leaf = it->leaf->u.leaf.next; it->pos = 0; }
+    return it->leaf ? it->leaf->u.leaf.rec[it->pos++] : NULL;
+}
+
+/* Τέλος σάρωσης: πέρα από το hi ή (plen > 0) εκτός του προθέματος lo */
+static inline int scan_past(const char *name, const char *lo, const char *hi, size_t plen) {
+    return (hi && strcmp(name, hi) > 0) || (plen && strncmp(name, lo, plen) != 0);
+}
+
+/* Κοινός πυρήνας των range/prefix: αντιγράφει έως max εγγραφές στο out -
+ * ITER_FAILED αν ο iterator δεν μπόρεσε να μεγαλώσει τη στοίβα του */
+static size_t bst_scan(BSTNode *root, const char *lo, const char *hi, size_t plen, Citizen *out, size_t max) {
+    BSTIter it;
+    BSTNode *n;
+    size_t k = 0;
+    bst_iter_seek(&it, root, lo);
+    while (k < max && (n = bst_iter_next(&it)) && !scan_past(n->data.full_name, lo, hi, plen))
+        out[k++] = n->data;
+    bst_iter_done(&it);
+    return it.failed ? ITER_FAILED : k;
+}
+
+static size_t rbt_scan(RBTNode *root, const char *lo, const char *hi, size_t plen, Citizen *out, size_t max) {
+    size_t k = 0;
+    for (RBTNode *n = rbt_seek(root, lo); k < max && n && !scan_past(n->data.full_name, lo, hi, plen); n = rbt_next(n))
+        out[k++] = n->data;
+    return k;
+}
+
+static size_t bpt_scan(BPTNode *root, const char *lo, const char *hi, size_t plen, Citizen *out, size_t max) {
+    BPTIter it;
+    Citizen *c;
+    size_t k = 0;
+    bpt_iter_seek(&it, root, lo);
+    while (k < max && (c = bpt_iter_next(&it)) && !scan_past(c->full_name, lo, hi, plen))
+        out[k++] = *c;
+    return k;
+}
+
+/* Εγγραφές με lo <= όνομα <= hi (NULL = χωρίς όριο), έως max - το πλήθος.
+ * Η bst_range επιστρέφει ITER_FAILED σε αποτυχία δέσμευσης. */
+size_t bst_range(BSTNode *root, const char *lo, const char *hi, Citizen *out, size_t max) {
+    return bst_scan(root, lo, hi, 0, out, max);
+}
+
+size_t rbt_range(RBTNode *root, const char *lo, const char *hi, Citizen *out, size_t max) {
+    return rbt_scan(root, lo, hi, 0, out, max);
+}
+
+size_t bpt_range(BPTNode *root, const char *lo, const char *hi, Citizen *out, size_t max) {
+    return bpt_scan(root, lo, hi, 0, out, max);
+}
+
+/* Εγγραφές με όνομα που αρχίζει από prefix, έως max - το πλήθος ή ITER_FAILED */
+size_t bst_prefix(BSTNode *root, const char *prefix, Citizen *out, size_t max) {
+    return bst_scan(root, prefix, NULL, strlen(prefix), out, max);
+}
+
+size_t rbt_prefix(RBTNode *root, const char *prefix, Citizen *out, size_t max) {
+    return rbt_scan(root, prefix, NULL, strlen(prefix), out, max);
+}
+
+size_t bpt_prefix(BPTNode *root, const char *prefix, Citizen *out, size_t max) {
+    return bpt_scan(root, prefix, NULL, strlen(prefix), out, max);
+}
+
+/* ============ Στατιστικά Διάταξης ============ */
+
+/* Αντίγραφα του AVL και του RBT με το μέγεθος του υποδέντρου σε κάθε κόμβο:
+ * rank(name), select(k) και πλήθος σε εύρος με μία κατάβαση, σε O(log n),
+ * αντί για διάσχιση. Τα μεγέθη ενημερώνονται στις περιστροφές, στο insert
+ * και στο delete. Τα κανονικά δέντρα μένουν χωρίς το πεδίο, ώστε το
+ * benchmark να μετρά τι προσθέτει στο μονοπάτι εγγραφής. */
+
+typedef struct OSNode {
+    uint64_t key;
+    struct OSNode *left;
+    struct OSNode *right;
+    int height;
+    int size;                       /* κόμβοι του υποδέντρου */
+    Citizen data;
+} OSNode;
+
+/* Το size παίρνει τη θέση του height του RBTNode, οπότε ο κόμβος έχει το
+ * ίδιο μέγεθος */
+typedef struct OSRBNode {
+    uint64_t key;
+    struct OSRBNode *left;
+    struct OSRBNode *right;
+    struct OSRBNode *parent;
+    int size;                       /* 0 στον φρουρό */
+    char color;
+    Citizen data;
+} OSRBNode;
+
+static MemStats os_mem;
+
+static inline int os_size(const OSNode *n) { return n ? n->size : 0; }
+static inline int os_height(const OSNode *n) { return n ? n->height : 0; }
+
+static inline void os_update(OSNode *n) {
+    n->height = avl_max(os_height(n->left), os_height(n->right)) + 1;
+    n->size = os_size(n->left) + os_size(n->right) + 1;
+}
+
+static OSNode* os_rotate_right(OSNode *y) {
+    OSNode *x = y->left;
+    y->left = x->right; x->right = y;
+    os_update(y); os_update(x);
+    return x;
+}
+
+static OSNode* os_rotate_left(OSNode *x) {
+    OSNode *y = x->right;
+    x->right = y->left; y->left = x;
+    os_update(x); os_update(y);
+    return y;
+}
+
+static OSNode* os_rebalance(OSNode *n) {
+    os_update(n);
+    int bal = os_height(n->left) - os_height(n->right);
+    if (bal > 1) {
+        if (os_height(n->left->left) < os_height(n->left->right)) n->left = os_rotate_left(n->left);
+        return os_rotate_right(n);
+    }
+    if (bal < -1) {
+        if (os_height(n->right->right) < os_height(n->right->left)) n->right = os_rotate_right(n->right);
+        return os_rotate_left(n);
+    }
+    return n;
+}
+
+/* Οι περιστροφές σταματούν στον πρώτο κόμβο με αμετάβλητο ύψος, όπως στο
+ * avl_insert, αλλά τα μεγέθη αλλάζουν σε όλο το μονοπάτι μέχρι τη ρίζα */
+static void os_avl_fix_path(OSNode **path[], int depth) {
+    while (depth > 0) {
+        OSNode **l = path[--depth];
+        int old = (*l)->height;
+        *l = os_rebalance(*l);
+        if ((*l)->height == old) break;
+    }
+    while (depth > 0) {
+        OSNode *n = *path[--depth];
+        n->size = os_size(n->left) + os_size(n->right) + 1;
+    }
+}
+
+/* *made = ο νέος κόμβος ή NULL αν το όνομα υπήρχε ήδη */
+OSNode* os_avl_insert_node(OSNode *root, const Citizen *c, OSNode **made) {
+    uint64_t key = key_prefix(c->full_name);
+    OSNode **path[AVL_MAX_DEPTH];
+    int depth = 0;
+    OSNode **link = &root;
+    *made = NULL;
+    while (*link) {
+        int cmp = key_cmp(key, c->full_name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0) return root;
+        path[depth++] = link;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+    OSNode *n = (OSNode*)node_alloc(NULL, &os_mem, sizeof(OSNode));
+    n->key = key;
+    n->data = *c;
+    n->left = n->right = NULL;
+    n->height = n->size = 1;
+    *link = n;
+    *made = n;
+    os_avl_fix_path(path, depth);
+    return root;
+}
+
+OSNode* os_avl_insert(OSNode *root, const Citizen *c) {
+    OSNode *made;
+    return os_avl_insert_node(root, c, &made);
+}
+
+OSNode* os_avl_delete(OSNode *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    OSNode **path[AVL_MAX_DEPTH];
+    int depth = 0;
+    OSNode **link = &root;
+    while (*link) {
+        int cmp = key_cmp(key, name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0) break;
+        path[depth++] = link;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+    OSNode *z = *link;
+    if (!z) return root;
+    if (!z->left || !z->right) *link = z->left ? z->left : z->right;
+    else {
+        int zi = depth;
+        path[depth++] = link;
+        OSNode **sl = &z->right;
+        while ((*sl)->left) { path[depth++] = sl; sl = &(*sl)->left; }
+        OSNode *s = *sl;
+        *sl = s->right;
+        s->left = z->left; s->right = z->right; s->height = z->height;
+        *link = s;
+        if (depth > zi + 1) path[zi + 1] = &s->right;
+    }
+    node_free(NULL, &os_mem, z, sizeof(OSNode));
+    os_avl_fix_path(path, depth);
+    return root;
+}
+
+OSNode* os_avl_search(OSNode *n, const char *name) {
+    uint64_t key = key_prefix(name);
+    while (n) {
+        int cmp = key_cmp(key, name, n->key, n->data.full_name);
+        if (cmp == 0) return n;
+        n = (cmp < 0) ? n->left : n->right;
+    }
+    return NULL;
+}
+
+void os_avl_free(OSNode *root) {
+    if (!root) return;
+    os_avl_free(root->left);
+    os_avl_free(root->right);
+    node_free(NULL, &os_mem, root, sizeof(OSNode));
+}
+
+/* Πλήθος ονομάτων < name ή, με inclusive = 1, <= name */
+static size_t os_avl_below(const OSNode *n, const char *name, int inclusive) {
+    uint64_t key = key_prefix(name);
+    size_t below = 0;
+    while (n) {
+        int cmp = key_cmp(key, name, n->key, n->data.full_name);
+        if (cmp == 0) return below + os_size(n->left) + inclusive;
+        if (cmp < 0) n = n->left;
+        else { below += os_size(n->left) + 1; n = n->right; }
+    }
+    return below;
+}
+
+/* Θέση του name σε αλφαβητική σειρά (από 0) ή η θέση όπου θα έμπαινε */
+size_t os_avl_rank(const OSNode *root, const char *name) {
+    return os_avl_below(root, name, 0);
+}
+
+/* Ο k-οστός κόμβος (από 0) ή NULL */
+OSNode* os_avl_select(OSNode *n, size_t k) {
+    while (n) {
+        size_t left = os_size(n->left);
+        if (k == left) return n;
+        if (k < left) n = n->left;
+        else { k -= left + 1; n = n->right; }
+    }
+    return NULL;
+}
+
+/* Πλήθος εγγραφών με lo <= όνομα <= hi */
+size_t os_avl_count_range(const OSNode *root, const char *lo, const char *hi) {
+    size_t a = os_avl_below(root, lo, 0), b = os_avl_below(root, hi, 1);
+    return b > a ? b - a : 0;
+}
+
+/* Ο φρουρός δεν γράφεται ποτέ (όπως ο RBT_NIL) και έχει size 0 */
+static OSRBNode OS_NIL_NODE = {.color = 'B'};
+static OSRBNode *OS_NIL = &OS_NIL_NODE;
+
+static OSRBNode* os_rbt_rotate_left(OSRBNode *root, OSRBNode *x) {
+    OSRBNode *y = x->right;
+    x->right = y->left;
+    if (y->left != OS_NIL) y->left->parent = x;
+    y->parent = x->parent;
+    if (x->parent == OS_NIL) root = y;
+    else if (x == x->parent->left) x->parent->left = y;
+    else x->parent->right = y;
+    y->left = x; x->parent = y;
+    y->size = x->size;
+    x->size = x->left->size + x->right->size + 1;
+    return root;
+}
+
+static OSRBNode* os_rbt_rotate_right(OSRBNode *root, OSRBNode *y) {
+    OSRBNode *x = y->left;
+    y->left = x->right;
+    if (x->right != OS_NIL) x->right->parent = y;
+    x->parent = y->parent;
+    if (y->parent == OS_NIL) root = x;
+    else if (y == y->parent->left) y->parent->left = x;
+    else y->parent->right = x;
+    x->right = y; y->parent = x;
+    x->size = y->size;
+    y->size = y->left->size + y->right->size + 1;
+    return root;
+}
+
+static OSRBNode* os_rbt_insert_fixup(OSRBNode *root, OSRBNode *z) {
+    while (z->parent->color == 'R') {
+        OSRBNode *g = z->parent->parent;
+        if (z->parent == g->left) {
+            OSRBNode *u = g->right;
+            if (u->color == 'R') {
+                z->parent->color = 'B'; u->color = 'B';
+                g->color = 'R'; z = g;
+            } else {
+                if (z == z->parent->right) { z = z->parent; root = os_rbt_rotate_left(root, z); }
+                z->parent->color = 'B'; z->parent->parent->color = 'R';
+                root = os_rbt_rotate_right(root, z->parent->parent);
+            }
+        } else {
+            OSRBNode *u = g->left;
+            if (u->color == 'R') {
+                z->parent->color = 'B'; u->color = 'B';
+                g->color = 'R'; z = g;
+            } else {
+                if (z == z->parent->left) { z = z->parent; root = os_rbt_rotate_right(root, z); }
+                z->parent->color = 'B'; z->parent->parent->color = 'R';
+                root = os_rbt_rotate_left(root, z->parent->parent);
+            }
+        }
+    }
+    root->color = 'B';
+    return root;
+}
+
+/* Τα μεγέθη των προγόνων αυξάνονται μόνο αφού βρεθεί θέση (όχι για
+ * διπλότυπα) - ανάβαση από τον γονέα του νέου κόμβου */
+OSRBNode* os_rbt_insert(OSRBNode *root, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    OSRBNode *y = OS_NIL, *x = root ? root : OS_NIL;
+    int cmp = 0;
+    while (x != OS_NIL) {
+        y = x;
+        cmp = key_cmp(key, c->full_name, x->key, x->data.full_name);
+        if (cmp < 0) x = x->left;
+        else if (cmp > 0) x = x->right;
+        else return root;
+    }
+    OSRBNode *z = (OSRBNode*)node_alloc(NULL, &os_mem, sizeof(OSRBNode));
+    z->key = key;
+    z->data = *c;
+    z->left = z->right = OS_NIL;
+    z->parent = y;
+    z->size = 1;
+    z->color = 'R';
+    if (y == OS_NIL) root = z;
+    else if (cmp < 0) y->left = z;
+    else y->right = z;
+    for (OSRBNode *p = y; p != OS_NIL; p = p->parent) p->size++;
+    return os_rbt_insert_fixup(root, z);
+}
+
+static OSRBNode* os_rbt_transplant(OSRBNode *root, OSRBNode *u, OSRBNode *v) {
+    if (u->parent == OS_NIL) root = v;
+    else if (u == u->parent->left) u->parent->left = v;
+    else u->parent->right = v;
+    if (v != OS_NIL) v->parent = u->parent;
+    return root;
+}
+
+static OSRBNode* os_rbt_delete_fixup(OSRBNode *root, OSRBNode *x, OSRBNode *xp) {
+    while (x != root && x->color == 'B') {
+        if (x == xp->left) {
+            OSRBNode *w = xp->right;
+            if (w->color == 'R') {
+                w->color = 'B'; xp->color = 'R';
+                root = os_rbt_rotate_left(root, xp); w = xp->right;
+            }
+            if (w->left->color == 'B' && w->right->color == 'B') {
+                w->color = 'R'; x = xp; xp = x->parent;
+            } else {
+                if (w->right->color == 'B') {
+                    w->left->color = 'B'; w->color = 'R';
+                    root = os_rbt_rotate_right(root, w); w = xp->right;
+                }
+                w->color = xp->color; xp->color = 'B';
+                w->right->color = 'B'; root = os_rbt_rotate_left(root, xp);
+                x = root;
+            }
+        } else {
+            OSRBNode *w = xp->left;
+            if (w->color == 'R') {
+                w->color = 'B'; xp->color = 'R';
+                root = os_rbt_rotate_right(root, xp); w = xp->left;
+            }
+            if (w->right->color == 'B' && w->left->color == 'B') {
+                w->color = 'R'; x = xp; xp = x->parent;
+            } else {
+                if (w->left->color == 'B') {
+                    w->right->color = 'B'; w->color = 'R';
+                    root = os_rbt_rotate_left(root, w); w = xp->left;
+                }
+                w->color = xp->color; xp->color = 'B';
+                w->left->color = 'B'; root = os_rbt_rotate_right(root, xp);
+                x = root;
+            }
+        }
+    }
+    if (x != OS_NIL) x->color = 'B';
+    return root;
+}
+
+/* Από τη θέση του φεύγει ο z ή, με δύο παιδιά, ο διάδοχός του y: οι
+ * πρόγονοί του χάνουν έναν κόμβο πριν από οποιαδήποτε αλλαγή συνδέσμων και
+ * ο y παίρνει το (ήδη μειωμένο) μέγεθος του z */
+OSRBNode* os_rbt_delete(OSRBNode *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    OSRBNode *z = root ? root : OS_NIL;
+    while (z != OS_NIL) {
+        int cmp = key_cmp(key, name, z->key, z->data.full_name);
+        if (cmp == 0) break;
+        z = (cmp < 0) ? z->left : z->right;
+    }
+    if (z == OS_NIL) return root;
+
+    OSRBNode *y = z, *x, *xp = z->parent;
+    if (z->left != OS_NIL && z->right != OS_NIL) {
+        y = z->right;
+        while (y->left != OS_NIL) y = y->left;
+    }
+    for (OSRBNode *p = y->parent; p != OS_NIL; p = p->parent) p->size--;
+
+    char orig = y->color;
+    if (z->left == OS_NIL) { x = z->right; root = os_rbt_transplant(root, z, z->right); }
+    else if (z->right == OS_NIL) { x = z->left; root = os_rbt_transplant(root, z, z->left); }
+    else {
+        x = y->right;
+        if (y->parent == z) xp = y;
+        else { xp = y->parent; root = os_rbt_transplant(root, y, y->right); y->right = z->right; y->right->parent = y; }
+        root = os_rbt_transplant(root, z, y); y->left = z->left; y->left->parent = y;
+        y->color = z->color; y->size = z->size;
+    }
+    node_free(NULL, &os_mem, z, sizeof(OSRBNode));
+    if (orig == 'B') root = os_rbt_delete_fixup(root, x, xp);
+    return root;
+}
+
+void os_rbt_free(OSRBNode *root) {
+    if (!root || root == OS_NIL) return;
+    os_rbt_free(root->left);
+    os_rbt_free(root->right);
+    node_free(NULL, &os_mem, root, sizeof(OSRBNode));
+}
+
+static size_t os_rbt_below(const OSRBNode *n, const char *name, int inclusive) {
+    uint64_t key = key_prefix(name);
+    size_t below = 0;
+    while (n && n != OS_NIL) {
+        int cmp = key_cmp(key, name, n->key, n->data.full_name);
+        if (cmp == 0) return below + n->left->size + inclusive;
+        if (cmp < 0) n = n->left;
+        else { below += n->left->size + 1; n = n->right; }
+    }
+    return below;
+}
+
+size_t os_rbt_rank(const OSRBNode *root, const char *name) {
+    return os_rbt_below(root, name, 0);
+}
+
+OSRBNode* os_rbt_select(OSRBNode *n, size_t k) {
+    while (n && n != OS_NIL) {
+        size_t left = n->left->size;
+        if (k == left) return n;
+        if (k < left) n = n->left;
+        else { k -= left + 1; n = n->right; }
+    }
+    return NULL;
+}
+
+size_t os_rbt_count_range(const OSRBNode *root, const char *lo, const char *hi) {
+    size_t a = os_rbt_below(root, lo, 0), b = os_rbt_below(root, hi, 1);
+    return b > a ? b - a : 0;
+}
+
+/* ============ Hot/Cold Διαχωρισμός Εγγραφών ============ */
+
+/* Οι εγγραφές ζουν σε στηλοθήκη (RecordStore): τα ονόματα σε συνεχόμενο
+ * heap και τα ψυχρά πεδία (ηλικία, πολιτεία, εισόδημα) σε ξεχωριστές
+ * στήλες. Οι κόμβοι των HC δέντρων κρατούν μόνο τους δείκτες παιδιών, το
+ * id της εγγραφής και τα πρώτα 8 bytes του ονόματος ως ακέραιο (hot key).
+ * Οι περισσότερες συγκρίσεις λύνονται μέσα στον κόμβο και το heap
+ * ονομάτων διαβάζεται μόνο όταν τα 8 bytes ταυτίζονται. Το store είναι
+ * append-only: η διαγραφή από το δέντρο δεν ανακτά τον χώρο της εγγραφής. */
+
+#define RS_MAX_STATES 65536       /* θέσεις λεξικού σε uint16_t */
+#define RS_NONE UINT32_MAX
+
+typedef struct {
+    char *names;              /* heap ονομάτων (NUL-terminated) */
+    uint64_t *name_off;       /* offset κάθε ονόματος στο heap */
+    int *age;
+    uint16_t *state;          /* θέση στο λεξικό πολιτειών */
+    int *income;
+    char (*state_dict)[50];   /* μεγαλώνει με realloc ως RS_MAX_STATES */
+    int state_count, state_cap;
+    uint32_t count, cap;
+    size_t heap_len, heap_cap;
+} RecordStore;
+
+void rs_init(RecordStore *rs) {
+    memset(rs, 0, sizeof(*rs));
+}
+
+void rs_free(RecordStore *rs) {
+    free(rs->names); free(rs->name_off);
+    free(rs->age); free(rs->state); free(rs->income);
+    free(rs->state_dict);
+    rs_init(rs);
+}
+
+/* Θέση της πολιτείας στο λεξικό (νέα αν λείπει) ή -1 αν είναι γεμάτο */
+static int rs_state_id(RecordStore *rs, const char *state) {
+    for (int i = 0; i < rs->state_count; i++)
+        if (strcmp(rs->state_dict[i], state) == 0) return i;
+    if (rs->state_count == RS_MAX_STATES) return -1;
+    if (rs->state_count == rs->state_cap) {
+        rs->state_cap = rs->state_cap ? rs->state_cap * 2 : 64;
+        rs->state_dict = (char(*)[50])realloc(rs->state_dict, rs->state_cap * sizeof(*rs->state_dict));
+    }
+    snprintf(rs->state_dict[rs->state_count], 50, "%s", state);
+    return rs->state_count++;
+}
+
+/* Προσθήκη εγγραφής - επιστρέφει το id της ή RS_NONE (χωρίς αλλαγή στο
+ * store) αν το λεξικό έχει ήδη RS_MAX_STATES πολιτείες */
+uint32_t rs_add(RecordStore *rs, const Citizen *c) {
+    int state = rs_state_id(rs, c->state);
+    if (state < 0) return RS_NONE;
+    if (rs->count == rs->cap) {
+        rs->cap = rs->cap ? rs->cap * 2 : 1024;
+        rs->name_off = (uint64_t*)realloc(rs->name_off, rs->cap * sizeof(uint64_t));
+        rs->age = (int*)realloc(rs->age, rs->cap * sizeof(int));
+        rs->state = (uint16_t*)realloc(rs->state, rs->cap * sizeof(uint16_t));
+        rs->income = (int*)realloc(rs->income, rs->cap * sizeof(int));
+    }
+    size_t len = strlen(c->full_name) + 1;
+    if (rs->heap_len + len > rs->heap_cap) {
+        rs->heap_cap = rs->heap_cap ? rs->heap_cap * 2 : 16384;
+        rs->names = (char*)realloc(rs->names, rs->heap_cap);
+    }
+    uint32_t id = rs->count++;
+    memcpy(rs->names + rs->heap_len, c->full_name, len);
+    rs->name_off[id] = rs->heap_len;
+    rs->heap_len += len;
+    rs->age[id] = c->age;
+    rs->state[id] = (uint16_t)state;
+    rs->income[id] = c->annual_income;
+    return id;
+}
+
+static inline const char* rs_name(const RecordStore *rs, uint32_t id) {
+    return rs->names + rs->name_off[id];
+}
+
+/* Ανασύνθεση πλήρους εγγραφής από τις στήλες */
+void rs_get(const RecordStore *rs, uint32_t id, Citizen *out) {
+    strncpy(out->full_name, rs_name(rs, id), 99);
+    out->full_name[99] = '\0';
+    out->age = rs->age[id];
+    strcpy(out->state, rs->state_dict[rs->state[id]]);
+    out->annual_income = rs->income[id];
+}
+
+/* Κόμβοι HC: σύνδεσμοι, hot key και αναφορά εγγραφής */
+typedef struct HCNode {
+    struct HCNode *left;
+    struct HCNode *right;
+    uint64_t key;
+    uint32_t rec;
+    int height;
+} HCNode;
+
+typedef struct HCRBTNode {
+    struct HCRBTNode *left;
+    struct HCRBTNode *right;
+    struct HCRBTNode *parent;
+    uint64_t key;
+    uint32_t rec;
+    char color;
+} HCRBTNode;
+
+/* Σύγκριση με hot key και, σε ισοπαλία, με το πλήρες όνομα του store */
+static inline int hc_cmp(const RecordStore *rs, uint64_t key, const char *name,
+                         uint64_t node_key, uint32_t node_rec) {
+    return key_cmp(key, name, node_key, rs_name(rs, node_rec));
+}
+
+/* --- HC BST --- */
+
+HCNode* hc_create(uint64_t key, uint32_t rec) {
+    HCNode *n = (HCNode*)malloc(sizeof(HCNode));
+    n->left = n->right = NULL;
+    n->key = key;
+    n->rec = rec;
+    n->height = 1;
+    return n;
+}
+
+static HCNode* hc_bst_insert_key(HCNode *root, const RecordStore *rs, uint64_t key, uint32_t rec) {
+    if (!root) return hc_create(key, rec);
+    int cmp = hc_cmp(rs, key, rs_name(rs, rec), root->key, root->rec);
+    if (cmp < 0) root->left = hc_bst_insert_key(root->left, rs, key, rec);
+    else if (cmp > 0) root->right = hc_bst_insert_key(root->right, rs, key, rec);
+    return root;
+}
+
+HCNode* hc_bst_insert(HCNode *root, const RecordStore *rs, uint32_t rec) {
+    return hc_bst_insert_key(root, rs, key_prefix(rs_name(rs, rec)), rec);
+}
+
+HCNode* hc_find_min(HCNode *root) {
+    while (root && root->left) root = root->left;
+    return root;
+}
+
+static HCNode* hc_bst_delete_key(HCNode *root, const RecordStore *rs, uint64_t key, const char *name) {
+    if (!root) return NULL;
+    int cmp = hc_cmp(rs, key, name, root->key, root->rec);
+    if (cmp < 0) root->left = hc_bst_delete_key(root->left, rs, key, name);
+    else if (cmp > 0) root->right = hc_bst_delete_key(root->right, rs, key, name);
+    else {
+        if (!root->left) { HCNode *t = root->right; free(root); return t; }
+        if (!root->right) { HCNode *t = root->left; free(root); return t; }
+        /* Μετακινούνται μόνο key και id, όχι ολόκληρη η εγγραφή */
+        HCNode *s = hc_find_min(root->right);
+        root->key = s->key;
+        root->rec = s->rec;
+        root->right = hc_bst_delete_key(root->right, rs, s->key, rs_name(rs, s->rec));
+    }
+    return root;
+}
+
+HCNode* hc_bst_delete(HCNode *root, const RecordStore *rs, const char *name) {
+    return hc_bst_delete_key(root, rs, key_prefix(name), name);
+}
+
+HCNode* hc_bst_search(HCNode *root, const RecordStore *rs, const char *name) {
+    uint64_t key = key_prefix(name);
+    while (root) {
+        int cmp = hc_cmp(rs, key, name, root->key, root->rec);
+        if (cmp == 0) return root;
+        root = (cmp < 0) ? root->left : root->right;
+    }
+    return NULL;
+}
+
+void hc_bst_free(HCNode *root) {
+    while (root) {
+        HCNode *next = root->left;
+        if (next) { root->left = next->right; next->right = root; }
+        else { next = root->right; free(root); }
+        root = next;
+    }
+}
+
+/* --- HC AVL --- */
+
+int hc_height(HCNode *n) { return n ? n->height : 0; }
+int hc_balance(HCNode *n) { return n ? hc_height(n->left) - hc_height(n->right) : 0; }
+static void hc_update(HCNode *n) { n->height = avl_max(hc_height(n->left), hc_height(n->right)) + 1; }
+
+HCNode* hc_rotate_right(HCNode *y) {
+    HCNode *x = y->left;
+    y->left = x->right; x->right = y;
+    hc_update(y); hc_update(x);
+    return x;
+}
+
+HCNode* hc_rotate_left(HCNode *x) {
+    HCNode *y = x->right;
+    x->right = y->left; y->left = x;
+    hc_update(x); hc_update(y);
+    return y;
+}
+
+static HCNode* hc_rebalance(HCNode *root) {
+    hc_update(root);
+    int bal = hc_balance(root);
+    if (bal > 1) {
+        if (hc_balance(root->left) < 0) root->left = hc_rotate_left(root->left);
+        return hc_rotate_right(root);
+    }
+    if (bal < -1) {
+        if (hc_balance(root->right) > 0) root->right = hc_rotate_right(root->right);
+        return hc_rotate_left(root);
+    }
+    return root;
+}
+
+static HCNode* hc_avl_insert_key(HCNode *root, const RecordStore *rs, uint64_t key, uint32_t rec) {
+    if (!root) return hc_create(key, rec);
+    int cmp = hc_cmp(rs, key, rs_name(rs, rec), root->key, root->rec);
+    if (cmp < 0) root->left = hc_avl_insert_key(root->left, rs, key, rec);
+    else if (cmp > 0) root->right = hc_avl_insert_key(root->right, rs, key, rec);
+    else return root;
+    return hc_rebalance(root);
+}
+
+HCNode* hc_avl_insert(HCNode *root, const RecordStore *rs, uint32_t rec) {
+    return hc_avl_insert_key(root, rs, key_prefix(rs_name(rs, rec)), rec);
+}
+
+static HCNode* hc_avl_delete_key(HCNode *root, const RecordStore *rs, uint64_t key, const char *name) {
+    if (!root) return NULL;
+    int cmp = hc_cmp(rs, key, name, root->key, root->rec);
+    if (cmp < 0) root->left = hc_avl_delete_key(root->left, rs, key, name);
+    else if (cmp > 0) root->right = hc_avl_delete_key(root->right, rs, key, name);
+    else {
+        if (!root->left || !root->right) {
+            HCNode *t = root->left ? root->left : root->right;
+            free(root);
+            return t;
+        }
+        HCNode *s = hc_find_min(root->right);
+        root->key = s->key;
+        root->rec = s->rec;
+        root->right = hc_avl_delete_key(root->right, rs, s->key, rs_name(rs, s->rec));
+    }
+    return hc_rebalance(root);
+}
+
+HCNode* hc_avl_delete(HCNode *root, const RecordStore *rs, const char *name) {
+    return hc_avl_delete_key(root, rs, key_prefix(name), name);
+}
+
+/* --- HC Red-Black --- */
+
+static HCRBTNode HC_NIL_NODE = {NULL, NULL, NULL, 0, 0, 'B'};
+static HCRBTNode *HC_NIL = &HC_NIL_NODE;
+
+HCRBTNode* hc_rbt_rotate_left(HCRBTNode *root, HCRBTNode *x) {
+    HCRBTNode *y = x->right;
+    x->right = y->left;
+    if (y->left != HC_NIL) y->left->parent = x;
+    y->parent = x->parent;
+    if (x->parent == HC_NIL) root = y;
+    else if (x == x->parent->left) x->parent->left = y;
+    else x->parent->right = y;
+    y->left = x; x->parent = y;
+    return root;
+}
+
+HCRBTNode* hc_rbt_rotate_right(HCRBTNode *root, HCRBTNode *y) {
+    HCRBTNode *x = y->left;
+    y->left = x->right;
+    if (x->right != HC_NIL) x->right->parent = y;
+    x->parent = y->parent;
+    if (y->parent == HC_NIL) root = x;
+    else if (y == y->parent->left) y->parent->left = x;
+    else y->parent->right = x;
+    x->right = y; y->parent = x;
+    return root;
+}
+
+HCRBTNode* hc_rbt_insert_fixup(HCRBTNode *root, HCRBTNode *z) {
+    while (z->parent->color == 'R') {
+        if (z->parent == z->parent->parent->left) {
+            HCRBTNode *u = z->parent->parent->right;
+            if (u->color == 'R') {
+                z->parent->color = 'B'; u->color = 'B';
+                z->parent->parent->color = 'R'; z = z->parent->parent;
+            } else {
+                if (z == z->parent->right) { z = z->parent; root = hc_rbt_rotate_left(root, z); }
+                z->parent->color = 'B'; z->parent->parent->color = 'R';
+                root = hc_rbt_rotate_right(root, z->parent->parent);
+            }
+        } else {
+            HCRBTNode *u = z->parent->parent->left;
+            if (u->color == 'R') {
+                z->parent->color = 'B'; u->color = 'B';
+                z->parent->parent->color = 'R'; z = z->parent->parent;
+            } else {
+                if (z == z->parent->left) { z = z->parent; root = hc_rbt_rotate_right(root, z); }
+                z->parent->color = 'B'; z->parent->parent->color = 'R';
+                root = hc_rbt_rotate_left(root, z->parent->parent);
+            }
+        }
+    }
+    root->color = 'B';
+    return root;
+}
+
+HCRBTNode* hc_rbt_insert(HCRBTNode *root, const RecordStore *rs, uint32_t rec) {
+    const char *name = rs_name(rs, rec);
+    uint64_t key = key_prefix(name);
+    HCRBTNode *y = HC_NIL, *x = root ? root : HC_NIL;
+    int cmp = 0;
+    while (x != HC_NIL) {
+        y = x;
+        cmp = hc_cmp(rs, key, name, x->key, x->rec);
+        if (cmp < 0) x = x->left;
+        else if (cmp > 0) x = x->right;
+        else return root;
+    }
+    HCRBTNode *z = (HCRBTNode*)malloc(sizeof(HCRBTNode));
+    z->left = z->right = HC_NIL;
+    z->parent = y;
+    z->key = key;
+    z->rec = rec;
+    z->color = 'R';
+    if (y == HC_NIL) root = z;
+    else if (cmp < 0) y->left = z;
+    else y->right = z;
+    return hc_rbt_insert_fixup(root, z);
+}
+
+HCRBTNode* hc_rbt_transplant(HCRBTNode *root, HCRBTNode *u, HCRBTNode *v) {
+    if (u->parent == HC_NIL) root = v;
+    else if (u == u->parent->left) u->parent->left = v;
+    else u->parent->right = v;
+    v->parent = u->parent;
+    return root;
+}
+
+HCRBTNode* hc_rbt_delete_fixup(HCRBTNode *root, HCRBTNode *x) {
+    while (x != root && x->color == 'B') {
+        if (x == x->parent->left) {
+            HCRBTNode *w = x->parent->right;
+            if (w->color == 'R') {
+                w->color = 'B'; x->parent->color = 'R';
+                root = hc_rbt_rotate_left(root, x->parent); w = x->parent->right;
+            }
+            if (w->left->color == 'B' && w->right->color == 'B') {
+                w->color = 'R'; x = x->parent;
+            } else {
+                if (w->right->color == 'B') {
+                    w->left->color = 'B'; w->color = 'R';
+                    root = hc_rbt_rotate_right(root, w); w = x->parent->right;
+                }
+                w->color = x->parent->color; x->parent->color = 'B';
+                w->right->color = 'B'; root = hc_rbt_rotate_left(root, x->parent);
+                x = root;
+            }
+        } else {
+            HCRBTNode *w = x->parent->left;
+            if (w->color == 'R') {
+                w->color = 'B'; x->parent->color = 'R';
+                root = hc_rbt_rotate_right(root, x->parent); w = x->parent->left;
+            }
+            if (w->right->color == 'B' && w->left->color == 'B') {
+                w->color = 'R'; x = x->parent;
+            } else {
+                if (w->left->color == 'B') {
+                    w->right->color = 'B'; w->color = 'R';
+                    root = hc_rbt_rotate_left(root, w); w = x->parent->left;
+                }
+                w->color = x->parent->color; x->parent->color = 'B';
+                w->left->color = 'B'; root = hc_rbt_rotate_right(root, x->parent);
+                x = root;
+            }
+        }
+    }
+    x->color = 'B';
+    return root;
+}
+
+HCRBTNode* hc_rbt_delete(HCRBTNode *root, const RecordStore *rs, const char *name) {
+    uint64_t key = key_prefix(name);
+    HCRBTNode *z = root ? root : HC_NIL;
+    while (z != HC_NIL) {
+        int cmp = hc_cmp(rs, key, name, z->key, z->rec);
+        if (cmp == 0) break;
+        z = (cmp < 0) ? z->left : z->right;
+    }
+    if (z == HC_NIL) return root;
+
+    HCRBTNode *y = z, *x;
+    char orig = y->color;
+    if (z->left == HC_NIL) { x = z->right; root = hc_rbt_transplant(root, z, z->right); }
+    else if (z->right == HC_NIL) { x = z->left; root = hc_rbt_transplant(root, z, z->left); }
+    else {
+        y = z->right;
+        while (y->left != HC_NIL) y = y->left;
+        orig = y->color; x = y->right;
+        if (y->parent == z) { x->parent = y; }
+        else { root = hc_rbt_transplant(root, y, y->right); y->right = z->right; y->right->parent = y; }
+        root = hc_rbt_transplant(root, z, y); y->left = z->left; y->left->parent = y; y->color = z->color;
+    }
+    free(z);
+    if (orig == 'B') root = hc_rbt_delete_fixup(root, x);
+    return root == HC_NIL ? NULL : root;
+}
+
+HCRBTNode* hc_rbt_search(HCRBTNode *root, const RecordStore *rs, const char *name) {
+    if (!root) return NULL;
+    uint64_t key = key_prefix(name);
+    while (root != HC_NIL) {
+        int cmp = hc_cmp(rs, key, name, root->key, root->rec);
+        if (cmp == 0) return root;
+        root = (cmp < 0) ? root->left : root->right;
+    }
+    return NULL;
+}
+
+void hc_rbt_free(HCRBTNode *root) {
+    if (!root || root == HC_NIL) return;
+    hc_rbt_free(root->left);
+    hc_rbt_free(root->right);
+    free(root);
+}
+
+/* ============ Παγωμένο Ευρετήριο (Eytzinger) ============ */
+
+/* Αμετάβλητο αντίγραφο ενός δέντρου για φάσεις μόνο-ανάγνωσης. Τα προθέματα
+ * των κλειδιών αποθηκεύονται σε διάταξη Eytzinger (σειρά BFS: ρίζα στη θέση 1,
+ * παιδιά του k στις 2k και 2k+1). Οι απόγονοι 3 επιπέδων κάτω από τον k είναι
+ * οι 8 συνεχόμενες θέσεις 8k..8k+7, δηλαδή μία cache line, που προφορτώνεται
+ * όσο γίνονται οι συγκρίσεις των ενδιάμεσων επιπέδων. Οι εγγραφές δείχνουν στα
+ * δεδομένα του δέντρου, το οποίο πρέπει να ζει όσο και το ευρετήριο. */
+
+#ifndef FROZEN_SIMD
+#define FROZEN_SIMD 1           /* σύγκριση προθεμάτων με AVX2 όταν υπάρχει */
+#endif
+#if FROZEN_SIMD && defined(__AVX2__)
+#define FROZEN_USE_AVX2 1
+#else
+#define FROZEN_USE_AVX2 0
+#endif
+#define FROZEN_SCAN_MAX 32      /* μέγιστη γραμμική σάρωση ομάδας ίσων προθεμάτων */
+
+typedef struct {
+    int n, cap;
+    uint64_t *eytz;         /* n + 1 προθέματα σε σειρά Eytzinger (θέση 0 αχρησιμοποίητη) */
+    uint32_t *eytz_rank;    /* θέση Eytzinger -> τάξη, eytz_rank[0] = n */
+    uint64_t *keys;         /* προθέματα σε αλφαβητική σειρά */
+    Citizen **rec;          /* εγγραφές σε αλφαβητική σειρά */
+} FrozenIndex;
+
+static void frozen_push(FrozenIndex *fi, uint64_t key, Citizen *c) {
+    if (fi->n == fi->cap) {
+        fi->cap = fi->cap ? fi->cap * 2 : 1024;
+        fi->keys = (uint64_t*)realloc(fi->keys, fi->cap * sizeof(uint64_t));
+        fi->rec = (Citizen**)realloc(fi->rec, fi->cap * sizeof(Citizen*));
+    }
+    fi->keys[fi->n] = key;
+    fi->rec[fi->n++] = c;
+}
+
+/* In-order γέμισμα των θέσεων Eytzinger από τον ταξινομημένο πίνακα */
+static void frozen_fill(FrozenIndex *fi, int *i, size_t k) {
+    if (k > (size_t)fi->n) return;
+    frozen_fill(fi, i, 2 * k);
+    fi->eytz[k] = fi->keys[*i];
+    fi->eytz_rank[k] = (uint32_t)(*i)++;
+    frozen_fill(fi, i, 2 * k + 1);
+}
+
+static FrozenIndex* frozen_finish(FrozenIndex *fi) {
+    void *mem;
+    if (posix_memalign(&mem, 64, (fi->n + 1) * sizeof(uint64_t))) { printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n"); exit(1); }
+    fi->eytz = (uint64_t*)mem;
+    fi->eytz_rank = (uint32_t*)malloc((fi->n + 1) * sizeof(uint32_t));
+    fi->eytz[0] = 0;
+    fi->eytz_rank[0] = (uint32_t)fi->n;
+    int i = 0;
+    frozen_fill(fi, &i, 1);
+    return fi;
+}
+
+static void frozen_collect_bst(FrozenIndex *fi, BSTNode *root) {
+    if (!root) return;
+    frozen_collect_bst(fi, root->left);
+    frozen_push(fi, root->key, &root->data);
+    frozen_collect_bst(fi, root->right);
+}
+
+static void frozen_collect_rbt(FrozenIndex *fi, RBTNode *root) {
+    if (!root || root == RBT_NIL) return;
+    frozen_collect_rbt(fi, root->left);
+    frozen_push(fi, root->key, &root->data);
+    frozen_collect_rbt(fi, root->right);
+}
+
+/* "Πάγωμα" ενός έτοιμου δέντρου (BST/AVL, RBT ή B+) */
+FrozenIndex* frozen_from_bst(BSTNode *root) {
+    FrozenIndex *fi = (FrozenIndex*)calloc(1, sizeof(FrozenIndex));
+    frozen_collect_bst(fi, root);
+    return frozen_finish(fi);
+}
+
+FrozenIndex* frozen_from_rbt(RBTNode *root) {
+    FrozenIndex *fi = (FrozenIndex*)calloc(1, sizeof(FrozenIndex));
+    frozen_collect_rbt(fi, root);
+    return frozen_finish(fi);
+}
+
+FrozenIndex* frozen_from_bpt(BPTNode *root) {
+    FrozenIndex *fi = (FrozenIndex*)calloc(1, sizeof(FrozenIndex));
+    while (root && !root->is_leaf) root = root->u.in.child[0];
+    for (; root; root = root->u.leaf.next)
+        for (int i = 0; i < root->n; i++) frozen_push(fi, root->keys[i], root->u.leaf.rec[i]);
+    return frozen_finish(fi);
+}
+
+void frozen_free(FrozenIndex *fi) {
+    if (!fi) return;
+    free(fi->eytz); free(fi->eytz_rank); free(fi->keys); free(fi->rec);
+    free(fi);
+}
+
+/* Branchless κατάβαση: θέση Eytzinger του πρώτου προθέματος >= key (0 αν
+ * κανένα). Το k κρατά το μονοπάτι ως bits (1 = δεξιά), οπότε στο τέλος
+ * αφαιρούνται οι τελευταίες δεξιές στροφές και η αριστερή πριν από αυτές. */
+static inline size_t frozen_descend(const FrozenIndex *fi, uint64_t key) {
+    const uint64_t *e = fi->eytz;
+    size_t k = 1, n = (size_t)fi->n;
+    while (k <= n) {
+        __builtin_prefetch(e + 8 * k);
+        k = 2 * k + (e[k] < key);
+    }
+    return k >> __builtin_ffsll((long long)~k);
+}
+
+/* Τέλος της ομάδας ίσων προθεμάτων που ξεκινά στην τάξη lo */
+static int frozen_prefix_run_end(const FrozenIndex *fi, int lo, uint64_t key) {
+    int i = lo + 1, lim = lo + FROZEN_SCAN_MAX < fi->n ? lo + FROZEN_SCAN_MAX : fi->n;
+#if FROZEN_USE_AVX2
+    __m256i v = _mm256_set1_epi64x((long long)key);
+    for (; i + 4 <= lim; i += 4) {
+        __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(fi->keys + i)), v);
+        int m = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        if (m != 0xF) return i + __builtin_ctz(~m);
+    }
+#endif
+    for (; i < lim; i++) if (fi->keys[i] != key) return i;
+    if (lim == fi->n) return lim;
+    /* Μεγάλη ομάδα: δεύτερη κατάβαση για το πρώτο πρόθεμα > key */
+    return key == UINT64_MAX ? fi->n : (int)fi->eytz_rank[frozen_descend(fi, key + 1)];
+}
+
+/* Τάξη του πρώτου ονόματος >= name (n αν δεν υπάρχει) */
+int frozen_lower_bound(const FrozenIndex *fi, const char *name) {
+    uint64_t key = key_prefix(name);
+    int lo = (int)fi->eytz_rank[frozen_descend(fi, key)];
+    if (lo == fi->n || fi->keys[lo] != key || (key & 0xFF) == 0) return lo;
+    /* Ίδιο πρόθεμα: δυαδική αναζήτηση με strcmp από το 9ο byte μέσα στην ομάδα */
+    int hi = frozen_prefix_run_end(fi, lo, key);
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (strcmp(fi->rec[mid]->full_name + 8, name + 8) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+Citizen* frozen_search(const FrozenIndex *fi, const char *name) {
+    int r = frozen_lower_bound(fi, name);
+    return (r < fi->n && strcmp(fi->rec[r]->full_name, name) == 0) ? fi->rec[r] : NULL;
+}
+
+/* Εγγραφή με τάξη r (0-based) σε αλφαβητική σειρά */
+Citizen* frozen_select(const FrozenIndex *fi, int r) {
+    return (r >= 0 && r < fi->n) ? fi->rec[r] : NULL;
+}
+
+/* Σάρωση εύρους [lo, hi): αντιγράφει έως max εγγραφές στο out και επιστρέφει
+ * το συνολικό πλήθος, που προκύπτει από τη διαφορά των τάξεων */
+int frozen_range(const FrozenIndex *fi, const char *lo, const char *hi, Citizen **out, int max) {
+    int a = frozen_lower_bound(fi, lo), b = frozen_lower_bound(fi, hi);
+    if (b <= a) return 0;
+    int m = b - a < max ? b - a : max;
+    if (out && m > 0) memcpy(out, fi->rec + a, m * sizeof(Citizen*));
+    return b - a;
+}
+
+/* ============ Ομαδικές Αναζητήσεις ============ */
+
+/* Αναζήτηση πολλών ονομάτων μαζί, σε στυλ AMAC (asynchronous memory access
+ * chaining): έως BATCH_GROUP αναζητήσεις βρίσκονται σε εξέλιξη, καθεμία με
+ * δική της κατάσταση (τρέχων κόμβος, κλειδί). Σε κάθε γύρο κάθε αναζήτηση
+ * κατεβαίνει ένα επίπεδο και κάνει prefetch τον επόμενο κόμβο της, οπότε ως
+ * τον επόμενο γύρο οι αστοχίες cache όλης της ομάδας εξελίσσονται παράλληλα
+ * αντί για μία κάθε φορά. Όποια αναζήτηση τελειώνει δίνει αμέσως τη θέση της
+ * στο επόμενο όνομα της παρτίδας. Τα αποτελέσματα γράφονται στο out[i]
+ * (NULL αν δεν βρέθηκε), όπως θα τα έδινε η απλή αναζήτηση. */
+#define BATCH_GROUP 16
+
+typedef struct {
+    const void *node;
+    uint64_t key;
+    int idx;
+} BatchState;
+
+/* Γεμίζει τη θέση s με την επόμενη αναζήτηση - 0 αν δεν υπάρχουν άλλες */
+static inline int batch_next(BatchState *st, int s, const void *root, const char *const *names, int n, int *next) {
+    if (*next >= n) return 0;
+    st[s].node = root;
+    st[s].key = key_prefix(names[*next]);
+    st[s].idx = (*next)++;
+    return 1;
+}
+
+/* BST και AVL */
+void bst_search_batch(BSTNode *root, const char *const *names, int n, BSTNode **out) {
+    BatchState st[BATCH_GROUP];
+    int next = 0, active = 0;
+    while (active < BATCH_GROUP && batch_next(st, active, root, names, n, &next)) active++;
+    while (active) {
+        for (int s = 0; s < active;) {
+            const BSTNode *x = (const BSTNode*)st[s].node;
+            int cmp = x ? key_cmp(st[s].key, names[st[s].idx], x->key, x->data.full_name) : 0;
+            if (x && cmp) {
+                x = cmp < 0 ? x->left : x->right;
+                __builtin_prefetch(x);
+                st[s++].node = x;
+                continue;
+            }
+            out[st[s].idx] = (BSTNode*)x;
+            if (!batch_next(st, s, root, names, n, &next)) st[s] = st[--active];
+        }
+    }
+}
+
+void rbt_search_batch(RBTNode *root, const char *const *names, int n, RBTNode **out) {
+    BatchState st[BATCH_GROUP];
+    int next = 0, active = 0;
+    if (root == RBT_NIL) root = NULL;
+    while (active < BATCH_GROUP && batch_next(st, active, root, names, n, &next)) active++;
+    while (active) {
+        for (int s = 0; s < active;) {
+            const RBTNode *x = (const RBTNode*)st[s].node;
+            int cmp = x ? key_cmp(st[s].key, names[st[s].idx], x->key, x->data.full_name) : 0;
+            if (x && cmp) {
+                x = cmp < 0 ? x->left : x->right;
+                if (x == RBT_NIL) x = NULL;
+                __builtin_prefetch(x);
+                st[s++].node = x;
+                continue;
+            }
+            out[st[s].idx] = (RBTNode*)x;
+            if (!batch_next(st, s, root, names, n, &next)) st[s] = st[--active];
+        }
+    }
+}
+
+/* Ο κόμβος B+ πιάνει πολλές cache lines: prefetch των κλειδιών και των
+ * δεικτών παιδιών, όσα διαβάζει η κατάβαση */
+static inline void bpt_prefetch(const BPTNode *x) {
+    const char *p = (const char*)x;
+    for (size_t off = 0; off < offsetof(BPTNode, u) + sizeof(x->u.in.child); off += 64) __builtin_prefetch(p + off);
+}
+
+void bpt_search_batch(BPTNode *root, const char *const *names, int n, Citizen **out) {
+    BatchState st[BATCH_GROUP];
+    int next = 0, active = 0;
+    while (active < BATCH_GROUP && batch_next(st, active, root, names, n, &next)) active++;
+    while (active) {
+        for (int s = 0; s < active;) {
+            const BPTNode *x = (const BPTNode*)st[s].node;
+            const char *name = names[st[s].idx];
+            if (x && !x->is_leaf) {
+                x = x->u.in.child[bpt_child_index(x, st[s].key, name)];
+                bpt_prefetch(x);
+                st[s++].node = x;
+                continue;
+            }
+            int found = 0, pos = x ? bpt_leaf_pos(x, st[s].key, name, &found) : 0;
+            out[st[s].idx] = found ? x->u.leaf.rec[pos] : NULL;
+            if (!batch_next(st, s, root, names, n, &next)) st[s] = st[--active];
+        }
+    }
+}
+
+/* ============ Red-Black με Αναγνώστες χωρίς Κλειδώματα ============ */
+
+/* Ένας writer και πολλοί αναγνώστες που δεν παίρνουν κανένα lock. Ο writer
+ * δεν αλλάζει ποτέ κόμβο που έχει δημοσιευτεί: πριν από κάθε αλλαγή (σύνδεσμο,
+ * χρώμα, περιστροφή) ο κόμβος αντιγράφεται (cow_own), οπότε ένα insert/delete
+ * φτιάχνει νέο μονοπάτι από τη ρίζα ως το σημείο της αλλαγής, μαζί με όσους
+ * αδελφούς και θείους αγγίζει το fixup. Στο τέλος η νέα ρίζα δημοσιεύεται με
+ * release store και κάθε αναγνώστης βλέπει ολόκληρη είτε την παλιά είτε τη νέα
+ * έκδοση. Οι κόμβοι δεν έχουν δείκτη γονέα (θα έπρεπε να αντιγράφονται και τα
+ * παιδιά σε κάθε αντιγραφή), οπότε τα fixup δουλεύουν με τη στοίβα του
+ * μονοπατιού. Η εγγραφή είναι ξεχωριστή και τη μοιράζονται τα αντίγραφα.
+ *
+ * Ανακύκλωση με εποχές (EBR): ο αναγνώστης δηλώνει την τρέχουσα εποχή στη
+ * θέση του πριν διαβάσει τη ρίζα και τη μηδενίζει στο τέλος. Ό,τι αντικαθιστά
+ * ή διαγράφει ο writer μπαίνει σε λίστα με την εποχή της δημοσίευσης, και η
+ * εποχή μετά αυξάνεται. Ένα στοιχείο ελευθερώνεται όταν κάθε ενεργός
+ * αναγνώστης έχει δηλώσει μεγαλύτερη εποχή, άρα έχει διαβάσει νεότερη ρίζα. */
+#define COW_MAX_READERS 64
+#define COW_MAX_DEPTH 128           /* ύψος RBT <= 2 log2(n + 1) */
+#define COW_RECLAIM_BATCH 1024      /* μέγεθος λίστας που πυροδοτεί ανακύκλωση */
+
+typedef struct CowNode {
+    uint64_t key;
+    struct CowNode *child[2];       /* 0 = αριστερά, 1 = δεξιά */
+    const Citizen *rec;
+    uint64_t version;               /* έκδοση δημιουργίας - αλλάζει επιτόπου μόνο στην τρέχουσα */
+    char color;
+} CowNode;
+
+/* Μία cache line ανά αναγνώστη, ώστε οι δηλώσεις εποχής να μη συγκρούονται */
+typedef struct {
+    uint64_t epoch;                 /* 0 = εκτός ανάγνωσης */
+    int used;
+    char pad[64 - sizeof(uint64_t) - sizeof(int)];
+} CowReaderSlot;
+
+typedef struct {
+    void *ptr;
+    uint64_t epoch;
+} CowRetired;
+
+typedef struct {
+    CowNode *root;                  /* δημοσιευμένη ρίζα */
+    uint64_t epoch;                 /* καθολική εποχή, ξεκινά από 1 */
+    char pad[64 - sizeof(CowNode*) - sizeof(uint64_t)];
+    CowReaderSlot readers[COW_MAX_READERS];
+    /* Μόνο ο writer */
+    uint64_t version;               /* έκδοση που χτίζεται */
+    CowRetired *limbo;
+    size_t limbo_len, limbo_cap, limbo_tagged;
+    size_t count, copies, freed;
+} CowTree;
+
+CowTree* cow_create(void) {
+    void *mem;
+    if (posix_memalign(&mem, 64, sizeof(CowTree))) { printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n"); exit(1); }
+    CowTree *t = (CowTree*)memset(mem, 0, sizeof(CowTree));
+    t->epoch = 1;
+    t->version = 1;
+    return t;
+}
+
+static CowNode* cow_new(CowTree *t, uint64_t key, const Citizen *rec) {
+    CowNode *n = (CowNode*)malloc(sizeof(CowNode));
+    n->key = key;
+    n->child[0] = n->child[1] = NULL;
+    n->rec = rec;
+    n->version = t->version;
+    n->color = 'R';
+    return n;
+}
+
+/* Το ptr θα ελευθερωθεί όταν κανένας αναγνώστης δεν μπορεί να το βλέπει */
+static void cow_retire(CowTree *t, const void *ptr) {
+    if (t->limbo_len == t->limbo_cap) {
+        t->limbo_cap = t->limbo_cap ? t->limbo_cap * 2 : COW_RECLAIM_BATCH * 2;
+        t->limbo = (CowRetired*)realloc(t->limbo, t->limbo_cap * sizeof(CowRetired));
+    }
+    t->limbo[t->limbo_len].ptr = (void*)ptr;
+    t->limbo[t->limbo_len++].epoch = 0;    /* ορίζεται στη δημοσίευση */
+}
+
+/* Κόμβος που μπορεί να αλλάξει: ο ίδιος αν φτιάχτηκε σε αυτή την έκδοση,
+ * αλλιώς αντίγραφο (και το πρωτότυπο αποσύρεται) */
+static CowNode* cow_own(CowTree *t, CowNode *n) {
+    if (!n || n->version == t->version) return n;
+    CowNode *c = (CowNode*)malloc(sizeof(CowNode));
+    *c = *n;
+    c->version = t->version;
+    t->copies++;
+    cow_retire(t, n);
+    return c;
+}
+
+static CowNode* cow_own_at(CowTree *t, CowNode **link) {
+    return *link = cow_own(t, *link);
+}
+
+/* Ο x κατεβαίνει προς την κατεύθυνση d και ανεβαίνει το παιδί του από την
+ * άλλη πλευρά - x και παιδί πρέπει να είναι ήδη δικά μας */
+static void cow_rotate(CowNode **link, CowNode *x, int d) {
+    CowNode *y = x->child[!d];
+    x->child[!d] = y->child[d];
+    y->child[d] = x;
+    *link = y;
+}
+
+static inline int cow_red(const CowNode *n) {
+    return n && n->color == 'R';
+}
+
+/* Ελευθέρωση όσων αποσύρθηκαν πριν από την παλαιότερη ενεργή ανάγνωση */
+static void cow_reclaim(CowTree *t) {
+    uint64_t min = UINT64_MAX;
+    for (int i = 0; i < COW_MAX_READERS; i++) {
+        uint64_t e = __atomic_load_n(&t->readers[i].epoch, __ATOMIC_SEQ_CST);
+        if (e && e < min) min = e;
+    }
+    size_t k = 0;
+    while (k < t->limbo_tagged && t->limbo[k].epoch < min) free(t->limbo[k++].ptr);
+    if (!k) return;
+    memmove(t->limbo, t->limbo + k, (t->limbo_len - k) * sizeof(CowRetired));
+    t->limbo_len -= k;
+    t->limbo_tagged -= k;
+    t->freed += k;
+}
+
+/* Δημοσίευση της νέας ρίζας. Store της ρίζας και μετά load των εποχών από
+ * τον writer, store της εποχής και μετά load της ρίζας από τον αναγνώστη, όλα
+ * seq_cst: είτε ο writer βλέπει τη δηλωμένη εποχή, είτε ο αναγνώστης βλέπει
+ * τη νέα ρίζα - ποτέ κανένα από τα δύο. */
+static void cow_publish(CowTree *t, CowNode *root) {
+    __atomic_store_n(&t->root, root, __ATOMIC_SEQ_CST);
+    uint64_t e = __atomic_fetch_add(&t->epoch, 1, __ATOMIC_SEQ_CST);
+    for (size_t i = t->limbo_tagged; i < t->limbo_len; i++) t->limbo[i].epoch = e;
+    t->limbo_tagged = t->limbo_len;
+    t->version++;
+    if (t->limbo_len >= COW_RECLAIM_BATCH) cow_reclaim(t);
+}
+
+/* Insert (μόνο από τον writer) - 1 αν προστέθηκε, 0 αν το όνομα υπάρχει */
+int cow_insert(CowTree *t, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    CowNode *path[COW_MAX_DEPTH];
+    int dir[COW_MAX_DEPTH], d = 0;
+    for (CowNode *n = t->root; n; n = n->child[dir[d++]]) {
+        int cmp = key_cmp_mt(key, c->full_name, n->key, n->rec->full_name);
+        if (cmp == 0) return 0;
+        path[d] = n;
+        dir[d] = cmp > 0;
+    }
+
+    CowNode *root = t->root, **link = &root;
+    for (int i = 0; i < d; i++) {
+        path[i] = cow_own_at(t, link);
+        link = &path[i]->child[dir[i]];
+    }
+    Citizen *rec = (Citizen*)malloc(sizeof(Citizen));
+    *rec = *c;
+    *link = path[d] = cow_new(t, key, rec);
+
+    /* Fixup από κάτω προς τα πάνω με τη στοίβα (γονέας path[i-1], παππούς path[i-2]) */
+    for (int i = d; i >= 2 && path[i - 1]->color == 'R';) {
+        CowNode *p = path[i - 1], *g = path[i - 2];
+        int pd = dir[i - 2];
+        if (cow_red(g->child[!pd])) {
+            CowNode *u = cow_own_at(t, &g->child[!pd]);
+            p->color = u->color = 'B';
+            g->color = 'R';
+            i -= 2;
+            continue;
+        }
+        if (dir[i - 1] != pd) {
+            cow_rotate(&g->child[pd], p, pd);
+            p = g->child[pd];
+        }
+        cow_rotate(i >= 3 ? &path[i - 3]->child[dir[i - 3]] : &root, g, !pd);
+        p->color = 'B';
+        g->color = 'R';
+        break;
+    }
+    root->color = 'B';
+    t->count++;
+    cow_publish(t, root);
+    return 1;
+}
+
+/* Ο κόμβος που αφαιρέθηκε ήταν μαύρος χωρίς παιδί: το "διπλό μαύρο" είναι
+ * στο παιδί dir[i] του path[i] */
+static void cow_delete_fixup(CowTree *t, CowNode **root, CowNode **path, const int *dir, int i) {
+    while (i >= 0) {
+        CowNode *p = path[i];
+        int side = dir[i];
+        CowNode **plink = i > 0 ? &path[i - 1]->child[dir[i - 1]] : root;
+        CowNode *w = cow_own_at(t, &p->child[!side]);
+        if (w->color == 'R') {              /* κόκκινος αδελφός: περιστροφή στον p */
+            w->color = 'B';
+            p->color = 'R';
+            cow_rotate(plink, p, side);
+            plink = &w->child[side];
+            w = cow_own_at(t, &p->child[!side]);
+        }
+        if (!cow_red(w->child[0]) && !cow_red(w->child[1])) {
+            w->color = 'R';
+            if (p->color == 'R') { p->color = 'B'; return; }
+            i--;                            /* το διπλό μαύρο ανεβαίνει στον p */
+            continue;
+        }
+        if (!cow_red(w->child[!side])) {    /* κόκκινο μόνο το κοντινό παιδί */
+            CowNode *near = cow_own_at(t, &w->child[side]);
+            near->color = 'B';
+            w->color = 'R';
+            cow_rotate(&p->child[!side], w, !side);
+            w = near;
+        }
+        CowNode *far = cow_own_at(t, &w->child[!side]);
+        w->color = p->color;
+        p->color = 'B';
+        far->color = 'B';
+        cow_rotate(plink, p, side);
+        return;
+    }
+}
+
+/* Delete (μόνο από τον writer) - 1 αν βρέθηκε */
+int cow_delete(CowTree *t, const char *name) {
+    uint64_t key = key_prefix(name);
+    CowNode *path[COW_MAX_DEPTH];
+    int dir[COW_MAX_DEPTH], d = 0;
+    CowNode *n = t->root;
+    for (; n; d++) {
+        int cmp = key_cmp_mt(key, name, n->key, n->rec->full_name);
+        path[d] = n;
+        if (cmp == 0) break;
+        dir[d] = cmp > 0;
+        n = n->child[cmp > 0];
+    }
+    if (!n) return 0;
+    int found = d;
+    if (n->child[0] && n->child[1]) {       /* δύο παιδιά: αφαιρείται ο διάδοχος */
+        dir[d++] = 1;
+        for (n = n->child[1]; n->child[0]; n = n->child[0]) {
+            path[d] = n;
+            dir[d++] = 0;
+        }
+        path[d] = n;
+    }
+
+    CowNode *root = t->root, **link = &root;
+    for (int i = 0; i <= d; i++) {
+        path[i] = cow_own_at(t, link);
+        if (i < d) link = &path[i]->child[dir[i]];
+    }
+    const Citizen *gone = path[found]->rec;
+    CowNode *m = path[d];
+    if (d != found) {
+        path[found]->key = m->key;
+        path[found]->rec = m->rec;
+    }
+    CowNode *x = m->child[m->child[0] == NULL];
+    *link = x;
+    char color = m->color;
+    free(m);                                /* αντίγραφο αυτής της έκδοσης - κανείς δεν το είδε */
+    if (color == 'B') {
+        if (x) cow_own_at(t, link)->color = 'B';    /* μοναδικό παιδί μαύρου: κόκκινο */
+        else if (d > 0) cow_delete_fixup(t, &root, path, dir, d - 1);
+    }
+    if (cow_red(root)) cow_own_at(t, &root)->color = 'B';
+    cow_retire(t, gone);
+    t->count--;
+    cow_publish(t, root);
+    return 1;
+}
+
+/* Αναγνώστες: μία θέση ανά νήμα */
+int cow_reader_register(CowTree *t) {
+    for (int i = 0; i < COW_MAX_READERS; i++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&t->readers[i].used, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            return i;
+    }
+    return -1;
+}
+
+void cow_reader_unregister(CowTree *t, int slot) {
+    __atomic_store_n(&t->readers[slot].used, 0, __ATOMIC_RELEASE);
+}
+
+/* Αρχή ανάγνωσης: δήλωση εποχής και μετά η ρίζα. Ό,τι βρεθεί από αυτή τη ρίζα
+ * μένει έγκυρο ως το cow_read_end. */
+const CowNode* cow_read_begin(CowTree *t, int slot) {
+    __atomic_store_n(&t->readers[slot].epoch, __atomic_load_n(&t->epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&t->root, __ATOMIC_SEQ_CST);
+}
+
+void cow_read_end(CowTree *t, int slot) {
+    __atomic_store_n(&t->readers[slot].epoch, 0, __ATOMIC_RELEASE);
+}
+
+const Citizen* cow_find(const CowNode *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    while (root) {
+        int cmp = key_cmp_mt(key, name, root->key, root->rec->full_name);
+        if (cmp == 0) return root->rec;
+        root = root->child[cmp > 0];
+    }
+    return NULL;
+}
+
+/* Αναζήτηση με αντιγραφή της εγγραφής - 1 αν βρέθηκε */
+int cow_search(CowTree *t, int slot, const char *name, Citizen *out) {
+    const Citizen *c = cow_find(cow_read_begin(t, slot), name);
+    if (c) *out = *c;
+    cow_read_end(t, slot);
+    return c != NULL;
+}
+
+static void cow_free_nodes(CowNode *n) {
+    if (!n) return;
+    cow_free_nodes(n->child[0]);
+    cow_free_nodes(n->child[1]);
+    free((void*)n->rec);
+    free(n);
+}
+
+/* Μόνο όταν δεν υπάρχουν πια αναγνώστες */
+void cow_destroy(CowTree *t) {
+    if (!t) return;
+    cow_free_nodes(t->root);
+    for (size_t i = 0; i < t->limbo_len; i++) free(t->limbo[i].ptr);
+    free(t->limbo);
+    free(t);
+}
+
+/* ============ Skip List χωρίς Κλειδώματα ============ */
+
+/* Πολλοί writers και πολλοί αναγνώστες ταυτόχρονα, χωρίς κανένα lock (Harris,
+ * Fraser). Κάθε κόμβος έχει πύργο από next[] ύψους 1..SKIP_MAX_LEVEL και το
+ * χαμηλότερο bit κάθε δείκτη είναι σημάδι διαγραφής. Insert: σύνδεση με CAS
+ * στο επίπεδο 0 (εκεί γίνεται ορατός) και μετά στα ψηλότερα. Delete: σημάδι
+ * σε όλα τα επίπεδα από πάνω προς τα κάτω - όποιος σημαδέψει το επίπεδο 0
+ * κερδίζει τη διαγραφή - και η αποσύνδεση γίνεται από την skip_locate, που
+ * βγάζει από τη λίστα κάθε σημαδεμένο κόμβο που συναντά (βοηθώντας και τις
+ * διαγραφές άλλων νημάτων). Η αναζήτηση απλώς προσπερνά τους σημαδεμένους.
+ *
+ * Ένας κόμβος μπορεί να συνδεθεί σε ψηλό επίπεδο ενώ ήδη διαγράφεται, οπότε
+ * αποσύρεται μόνο όταν τελειώσουν και ο insert και ο delete (refs 2 -> 0):
+ * όποιος τελειώνει δεύτερος έχει δει ή κάνει skip_locate μετά την τελευταία
+ * σύνδεση, άρα ο κόμβος δεν είναι πια προσβάσιμος από κανένα επίπεδο.
+ *
+ * Ανακύκλωση με εποχές (EBR), όπως στο copy-on-write RBT αλλά με λίστα
+ * αποσυρμένων ανά νήμα: κάθε λειτουργία δηλώνει την καθολική εποχή στη θέση
+ * του νήματος. Ένας κόμβος παίρνει την εποχή τη στιγμή της απόσυρσης και
+ * ελευθερώνεται όταν όλες οι ενεργές θέσεις έχουν δηλώσει μεγαλύτερη. */
+#define SKIP_MAX_LEVEL 24           /* p = 1/2: αρκεί για ~16M κλειδιά */
+#define SKIP_MAX_THREADS 64
+#define SKIP_RECLAIM_BATCH 256      /* αποσυρμένοι ανά νήμα πριν από ανακύκλωση */
+
+typedef struct SkipNode {
+    uint64_t key;
+    Citizen data;
+    int level;                      /* ύψος πύργου */
+    int refs;                       /* insert + delete που δεν έχουν τελειώσει */
+    uintptr_t next[];               /* bit 0 = σημάδι διαγραφής */
+} SkipNode;
+
+typedef struct {
+    void *ptr;
+    uint64_t epoch;
+} SkipRetired;
+
+/* Μία cache line ανά νήμα: η εποχή διαβάζεται από όλους, τα υπόλοιπα μόνο από
+ * το νήμα που κατέχει τη θέση */
+typedef struct {
+    uint64_t epoch;                 /* 0 = εκτός λειτουργίας */
+    int used;
+    uint64_t rng;
+    SkipRetired *limbo;
+    size_t limbo_len, limbo_cap;
+    char pad[64 - 6 * sizeof(uint64_t)];
+} SkipThread;
+
+typedef struct {
+    SkipNode *head;                 /* φρουρός με πύργο SKIP_MAX_LEVEL */
+    int level;                      /* ψηλότερο επίπεδο σε χρήση (μόνο αυξάνεται) */
+    char pad[64 - sizeof(SkipNode*) - sizeof(int)];
+    uint64_t epoch;                 /* καθολική εποχή, ξεκινά από 1 */
+    char pad2[64 - sizeof(uint64_t)];
+    SkipThread threads[SKIP_MAX_THREADS];
+} SkipList;
+
+#define SKIP_MARKED(p) ((p) & 1)
+
+static inline SkipNode* skip_ptr(uintptr_t p) {
+    return (SkipNode*)(p & ~(uintptr_t)1);
+}
+
+static inline uintptr_t skip_next(SkipNode *n, int i) {
+    return __atomic_load_n(&n->next[i], __ATOMIC_SEQ_CST);
+}
+
+static inline int skip_cas(uintptr_t *p, uintptr_t expected, uintptr_t desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static SkipNode* skip_node_new(int level) {
+    SkipNode *n = (SkipNode*)malloc(sizeof(SkipNode) + level * sizeof(uintptr_t));
+    if (!n) { printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n"); exit(1); }
+    n->level = level;
+    n->refs = 2;
+    return n;
+}
+
+SkipList* skip_create(void) {
+    void *mem;
+    if (posix_memalign(&mem, 64, sizeof(SkipList))) { printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n"); exit(1); }
+    SkipList *l = (SkipList*)memset(mem, 0, sizeof(SkipList));
+    l->head = skip_node_new(SKIP_MAX_LEVEL);
+    for (int i = 0; i < SKIP_MAX_LEVEL; i++) l->head->next[i] = 0;
+    l->level = 1;
+    l->epoch = 1;
+    return l;
+}
+
+/* Μία θέση ανά νήμα - όλες οι λειτουργίες παίρνουν τη θέση του νήματος */
+int skip_thread_register(SkipList *l) {
+    for (int i = 0; i < SKIP_MAX_THREADS; i++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&l->threads[i].used, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            if (!l->threads[i].rng) l->threads[i].rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Οι αποσυρμένοι της θέσης μένουν εκεί για τον επόμενο κάτοχο ή τη skip_destroy */
+void skip_thread_unregister(SkipList *l, int slot) {
+    __atomic_store_n(&l->threads[slot].used, 0, __ATOMIC_RELEASE);
+}
+
+/* Ό,τι βρεθεί ανάμεσα σε skip_enter και skip_exit μένει έγκυρο ως το skip_exit */
+void skip_enter(SkipList *l, int slot) {
+    __atomic_store_n(&l->threads[slot].epoch, __atomic_load_n(&l->epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+}
+
+void skip_exit(SkipList *l, int slot) {
+    __atomic_store_n(&l->threads[slot].epoch, 0, __ATOMIC_RELEASE);
+}
+
+/* Η εποχή προχωρά εδώ και όχι σε κάθε απόσυρση, ώστε ο κοινός μετρητής να
+ * αγγίζεται μία φορά ανά SKIP_RECLAIM_BATCH διαγραφές */
+static void skip_reclaim(SkipList *l, SkipThread *t) {
+    __atomic_fetch_add(&l->epoch, 1, __ATOMIC_SEQ_CST);
+    uint64_t min = UINT64_MAX;
+    for (int i = 0; i < SKIP_MAX_THREADS; i++) {
+        uint64_t e = __atomic_load_n(&l->threads[i].epoch, __ATOMIC_SEQ_CST);
+        if (e && e < min) min = e;
+    }
+    size_t k = 0;
+    for (size_t i = 0; i < t->limbo_len; i++) {
+        if (t->limbo[i].epoch < min) free(t->limbo[i].ptr);
+        else t->limbo[k++] = t->limbo[i];
+    }
+    t->limbo_len = k;
+}
+
+static void skip_retire(SkipList *l, int slot, SkipNode *n) {
+    SkipThread *t = &l->threads[slot];
+    if (t->limbo_len == t->limbo_cap) {
+        t->limbo_cap = t->limbo_cap ? t->limbo_cap * 2 : SKIP_RECLAIM_BATCH * 2;
+        t->limbo = (SkipRetired*)realloc(t->limbo, t->limbo_cap * sizeof(SkipRetired));
+    }
+    t->limbo[t->limbo_len].ptr = n;
+    t->limbo[t->limbo_len++].epoch = __atomic_load_n(&l->epoch, __ATOMIC_SEQ_CST);
+    if (t->limbo_len >= SKIP_RECLAIM_BATCH) skip_reclaim(l, t);
+}
+
+static void skip_release(SkipList *l, int slot, SkipNode *n) {
+    if (__atomic_sub_fetch(&n->refs, 1, __ATOMIC_ACQ_REL) == 0) skip_retire(l, slot, n);
+}
+
+/* Γεωμετρικό ύψος πύργου με p = 1/2 από xorshift ανά νήμα */
+static int skip_random_level(SkipThread *t) {
+    uint64_t x = t->rng;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    t->rng = x;
+    int level = 1 + __builtin_ctzll(x | (1ULL << (SKIP_MAX_LEVEL - 1)));
+    return level;
+}
+
+/* Για κάθε επίπεδο: preds[i] ο τελευταίος κόμβος με κλειδί < name και succs[i]
+ * ο επόμενός του. Οι σημαδεμένοι κόμβοι στη διαδρομή αποσυνδέονται με CAS και
+ * αν το CAS αποτύχει (ο pred άλλαξε ή σημαδεύτηκε) η αναζήτηση ξεκινά πάλι.
+ * 1 αν το succs[0] έχει το name. */
+static int skip_locate(SkipList *l, uint64_t key, const char *name, SkipNode **preds, SkipNode **succs) {
+    int top = __atomic_load_n(&l->level, __ATOMIC_SEQ_CST);
+retry:;
+    SkipNode *pred = l->head, *curr = NULL;
+    int cmp = 1;
+    for (int i = SKIP_MAX_LEVEL - 1; i >= top; i--) { preds[i] = pred; succs[i] = NULL; }
+    for (int i = top - 1; i >= 0; i--) {
+        curr = skip_ptr(skip_next(pred, i));
+        cmp = 1;
+        while (curr) {
+            uintptr_t succ = skip_next(curr, i);
+            if (SKIP_MARKED(succ)) {
+                if (!skip_cas(&pred->next[i], (uintptr_t)curr, succ & ~(uintptr_t)1)) goto retry;
+                curr = skip_ptr(succ);
+                continue;
+            }
+            cmp = key_cmp_mt(key, name, curr->key, curr->data.full_name);
+            if (cmp <= 0) break;
+            pred = curr;
+            curr = skip_ptr(succ);
+        }
+        preds[i] = pred;
+        succs[i] = curr;
+    }
+    return curr && cmp == 0;
+}
+
+/* Insert - 1 αν προστέθηκε, 0 αν το όνομα υπάρχει */
+int skip_insert(SkipList *l, int slot, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    SkipNode *preds[SKIP_MAX_LEVEL], *succs[SKIP_MAX_LEVEL];
+    SkipNode *n = NULL;
+    skip_enter(l, slot);
+    for (;;) {
+        if (skip_locate(l, key, c->full_name, preds, succs)) {
+            skip_exit(l, slot);
+            free(n);                        /* δεν δημοσιεύτηκε ποτέ */
+            return 0;
+        }
+        if (!n) {
+            n = skip_node_new(skip_random_level(&l->threads[slot]));
+            n->key = key;
+            n->data = *c;
+        }
+        for (int i = 0; i < n->level; i++) n->next[i] = (uintptr_t)succs[i];
+        if (skip_cas(&preds[0]->next[0], (uintptr_t)succs[0], (uintptr_t)n)) break;
+    }
+
+    int top = __atomic_load_n(&l->level, __ATOMIC_SEQ_CST);
+    while (top < n->level && !__atomic_compare_exchange_n(&l->level, &top, n->level, 0, __ATOMIC_SEQ_CST,
+                                                          __ATOMIC_SEQ_CST)) {}
+    /* Ψηλότερα επίπεδα: πρώτα ο δικός μας δείκτης (αποτυγχάνει αν σημαδεύτηκε)
+     * και μετά ο pred. Σταματά μόλις ο κόμβος αρχίσει να διαγράφεται. */
+    for (int i = 1; i < n->level; i++) {
+        for (;;) {
+            uintptr_t cur = skip_next(n, i);
+            if (SKIP_MARKED(cur)) goto linked;
+            if (skip_ptr(cur) != succs[i] && !skip_cas(&n->next[i], cur, (uintptr_t)succs[i])) goto linked;
+            if (skip_cas(&preds[i]->next[i], (uintptr_t)succs[i], (uintptr_t)n)) break;
+            if (!skip_locate(l, key, c->full_name, preds, succs) || succs[0] != n) goto linked;
+        }
+    }
+linked:
+    if (SKIP_MARKED(skip_next(n, 0))) skip_locate(l, key, c->full_name, preds, succs);
+    skip_release(l, slot, n);
+    skip_exit(l, slot);
+    return 1;
+}
+
+/* Delete - 1 αν βρέθηκε και το νήμα αυτό κέρδισε τη διαγραφή */
+int skip_delete(SkipList *l, int slot, const char *name) {
+    uint64_t key = key_prefix(name);
+    SkipNode *preds[SKIP_MAX_LEVEL], *succs[SKIP_MAX_LEVEL];
+    skip_enter(l, slot);
+    if (!skip_locate(l, key, name, preds, succs)) { skip_exit(l, slot); return 0; }
+    SkipNode *n = succs[0];
+    for (int i = n->level - 1; i >= 1; i--) __atomic_fetch_or(&n->next[i], 1, __ATOMIC_SEQ_CST);
+    if (SKIP_MARKED(__atomic_fetch_or(&n->next[0], 1, __ATOMIC_SEQ_CST))) { skip_exit(l, slot); return 0; }
+    skip_locate(l, key, name, preds, succs);    /* αποσύνδεση από όλα τα επίπεδα */
+    skip_release(l, slot, n);
+    skip_exit(l, slot);
+    return 1;
+}
+
+/* Αναζήτηση χωρίς εγγραφές στη μνήμη - μόνο μέσα σε skip_enter/skip_exit */
+const Citizen* skip_find(SkipList *l, const char *name) {
+    uint64_t key = key_prefix(name);
+    SkipNode *pred = l->head;
+    for (int i = __atomic_load_n(&l->level, __ATOMIC_SEQ_CST) - 1; i >= 0; i--) {
+        SkipNode *curr = skip_ptr(skip_next(pred, i));
+        while (curr) {
+            uintptr_t succ = skip_next(curr, i);
+            if (!SKIP_MARKED(succ)) {
+                int cmp = key_cmp_mt(key, name, curr->key, curr->data.full_name);
+                if (cmp < 0) break;
+                if (cmp == 0 && !SKIP_MARKED(skip_next(curr, 0))) return &curr->data;
+                if (cmp > 0) pred = curr;
+            }
+            curr = skip_ptr(succ);
+        }
+    }
+    return NULL;
+}
+
+/* Αναζήτηση με αντιγραφή της εγγραφής - 1 αν βρέθηκε */
+int skip_search(SkipList *l, int slot, const char *name, Citizen *out) {
+    skip_enter(l, slot);
+    const Citizen *c = skip_find(l, name);
+    if (c) *out = *c;
+    skip_exit(l, slot);
+    return c != NULL;
+}
+
+/* Ενδοδιατεταγμένη διάσχιση στο επίπεδο 0 - επιστρέφει το πλήθος. Με
+ * ταυτόχρονες αλλαγές βλέπει κάθε κλειδί που υπήρχε σε όλη τη διάρκεια και
+ * κανένα που έλειπε σε όλη τη διάρκεια. */
+size_t skip_inorder(SkipList *l, int slot, void (*visit)(const Citizen*, void*), void *arg) {
+    size_t n = 0;
+    skip_enter(l, slot);
+    for (SkipNode *curr = skip_ptr(skip_next(l->head, 0)); curr;) {
+        uintptr_t succ = skip_next(curr, 0);
+        if (!SKIP_MARKED(succ)) {
+            if (visit) visit(&curr->data, arg);
+            n++;
+        }
+        curr = skip_ptr(succ);
+    }
+    skip_exit(l, slot);
+    return n;
+}
+
+/* Μόνο όταν δεν τρέχει πια κανένα νήμα */
+void skip_destroy(SkipList *l) {
+    if (!l) return;
+    for (SkipNode *curr = l->head; curr;) {
+        SkipNode *next = skip_ptr(curr->next[0]);
+        free(curr);
+        curr = next;
+    }
+    for (int i = 0; i < SKIP_MAX_THREADS; i++) {
+        for (size_t k = 0; k < l->threads[i].limbo_len; k++) free(l->threads[i].limbo[k].ptr);
+        free(l->threads[i].limbo);
+    }
+    free(l);
+}
+
+/* ============ Φόρτωση Δεδομένων ============ */
+
+/* Αρχική ανάγνωση με fgets/strtok - κρατιέται για σύγκριση με τον mmap loader */
+int load_citizens(Citizen citizens[], int max) {
+    FILE *fp = fopen("citizens.txt", "r");
+    if (!fp) { printf("Σφάλμα: δεν ανοίγει το citizens.txt\n"); return 0; }
+    int count = 0;
+    char line[256];
+    while (count < max && fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        /* Ανάλυση γραμμής: όνομα,ηλικία,πολιτεία,εισόδημα */
+        char *token = strtok(line, ",");
+        if (!token) continue;
+        strncpy(citizens[count].full_name, token, 99);
+        token = strtok(NULL, ",");
+        if (token) citizens[count].age = atoi(token);
+        token = strtok(NULL, ",");
+        if (token) strncpy(citizens[count].state, token, 49);
+        token = strtok(NULL, ",");
+        if (token) citizens[count].annual_income = atoi(token);
+        count++;
+    }
+    fclose(fp);
+    return count;
+}
+
+/* Εγγραφή χωρίς αντιγραφή: όνομα και πολιτεία δείχνουν μέσα στο αρχείο
+ * (δεν τερματίζονται με '\0' - το μήκος δίνεται χωριστά) */
+typedef struct {
+    const char *name, *state;
+    uint32_t name_len, state_len;
+    int age, annual_income;
+} CitizenRef;
+
+/* citizens.txt αντιστοιχισμένο στη μνήμη με mmap και οι εγγραφές του */
+typedef struct {
+    const char *data;
+    size_t size;
+    int mapped;             /* 1 = mmap, 0 = αντίγραφο σε malloc (π.χ. pipe) */
+    size_t parsed;          /* bytes μέχρι το τέλος της τελευταίας εγγραφής */
+    CitizenRef *rows;
+    int count, cap;
+} CitizenFile;
+
+/* Μάσκα 64 bit με τις θέσεις των ',' και '\n' σε 64 bytes - με SSE2
+ * συγκρίνονται 16 bytes ανά εντολή αντί για ένα byte τη φορά */
+static inline uint64_t delim_mask64(const char *p) {
+#ifdef __SSE2__
+    const __m128i comma = _mm_set1_epi8(','), nl = _mm_set1_epi8('\n');
+    uint64_t m = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, nl));
+        m |= (uint64_t)(uint16_t)_mm_movemask_epi8(hit) << (16 * i);
+    }
+    return m;
+#else
+    uint64_t m = 0;
+    for (int i = 0; i < 64; i++) m |= (uint64_t)(p[i] == ',' || p[i] == '\n') << i;
+    return m;
+#endif
+}
+
+/* Ακέραιος χωρίς atoi: προαιρετικό '-' και ψηφία, ό,τι άλλο τερματίζει */
+static inline int parse_int(const char *p, const char *end) {
+    int neg = 0, v = 0;
+    if (p < end && *p == '-') { neg = 1; p++; }
+    while (p < end && (unsigned)(*p - '0') < 10) v = v * 10 + (*p++ - '0');
+    return neg ? -v : v;
+}
+
+/* Προσθήκη εγγραφής με διπλασιασμό του πίνακα όταν γεμίσει */
+static int cf_push(CitizenFile *cf, const CitizenRef *r) {
+    if (cf->count == cf->cap) {
+        int cap = cf->cap ? cf->cap * 2 : 1024;
+        CitizenRef *rows = (CitizenRef*)realloc(cf->rows, (size_t)cap * sizeof(CitizenRef));
+        if (!rows) return 0;
+        cf->rows = rows;
+        cf->cap = cap;
+    }
+    cf->rows[cf->count++] = *r;
+    return 1;
+}
+
+/* Τέλος πεδίου στη θέση pos: field 0 όνομα, 1 ηλικία, 2 πολιτεία, 3 εισόδημα */
+static inline void cf_field(CitizenRef *r, int field, const char *start, const char *end) {
+    switch (field) {
+    case 0: r->name = start; r->name_len = (uint32_t)(end - start); break;
+    case 1: r->age = parse_int(start, end); break;
+    case 2: r->state = start; r->state_len = (uint32_t)(end - start); break;
+    case 3: r->annual_income = parse_int(start, end); break;
+    }
+}
+
+/* Ανάλυση όλου του αρχείου: οι οριοθέτες εντοπίζονται 64 bytes τη φορά και
+ * κάθε set bit της μάσκας κλείνει ένα πεδίο. max <= 0 σημαίνει χωρίς όριο. */
+static void cf_parse(CitizenFile *cf, int max) {
+    const char *d = cf->data;
+    size_t size = cf->size, start = 0;
+    int field = 0;
+    CitizenRef cur;
+    memset(&cur, 0, sizeof(cur));
+
+    for (size_t base = 0; base < size; base += 64) {
+        uint64_t m;
+        if (base + 64 <= size) {
+            m = delim_mask64(d + base);
+        } else {
+            m = 0;
+            for (size_t i = base; i < size; i++) m |= (uint64_t)(d[i] == ',' || d[i] == '\n') << (i - base);
+        }
+        while (m) {
+            size_t pos = base + (size_t)__builtin_ctzll(m);
+            m &= m - 1;
+            if (d[pos] == ',') {
+                cf_field(&cur, field++, d + start, d + pos);
+            } else {
+                size_t end = pos > start && d[pos - 1] == '\r' ? pos - 1 : pos;
+                cf_field(&cur, field, d + start, d + end);
+                /* Γραμμή χωρίς όνομα (π.χ. κενή) παραλείπεται, όπως με strtok */
+                if (cur.name_len > 0 && !cf_push(cf, &cur)) return;
+                cf->parsed = pos + 1;
+                if (max > 0 && cf->count >= max) return;
+                memset(&cur, 0, sizeof(cur));
+                field = 0;
+            }
+            start = pos + 1;
+        }
+    }
+    /* Τελευταία γραμμή χωρίς '\n' */
+    if (start < size) {
+        size_t end = d[size - 1] == '\r' ? size - 1 : size;
+        cf_field(&cur, field, d + start, d + end);
+        if (cur.name_len > 0) cf_push(cf, &cur);
+        cf->parsed = size;
+    }
+}
+
+/* Άνοιγμα και ανάλυση του path με mmap (ή ανάγνωση σε buffer αν το mmap
+ * αποτύχει). Επιστρέφει το πλήθος εγγραφών ή -1 σε σφάλμα. */
+int citizen_file_open(CitizenFile *cf, const char *path, int max) {
+    memset(cf, 0, sizeof(*cf));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { printf("Σφάλμα: δεν ανοίγει το %s\n", path); return -1; }
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); return -1; }
+    cf->size = (size_t)st.st_size;
+
+    if (cf->size > 0) {
+        void *p = mmap(NULL, cf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, cf->size, MADV_SEQUENTIAL);
+            cf->data = (const char*)p;
+            cf->mapped = 1;
+        } else {
+            char *buf = (char*)malloc(cf->size);
+            size_t got = 0;
+            ssize_t r;
+            while (buf && got < cf->size && (r = read(fd, buf + got, cf->size - got)) > 0) got += (size_t)r;
+            if (!buf) { close(fd); return -1; }
+            cf->data = buf;
+            cf->size = got;
+        }
+    }
+    close(fd);
+    cf_parse(cf, max);
+    return cf->count;
+}
+
+void citizen_file_close(CitizenFile *cf) {
+    if (cf->mapped) munmap((void*)cf->data, cf->size);
+    else free((void*)cf->data);
+    free(cf->rows);
+    memset(cf, 0, sizeof(*cf));
+}
+
+/* Αντιγραφή των εγγραφών σε πίνακα Citizen για τα δέντρα (τα πεδία
+ * περικόπτονται στο μέγεθος του Citizen, όπως με το strncpy) */
+Citizen* citizen_file_materialize(const CitizenFile *cf) {
+    Citizen *c = (Citizen*)calloc(cf->count > 0 ? cf->count : 1, sizeof(Citizen));
+    if (!c) return NULL;
+    for (int i = 0; i < cf->count; i++) {
+        const CitizenRef *r = &cf->rows[i];
+        size_t n = r->name_len < sizeof(c[i].full_name) - 1 ? r->name_len : sizeof(c[i].full_name) - 1;
+        size_t s = r->state_len < sizeof(c[i].state) - 1 ? r->state_len : sizeof(c[i].state) - 1;
+        memcpy(c[i].full_name, r->name, n);
+        memcpy(c[i].state, r->state, s);
+        c[i].age = r->age;
+        c[i].annual_income = r->annual_income;
+    }
+    return c;
+}
+
+/* Δυαδική στηλοθετημένη μορφή (citizens.bin, γράφεται από το
+ * generate_citizens -f bin ή -i): header 64 bytes με πλήθη και αθροίσματα
+ * ελέγχου, και στήλες ευθυγραμμισμένες στα 64 bytes - λεξικό πολιτειών,
+ * offsets ονομάτων (count + 1), heap ονομάτων, ηλικία (uint8), πολιτεία
+ * (uint8) και εισόδημα (int32). Ο loader κάνει mmap και χρησιμοποιεί τις
+ * στήλες όπως είναι, χωρίς ανάλυση ανά εγγραφή. Οι ορισμοί της μορφής
+ * (BinHeader, bin_layout, bin_checksum) είναι στο citizens_bin.h, κοινό με
+ * τον writer. */
+
+/* citizens.bin αντιστοιχισμένο στη μνήμη - οι στήλες δείχνουν στο mapping */
+typedef struct {
+    const unsigned char *base;
+    size_t size;
+    BinHeader h;
+    const char *dict;           /* state_count x BIN_STATE_LEN */
+    const uint64_t *name_off;
+    const char *names;
+    const uint8_t *age, *state;
+    const int32_t *income;
+} CitizenBin;
+
+static int bin_fail(const char *path, const char *why) {
+    printf("Σφάλμα: %s: %s\n", path, why);
+    return -1;
+}
+
+/* Έλεγχος του αθροίσματος όλων των δεδομένων - O(μέγεθος αρχείου) */
+int citizen_bin_verify(const CitizenBin *cb) {
+    return bin_checksum(cb->base + BIN_HEADER_SIZE, cb->size - BIN_HEADER_SIZE) == cb->h.data_checksum;
+}
+
+/* mmap και έλεγχος header, μεγεθών και (αν verify) αθροίσματος δεδομένων.
+ * Επιστρέφει το πλήθος εγγραφών ή -1 σε σφάλμα. */
+int citizen_bin_open(CitizenBin *cb, const char *path, int verify) {
+    memset(cb, 0, sizeof(*cb));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return bin_fail(path, "δεν ανοίγει");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < BIN_HEADER_SIZE) { close(fd); return bin_fail(path, "πολύ μικρό αρχείο"); }
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return bin_fail(path, "αποτυχία mmap");
+    cb->base = (const unsigned char*)p;
+    cb->size = (size_t)st.st_size;
+    memcpy(&cb->h, cb->base, sizeof(BinHeader));
+
+    const char *why = NULL;
+    BinLayout l;
+    if (memcmp(cb->h.magic, BIN_MAGIC, 8) != 0) why = "δεν είναι αρχείο citizens.bin";
+    else if (cb->h.version != BIN_VERSION) why = "άγνωστη έκδοση μορφής";
+    else if (bin_checksum(&cb->h, offsetof(BinHeader, header_checksum)) != cb->h.header_checksum) why = "αλλοιωμένο header";
+    else if (cb->h.count > INT32_MAX || cb->h.state_count > 256) why = "μη έγκυρα πλήθη";
+    else {
+        bin_layout(&cb->h, &l);
+        if (cb->h.file_size != cb->size || l.end != cb->size) why = "λάθος μέγεθος αρχείου";
+        else if (verify && !citizen_bin_verify(cb)) why = "λάθος άθροισμα ελέγχου δεδομένων";
+    }
+    if (why) {
+        munmap(p, cb->size);
+        memset(cb, 0, sizeof(*cb));
+        return bin_fail(path, why);
+    }
+    cb->dict = (const char*)cb->base + l.dict;
+    cb->name_off = (const uint64_t*)(cb->base + l.offsets);
+    cb->names = (const char*)cb->base + l.heap;
+    cb->age = cb->base + l.age;
+    cb->state = cb->base + l.state;
+    cb->income = (const int32_t*)(cb->base + l.income);
+    return (int)cb->h.count;
+}
+
+void citizen_bin_close(CitizenBin *cb) {
+    if (cb->base) munmap((void*)cb->base, cb->size);
+    memset(cb, 0, sizeof(*cb));
+}
+
+/* Όνομα της εγγραφής i κατευθείαν από το mapping (NUL-terminated) */
+static inline const char* cb_name(const CitizenBin *cb, uint64_t i) {
+    return cb->names + cb->name_off[i];
+}
+
+/* Αντιγραφή των πρώτων max εγγραφών (όλων αν max <= 0) σε πίνακα Citizen.
+ * Τα offsets ελέγχονται ώστε και ένα αρχείο χωρίς verify να μη διαβάζει
+ * έξω από το heap. */
+Citizen* citizen_bin_materialize(const CitizenBin *cb, int max, int *count) {
+    int n = max > 0 && (uint64_t)max < cb->h.count ? max : (int)cb->h.count;
+    Citizen *c = (Citizen*)calloc(n > 0 ? n : 1, sizeof(Citizen));
+    if (!c) return NULL;
+    for (int i = 0; i < n; i++) {
+        uint64_t a = cb->name_off[i], b = cb->name_off[i + 1];
+        if (a < b && b <= cb->h.heap_bytes) {
+            size_t len = strnlen(cb->names + a, (size_t)(b - a));
+            if (len > sizeof(c[i].full_name) - 1) len = sizeof(c[i].full_name) - 1;
+            memcpy(c[i].full_name, cb->names + a, len);
+        }
+        if (cb->state[i] < cb->h.state_count)
+            snprintf(c[i].state, sizeof(c[i].state), "%s", cb->dict + (size_t)cb->state[i] * BIN_STATE_LEN);
+        c[i].age = cb->age[i];
+        c[i].annual_income = cb->income[i];
+    }
+    *count = n;
+    return c;
+}
+
+/* Χρόνοι φόρτωσης (us) ανά τρόπο - οι γραμμές είναι σωρευτικές όπου το
+ * label το λέει (π.χ. "mmap + copy") */
+#define LOAD_ROWS_MAX 4
+
+typedef struct {
+    size_t bytes;
+    int records, rows;
+    const char *label[LOAD_ROWS_MAX];
+    double us[LOAD_ROWS_MAX];
+} LoadTimes;
+
+static void load_row(LoadTimes *t, const char *label, double us) {
+    if (t->rows == LOAD_ROWS_MAX) return;
+    t->label[t->rows] = label;
+    t->us[t->rows++] = us;
+}
+
+void print_load_table(FILE *fp, const LoadTimes *t) {
+    fprintf(fp, "%-26s %10s %12s %10s\n", "Loader", "records", "ms", "MB/s");
+    fprintf(fp, "-------------------------------------------------------------\n");
+    for (int r = 0; r < t->rows; r++)
+        fprintf(fp, "%-26s %10d %12.3f %10.1f\n", t->label[r], t->records, t->us[r] / 1000,
+                t->us[r] > 0 ? t->bytes / t->us[r] : 0.0);
+}
+
+/* citizens.txt με mmap (ανάλυση χωρίς αντιγραφή και μετά αντιγραφή στον
+ * πίνακα Citizen που χρησιμοποιούν τα δέντρα) και με fgets/strtok για σύγκριση */
+Citizen* load_text_timed(int max, int *count, LoadTimes *t) {
+    CitizenFile cf;
+    memset(t, 0, sizeof(*t));
+    uint64_t t0 = now_ns();
+    int n = citizen_file_open(&cf, "citizens.txt", max);
+    uint64_t t1 = now_ns();
+    Citizen *citizens = n > 0 ? citizen_file_materialize(&cf) : NULL;
+    uint64_t t2 = now_ns();
+    if (n == 0) printf("Σφάλμα: το citizens.txt δεν περιέχει εγγραφές\n");
+    t->bytes = n > 0 ? cf.parsed : 0;
+    if (n >= 0) citizen_file_close(&cf);
+    if (!citizens) return NULL;
+    t->records = *count = n;
+
+    Citizen *stdio_copy = (Citizen*)malloc((size_t)n * sizeof(Citizen));
+    uint64_t t3 = now_ns();
+    if (stdio_copy) load_citizens(stdio_copy, n);
+    uint64_t t4 = now_ns();
+    free(stdio_copy);
+
+    load_row(t, "fgets/strtok/atoi", (t4 - t3) / 1000.0);
+    load_row(t, "mmap + SIMD scan", (t1 - t0) / 1000.0);
+    load_row(t, "mmap + copy to Citizen", (t2 - t0) / 1000.0);
+    return citizens;
+}
+
+/* Δυαδικό αρχείο: mmap με έλεγχο μόνο του header, έλεγχος αθροίσματος των
+ * δεδομένων και αντιγραφή σε Citizen (οι γραμμές είναι σωρευτικές) */
+Citizen* load_binary_timed(const char *path, int max, int *count, LoadTimes *t) {
+    CitizenBin cb;
+    memset(t, 0, sizeof(*t));
+    uint64_t t0 = now_ns();
+    int n = citizen_bin_open(&cb, path, 0);
+    uint64_t t1 = now_ns();
+    if (n < 0) return NULL;
+    if (n == 0) { printf("Σφάλμα: το %s δεν περιέχει εγγραφές\n", path); citizen_bin_close(&cb); return NULL; }
+    int ok = citizen_bin_verify(&cb);
+    uint64_t t2 = now_ns();
+    if (!ok) { bin_fail(path, "λάθος άθροισμα ελέγχου δεδομένων"); citizen_bin_close(&cb); return NULL; }
+    Citizen *citizens = citizen_bin_materialize(&cb, max, count);
+    uint64_t t3 = now_ns();
+    t->bytes = cb.size;
+    t->records = *count;
+    citizen_bin_close(&cb);
+    if (!citizens) return NULL;
+
+    load_row(t, "binary mmap (header only)", (t1 - t0) / 1000.0);
+    load_row(t, "binary mmap + checksum", (t2 - t0) / 1000.0);
+    load_row(t, "binary + copy to Citizen", (t3 - t0) / 1000.0);
+    return citizens;
+}
+
+/* ============ Στιγμιότυπα Δέντρων ============ */
+
+/* Αποθήκευση ενός έτοιμου AVL/RBT σε αρχείο χωρίς δείκτες: οι κόμβοι
+ * αριθμούνται σε in-order σειρά και τα παιδιά και ο γονέας κάθε κόμβου είναι
+ * θέσεις 32-bit (SNAP_NONE για κενό). Μετά το header ακολουθούν ο πίνακας
+ * κόμβων (πρόθεμα, θέσεις, ύψος, χρώμα) και, ευθυγραμμισμένος στα 64 bytes,
+ * ο πίνακας εγγραφών στην ίδια σειρά - άρα ταξινομημένος. Τίποτα δεν
+ * εξαρτάται από διευθύνσεις, οπότε μετά το mmap οι αναζητήσεις γίνονται
+ * κατευθείαν πάνω στο αρχείο, ή το δέντρο με δείκτες ξαναστήνεται σε O(n)
+ * χωρίς συγκρίσεις και περιστροφές. Ακέραιοι σε σειρά bytes του host. */
+#define SNAP_MAGIC "CITZSNP1"
+#define SNAP_VERSION 1
+#define SNAP_NONE UINT32_MAX
+
+enum { SNAP_AVL = 1, SNAP_RBT = 2 };
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;              /* SNAP_AVL ή SNAP_RBT */
+    uint64_t count;
+    uint32_t root;
+    uint32_t height;            /* επίπεδα, για το όριο της κατάβασης */
+    uint32_t node_size;         /* sizeof(SnapNode) */
+    uint32_t record_size;       /* sizeof(Citizen) */
+    uint64_t file_size;
+    uint64_t data_checksum;     /* όλα τα bytes μετά το header */
+    uint64_t header_checksum;   /* τα πρώτα 56 bytes του header */
+} SnapHeader;
+
+typedef struct {
+    uint64_t key;
+    uint32_t left, right, parent;
+    uint8_t height;             /* ύψος AVL (στο RBT ό,τι κρατά ο κόμβος) */
+    char color;                 /* 'R'/'B' στο RBT, 0 στο AVL */
+    uint16_t pad;
+} SnapNode;
+
+/* Στιγμιότυπο αντιστοιχισμένο στη μνήμη - οι πίνακες δείχνουν στο mapping */
+typedef struct {
+    const unsigned char *base;
+    size_t size;
+    SnapHeader h;
+    const SnapNode *node;
+    const Citizen *rec;
+} Snapshot;
+
+static uint64_t snap_records_offset(uint64_t count) {
+    return BIN_ALIGN(sizeof(SnapHeader) + count * sizeof(SnapNode));
+}
+
+/* Ανώτατο ύψος ισορροπημένου δέντρου n κόμβων: 2 log2(n+1) + 2 καλύπτει
+ * AVL (~1.44 log2 n) και RBT (2 log2(n+1)) - με αυτό το όριο η κατάβαση της
+ * αναζήτησης και η αναδρομή της ανασύστασης μένουν ρηχές */
+static uint32_t snap_max_height(uint64_t count) {
+    uint32_t log2 = 0;
+    while ((count + 1) >> (log2 + 1)) log2++;
+    return 2 * log2 + 2;
+}
+
+/* Γέμισμα των πινάκων σε in-order σειρά - επιστρέφει τη θέση του κόμβου */
+typedef struct {
+    SnapNode *node;
+    Citizen *rec;
+    uint32_t next, height;
+} SnapWriter;
+
+static void snap_put(SnapWriter *w, uint32_t i, uint64_t key, const Citizen *c, int height, char color,
+                     uint32_t l, uint32_t r, uint32_t depth) {
+    SnapNode *sn = &w->node[i];
+    sn->key = key;
+    sn->left = l; sn->right = r;
+    sn->parent = SNAP_NONE;     /* τον ορίζει ο γονέας όταν επιστρέψει */
+    sn->height = (uint8_t)(height > 255 ? 255 : height);
+    sn->color = color;
+    sn->pad = 0;
+    w->rec[i] = *c;
+    if (l != SNAP_NONE) w->node[l].parent = i;
+    if (r != SNAP_NONE) w->node[r].parent = i;
+    if (depth + 1 > w->height) w->height = depth + 1;
+}
+
+static uint32_t snap_fill_bst(SnapWriter *w, const BSTNode *n, uint32_t depth) {
+    if (!n) return SNAP_NONE;
+    uint32_t l = snap_fill_bst(w, n->left, depth + 1);
+    uint32_t i = w->next++;
+    uint32_t r = snap_fill_bst(w, n->right, depth + 1);
+    snap_put(w, i, n->key, &n->data, n->height, 0, l, r, depth);
+    return i;
+}
+
+static uint32_t snap_fill_rbt(SnapWriter *w, const RBTNode *n, uint32_t depth) {
+    if (!n || n == RBT_NIL) return SNAP_NONE;
+    uint32_t l = snap_fill_rbt(w, n->left, depth + 1);
+    uint32_t i = w->next++;
+    uint32_t r = snap_fill_rbt(w, n->right, depth + 1);
+    snap_put(w, i, n->key, &n->data, n->height, n->color, l, r, depth);
+    return i;
+}
+
+static uint64_t snap_count_bst(const BSTNode *n) {
+    return n ? 1 + snap_count_bst(n->left) + snap_count_bst(n->right) : 0;
+}
+
+static uint64_t snap_count_rbt(const RBTNode *n) {
+    return (n && n != RBT_NIL) ? 1 + snap_count_rbt(n->left) + snap_count_rbt(n->right) : 0;
+}
+
+/* Το στιγμιότυπο γράφεται σε path.tmp μέσω mmap και μετονομάζεται στο path
+ * μόνο όταν είναι πλήρες, οπότε ένα προηγούμενο αρχείο δεν μένει ποτέ μισό.
+ * Με sync τα δεδομένα φτάνουν στον δίσκο πριν από τη μετονομασία.
+ * Επιστρέφει το μέγεθος του αρχείου ή 0 σε σφάλμα. */
+static size_t snapshot_save(const char *path, int kind, const BSTNode *bst, const RBTNode *rbt, int sync) {
+    uint64_t count = kind == SNAP_AVL ? snap_count_bst(bst) : snap_count_rbt(rbt);
+    if (count >= SNAP_NONE) { bin_fail(path, "πάρα πολλοί κόμβοι για θέσεις 32-bit"); return 0; }
+    uint64_t rec_off = snap_records_offset(count);
+    size_t size = (size_t)(rec_off + count * sizeof(Citizen));
+
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) { bin_fail(tmp, "δεν δημιουργείται"); return 0; }
+    void *p = ftruncate(fd, (off_t)size) == 0 ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (p == MAP_FAILED) { unlink(tmp); bin_fail(tmp, "αποτυχία mmap"); return 0; }
+
+    unsigned char *base = (unsigned char*)p;
+    SnapWriter w = {(SnapNode*)(base + sizeof(SnapHeader)), (Citizen*)(base + rec_off), 0, 0};
+    uint32_t root = kind == SNAP_AVL ? snap_fill_bst(&w, bst, 0) : snap_fill_rbt(&w, rbt, 0);
+
+    SnapHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAP_MAGIC, 8);
+    h.version = SNAP_VERSION;
+    h.kind = (uint32_t)kind;
+    h.count = count;
+    h.root = root;
+    h.height = w.height;
+    h.node_size = sizeof(SnapNode);
+    h.record_size = sizeof(Citizen);
+    h.file_size = size;
+    h.data_checksum = bin_checksum(base + sizeof(SnapHeader), size - sizeof(SnapHeader));
+    h.header_checksum = bin_checksum(&h, offsetof(SnapHeader, header_checksum));
+    memcpy(base, &h, sizeof(h));
+    int synced = !sync || msync(p, size, MS_SYNC) == 0;
+    munmap(p, size);
+    if (!synced) { unlink(tmp); bin_fail(tmp, "αποτυχία msync"); return 0; }
+
+    if (rename(tmp, path) != 0) { unlink(tmp); bin_fail(path, "αποτυχία μετονομασίας"); return 0; }
+    return size;
+}
+
+size_t avl_snapshot_save(const BSTNode *root, const char *path) {
+    return snapshot_save(path, SNAP_AVL, root, NULL, 0);
+}
+
+size_t rbt_snapshot_save(const RBTNode *root, const char *path) {
+    return snapshot_save(path, SNAP_RBT, NULL, root, 0);
+}
+
+int snapshot_verify(const Snapshot *s) {
+    return bin_checksum(s->base + sizeof(SnapHeader), s->size - sizeof(SnapHeader)) == s->h.data_checksum;
+}
+
+/* mmap και έλεγχος header, τύπου δέντρου, μεγεθών και (αν verify) του
+ * αθροίσματος δεδομένων. Επιστρέφει το πλήθος κόμβων ή -1 σε σφάλμα. */
+int snapshot_open(Snapshot *s, const char *path, int kind, int verify) {
+    memset(s, 0, sizeof(*s));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return bin_fail(path, "δεν ανοίγει");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapHeader)) { close(fd); return bin_fail(path, "πολύ μικρό αρχείο"); }
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return bin_fail(path, "αποτυχία mmap");
+    s->base = (const unsigned char*)p;
+    s->size = (size_t)st.st_size;
+    memcpy(&s->h, s->base, sizeof(SnapHeader));
+
+    const SnapHeader *h = &s->h;
+    const char *why = NULL;
+    if (memcmp(h->magic, SNAP_MAGIC, 8) != 0) why = "δεν είναι στιγμιότυπο δέντρου";
+    else if (h->version != SNAP_VERSION) why = "άγνωστη έκδοση μορφής";
+    else if (bin_checksum(h, offsetof(SnapHeader, header_checksum)) != h->header_checksum) why = "αλλοιωμένο header";
+    else if (h->kind != (uint32_t)kind) why = "στιγμιότυπο άλλου τύπου δέντρου";
+    else if (h->node_size != sizeof(SnapNode) || h->record_size != sizeof(Citizen)) why = "άλλη διάταξη κόμβων/εγγραφών";
+    else if (h->count > INT32_MAX || (h->count ? h->root >= h->count : h->root != SNAP_NONE) || h->height > h->count)
+        why = "μη έγκυρα πλήθη";
+    else if (h->height > snap_max_height(h->count))
+        why = "ύψος μεγαλύτερο από ισορροπημένου δέντρου";
+    else if (h->file_size != s->size || snap_records_offset(h->count) + h->count * sizeof(Citizen) != s->size)
+        why = "λάθος μέγεθος αρχείου";
+    else if (verify && !snapshot_verify(s)) why = "λάθος άθροισμα ελέγχου δεδομένων";
+    if (why) {
+        munmap(p, s->size);
+        memset(s, 0, sizeof(*s));
+        return bin_fail(path, why);
+    }
+    s->node = (const SnapNode*)(s->base + sizeof(SnapHeader));
+    s->rec = (const Citizen*)(s->base + snap_records_offset(h->count));
+    return (int)h->count;
+}
+
+void snapshot_close(Snapshot *s) {
+    if (s->base) munmap((void*)s->base, s->size);
+    memset(s, 0, sizeof(*s));
+}
+
+/* Αναζήτηση κατευθείαν στο mapping. Οι θέσεις ελέγχονται (i < count) και η
+ * κατάβαση σταματά στο ύψος του header, ώστε και ένα αρχείο χωρίς verify
+ * να μη διαβάζει έξω από τους πίνακες ούτε να κάνει κύκλους. */
+const Citizen* snapshot_search(const Snapshot *s, const char *name) {
+    uint64_t key = key_prefix(name);
+    uint32_t i = s->h.root, n = (uint32_t)s->h.count;
+    for (uint32_t depth = 0; i < n && depth < s->h.height; depth++) {
+        const SnapNode *sn = &s->node[i];
+        int cmp = key_cmp(key, name, sn->key, s->rec[i].full_name);
+        if (cmp == 0) return &s->rec[i];
+        i = (cmp < 0) ? sn->left : sn->right;
+    }
+    return NULL;
+}
+
+/* Οι κόμβοι είναι αριθμημένοι in-order: οι εγγραφές πρέπει να είναι αυστηρά
+ * αύξουσες, με τερματισμένα strings και σωστό πρόθεμα - O(n) */
+static int snap_order_ok(const Snapshot *s) {
+    for (uint64_t i = 0; i < s->h.count; i++) {
+        const Citizen *c = &s->rec[i];
+        if (!memchr(c->full_name, 0, sizeof(c->full_name)) || !memchr(c->state, 0, sizeof(c->state))) return 0;
+        if (s->node[i].key != key_prefix(c->full_name)) return 0;
+        if (i > 0 && key_cmp(s->node[i - 1].key, s->rec[i - 1].full_name, s->node[i].key, c->full_name) >= 0) return 0;
+    }
+    return 1;
+}
+
+/* Ανασύσταση του δέντρου με δείκτες από τη ρίζα. Κάθε σύνδεσμος ελέγχεται
+ * (θέση μέσα στο in-order διάστημα [lo, hi) του υποδέντρου, ίδιος γονέας
+ * και στις δύο πλευρές, βάθος έως το ύψος), άρα κάθε κόμβος επισκέπτεται
+ * το πολύ μία φορά και η θέση του είναι η in-order σειρά του - μαζί με το
+ * snap_order_ok, τα ονόματα είναι σε σειρά BST. Η ισορροπία (ύψη AVL,
+ * χρώματα RBT) ελέγχεται στην επιστροφή. */
+static int snap_link_ok(const Snapshot *s, uint32_t i, uint32_t parent, uint32_t lo, uint32_t hi, uint32_t depth) {
+    return i >= lo && i < hi && s->node[i].parent == parent && depth < s->h.height;
+}
+
+static BSTNode* snap_thaw_bst(const Snapshot *s, uint32_t i, uint32_t parent, uint32_t lo, uint32_t hi,
+                              uint32_t depth, uint64_t *made, int *bad) {
+    if (i == SNAP_NONE || *bad) return NULL;
+    if (!snap_link_ok(s, i, parent, lo, hi, depth)) { *bad = 1; return NULL; }
+    const SnapNode *sn = &s->node[i];
+    BSTNode *n = bst_create(sn->key, &s->rec[i]);
+    n->height = sn->height;
+    (*made)++;
+    n->left = snap_thaw_bst(s, sn->left, i, lo, i, depth + 1, made, bad);
+    n->right = snap_thaw_bst(s, sn->right, i, i + 1, hi, depth + 1, made, bad);
+    int hl = avl_height(n->left), hr = avl_height(n->right);
+    if (n->height != avl_max(hl, hr) + 1 || hl - hr > 1 || hr - hl > 1) *bad = 1;
+    return n;
+}
+
+/* *black: μαύρο ύψος του υποδέντρου (0 για το NIL) */
+static RBTNode* snap_thaw_rbt(const Snapshot *s, uint32_t i, uint32_t parent, RBTNode *up, uint32_t lo, uint32_t hi,
+                              uint32_t depth, uint64_t *made, int *black, int *bad) {
+    *black = 0;
+    if (i == SNAP_NONE || *bad) return RBT_NIL;
+    if (!snap_link_ok(s, i, parent, lo, hi, depth)) { *bad = 1; return RBT_NIL; }
+    const SnapNode *sn = &s->node[i];
+    RBTNode *n = rbt_create(&s->rec[i]);
+    n->parent = up;
+    n->height = sn->height;
+    n->color = sn->color == 'R' ? 'R' : 'B';
+    (*made)++;
+    int bl, br;
+    n->left = snap_thaw_rbt(s, sn->left, i, n, lo, i, depth + 1, made, &bl, bad);
+    n->right = snap_thaw_rbt(s, sn->right, i, n, i + 1, hi, depth + 1, made, &br, bad);
+    if (bl != br || (n->color == 'R' && (n->left->color == 'R' || n->right->color == 'R'))) *bad = 1;
+    *black = bl + (n->color == 'B');
+    return n;
+}
+
+/* Το δέντρο στο *root - επιστρέφει το πλήθος κόμβων ή -1 αν το στιγμιότυπο
+ * δεν περιγράφει έγκυρο δέντρο (τότε *root = NULL) */
+int avl_snapshot_load(const Snapshot *s, BSTNode **root) {
+    uint64_t made = 0;
+    int bad = s->h.kind != SNAP_AVL || !snap_order_ok(s);
+    *root = bad ? NULL : snap_thaw_bst(s, s->h.root, SNAP_NONE, 0, (uint32_t)s->h.count, 0, &made, &bad);
+    if (bad || made != s->h.count) { bst_free(*root); *root = NULL; return -1; }
+    return (int)made;
+}
+
+int rbt_snapshot_load(const Snapshot *s, RBTNode **root) {
+    uint64_t made = 0;
+    int black;
+    int bad = s->h.kind != SNAP_RBT || !snap_order_ok(s);
+    RBTNode *r = bad ? RBT_NIL : snap_thaw_rbt(s, s->h.root, SNAP_NONE, RBT_NIL, 0, (uint32_t)s->h.count, 0, &made, &black, &bad);
+    *root = r == RBT_NIL ? NULL : r;
+    if (bad || made != s->h.count || (*root && (*root)->color != 'B')) { rbt_free(*root); *root = NULL; return -1; }
+    return (int)made;
+}
+
+/* ============ Αρχείο Καταγραφής (WAL) ============ */
+
+/* Προαιρετικό append-only log λειτουργιών μπροστά από τα insert/delete ενός
+ * AVL ή RBT: κάθε λειτουργία γράφεται πρώτα στο log και μετά εφαρμόζεται στο
+ * δέντρο. Οι εγγραφές μαζεύονται σε buffer και γράφονται με write +
+ * fdatasync ανά ομάδα (group commit): κάθε every_ops λειτουργίες ή όταν
+ * περάσουν every_ms από το προηγούμενο sync. Το όριο χρόνου ελέγχεται σε κάθε
+ * λειτουργία (δεν υπάρχει νήμα στο παρασκήνιο), οπότε ένα αδρανές log
+ * γράφεται στην επόμενη λειτουργία ή στο wal_commit. Μια λειτουργία είναι
+ * μόνιμη όταν lsn <= durable_lsn.
+ *
+ * Checkpoint: sync του log, στιγμιότυπο του δέντρου (με msync) και νέο άδειο
+ * log που ξεκινά από το επόμενο lsn. Στο άνοιγμα φορτώνεται το στιγμιότυπο
+ * και εφαρμόζονται οι εγγραφές του log ως την πρώτη κομμένη ή αλλοιωμένη,
+ * όπου το log περικόπτεται. Αν η διακοπή έγινε μετά το στιγμιότυπο αλλά πριν
+ * από το νέο log, το παλιό log ξαναεφαρμόζεται πάνω στο νέο στιγμιότυπο - αυτό
+ * δίνει το ίδιο δέντρο, γιατί για κάθε όνομα μετρά μόνο η τελευταία διαγραφή
+ * και το πρώτο insert μετά από αυτήν (το insert αγνοεί υπάρχοντα ονόματα). */
+#define WAL_MAGIC "CITZWAL1"
+#define WAL_VERSION 1
+#define WAL_BUF_MAX (1u << 20)  /* πάνω από αυτό ο buffer γράφεται, χωρίς sync */
+
+enum { WAL_INSERT = 1, WAL_DELETE = 2 };
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;              /* SNAP_AVL ή SNAP_RBT */
+    uint64_t start_lsn;         /* lsn της πρώτης εγγραφής */
+    uint64_t header_checksum;   /* τα πρώτα 24 bytes */
+} WalHeader;
+
+/* Ακολουθεί payload size bytes: για insert age και income (int32),
+ * full_name\0 και state\0 - για delete μόνο full_name\0 */
+typedef struct {
+    uint64_t checksum;          /* των bytes μετά από αυτό, μαζί με το payload */
+    uint64_t lsn;
+    uint32_t size;
+    uint32_t op;
+} WalRecord;
+
+typedef struct {
+    int every_ops;              /* sync κάθε N λειτουργίες (0 = χωρίς όριο) */
+    int every_ms;               /* sync όταν περάσουν T ms (0 = χωρίς όριο) */
+    int sync;                   /* 0: μόνο write στο λειτουργικό, χωρίς fdatasync */
+} WalPolicy;
+
+/* Δέντρο με log - το δέντρο είναι στο avl ή στο rbt ανάλογα με το kind */
+typedef struct {
+    int kind;
+    BSTNode *avl;
+    RBTNode *rbt;
+    int fd;                     /* -1: χωρίς log, μόνο στη μνήμη */
+    int failed;                 /* μετά από σφάλμα εγγραφής δεν δέχεται λειτουργίες */
+    char log_path[1024], snap_path[1024];
+    WalPolicy policy;
+    unsigned char *buf;
+    size_t len, cap;
+    uint64_t next_lsn;          /* lsn της επόμενης λειτουργίας */
+    uint64_t durable_lsn;       /* ως και αυτή έχουν γίνει fdatasync */
+    int pending;                /* λειτουργίες από το τελευταίο group commit */
+    uint64_t last_sync_ns;
+    uint64_t syncs, log_bytes, replayed;
+} WalTree;
+
+/* fsync του καταλόγου, ώστε μια μετονομασία να είναι μόνιμη */
+static void sync_parent_dir(const char *path) {
+    char dir[1024];
+    const char *slash = strrchr(path, '/');
+    if (!slash) snprintf(dir, sizeof(dir), ".");
+    else snprintf(dir, sizeof(dir), "%.*s", slash == path ? 1 : (int)(slash - path), path);
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) { fsync(fd); close(fd); }
+}
+
+static void wal_apply(WalTree *w, int op, const Citizen *c) {
+    if (w->kind == SNAP_AVL) w->avl = op == WAL_INSERT ? avl_insert(w->avl, c) : avl_delete(w->avl, c->full_name);
+    else w->rbt = op == WAL_INSERT ? rbt_insert(w->rbt, c) : rbt_delete(w->rbt, c->full_name);
+}
+
+/* Νέο άδειο log (μέσω path.tmp, fsync και μετονομασίας), ανοιχτό για προσθήκες */
+static int wal_create_log(WalTree *w, uint64_t start_lsn) {
+    char tmp[1100];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", w->log_path);
+    WalHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, WAL_MAGIC, 8);
+    h.version = WAL_VERSION;
+    h.kind = (uint32_t)w->kind;
+    h.start_lsn = start_lsn;
+    h.header_checksum = bin_checksum(&h, offsetof(WalHeader, header_checksum));
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return bin_fail(tmp, "δεν δημιουργείται");
+    if (write(fd, &h, sizeof(h)) != (ssize_t)sizeof(h) || fsync(fd) != 0 || rename(tmp, w->log_path) != 0) {
+        close(fd);
+        unlink(tmp);
+        return bin_fail(w->log_path, "αποτυχία δημιουργίας log");
+    }
+    sync_parent_dir(w->log_path);
+    if (w->fd >= 0) close(w->fd);
+    w->fd = fd;
+    w->log_bytes = sizeof(h);
+    w->durable_lsn = start_lsn - 1;
+    w->last_sync_ns = now_ns();
+    return 0;
+}
+
+/* Εγγραφή του buffer στο log. Σε σφάλμα το log περικόπτεται στο τελευταίο
+ * πλήρες σημείο και το δέντρο δεν δέχεται άλλες λειτουργίες. */
+static int wal_write(WalTree *w) {
+    for (size_t off = 0; off < w->len;) {
+        ssize_t k = write(w->fd, w->buf + off, w->len - off);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) {
+            w->failed = 1;
+            if (ftruncate(w->fd, (off_t)w->log_bytes) == 0) lseek(w->fd, (off_t)w->log_bytes, SEEK_SET);
+            return bin_fail(w->log_path, "αποτυχία εγγραφής log");
+        }
+        off += (size_t)k;
+    }
+    w->log_bytes += w->len;
+    w->len = 0;
+    return 0;
+}
+
+/* Group commit: write και, αν sync, fdatasync - μετά από αυτό όλες οι
+ * λειτουργίες ως το next_lsn - 1 είναι μόνιμες */
+static int wal_group_commit(WalTree *w, int sync) {
+    if (wal_write(w) != 0) return -1;
+    if (sync) {
+        if (fdatasync(w->fd) != 0) { w->failed = 1; return bin_fail(w->log_path, "αποτυχία fdatasync"); }
+        w->syncs++;
+        w->durable_lsn = w->next_lsn - 1;
+    }
+    w->pending = 0;
+    w->last_sync_ns = now_ns();
+    return 0;
+}
+
+static int wal_append(WalTree *w, int op, const Citizen *c) {
+    if (w->fd < 0) return 0;
+    if (w->failed) return -1;
+    size_t name_len = strnlen(c->full_name, sizeof(c->full_name) - 1) + 1;
+    size_t state_len = op == WAL_INSERT ? strnlen(c->state, sizeof(c->state) - 1) + 1 : 0;
+    size_t size = op == WAL_INSERT ? 2 * sizeof(int32_t) + name_len + state_len : name_len;
+    size_t need = w->len + sizeof(WalRecord) + size;
+    if (need > w->cap) {
+        size_t cap = w->cap ? w->cap * 2 : 4096;
+        while (cap < need) cap *= 2;
+        unsigned char *b = (unsigned char*)realloc(w->buf, cap);
+        if (!b) { printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n"); return -1; }
+        w->buf = b;
+        w->cap = cap;
+    }
+
+    unsigned char *p = w->buf + w->len, *q = p + sizeof(WalRecord);
+    WalRecord r = {0, w->next_lsn, (uint32_t)size, (uint32_t)op};
+    if (op == WAL_INSERT) {
+        int32_t v[2] = {c->age, c->annual_income};
+        memcpy(q, v, sizeof(v));
+        q += sizeof(v);
+    }
+    memcpy(q, c->full_name, name_len - 1);
+    q[name_len - 1] = '\0';
+    if (op == WAL_INSERT) {
+        memcpy(q + name_len, c->state, state_len - 1);
+        q[name_len + state_len - 1] = '\0';
+    }
+    memcpy(p, &r, sizeof(r));
+    r.checksum = bin_checksum(p + sizeof(r.checksum), sizeof(r) - sizeof(r.checksum) + size);
+    memcpy(p, &r.checksum, sizeof(r.checksum));
+    w->len = need;
+    w->next_lsn++;
+    w->pending++;
+
+    const WalPolicy *pol = &w->policy;
+    if ((pol->every_ops > 0 && w->pending >= pol->every_ops) ||
+        (pol->every_ms > 0 && now_ns() - w->last_sync_ns >= (uint64_t)pol->every_ms * 1000000ULL))
+        return wal_group_commit(w, pol->sync);
+    return w->len >= WAL_BUF_MAX ? wal_write(w) : 0;
+}
+
+/* Λειτουργίες: 0 ή -1 αν το log απέτυχε (τότε το δέντρο δεν αλλάζει) */
+int wal_insert(WalTree *w, const Citizen *c) {
+    if (wal_append(w, WAL_INSERT, c) != 0) return -1;
+    wal_apply(w, WAL_INSERT, c);
+    return 0;
+}
+
+int wal_delete(WalTree *w, const char *name) {
+    Citizen c;
+    memset(&c, 0, sizeof(c));
+    snprintf(c.full_name, sizeof(c.full_name), "%s", name);
+    if (wal_append(w, WAL_DELETE, &c) != 0) return -1;
+    wal_apply(w, WAL_DELETE, &c);
+    return 0;
+}
+
+/* Όλες οι λειτουργίες ως τώρα γίνονται μόνιμες, ανεξάρτητα από την πολιτική */
+int wal_commit(WalTree *w) {
+    if (w->fd < 0) return 0;
+    if (w->failed) return -1;
+    return (w->len || w->durable_lsn + 1 < w->next_lsn) ? wal_group_commit(w, 1) : 0;
+}
+
+/* Στιγμιότυπο του δέντρου και νέο άδειο log από το επόμενο lsn */
+int wal_checkpoint(WalTree *w) {
+    if (w->fd < 0) return 0;
+    if (wal_commit(w) != 0) return -1;
+    if (!snapshot_save(w->snap_path, w->kind, w->avl, w->rbt, 1)) return -1;
+    sync_parent_dir(w->snap_path);
+    return wal_create_log(w, w->next_lsn);
+}
+
+/* Αποκωδικοποίηση payload - 0 αν τα μήκη ή οι τερματισμοί δεν ταιριάζουν */
+static int wal_decode(const WalRecord *r, const char *q, Citizen *c) {
+    memset(c, 0, sizeof(*c));
+    size_t size = r->size;
+    if (r->op == WAL_INSERT) {
+        if (size < 2 * sizeof(int32_t) + 2) return 0;
+        int32_t v[2];
+        memcpy(v, q, sizeof(v));
+        c->age = v[0];
+        c->annual_income = v[1];
+        q += sizeof(v);
+        size -= sizeof(v);
+    } else if (r->op != WAL_DELETE) return 0;
+    const char *end = (const char*)memchr(q, '\0', size);
+    if (!end || (size_t)(end - q) >= sizeof(c->full_name)) return 0;
+    memcpy(c->full_name, q, (size_t)(end - q));
+    if (r->op == WAL_DELETE) return (size_t)(end - q) + 1 == size;
+    const char *st = end + 1;
+    size_t rest = size - (size_t)(st - q);
+    if (rest == 0 || st[rest - 1] != '\0' || rest > sizeof(c->state)) return 0;
+    memcpy(c->state, st, rest);
+    return 1;
+}
+
+/* Εφαρμογή των εγγραφών από το start_lsn - επιστρέφει το offset μετά την
+ * τελευταία έγκυρη εγγραφή */
+static size_t wal_replay(WalTree *w, const unsigned char *p, size_t size, uint64_t start_lsn) {
+    size_t off = sizeof(WalHeader);
+    uint64_t lsn = start_lsn;
+    while (size - off >= sizeof(WalRecord)) {
+        WalRecord r;
+        memcpy(&r, p + off, sizeof(r));
+        if (r.lsn != lsn || r.size > size - off - sizeof(r) || r.size > sizeof(Citizen)) break;
+        if (bin_checksum(p + off + sizeof(r.checksum), sizeof(r) - sizeof(r.checksum) + r.size) != r.checksum) break;
+        Citizen c;
+        if (!wal_decode(&r, (const char*)(p + off + sizeof(r)), &c)) break;
+        wal_apply(w, (int)r.op, &c);
+        off += sizeof(r) + r.size;
+        lsn++;
+        w->replayed++;
+    }
+    w->next_lsn = lsn;
+    return off;
+}
+
+static int wal_open_fail(WalTree *w, const char *path, const char *why) {
+    bst_free(w->avl); rbt_free(w->rbt);
+    w->avl = NULL; w->rbt = NULL;
+    if (w->fd >= 0) close(w->fd);
+    w->fd = -1;
+    return bin_fail(path, why);
+}
+
+/* Άνοιγμα δέντρου με log: φόρτωση του στιγμιοτύπου αν υπάρχει, replay του
+ * log και περικοπή του μετά την τελευταία έγκυρη εγγραφή (ή δημιουργία νέου).
+ * Με log_path NULL το δέντρο μένει μόνο στη μνήμη. Επιστρέφει 0 ή -1. */
+int wal_open(WalTree *w, int kind, const char *log_path, const char *snap_path, WalPolicy policy) {
+    memset(w, 0, sizeof(*w));
+    w->kind = kind;
+    w->fd = -1;
+    w->policy = policy;
+    w->next_lsn = 1;
+    if (!log_path) return 0;
+    snprintf(w->log_path, sizeof(w->log_path), "%s", log_path);
+    snprintf(w->snap_path, sizeof(w->snap_path), "%s", snap_path);
+
+    if (access(snap_path, F_OK) == 0) {
+        Snapshot s;
+        int ok = snapshot_open(&s, snap_path, kind, 1) >= 0 &&
+                 (kind == SNAP_AVL ? avl_snapshot_load(&s, &w->avl) : rbt_snapshot_load(&s, &w->rbt)) >= 0;
+        snapshot_close(&s);
+        if (!ok) return wal_open_fail(w, snap_path, "το στιγμιότυπο δεν φορτώνεται");
+    }
+
+    int fd = open(log_path, O_RDWR);
+    if (fd < 0 && errno == ENOENT) {
+        if (wal_create_log(w, 1) == 0) return 0;
+        return wal_open_fail(w, log_path, "αποτυχία ανοίγματος");
+    }
+    if (fd < 0) return wal_open_fail(w, log_path, "δεν ανοίγει");
+    w->fd = fd;
+    struct stat st;
+    WalHeader h;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(h) || pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) ||
+        memcmp(h.magic, WAL_MAGIC, 8) != 0 || h.version != WAL_VERSION ||
+        bin_checksum(&h, offsetof(WalHeader, header_checksum)) != h.header_checksum)
+        return wal_open_fail(w, log_path, "δεν είναι έγκυρο log");
+    if (h.kind != (uint32_t)kind) return wal_open_fail(w, log_path, "log άλλου τύπου δέντρου");
+
+    size_t size = (size_t)st.st_size, end = sizeof(h);
+    w->next_lsn = h.start_lsn;
+    if (size > sizeof(h)) {
+        void *p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) return wal_open_fail(w, log_path, "αποτυχία mmap");
+        end = wal_replay(w, (const unsigned char*)p, size, h.start_lsn);
+        munmap(p, size);
+    }
+    /* Κομμένη ουρά από διακοπή: οι νέες εγγραφές συνεχίζουν μετά την τελευταία έγκυρη */
+    if ((end < size && ftruncate(fd, (off_t)end) != 0) || lseek(fd, (off_t)end, SEEK_SET) < 0)
+        return wal_open_fail(w, log_path, "αποτυχία περικοπής");
+    w->log_bytes = end;
+    w->durable_lsn = w->next_lsn - 1;
+    w->last_sync_ns = now_ns();
+    return 0;
+}
+
+/* Commit των εκκρεμών λειτουργιών και απελευθέρωση του δέντρου */
+int wal_close(WalTree *w) {
+    int rc = wal_commit(w);
+    if (w->fd >= 0) close(w->fd);
+    free(w->buf);
+    bst_free(w->avl); rbt_free(w->rbt);
+    memset(w, 0, sizeof(*w));
+    w->fd = -1;
+    return rc;
+}
+
+/* ============ Αποθήκη σε Shards ============ */
+
+/* N ανεξάρτητα AVL ή RBT δέντρα (shards). Κάθε όνομα ανήκει στο shard που
+ * δίνει ένα hash του full_name, και κάθε shard έχει δικό του mutex και δική
+ * του arena, οπότε inserts/deletes σε διαφορετικά shards δεν μοιράζονται ούτε
+ * lock ούτε allocator. Οι λειτουργίες ενός ονόματος αγγίζουν μόνο το shard
+ * του. Η διατεταγμένη διάσχιση και τα ερωτήματα εύρους κλειδώνουν όλα τα
+ * shards με τη σειρά (συνεπές στιγμιότυπο χωρίς deadlock) και συγχωνεύουν
+ * με σωρό k δρόμων τους iterators των shards, χωρίς ενδιάμεσους πίνακες. */
+#define SHARD_MAX 64
+
+typedef struct {
+    pthread_mutex_t lock;
+    NodePool pool;                  /* κόμβοι του shard - pool.live = πλήθος εγγραφών */
+    BSTNode *avl;
+    RBTNode *rbt;
+    char pad[64];                   /* τα mutex γειτονικών shards σε άλλη cache line */
+} Shard;
+
+typedef struct {
+    int kind;                       /* SNAP_AVL ή SNAP_RBT */
+    int shards;
+    Shard *shard;
+} ShardStore;
+
+/* FNV-1a σε όλο το όνομα: το πρόθεμα των 8 bytes (το κλειδί των δέντρων)
+ * είναι σχεδόν μόνο το μικρό όνομα και θα μοίραζε άνισα */
+static inline uint64_t shard_hash(const char *name) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (; *name; name++) h = (h ^ (unsigned char)*name) * 0x100000001B3ULL;
+    return h;
+}
+
+static inline Shard* shard_of(ShardStore *s, const char *name) {
+    return &s->shard[((shard_hash(name) >> 32) * (uint64_t)s->shards) >> 32];
+}
+
+int shard_store_init(ShardStore *s, int kind, int shards) {
+    if (shards < 1 || shards > SHARD_MAX || (kind != SNAP_AVL && kind != SNAP_RBT)) return -1;
+    s->kind = kind;
+    s->shards = shards;
+    s->shard = (Shard*)calloc(shards, sizeof(Shard));
+    if (!s->shard) return -1;
+    for (int i = 0; i < shards; i++) {
+        pthread_mutex_init(&s->shard[i].lock, NULL);
+        pool_init(&s->shard[i].pool, kind == SNAP_AVL ? sizeof(BSTNode) : sizeof(RBTNode));
+    }
+    return 0;
+}
+
+/* Insert (c != NULL) ή delete του name στο shard του - 1 αν άλλαξε το shard.
+ * Η arena του νήματος δείχνει στο shard όσο κρατιέται το lock. */
+static int shard_update(ShardStore *s, const char *name, const Citizen *c) {
+    Shard *sh = shard_of(s, name);
+    pthread_mutex_lock(&sh->lock);
+    NodePool *saved_bst = bst_pool, *saved_rbt = rbt_pool;
+    bst_pool = rbt_pool = &sh->pool;
+    size_t before = sh->pool.live;
+    if (s->kind == SNAP_AVL) sh->avl = c ? avl_insert(sh->avl, c) : avl_delete(sh->avl, name);
+    else sh->rbt = c ? rbt_insert(sh->rbt, c) : rbt_delete(sh->rbt, name);
+    int changed = sh->pool.live != before;
+    bst_pool = saved_bst;
+    rbt_pool = saved_rbt;
+    pthread_mutex_unlock(&sh->lock);
+    return changed;
+}
+
+int shard_insert(ShardStore *s, const Citizen *c) {
+    return shard_update(s, c->full_name, c);
+}
+
+int shard_delete(ShardStore *s, const char *name) {
+    return shard_update(s, name, NULL);
+}
+
+/* Αναζήτηση με αντιγραφή της εγγραφής - 1 αν βρέθηκε */
+int shard_search(ShardStore *s, const char *name, Citizen *out) {
+    Shard *sh = shard_of(s, name);
+    pthread_mutex_lock(&sh->lock);
+    const Citizen *c = NULL;
+    if (s->kind == SNAP_AVL) { BSTNode *n = bst_search(sh->avl, name); if (n) c = &n->data; }
+    else { RBTNode *n = rbt_search(sh->rbt, name); if (n) c = &n->data; }
+    if (c) *out = *c;
+    pthread_mutex_unlock(&sh->lock);
+    return c != NULL;
+}
+
+/* Δρόμος της συγχώνευσης: iterator στο δέντρο ενός shard και η τρέχουσα
+ * εγγραφή του (NULL όταν εξαντληθεί ή περάσει το hi) */
+typedef struct {
+    BSTIter it;
+    RBTNode *rbt;
+    const Citizen *cur;
+} ShardRun;
+
+static void shard_run_next(const ShardStore *s, ShardRun *r, const char *hi) {
+    const Citizen *c = NULL;
+    if (s->kind == SNAP_AVL) { BSTNode *n = bst_iter_next(&r->it); if (n) c = &n->data; }
+    else if (r->rbt) { c = &r->rbt->data; r->rbt = rbt_next(r->rbt); }
+    r->cur = (c && (!hi || strcmp(c->full_name, hi) <= 0)) ? c : NULL;
+}
+
+static inline const char* shard_run_name(const ShardRun *r) {
+    return r->cur->full_name;
+}
+
+static void shard_heap_down(const ShardRun *run, int *heap, int n, int i) {
+    for (;;) {
+        int m = i, l = 2 * i + 1, r = l + 1;
+        if (l < n && strcmp(shard_run_name(&run[heap[l]]), shard_run_name(&run[heap[m]])) < 0) m = l;
+        if (r < n && strcmp(shard_run_name(&run[heap[r]]), shard_run_name(&run[heap[m]])) < 0) m = r;
+        if (m == i) return;
+        int t = heap[i]; heap[i] = heap[m]; heap[m] = t;
+        i = m;
+    }
+}
+
+/* Όλες οι εγγραφές με lo <= όνομα <= hi σε αλφαβητική σειρά (NULL = χωρίς
+ * όριο) - επιστρέφει το πλήθος ή ITER_FAILED αν κάποιος iterator αποτύχει.
+ * Η visit καλείται με όλα τα shards κλειδωμένα και δεν πρέπει να αλλάζει
+ * την αποθήκη. */
+size_t shard_range(ShardStore *s, const char *lo, const char *hi, void (*visit)(const Citizen*, void*), void *arg) {
+    ShardRun *run = (ShardRun*)calloc(s->shards, sizeof(ShardRun));
+    int *heap = (int*)malloc(s->shards * sizeof(int)), n = 0;
+    for (int i = 0; i < s->shards; i++) pthread_mutex_lock(&s->shard[i].lock);
+    for (int i = 0; i < s->shards; i++) {
+        if (s->kind == SNAP_AVL) bst_iter_seek(&run[i].it, s->shard[i].avl, lo);
+        else run[i].rbt = rbt_seek(s->shard[i].rbt, lo);
+        shard_run_next(s, &run[i], hi);
+        if (run[i].cur) heap[n++] = i;
+    }
+    for (int i = n / 2 - 1; i >= 0; i--) shard_heap_down(run, heap, n, i);
+    size_t total = 0;
+    while (n) {
+        ShardRun *r = &run[heap[0]];
+        if (visit) visit(r->cur, arg);
+        total++;
+        shard_run_next(s, r, hi);
+        if (!r->cur) heap[0] = heap[--n];
+        shard_heap_down(run, heap, n, 0);
+    }
+    for (int i = s->shards - 1; i >= 0; i--) pthread_mutex_unlock(&s->shard[i].lock);
+    if (s->kind == SNAP_AVL)
+        for (int i = 0; i < s->shards; i++) {
+            if (run[i].it.failed) total = ITER_FAILED;
+            bst_iter_done(&run[i].it);
+        }
+    free(run);
+    free(heap);
+    return total;
+}
+
+size_t shard_traverse(ShardStore *s, void (*visit)(const Citizen*, void*), void *arg) {
+    return shard_range(s, NULL, NULL, visit, arg);
+}
+
+/* Μόνο όταν δεν τρέχει πια κανένα νήμα - οι arenas ελευθερώνονται χωρίς διάσχιση */
+void shard_store_destroy(ShardStore *s) {
+    for (int i = 0; i < s->shards; i++) {
+        pool_destroy(&s->shard[i].pool);
+        pthread_mutex_destroy(&s->shard[i].lock);
+    }
+    free(s->shard);
+    s->shard = NULL;
+    s->shards = 0;
+}
+
+/* ============ Πολλαπλά Ευρετήρια ============ */
+
+/* Αποθήκη πολιτών με κύριο δέντρο ονομάτων (OS-AVL, κρατά τις εγγραφές),
+ * δευτερεύοντα διατεταγμένα ευρετήρια σε annual_income και age και ένα
+ * ευρετήριο ανά πολιτεία, διατεταγμένο κατά εισόδημα. Τα δευτερεύοντα
+ * είναι AVL με μεγέθη υποδέντρων και κλειδί (τιμή, όνομα) - το όνομα κάνει
+ * μοναδικό το κλειδί για ίδιες τιμές - και δείχνουν στην εγγραφή του
+ * κύριου κόμβου, που δεν αλλάζει διεύθυνση όσο υπάρχει. Insert και delete αλλάζουν όλα τα ευρετήρια κάτω
+ * από το ίδιο write lock, οπότε ένα ερώτημα βλέπει μια εγγραφή σε όλα ή σε
+ * κανένα. Ο planner μετρά σε O(log n) πόσες εγγραφές θα διάβαζε κάθε
+ * υποψήφιο ευρετήριο και σαρώνει το μικρότερο, φιλτράροντας τα υπόλοιπα
+ * κριτήρια. Κάθε κόμβος κρατά επίσης πλήθος, άθροισμα, min και max
+ * εισοδήματος του υποδέντρου του, οπότε συναθροίσεις εισοδήματος σε εύρος
+ * του κλειδιού ενός ευρετηρίου βγαίνουν σε O(log n) χωρίς σάρωση. */
+#define MIDX_STATE_SLOTS 1024           /* δύναμη του 2 */
+
+typedef struct IdxNode {
+    uint64_t key;                   /* πρόθεμα του ονόματος, όπως στα δέντρα ονομάτων */
+    const Citizen *rec;
+    struct IdxNode *left;
+    struct IdxNode *right;
+    long long sum;                  /* άθροισμα εισοδήματος του υποδέντρου */
+    int value;                      /* annual_income ή age */
+    int height;
+    int size;
+    int income;                     /* annual_income της εγγραφής */
+    int min, max;                   /* min / max εισοδήματος του υποδέντρου */
+} IdxNode;
+
+static MemStats idx_mem;
+
+static inline int idx_size(const IdxNode *n) { return n ? n->size : 0; }
+static inline int idx_height(const IdxNode *n) { return n ? n->height : 0; }
+
+/* Σε ίδιες τιμές συγκρίνεται το πρόθεμα και η εγγραφή διαβάζεται μόνο αν
+ * ταυτίζεται και αυτό */
+static inline int idx_cmp(int value, uint64_t key, const char *name, const IdxNode *n) {
+    if (value != n->value) return value < n->value ? -1 : 1;
+    return key_cmp(key, name, n->key, n->rec->full_name);
+}
+
+static inline void idx_update(IdxNode *n) {
+    n->height = avl_max(idx_height(n->left), idx_height(n->right)) + 1;
+    n->size = idx_size(n->left) + idx_size(n->right) + 1;
+    n->sum = n->income;
+    n->min = n->max = n->income;
+    if (n->left) {
+        n->sum += n->left->sum;
+        if (n->left->min < n->min) n->min = n->left->min;
+        if (n->left->max > n->max) n->max = n->left->max;
+    }
+    if (n->right) {
+        n->sum += n->right->sum;
+        if (n->right->min < n->min) n->min = n->right->min;
+        if (n->right->max > n->max) n->max = n->right->max;
+    }
+}
+
+static IdxNode* idx_rotate_right(IdxNode *y) {
+    IdxNode *x = y->left;
+    y->left = x->right; x->right = y;
+    idx_update(y); idx_update(x);
+    return x;
+}
+
+static IdxNode* idx_rotate_left(IdxNode *x) {
+    IdxNode *y = x->right;
+    x->right = y->left; y->left = x;
+    idx_update(x); idx_update(y);
+    return y;
+}
+
+static IdxNode* idx_rebalance(IdxNode *n) {
+    idx_update(n);
+    int bal = idx_height(n->left) - idx_height(n->right);
+    if (bal > 1) {
+        if (idx_height(n->left->left) < idx_height(n->left->right)) n->left = idx_rotate_left(n->left);
+        return idx_rotate_right(n);
+    }
+    if (bal < -1) {
+        if (idx_height(n->right->right) < idx_height(n->right->left)) n->right = idx_rotate_right(n->right);
+        return idx_rotate_left(n);
+    }
+    return n;
+}
+
+static void idx_fix_path(IdxNode **path[], int depth) {
+    while (depth > 0) {
+        IdxNode **l = path[--depth];
+        int old = (*l)->height;
+        *l = idx_rebalance(*l);
+        if ((*l)->height == old) break;
+    }
+    /* Πάνω από εκεί δεν αλλάζει το ύψος, αλλά μέγεθος και αθροίσματα ναι */
+    while (depth > 0) idx_update(*path[--depth]);
+}
+
+/* Το κλειδί (value, όνομα) είναι μοναδικό, αφού τα ονόματα είναι μοναδικά
+ * στο κύριο δέντρο */
+static IdxNode* idx_insert(IdxNode *root, int value, uint64_t key, const Citizen *rec) {
+    IdxNode **path[AVL_MAX_DEPTH];
+    int depth = 0;
+    IdxNode **link = &root;
+    while (*link) {
+        path[depth++] = link;
+        link = idx_cmp(value, key, rec->full_name, *link) < 0 ? &(*link)->left : &(*link)->right;
+    }
+    IdxNode *n = (IdxNode*)node_alloc(NULL, &idx_mem, sizeof(IdxNode));
+    n->key = key;
+    n->rec = rec;
+    n->left = n->right = NULL;
+    n->value = value;
+    n->income = rec->annual_income;
+    idx_update(n);
+    *link = n;
+    idx_fix_path(path, depth);
+    return root;
+}
+
+static IdxNode* idx_delete(IdxNode *root, int value, uint64_t key, const char *name) {
+    IdxNode **path[AVL_MAX_DEPTH];
+    int depth = 0;
+    IdxNode **link = &root;
+    while (*link) {
+        int cmp = idx_cmp(value, key, name, *link);
+        if (cmp == 0) break;
+        path[depth++] = link;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+    IdxNode *z = *link;
+    if (!z) return root;
+    if (!z->left || !z->right) *link = z->left ? z->left : z->right;
+    else {
+        int zi = depth;
+        path[depth++] = link;
+        IdxNode **sl = &z->right;
+        while ((*sl)->left) { path[depth++] = sl; sl = &(*sl)->left; }
+        IdxNode *s = *sl;
+        *sl = s->right;
+        s->left = z->left; s->right = z->right; s->height = z->height;
+        *link = s;
+        if (depth > zi + 1) path[zi + 1] = &s->right;
+    }
+    node_free(NULL, &idx_mem, z, sizeof(IdxNode));
+    idx_fix_path(path, depth);
+    return root;
+}
+
+static void idx_free(IdxNode *root) {
+    if (!root) return;
+    idx_free(root->left);
+    idx_free(root->right);
+    node_free(NULL, &idx_mem, root, sizeof(IdxNode));
+}
+
+/* Νέο εισόδημα σε καταχώριση που κρατά τη θέση της (το κλειδί δεν είναι
+ * το εισόδημα): ξαναϋπολογίζονται μόνο τα αθροίσματα της διαδρομής */
+static int idx_refresh(IdxNode *root, int value, uint64_t key, const char *name, int income) {
+    IdxNode *path[AVL_MAX_DEPTH];
+    int depth = 0;
+    IdxNode *n = root;
+    while (n) {
+        int cmp = idx_cmp(value, key, name, n);
+        path[depth++] = n;
+        if (cmp == 0) break;
+        n = (cmp < 0) ? n->left : n->right;
+    }
+    if (!n) return 0;
+    n->income = income;
+    while (depth > 0) idx_update(path[--depth]);
+    return 1;
+}
+
+/* Πλήθος καταχωρίσεων με τιμή < v (long long, ώστε να δέχεται INT_MAX + 1) */
+static size_t idx_below(const IdxNode *n, long long v) {
+    size_t below = 0;
+    while (n) {
+        if (v <= n->value) n = n->left;
+        else { below += idx_size(n->left) + 1; n = n->right; }
+    }
+    return below;
+}
+
+/* Πλήθος καταχωρίσεων με lo <= τιμή <= hi σε O(log n) */
+size_t idx_count(const IdxNode *root, int lo, int hi) {
+    if (lo > hi) return 0;
+    return idx_below(root, (long long)hi + 1) - idx_below(root, lo);
+}
+
+/* Συνάθροιση εισοδήματος - σε κενό σύνολο count = 0 και min > max */
+typedef struct {
+    size_t count;
+    long long sum;
+    int min, max;
+} IdxAgg;
+
+static inline void idx_agg_init(IdxAgg *a) {
+    a->count = 0;
+    a->sum = 0;
+    a->min = INT_MAX;
+    a->max = INT_MIN;
+}
+
+static inline void idx_agg_add(IdxAgg *a, size_t count, long long sum, int min, int max) {
+    a->count += count;
+    a->sum += sum;
+    if (min < a->min) a->min = min;
+    if (max > a->max) a->max = max;
+}
+
+static inline void idx_agg_node(IdxAgg *a, const IdxNode *n) {
+    idx_agg_add(a, 1, n->income, n->income, n->income);
+}
+
+static inline void idx_agg_tree(IdxAgg *a, const IdxNode *n) {
+    if (n) idx_agg_add(a, n->size, n->sum, n->min, n->max);
+}
+
+/* Κάτω από τον κόμβο διαχωρισμού ισχύει ήδη το ένα όριο: σε κάθε βήμα ένα
+ * ολόκληρο υποδέντρο μπαίνει από τα αθροίσματά του */
+static void idx_agg_from(const IdxNode *n, int lo, IdxAgg *a) {
+    while (n) {
+        if (lo <= n->value) { idx_agg_node(a, n); idx_agg_tree(a, n->right); n = n->left; }
+        else n = n->right;
+    }
+}
+
+static void idx_agg_to(const IdxNode *n, int hi, IdxAgg *a) {
+    while (n) {
+        if (n->value <= hi) { idx_agg_node(a, n); idx_agg_tree(a, n->left); n = n->right; }
+        else n = n->left;
+    }
+}
+
+/* Συνάθροιση εισοδήματος των καταχωρίσεων με lo <= τιμή <= hi σε O(log n):
+ * κατάβαση ως τον πρώτο κόμβο μέσα στο εύρος και από εκεί μία διαδρομή
+ * προς κάθε όριο */
+void idx_aggregate(const IdxNode *n, int lo, int hi, IdxAgg *a) {
+    idx_agg_init(a);
+    if (lo > hi) return;
+    while (n && (n->value < lo || n->value > hi)) n = (n->value < lo) ? n->right : n->left;
+    if (!n) return;
+    idx_agg_node(a, n);
+    idx_agg_from(n->left, lo, a);
+    idx_agg_to(n->right, hi, a);
+}
+
+typedef struct {
+    IdxNode *stack[AVL_MAX_DEPTH];
+    int top;
+} IdxIter;
+
+/* Τοποθέτηση στην πρώτη καταχώριση με τιμή >= lo */
+static void idx_iter_seek(IdxIter *it, IdxNode *n, int lo) {
+    it->top = 0;
+    while (n) {
+        if (lo <= n->value) { it->stack[it->top++] = n; n = n->left; }
+        else n = n->right;
+    }
+}
+
+static IdxNode* idx_iter_next(IdxIter *it) {
+    if (!it->top) return NULL;
+    IdxNode *n = it->stack[--it->top];
+    for (IdxNode *x = n->right; x; x = x->left) it->stack[it->top++] = x;
+    return n;
+}
+
+typedef struct {
+    char name[50];
+    int used;
+    IdxNode *root;                  /* κλειδί (annual_income, όνομα) */
+} StateIndex;
+
+typedef struct {
+    pthread_rwlock_t lock;
+    OSNode *primary;
+    IdxNode *income;
+    IdxNode *age;
+    StateIndex *states;             /* ανοιχτή διευθυνσιοδότηση */
+    int state_count;
+} MultiIndex;
+
+int midx_init(MultiIndex *s) {
+    memset(s, 0, sizeof(*s));
+    s->states = (StateIndex*)calloc(MIDX_STATE_SLOTS, sizeof(StateIndex));
+    if (!s->states) return -1;
+    pthread_rwlock_init(&s->lock, NULL);
+    return 0;
+}
+
+/* Ευρετήριο της πολιτείας (με create, νέα θέση αν λείπει) ή NULL */
+static StateIndex* midx_state(MultiIndex *s, const char *state, int create) {
+    uint64_t i = shard_hash(state);
+    for (int probe = 0; probe < MIDX_STATE_SLOTS; probe++, i++) {
+        StateIndex *st = &s->states[i & (MIDX_STATE_SLOTS - 1)];
+        if (!st->used) {
+            if (!create || s->state_count >= MIDX_STATE_SLOTS / 2) return NULL;
+            snprintf(st->name, sizeof(st->name), "%s", state);
+            st->used = 1;
+            s->state_count++;
+            return st;
+        }
+        if (strcmp(st->name, state) == 0) return st;
+    }
+    return NULL;
+}
+
+/* 1 αν μπήκε, 0 αν το όνομα υπάρχει ήδη, -1 αν δεν χωράει άλλη πολιτεία -
+ * σε κάθε περίπτωση είτε αλλάζουν όλα τα ευρετήρια είτε κανένα */
+int midx_insert(MultiIndex *s, const Citizen *c) {
+    pthread_rwlock_wrlock(&s->lock);
+    StateIndex *st = midx_state(s, c->state, 1);
+    OSNode *n = NULL;
+    if (st) s->primary = os_avl_insert_node(s->primary, c, &n);
+    if (n) {
+        s->income = idx_insert(s->income, n->data.annual_income, n->key, &n->data);
+        s->age = idx_insert(s->age, n->data.age, n->key, &n->data);
+        st->root = idx_insert(st->root, n->data.annual_income, n->key, &n->data);
+    }
+    pthread_rwlock_unlock(&s->lock);
+    return st ? n != NULL : -1;
+}
+
+/* Τα δευτερεύοντα ευρετήρια πρώτα, όσο η εγγραφή του κύριου κόμβου υπάρχει */
+int midx_delete(MultiIndex *s, const char *name) {
+    pthread_rwlock_wrlock(&s->lock);
+    OSNode *n = os_avl_search(s->primary, name);
+    if (n) {
+        const Citizen *c = &n->data;
+        StateIndex *st = midx_state(s, c->state, 0);
+        s->income = idx_delete(s->income, c->annual_income, n->key, c->full_name);
+        s->age = idx_delete(s->age, c->age, n->key, c->full_name);
+        st->root = idx_delete(st->root, c->annual_income, n->key, c->full_name);
+        s->primary = os_avl_delete(s->primary, name);
+    }
+    pthread_rwlock_unlock(&s->lock);
+    return n != NULL;
+}
+
+/* Νέο εισόδημα για υπάρχουσα εγγραφή, χωρίς να ξαναχτιστεί τίποτα: τα
+ * ευρετήρια εισοδήματος και πολιτείας μετακινούν την καταχώριση, το
+ * ευρετήριο ηλικίας ενημερώνει τα αθροίσματα της διαδρομής της - O(log n).
+ * 1 αν βρέθηκε το όνομα */
+int midx_set_income(MultiIndex *s, const char *name, int income) {
+    pthread_rwlock_wrlock(&s->lock);
+    OSNode *n = os_avl_search(s->primary, name);
+    if (n && n->data.annual_income != income) {
+        Citizen *c = &n->data;
+        StateIndex *st = midx_state(s, c->state, 0);
+        s->income = idx_delete(s->income, c->annual_income, n->key, c->full_name);
+        st->root = idx_delete(st->root, c->annual_income, n->key, c->full_name);
+        c->annual_income = income;
+        s->income = idx_insert(s->income, income, n->key, c);
+        st->root = idx_insert(st->root, income, n->key, c);
+        idx_refresh(s->age, c->age, n->key, c->full_name, income);
+    }
+    pthread_rwlock_unlock(&s->lock);
+    return n != NULL;
+}
+
+void midx_destroy(MultiIndex *s) {
+    for (int i = 0; i < MIDX_STATE_SLOTS; i++) idx_free(s->states[i].root);
+    idx_free(s->income);
+    idx_free(s->age);
+    os_avl_free(s->primary);
+    free(s->states);
+    pthread_rwlock_destroy(&s->lock);
+    memset(s, 0, sizeof(*s));
+}
+
+/* Κριτήρια ερωτήματος - INT_MIN / INT_MAX για ανοιχτά όρια */
+typedef struct {
+    const char *state;              /* NULL = κάθε πολιτεία */
+    int income_lo, income_hi;
+    int age_lo, age_hi;
+} MidxQuery;
+
+enum { MIDX_SCAN, MIDX_STATE, MIDX_INCOME, MIDX_AGE };
+static const char *const midx_plan_names[] = {"scan", "state", "income", "age"};
+
+/* Το ευρετήριο που θα σαρωθεί, το εύρος τιμών του και το πλήθος εγγραφών */
+typedef struct {
+    int index;
+    size_t rows;
+    IdxNode *root;
+    int lo, hi;
+} MidxPlan;
+
+static inline int midx_match(const MidxQuery *q, const Citizen *c) {
+    return c->annual_income >= q->income_lo && c->annual_income <= q->income_hi &&
+           c->age >= q->age_lo && c->age <= q->age_hi &&
+           (!q->state || strcmp(c->state, q->state) == 0);
+}
+
+/* Πλήρης σάρωση: όλο το ευρετήριο εισοδήματος (μία καταχώριση ανά εγγραφή) */
+static void midx_plan_scan(MultiIndex *s, MidxPlan *p) {
+    p->index = MIDX_SCAN;
+    p->rows = idx_size(s->income);
+    p->root = s->income;
+    p->lo = INT_MIN;
+    p->hi = INT_MAX;
+}
+
+/* Ο planner: κάθε υποψήφιο μετριέται σε O(log n) (μέγεθος υποδέντρων) και
+ * κερδίζει αυτό με τις λιγότερες εγγραφές προς ανάγνωση */
+static void midx_plan(MultiIndex *s, const MidxQuery *q, MidxPlan *p) {
+    midx_plan_scan(s, p);
+    if (q->state) {
+        StateIndex *st = midx_state(s, q->state, 0);
+        size_t rows = st ? idx_count(st->root, q->income_lo, q->income_hi) : 0;
+        if (rows < p->rows) {
+            p->index = MIDX_STATE; p->rows = rows; p->root = st ? st->root : NULL;
+            p->lo = q->income_lo; p->hi = q->income_hi;
+        }
+    }
+    if (q->income_lo > INT_MIN || q->income_hi < INT_MAX) {
+        size_t rows = idx_count(s->income, q->income_lo, q->income_hi);
+        if (rows < p->rows) {
+            p->index = MIDX_INCOME; p->rows = rows; p->root = s->income;
+            p->lo = q->income_lo; p->hi = q->income_hi;
+        }
+    }
+    if (q->age_lo > INT_MIN || q->age_hi < INT_MAX) {
+        size_t rows = idx_count(s->age, q->age_lo, q->age_hi);
+        if (rows < p->rows) {
+            p->index = MIDX_AGE; p->rows = rows; p->root = s->age;
+            p->lo = q->age_lo; p->hi = q->age_hi;
+        }
+    }
+}
+
+static size_t midx_exec(const MidxQuery *q, const MidxPlan *p, Citizen *out, size_t max) {
+    IdxIter it;
+    IdxNode *n;
+    size_t k = 0;
+    idx_iter_seek(&it, p->root, p->lo);
+    while (k < max && (n = idx_iter_next(&it)) && n->value <= p->hi)
+        if (midx_match(q, n->rec)) out[k++] = *n->rec;
+    return k;
+}
+
+/* Οι εγγραφές που ικανοποιούν όλα τα κριτήρια (έως max, με τη σειρά του
+ * ευρετηρίου που επιλέχθηκε) - στο *plan, αν δοθεί, το σχέδιο εκτέλεσης */
+size_t midx_query(MultiIndex *s, const MidxQuery *q, Citizen *out, size_t max, MidxPlan *plan) {
+    MidxPlan p;
+    pthread_rwlock_rdlock(&s->lock);
+    midx_plan(s, q, &p);
+    size_t k = midx_exec(q, &p, out, max);
+    pthread_rwlock_unlock(&s->lock);
+    if (plan) *plan = p;
+    return k;
+}
+
+/* Το ίδιο ερώτημα χωρίς ευρετήριο - για σύγκριση */
+size_t midx_scan(MultiIndex *s, const MidxQuery *q, Citizen *out, size_t max) {
+    MidxPlan p;
+    pthread_rwlock_rdlock(&s->lock);
+    midx_plan_scan(s, &p);
+    size_t k = midx_exec(q, &p, out, max);
+    pthread_rwlock_unlock(&s->lock);
+    return k;
+}
+
+/* Συνάθροιση εισοδήματος (πλήθος, άθροισμα, min, max) των εγγραφών του
+ * ερωτήματος. Όταν ένα ευρετήριο καλύπτει όλα τα κριτήρια - εύρος
+ * εισοδήματος, εύρος ηλικίας ή πολιτεία με εύρος εισοδήματος - απαντούν
+ * τα αθροίσματα των κόμβων σε O(log n) και επιστρέφει 1. Αλλιώς σαρώνεται
+ * το ευρετήριο που διαλέγει ο planner και επιστρέφει 0 */
+int midx_aggregate(MultiIndex *s, const MidxQuery *q, IdxAgg *out) {
+    int income = q->income_lo > INT_MIN || q->income_hi < INT_MAX;
+    int age = q->age_lo > INT_MIN || q->age_hi < INT_MAX;
+    int covered = !age || (!income && !q->state);
+    pthread_rwlock_rdlock(&s->lock);
+    if (covered && q->state) {
+        StateIndex *st = midx_state(s, q->state, 0);
+        idx_aggregate(st ? st->root : NULL, q->income_lo, q->income_hi, out);
+    } else if (covered && age) {
+        idx_aggregate(s->age, q->age_lo, q->age_hi, out);
+    } else if (covered) {
+        idx_aggregate(s->income, q->income_lo, q->income_hi, out);
+    } else {
+        MidxPlan p;
+        IdxIter it;
+        IdxNode *n;
+        midx_plan(s, q, &p);
+        idx_agg_init(out);
+        idx_iter_seek(&it, p.root, p.lo);
+        while ((n = idx_iter_next(&it)) && n->value <= p.hi)
+            if (midx_match(q, n->rec)) idx_agg_node(out, n);
+    }
+    pthread_rwlock_unlock(&s->lock);
+    return covered;
+}
+
+/* Η ίδια συνάθροιση με πλήρη σάρωση - για σύγκριση */
+void midx_aggregate_scan(MultiIndex *s, const MidxQuery *q, IdxAgg *out) {
+    IdxIter it;
+    IdxNode *n;
+    pthread_rwlock_rdlock(&s->lock);
+    idx_agg_init(out);
+    idx_iter_seek(&it, s->income, INT_MIN);
+    while ((n = idx_iter_next(&it)))
+        if (midx_match(q, n->rec)) idx_agg_node(out, n);
+    pthread_rwlock_unlock(&s->lock);
+}
+
+/* ============ Σύγκριση malloc / arena ============ */
+
+/* Χρόνοι εισαγωγής και απελευθέρωσης ολόκληρου δέντρου (μ.ό. σε us) */
+typedef struct {
+    double insert_us[3];
+    double free_us[3];
+} AllocTimes;
+
+/* Χτίζει BST, AVL και RBT με malloc (use_arena = 0) ή με arena ανά δέντρο
+ * και μετρά insert και teardown: free_tree με διάσχιση ή pool_reset
+ * (τα slabs μένουν στην arena όπως η μνήμη του malloc μένει στο heap). */
+void bench_allocator(Citizen citizens[], int count, int use_arena, int runs, AllocTimes *t) {
+    NodePool bst_arena, avl_arena, rbt_arena;
+    pool_init(&bst_arena, sizeof(BSTNode));
+    pool_init(&avl_arena, sizeof(BSTNode));
+    pool_init(&rbt_arena, sizeof(RBTNode));
+    memset(t, 0, sizeof(*t));
+
+    for (int run = 0; run < runs; run++) {
+        BSTNode *bst_root = NULL, *avl_root = NULL;
+        RBTNode *rbt_root = NULL;
+        double start;
+
+        bst_pool = use_arena ? &bst_arena : NULL;
+        start = get_time_us();
+        for (int i = 0; i < count; i++) bst_root = bst_insert(bst_root, &citizens[i]);
+        t->insert_us[0] += get_time_us() - start;
+
+        bst_pool = use_arena ? &avl_arena : NULL;
+        start = get_time_us();
+        for (int i = 0; i < count; i++) avl_root = avl_insert(avl_root, &citizens[i]);
+        t->insert_us[1] += get_time_us() - start;
+
+        rbt_pool = use_arena ? &rbt_arena : NULL;
+        start = get_time_us();
+        for (int i = 0; i < count; i++) rbt_root = rbt_insert(rbt_root, &citizens[i]);
+        t->insert_us[2] += get_time_us() - start;
+
+        /* Teardown: με arena δεν επισκεπτόμαστε κανέναν κόμβο */
+        start = get_time_us();
+        if (use_arena) pool_reset(&bst_arena); else bst_free(bst_root);
+        t->free_us[0] += get_time_us() - start;
+
+        start = get_time_us();
+        if (use_arena) pool_reset(&avl_arena); else bst_free(avl_root);
+        t->free_us[1] += get_time_us() - start;
+
+        start = get_time_us();
+        if (use_arena) pool_reset(&rbt_arena); else rbt_free(rbt_root);
+        t->free_us[2] += get_time_us() - start;
+    }
+    bst_pool = rbt_pool = NULL;
+    pool_destroy(&bst_arena);
+    pool_destroy(&avl_arena);
+    pool_destroy(&rbt_arena);
+
+    for (int k = 0; k < 3; k++) { t->insert_us[k] /= runs; t->free_us[k] /= runs; }
+}
+
+void print_alloc_times(FILE *fp, const char *label, AllocTimes *t) {
+    fprintf(fp, "%-14s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", label,
+            t->insert_us[0], t->free_us[0], t->insert_us[1], t->free_us[1],
+            t->insert_us[2], t->free_us[2]);
+}
+
+void print_alloc_table(FILE *fp, AllocTimes *heap, AllocTimes *arena) {
+    fprintf(fp, "%-14s %10s %10s %10s %10s %10s %10s\n", "Allocator",
+            "BST ins", "BST free", "AVL ins", "AVL free", "RBT ins", "RBT free");
+    fprintf(fp, "------------------------------------------------------------------------------\n");
+    print_alloc_times(fp, "malloc", heap);
+    print_alloc_times(fp, "arena", arena);
+}
+
+/* ============ Σύγκριση hot/cold διάταξης ============ */
+
+#define HC_SEARCH_PASSES 20
+
+/* Χρόνος αναζήτησης όλων των ονομάτων HC_SEARCH_PASSES φορές (us) */
+typedef struct {
+    double inline_us[3];
+    double hc_us[3];
+} HotColdTimes;
+
+void bench_hot_cold(Citizen citizens[], int count, HotColdTimes *t) {
+    RecordStore rs;
+    rs_init(&rs);
+    BSTNode *bst_root = NULL, *avl_root = NULL;
+    RBTNode *rbt_root = NULL;
+    HCNode *hc_bst = NULL, *hc_avl = NULL;
+    HCRBTNode *hc_rbt = NULL;
+
+    int dropped = 0;
+    for (int i = 0; i < count; i++) {
+        uint32_t rec = rs_add(&rs, &citizens[i]);
+        bst_root = bst_insert(bst_root, &citizens[i]);
+        avl_root = avl_insert(avl_root, &citizens[i]);
+        rbt_root = rbt_insert(rbt_root, &citizens[i]);
+        if (rec == RS_NONE) { dropped++; continue; }
+        hc_bst = hc_bst_insert(hc_bst, &rs, rec);
+        hc_avl = hc_avl_insert(hc_avl, &rs, rec);
+        hc_rbt = hc_rbt_insert(hc_rbt, &rs, rec);
+    }
+    if (dropped)
+        printf("Σφάλμα: το λεξικό πολιτειών γέμισε (%d) - %d εγγραφές λείπουν από τα HC δέντρα\n", RS_MAX_STATES, dropped);
+
+    volatile uintptr_t sink = 0;
+    double start;
+    memset(t, 0, sizeof(*t));
+
+    start = get_time_us();
+    for (int p = 0; p < HC_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += (uintptr_t)bst_search(bst_root, citizens[i].full_name);
+    t->inline_us[0] = get_time_us() - start;
+    start = get_time_us();
+    for (int p = 0; p < HC_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += (uintptr_t)bst_search(avl_root, citizens[i].full_name);
+    t->inline_us[1] = get_time_us() - start;
+    start = get_time_us();
+    for (int p = 0; p < HC_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += (uintptr_t)rbt_search(rbt_root, citizens[i].full_name);
+    t->inline_us[2] = get_time_us() - start;
+
+    start = get_time_us();
+    for (int p = 0; p < HC_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += (uintptr_t)hc_bst_search(hc_bst, &rs, citizens[i].full_name);
+    t->hc_us[0] = get_time_us() - start;
+    start = get_time_us();
+    for (int p = 0; p < HC_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += (uintptr_t)hc_bst_search(hc_avl, &rs, citizens[i].full_name);
+    t->hc_us[1] = get_time_us() - start;
+    start = get_time_us();
+    for (int p = 0; p < HC_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += (uintptr_t)hc_rbt_search(hc_rbt, &rs, citizens[i].full_name);
+    t->hc_us[2] = get_time_us() - start;
+    (void)sink;
+
+    bst_free(bst_root); bst_free(avl_root); rbt_free(rbt_root);
+    hc_bst_free(hc_bst); hc_bst_free(hc_avl); hc_rbt_free(hc_rbt);
+    rs_free(&rs);
+}
+
+void print_hot_cold_table(FILE *fp, HotColdTimes *t) {
+    const char *names[3] = {"BST", "AVL", "RBT"};
+    size_t inline_size[3] = {sizeof(BSTNode), sizeof(BSTNode), sizeof(RBTNode)};
+    size_t hc_size[3] = {sizeof(HCNode), sizeof(HCNode), sizeof(HCRBTNode)};
+    fprintf(fp, "%-6s %10s %10s %10s %10s %12s %12s %8s\n", "Tree", "node B", "hc node B",
+            "nodes/CL", "hc nodes/CL", "search us", "hc search us", "speedup");
+    fprintf(fp, "------------------------------------------------------------------------------------\n");
+    for (int k = 0; k < 3; k++)
+        fprintf(fp, "%-6s %10zu %10zu %10.2f %10.2f %12.2f %12.2f %7.2fx\n", names[k],
+                inline_size[k], hc_size[k], 64.0 / inline_size[k], 64.0 / hc_size[k],
+                t->inline_us[k], t->hc_us[k], t->hc_us[k] > 0 ? t->inline_us[k] / t->hc_us[k] : 0.0);
+}
+
+/* ============ Σύγκριση παγωμένου ευρετηρίου ============ */
+
+#define FROZEN_LOOKUPS 200000
+
+/* ns ανά αναζήτηση για BST, AVL, RBT, B+ και το παγωμένο ευρετήριο,
+ * με την ίδια τυχαία σειρά ονομάτων, και χρόνος παγώματος του RBT */
+typedef struct {
+    double search_ns[5];
+    double freeze_us;
+    size_t frozen_bytes;
+} FrozenTimes;
+
+void bench_frozen(Citizen citizens[], int count, FrozenTimes *t) {
+    BSTNode *bst_root = NULL, *avl_root = NULL;
+    RBTNode *rbt_root = NULL;
+    BPTNode *bpt_root = NULL;
+    for (int i = 0; i < count; i++) {
+        bst_root = bst_insert(bst_root, &citizens[i]);
+        avl_root = avl_insert(avl_root, &citizens[i]);
+        rbt_root = rbt_insert(rbt_root, &citizens[i]);
+        bpt_root = bpt_insert(bpt_root, &citizens[i]);
+    }
+    double start = get_time_us();
+    FrozenIndex *fi = frozen_from_rbt(rbt_root);
+    t->freeze_us = get_time_us() - start;
+    t->frozen_bytes = fi->n * (2 * sizeof(uint64_t) + sizeof(uint32_t) + sizeof(Citizen*));
+
+    char **names = (char**)malloc(FROZEN_LOOKUPS * sizeof(char*));
+    for (int i = 0; i < FROZEN_LOOKUPS; i++) names[i] = citizens[rand() % count].full_name;
+
+    volatile uintptr_t sink = 0;
+    start = get_time_us();
+    for (int i = 0; i < FROZEN_LOOKUPS; i++) sink += (uintptr_t)bst_search(bst_root, names[i]);
+    t->search_ns[0] = get_time_us() - start;
+    start = get_time_us();
+    for (int i = 0; i < FROZEN_LOOKUPS; i++) sink += (uintptr_t)bst_search(avl_root, names[i]);
+    t->search_ns[1] = get_time_us() - start;
+    start = get_time_us();
+    for (int i = 0; i < FROZEN_LOOKUPS; i++) sink += (uintptr_t)rbt_search(rbt_root, names[i]);
+    t->search_ns[2] = get_time_us() - start;
+    start = get_time_us();
+    for (int i = 0; i < FROZEN_LOOKUPS; i++) sink += (uintptr_t)bpt_search(bpt_root, names[i]);
+    t->search_ns[3] = get_time_us() - start;
+    start = get_time_us();
+    for (int i = 0; i < FROZEN_LOOKUPS; i++) sink += (uintptr_t)frozen_search(fi, names[i]);
+    t->search_ns[4] = get_time_us() - start;
+    (void)sink;
+    for (int k = 0; k < 5; k++) t->search_ns[k] = t->search_ns[k] * 1000.0 / FROZEN_LOOKUPS;
+
+    free(names);
+    frozen_free(fi);
+    bst_free(bst_root); bst_free(avl_root); rbt_free(rbt_root); bpt_free(bpt_root);
+}
+
+void print_frozen_table(FILE *fp, FrozenTimes *t) {
+    const char *names[5] = {"BST", "AVL", "RBT", "B+", "Frozen"};
+    fprintf(fp, "%-8s %12s %12s\n", "Index", "ns/lookup", "vs RBT");
+    fprintf(fp, "-----------------------------------\n");
+    for (int k = 0; k < 5; k++)
+        fprintf(fp, "%-8s %12.2f %11.2fx\n", names[k], t->search_ns[k],
+                t->search_ns[k] > 0 ? t->search_ns[2] / t->search_ns[k] : 0.0);
+    fprintf(fp, "Freeze (RBT -> Eytzinger): %.2f us, %zu bytes (SIMD prefix scan: %s)\n", t->freeze_us,
+            t->frozen_bytes, FROZEN_USE_AVX2 ? "AVX2" : "off");
+}
+
+/* ============ Σύγκριση ομαδικών αναζητήσεων ============ */
+
+#define BATCH_LOOKUPS 200000
+#define BATCH_ROWS 5
+static const int batch_sizes[BATCH_ROWS] = {0, 4, 16, 64, 256};   /* 0 = απλές αναζητήσεις */
+
+/* ns ανά αναζήτηση για BST, AVL, RBT και B+ με απλές αναζητήσεις και με
+ * ομαδικές ανά μέγεθος παρτίδας, με την ίδια τυχαία σειρά ονομάτων */
+typedef struct {
+    double ns[BATCH_ROWS][4];
+} BatchTimes;
+
+void bench_batch(Citizen citizens[], int count, BatchTimes *t) {
+    BSTNode *bst_root = NULL, *avl_root = NULL;
+    RBTNode *rbt_root = NULL;
+    BPTNode *bpt_root = NULL;
+    for (int i = 0; i < count; i++) {
+        bst_root = bst_insert(bst_root, &citizens[i]);
+        avl_root = avl_insert(avl_root, &citizens[i]);
+        rbt_root = rbt_insert(rbt_root, &citizens[i]);
+        bpt_root = bpt_insert(bpt_root, &citizens[i]);
+    }
+    const char **names = (const char**)malloc(BATCH_LOOKUPS * sizeof(char*));
+    void **out = (void**)malloc(BATCH_LOOKUPS * sizeof(void*));
+    for (int i = 0; i < BATCH_LOOKUPS; i++) names[i] = citizens[rand() % count].full_name;
+
+    volatile uintptr_t sink = 0;
+    for (int row = 0; row < BATCH_ROWS; row++) {
+        int b = batch_sizes[row];
+        for (int k = 0; k < 4; k++) {
+            double start = get_time_us();
+            if (b == 0) {
+                for (int i = 0; i < BATCH_LOOKUPS; i++) {
+                    if (k < 2) out[i] = bst_search(k ? avl_root : bst_root, names[i]);
+                    else if (k == 2) out[i] = rbt_search(rbt_root, names[i]);
+                    else out[i] = bpt_search(bpt_root, names[i]);
+                }
+            } else {
+                for (int i = 0; i < BATCH_LOOKUPS; i += b) {
+                    int m = BATCH_LOOKUPS - i < b ? BATCH_LOOKUPS - i : b;
+                    if (k < 2) bst_search_batch(k ? avl_root : bst_root, names + i, m, (BSTNode**)(out + i));
+                    else if (k == 2) rbt_search_batch(rbt_root, names + i, m, (RBTNode**)(out + i));
+                    else bpt_search_batch(bpt_root, names + i, m, (Citizen**)(out + i));
+                }
+            }
+            t->ns[row][k] = (get_time_us() - start) * 1000.0 / BATCH_LOOKUPS;
+            for (int i = 0; i < BATCH_LOOKUPS; i++) sink += (uintptr_t)out[i];
+        }
+    }
+    (void)sink;
+    free(names); free(out);
+    bst_free(bst_root); bst_free(avl_root); rbt_free(rbt_root); bpt_free(bpt_root);
+}
+
+void print_batch_table(FILE *fp, BatchTimes *t) {
+    fprintf(fp, "%-8s %10s %10s %10s %10s %9s\n", "Batch", "BST ns", "AVL ns", "RBT ns", "B+ ns", "RBT gain");
+    fprintf(fp, "-------------------------------------------------------------\n");
+    for (int r = 0; r < BATCH_ROWS; r++) {
+        char label[16];
+        if (batch_sizes[r]) snprintf(label, sizeof(label), "%d", batch_sizes[r]);
+        else snprintf(label, sizeof(label), "single");
+        fprintf(fp, "%-8s %10.2f %10.2f %10.2f %10.2f %8.2fx\n", label, t->ns[r][0], t->ns[r][1], t->ns[r][2],
+                t->ns[r][3], t->ns[r][2] > 0 ? t->ns[0][2] / t->ns[r][2] : 0.0);
+    }
+}
+
+/* ============ Σύγκριση διατεταγμένων σαρώσεων ============ */
+
+#define SCAN_QUERIES 20000
+#define SCAN_PASSES 5                   /* πλήρεις σαρώσεις ανά δέντρο */
+#define SCAN_WINDOW 100                 /* διαδοχικά ονόματα ανά ερώτημα εύρους */
+#define SCAN_PREFIX 3                   /* μήκος προθέματος */
+#define SCAN_BUFFER 4096                /* χωρητικότητα buffer ανά ερώτημα */
+#define SCAN_ROWS 3
+static const char *const scan_labels[SCAN_ROWS] = {"full scan", "range", "prefix"};
+
+/* Εγγραφές/s για BST, AVL, RBT και B+: πλήρης σάρωση με iterator και
+ * ερωτήματα range/prefix που αντιγράφουν τις εγγραφές σε buffer */
+typedef struct {
+    double rate[SCAN_ROWS][4];
+    double per_query[SCAN_ROWS];        /* μέσο πλήθος εγγραφών ανά ερώτημα */
+} ScanTimes;
+
+static size_t scan_query(int k, void *root, const char *lo, const char *hi, Citizen *out) {
+    if (hi) {
+        if (k < 2) return bst_range((BSTNode*)root, lo, hi, out, SCAN_BUFFER);
+        if (k == 2) return rbt_range((RBTNode*)root, lo, hi, out, SCAN_BUFFER);
+        return bpt_range((BPTNode*)root, lo, hi, out, SCAN_BUFFER);
+    }
+    if (k < 2) return bst_prefix((BSTNode*)root, lo, out, SCAN_BUFFER);
+    if (k == 2) return rbt_prefix((RBTNode*)root, lo, out, SCAN_BUFFER);
+    return bpt_prefix((BPTNode*)root, lo, out, SCAN_BUFFER);
+}
+
+void bench_scan(Citizen citizens[], int count, ScanTimes *t) {
+    BSTNode *bst_root = NULL, *avl_root = NULL;
+    RBTNode *rbt_root = NULL;
+    BPTNode *bpt_root = NULL;
+    for (int i = 0; i < count; i++) {
+        bst_root = bst_insert(bst_root, &citizens[i]);
+        avl_root = avl_insert(avl_root, &citizens[i]);
+        rbt_root = rbt_insert(rbt_root, &citizens[i]);
+        bpt_root = bpt_insert(bpt_root, &citizens[i]);
+    }
+    void *roots[4] = {bst_root, avl_root, rbt_root, bpt_root};
+
+    /* Ταξινομημένα ονόματα από τη σάρωση του AVL - τα όρια των ερωτημάτων */
+    const char **sorted = (const char**)malloc((count > 0 ? count : 1) * sizeof(char*));
+    int m = 0;
+    BSTIter it;
+    BSTNode *n;
+    bst_iter_seek(&it, avl_root, NULL);
+    while ((n = bst_iter_next(&it))) sorted[m++] = n->data.full_name;
+    bst_iter_done(&it);
+
+    int *lo_idx = (int*)malloc(SCAN_QUERIES * sizeof(int));
+    char (*prefix)[SCAN_PREFIX + 1] = malloc(SCAN_QUERIES * sizeof(*prefix));
+    for (int q = 0; q < SCAN_QUERIES && m > 0; q++) {
+        lo_idx[q] = m > SCAN_WINDOW ? rand() % (m - SCAN_WINDOW + 1) : 0;
+        snprintf(prefix[q], sizeof(prefix[q]), "%.*s", SCAN_PREFIX, citizens[rand() % count].full_name);
+    }
+    Citizen *out = (Citizen*)malloc(SCAN_BUFFER * sizeof(Citizen));
+
+    volatile long long sink = 0;
+    memset(t, 0, sizeof(*t));
+    for (int k = 0; k < 4 && m > 0; k++) {
+        long long sum = 0;
+        size_t total = 0;
+        double start = get_time_us();
+        for (int pass = 0; pass < SCAN_PASSES; pass++) {
+            if (k < 2) {
+                bst_iter_seek(&it, (BSTNode*)roots[k], NULL);
+                while ((n = bst_iter_next(&it))) { sum += n->data.annual_income; total++; }
+                bst_iter_done(&it);
+                if (it.failed) { total = 0; break; }
+            } else if (k == 2) {
+                for (RBTNode *r = rbt_seek(rbt_root, NULL); r; r = rbt_next(r)) { sum += r->data.annual_income; total++; }
+            } else {
+                BPTIter bi;
+                Citizen *c;
+                bpt_iter_seek(&bi, bpt_root, NULL);
+                while ((c = bpt_iter_next(&bi))) { sum += c->annual_income; total++; }
+            }
+        }
+        double us = get_time_us() - start;
+        t->rate[0][k] = us > 0 ? total * 1e6 / us : 0.0;   /* 0 σε αποτυχία */
+        t->per_query[0] = (double)total / SCAN_PASSES;
+        sink += sum;
+
+        for (int row = 1; row < SCAN_ROWS; row++) {
+            total = 0;
+            start = get_time_us();
+            for (int q = 0; q < SCAN_QUERIES; q++) {
+                size_t got;
+                if (row == 1) {
+                    int hi = lo_idx[q] + SCAN_WINDOW - 1 < m ? lo_idx[q] + SCAN_WINDOW - 1 : m - 1;
+                    got = scan_query(k, roots[k], sorted[lo_idx[q]], sorted[hi], out);
+                } else got = scan_query(k, roots[k], prefix[q], NULL, out);
+                if (got == ITER_FAILED) { total = 0; break; }
+                if (got) sink += out[got - 1].age;
+                total += got;
+            }
+            us = get_time_us() - start;
+            t->rate[row][k] = us > 0 ? total * 1e6 / us : 0.0;
+            t->per_query[row] = (double)total / SCAN_QUERIES;
+        }
+    }
+    (void)sink;
+    free(sorted); free(lo_idx); free(prefix); free(out);
+    bst_free(bst_root); bst_free(avl_root); rbt_free(rbt_root); bpt_free(bpt_root);
+}
+
+void print_scan_table(FILE *fp, ScanTimes *t) {
+    fprintf(fp, "%-10s %9s %11s %11s %11s %11s\n", "Scan", "rec/query", "BST Mrec/s", "AVL Mrec/s", "RBT Mrec/s", "B+ Mrec/s");
+    fprintf(fp, "---------------------------------------------------------------------\n");
+    for (int r = 0; r < SCAN_ROWS; r++)
+        fprintf(fp, "%-10s %9.1f %11.2f %11.2f %11.2f %11.2f\n", scan_labels[r], t->per_query[r],
+                t->rate[r][0] / 1e6, t->rate[r][1] / 1e6, t->rate[r][2] / 1e6, t->rate[r][3] / 1e6);
+}
+
+/* ============ Σύγκριση στατιστικών διάταξης ============ */
+
+#define OS_QUERIES 200000
+#define OS_SCAN_QUERIES 10              /* ερωτήματα με διάσχιση - O(n) το καθένα */
+#define OS_ROWS 3
+static const char *const os_labels[OS_ROWS] = {"rank", "select", "count range"};
+
+/* Κόστος στο μονοπάτι εγγραφής (us, insert όλων / delete των μισών) για
+ * [0] AVL και [1] RBT χωρίς [0] και με [1] μεγέθη υποδέντρων, και ns ανά
+ * ερώτημα στα OS-AVL, OS-RBT και με διάσχιση iterator στο AVL */
+typedef struct {
+    double insert_us[2][2];
+    double delete_us[2][2];
+    double query_ns[OS_ROWS][3];
+} OrderStatTimes;
+
+/* Η ίδια απάντηση με διάσχιση: πλήθος βημάτων μέχρι το όνομα ή το k */
+static size_t os_scan_query(BSTNode *root, int row, const char *a, const char *b, size_t k) {
+    BSTIter it;
+    BSTNode *n;
+    size_t steps = 0;
+    bst_iter_seek(&it, root, row == 2 ? a : NULL);
+    while ((n = bst_iter_next(&it))) {
+        if (row == 0 && strcmp(n->data.full_name, a) >= 0) break;
+        if (row == 1 && steps == k) break;
+        if (row == 2 && strcmp(n->data.full_name, b) > 0) break;
+        steps++;
+    }
+    bst_iter_done(&it);
+    return steps;
+}
+
+void bench_order_stats(Citizen citizens[], int count, int runs, OrderStatTimes *t) {
+    memset(t, 0, sizeof(*t));
+    for (int r = 0; r < runs; r++) {
+        BSTNode *avl_root = NULL;
+        RBTNode *rbt_root = NULL;
+        OSNode *osa = NULL;
+        OSRBNode *osr = NULL;
+        double start = get_time_us();
+        for (int i = 0; i < count; i++) avl_root = avl_insert(avl_root, &citizens[i]);
+        t->insert_us[0][0] += get_time_us() - start;
+        start = get_time_us();
+        for (int i = 0; i < count; i++) osa = os_avl_insert(osa, &citizens[i]);
+        t->insert_us[0][1] += get_time_us() - start;
+        start = get_time_us();
+        for (int i = 0; i < count; i++) rbt_root = rbt_insert(rbt_root, &citizens[i]);
+        t->insert_us[1][0] += get_time_us() - start;
+        start = get_time_us();
+        for (int i = 0; i < count; i++) osr = os_rbt_insert(osr, &citizens[i]);
+        t->insert_us[1][1] += get_time_us() - start;
+
+        start = get_time_us();
+        for (int i = 0; i < count; i += 2) avl_root = avl_delete(avl_root, citizens[i].full_name);
+        t->delete_us[0][0] += get_time_us() - start;
+        start = get_time_us();
+        for (int i = 0; i < count; i += 2) osa = os_avl_delete(osa, citizens[i].full_name);
+        t->delete_us[0][1] += get_time_us() - start;
+        start = get_time_us();
+        for (int i = 0; i < count; i += 2) rbt_root = rbt_delete(rbt_root, citizens[i].full_name);
+        t->delete_us[1][0] += get_time_us() - start;
+        start = get_time_us();
+        for (int i = 0; i < count; i += 2) osr = os_rbt_delete(osr, citizens[i].full_name);
+        t->delete_us[1][1] += get_time_us() - start;
+
+        /* Ερωτήματα στο τελευταίο run, στα δέντρα με τις μισές εγγραφές */
+        if (r == runs - 1 && osa) {
+            size_t live = osa->size;
+            const char **a = (const char**)malloc(OS_QUERIES * sizeof(char*));
+            const char **b = (const char**)malloc(OS_QUERIES * sizeof(char*));
+            size_t *k = (size_t*)malloc(OS_QUERIES * sizeof(size_t));
+            for (int q = 0; q < OS_QUERIES; q++) {
+                a[q] = citizens[rand() % count].full_name;
+                b[q] = citizens[rand() % count].full_name;
+                if (strcmp(a[q], b[q]) > 0) { const char *x = a[q]; a[q] = b[q]; b[q] = x; }
+                k[q] = (size_t)rand() % live;
+            }
+            volatile size_t sink = 0;
+            for (int row = 0; row < OS_ROWS; row++) {
+                start = get_time_us();
+                for (int q = 0; q < OS_QUERIES; q++) {
+                    if (row == 0) sink += os_avl_rank(osa, a[q]);
+                    else if (row == 1) sink += (uintptr_t)os_avl_select(osa, k[q]);
+                    else sink += os_avl_count_range(osa, a[q], b[q]);
+                }
+                t->query_ns[row][0] = (get_time_us() - start) * 1000.0 / OS_QUERIES;
+                start = get_time_us();
+                for (int q = 0; q < OS_QUERIES; q++) {
+                    if (row == 0) sink += os_rbt_rank(osr, a[q]);
+                    else if (row == 1) sink += (uintptr_t)os_rbt_select(osr, k[q]);
+                    else sink += os_rbt_count_range(osr, a[q], b[q]);
+                }
+                t->query_ns[row][1] = (get_time_us() - start) * 1000.0 / OS_QUERIES;
+                start = get_time_us();
+                for (int q = 0; q < OS_SCAN_QUERIES; q++) sink += os_scan_query(avl_root, row, a[q], b[q], k[q]);
+                t->query_ns[row][2] = (get_time_us() - start) * 1000.0 / OS_SCAN_QUERIES;
+            }
+            (void)sink;
+            free(a); free(b); free(k);
+        }
+        bst_free(avl_root); rbt_free(rbt_root); os_avl_free(osa); os_rbt_free(osr);
+    }
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++) { t->insert_us[i][j] /= runs; t->delete_us[i][j] /= runs; }
+}
+
+void print_order_stats_table(FILE *fp, OrderStatTimes *t) {
+    fprintf(fp, "%-12s %12s %12s %9s %12s %12s %9s\n", "Write path", "AVL us", "OS-AVL us", "overhead",
+            "RBT us", "OS-RBT us", "overhead");
+    fprintf(fp, "-------------------------------------------------------------------------------------\n");
+    for (int op = 0; op < 2; op++) {
+        double (*us)[2] = op ? t->delete_us : t->insert_us;
+        fprintf(fp, "%-12s %12.1f %12.1f %8.1f%% %12.1f %12.1f %8.1f%%\n", op ? "delete half" : "insert all",
+                us[0][0], us[0][1], us[0][0] > 0 ? 100.0 * (us[0][1] - us[0][0]) / us[0][0] : 0.0,
+                us[1][0], us[1][1], us[1][0] > 0 ? 100.0 * (us[1][1] - us[1][0]) / us[1][0] : 0.0);
+    }
+    fprintf(fp, "\n%-12s %12s %12s %14s\n", "Query", "OS-AVL ns", "OS-RBT ns", "AVL scan ns");
+    fprintf(fp, "-----------------------------------------------------\n");
+    for (int r = 0; r < OS_ROWS; r++)
+        fprintf(fp, "%-12s %12.1f %12.1f %14.0f\n", os_labels[r], t->query_ns[r][0], t->query_ns[r][1], t->query_ns[r][2]);
+}
+
+/* ============ Σύγκριση πολλαπλών ευρετηρίων ============ */
+
+#define MIDX_QUERIES 2000
+#define MIDX_SCAN_QUERIES 10            /* ερωτήματα με πλήρη σάρωση */
+#define MIDX_BUFFER 8192
+#define MIDX_ROWS 4
+static const char *const midx_labels[MIDX_ROWS] = {
+    "state + income 50k-100k", "income 1k window", "state + age", "age 20-60 + income 10k"
+};
+
+/* Κόστος συντήρησης (us, insert όλων / delete των μισών) μόνο του κύριου
+ * δέντρου [0] και της αποθήκης με όλα τα ευρετήρια [1], και ανά είδος
+ * ερωτήματος: us με τον planner και με πλήρη σάρωση, μέσο πλήθος
+ * αποτελεσμάτων και το ευρετήριο που επιλέχθηκε συχνότερα */
+typedef struct {
+    double insert_us[2];
+    double delete_us[2];
+    double index_us[MIDX_ROWS];
+    double scan_us[MIDX_ROWS];
+    double rows[MIDX_ROWS];
+    int plan[MIDX_ROWS];
+} MidxTimes;
+
+static void midx_make_query(MidxQuery *q, int row, const Citizen *c) {
+    int x = rand() % 990001;
+    q->state = (row == 0 || row == 2) ? c->state : NULL;
+    q->income_lo = INT_MIN; q->income_hi = INT_MAX;
+    q->age_lo = INT_MIN; q->age_hi = INT_MAX;
+    if (row == 0) { q->income_lo = 50000; q->income_hi = 100000; }
+    else if (row == 1) { q->income_lo = x; q->income_hi = x + 999; }
+    else if (row == 2) q->age_lo = q->age_hi = c->age;
+    else { q->age_lo = 20; q->age_hi = 60; q->income_lo = x; q->income_hi = x + 9999; }
+}
+
+void bench_multi_index(Citizen citizens[], int count, int runs, MidxTimes *t) {
+    memset(t, 0, sizeof(*t));
+    for (int r = 0; r < runs; r++) {
+        OSNode *primary = NULL;
+        MultiIndex s;
+        midx_init(&s);
+        double start = get_time_us();
+        for (int i = 0; i < count; i++) primary = os_avl_insert(primary, &citizens[i]);
+        t->insert_us[0] += get_time_us() - start;
+        start = get_time_us();
+        for (int i = 0; i < count; i++) midx_insert(&s, &citizens[i]);
+        t->insert_us[1] += get_time_us() - start;
+        start = get_time_us();
+        for (int i = 0; i < count; i += 2) primary = os_avl_delete(primary, citizens[i].full_name);
+        t->delete_us[0] += get_time_us() - start;
+        start = get_time_us();
+        for (int i = 0; i < count; i += 2) midx_delete(&s, citizens[i].full_name);
+        t->delete_us[1] += get_time_us() - start;
+
+        /* Ερωτήματα στο τελευταίο run, στην αποθήκη με τις μισές εγγραφές */
+        if (r == runs - 1 && count > 0) {
+            Citizen *out = (Citizen*)malloc(MIDX_BUFFER * sizeof(Citizen));
+            MidxQuery *q = (MidxQuery*)malloc(MIDX_QUERIES * sizeof(MidxQuery));
+            volatile size_t sink = 0;
+            for (int row = 0; row < MIDX_ROWS; row++) {
+                int votes[4] = {0};
+                size_t found = 0;
+                for (int i = 0; i < MIDX_QUERIES; i++) midx_make_query(&q[i], row, &citizens[rand() % count]);
+                start = get_time_us();
+                for (int i = 0; i < MIDX_QUERIES; i++) {
+                    MidxPlan p;
+                    size_t k = midx_query(&s, &q[i], out, MIDX_BUFFER, &p);
+                    votes[p.index]++;
+                    found += k;
+                }
+                t->index_us[row] = (get_time_us() - start) / MIDX_QUERIES;
+                start = get_time_us();
+                for (int i = 0; i < MIDX_SCAN_QUERIES; i++) sink += midx_scan(&s, &q[i], out, MIDX_BUFFER);
+                t->scan_us[row] = (get_time_us() - start) / MIDX_SCAN_QUERIES;
+                t->rows[row] = (double)found / MIDX_QUERIES;
+                for (int k = 1; k < 4; k++) if (votes[k] > votes[t->plan[row]]) t->plan[row] = k;
+            }
+            (void)sink;
+            free(out); free(q);
+        }
+        os_avl_free(primary);
+        midx_destroy(&s);
+    }
+    for (int i = 0; i < 2; i++) { t->insert_us[i] /= runs; t->delete_us[i] /= runs; }
+}
+
+void print_multi_index_table(FILE *fp, MidxTimes *t) {
+    fprintf(fp, "%-12s %14s %14s %9s\n", "Maintenance", "primary us", "all idx us", "overhead");
+    fprintf(fp, "------------------------------------------------------\n");
+    for (int op = 0; op < 2; op++) {
+        double *us = op ? t->delete_us : t->insert_us;
+        fprintf(fp, "%-12s %14.1f %14.1f %8.1f%%\n", op ? "delete half" : "insert all", us[0], us[1],
+                us[0] > 0 ? 100.0 * (us[1] - us[0]) / us[0] : 0.0);
+    }
+    fprintf(fp, "\n%-24s %-7s %8s %11s %11s %9s\n", "Query", "index", "rows", "planned us", "scan us", "speedup");
+    fprintf(fp, "-------------------------------------------------------------------------\n");
+    for (int r = 0; r < MIDX_ROWS; r++)
+        fprintf(fp, "%-24s %-7s %8.1f %11.2f %11.1f %8.1fx\n", midx_labels[r], midx_plan_names[t->plan[r]], t->rows[r],
+                t->index_us[r], t->scan_us[r], t->index_us[r] > 0 ? t->scan_us[r] / t->index_us[r] : 0.0);
+}
+
+/* ============ Σύγκριση συναθροίσεων εύρους ============ */
+
+#define AGG_QUERIES 20000
+#define AGG_SCAN_QUERIES 10             /* συναθροίσεις με πλήρη σάρωση */
+#define AGG_UPDATES 20000
+#define AGG_ROWS 4
+static const char *const agg_labels[AGG_ROWS] = {
+    "income 100k window", "age 10-year window", "state + income 200k", "age 30-50 + income 10k"
+};
+
+/* Ανά είδος συνάθροισης: us με τα αθροίσματα των κόμβων (ή τον planner, αν
+ * κανένα ευρετήριο δεν καλύπτει το ερώτημα) και με πλήρη σάρωση, μέσο
+ * πλήθος εγγραφών και αν απάντησαν τα αθροίσματα. Αλλαγή εισοδήματος (ns):
+ * midx_set_income [0] έναντι delete + insert της εγγραφής [1] */
+typedef struct {
+    double agg_us[AGG_ROWS];
+    double scan_us[AGG_ROWS];
+    double rows[AGG_ROWS];
+    int covered[AGG_ROWS];
+    double update_ns[2];
+} AggTimes;
+
+static void agg_make_query(MidxQuery *q, int row, const Citizen *c) {
+    int x = rand() % 900001, a = 1 + rand() % 91;
+    q->state = (row == 2) ? c->state : NULL;
+    q->income_lo = INT_MIN; q->income_hi = INT_MAX;
+    q->age_lo = INT_MIN; q->age_hi = INT_MAX;
+    if (row == 0) { q->income_lo = x; q->income_hi = x + 99999; }
+    else if (row == 1) { q->age_lo = a; q->age_hi = a + 9; }
+    else if (row == 2) { q->income_lo = x / 2; q->income_hi = x / 2 + 199999; }
+    else { q->age_lo = 30; q->age_hi = 50; q->income_lo = x; q->income_hi = x + 9999; }
+}
+
+void bench_aggregate(Citizen citizens[], int count, AggTimes *t) {
+    MultiIndex s;
+    memset(t, 0, sizeof(*t));
+    if (count <= 0) return;
+    midx_init(&s);
+    for (int i = 0; i < count; i++) midx_insert(&s, &citizens[i]);
+
+    MidxQuery *q = (MidxQuery*)malloc(AGG_QUERIES * sizeof(MidxQuery));
+    volatile long long sink = 0;
+    for (int row = 0; row < AGG_ROWS; row++) {
+        IdxAgg a;
+        size_t found = 0;
+        for (int i = 0; i < AGG_QUERIES; i++) agg_make_query(&q[i], row, &citizens[rand() % count]);
+        double start = get_time_us();
+        for (int i = 0; i < AGG_QUERIES; i++) {
+            t->covered[row] = midx_aggregate(&s, &q[i], &a);
+            found += a.count;
+            sink += a.sum;
+        }
+        t->agg_us[row] = (get_time_us() - start) / AGG_QUERIES;
+        start = get_time_us();
+        for (int i = 0; i < AGG_SCAN_QUERIES; i++) { midx_aggregate_scan(&s, &q[i], &a); sink += a.sum; }
+        t->scan_us[row] = (get_time_us() - start) / AGG_SCAN_QUERIES;
+        t->rows[row] = (double)found / AGG_QUERIES;
+    }
+    (void)sink;
+    free(q);
+
+    /* Νέο τυχαίο εισόδημα σε τυχαίες εγγραφές, με τους δύο τρόπους */
+    int updates = count < AGG_UPDATES ? count : AGG_UPDATES;
+    double start = get_time_us();
+    for (int i = 0; i < updates; i++) midx_set_income(&s, citizens[rand() % count].full_name, rand() % 1000001);
+    t->update_ns[0] = (get_time_us() - start) * 1000.0 / updates;
+    start = get_time_us();
+    for (int i = 0; i < updates; i++) {
+        Citizen c = citizens[rand() % count];
+        c.annual_income = rand() % 1000001;
+        midx_delete(&s, c.full_name);
+        midx_insert(&s, &c);
+    }
+    t->update_ns[1] = (get_time_us() - start) * 1000.0 / updates;
+    midx_destroy(&s);
+}
+
+void print_aggregate_table(FILE *fp, AggTimes *t) {
+    fprintf(fp, "%-24s %-7s %9s %11s %11s %9s\n", "Aggregate", "path", "rows", "agg us", "scan us", "speedup");
+    fprintf(fp, "--------------------------------------------------------------------------\n");
+    for (int r = 0; r < AGG_ROWS; r++)
+        fprintf(fp, "%-24s %-7s %9.1f %11.2f %11.1f %8.1fx\n", agg_labels[r], t->covered[r] ? "tree" : "planner",
+                t->rows[r], t->agg_us[r], t->scan_us[r], t->agg_us[r] > 0 ? t->scan_us[r] / t->agg_us[r] : 0.0);
+    fprintf(fp, "\n%-24s %12s\n", "Income change", "ns/update");
+    fprintf(fp, "-------------------------------------\n");
+    fprintf(fp, "%-24s %12.1f\n", "midx_set_income", t->update_ns[0]);
+    fprintf(fp, "%-24s %12.1f\n", "delete + insert", t->update_ns[1]);
+}
+
+/* ============ Σύγκριση μαζικής κατασκευής ============ */
+
+/* Χρόνος κατασκευής ολόκληρου δέντρου (us) με count διαδοχικά insert και με
+ * bulk build, για είσοδο σε τυχαία σειρά [0] και ήδη ταξινομημένη [1] */
+typedef struct {
+    double insert_us[2][3];
+    double bulk_us[2][3];
+    int records[2][3];
+} BulkTimes;
+
+/* Ταξινομημένη είσοδος εκφυλίζει το BST σε λίστα: insert O(n^2) και, στις
+ * αναδρομικές εκδόσεις, βάθος στοίβας n. Αυτές οι φάσεις τρέχουν μόνο στις
+ * πρώτες cap εγγραφές (-m, προεπιλογή DEGENERATE_MAX, 0 = παράλειψη) -
+ * στήλη records των πινάκων */
+#define DEGENERATE_MAX 5000
+
+static int cmp_citizen_name(const void *a, const void *b) {
+    return strcmp(((const Citizen*)a)->full_name, ((const Citizen*)b)->full_name);
+}
+
+/* Ταξινομημένο αντίγραφο των πρώτων n εγγραφών */
+static Citizen* sorted_copy(const Citizen citizens[], int n) {
+    Citizen *sorted = (Citizen*)malloc((n > 0 ? n : 1) * sizeof(Citizen));
+    memcpy(sorted, citizens, n * sizeof(Citizen));
+    qsort(sorted, n, sizeof(Citizen), cmp_citizen_name);
+    return sorted;
+}
+
+void bench_bulk(Citizen citizens[], int count, int runs, int cap, BulkTimes *t) {
+    int head = count < cap ? count : cap;
+    Citizen *sorted = sorted_copy(citizens, count);
+    Citizen *sorted_head = sorted_copy(citizens, head);
+    memset(t, 0, sizeof(*t));
+
+    for (int in = 0; in < 2; in++) {
+        Citizen *src = in ? sorted : citizens;
+        /* BST με ταξινομημένη είσοδο: μόνο το ταξινομημένο πρόθεμα */
+        Citizen *bst_src = in ? sorted_head : citizens;
+        int bst_n = in ? head : count;
+        t->records[in][0] = bst_n;
+        t->records[in][1] = t->records[in][2] = count;
+        for (int r = 0; r < runs; r++) {
+            BSTNode *bst_root = NULL, *avl_root = NULL;
+            RBTNode *rbt_root = NULL;
+            double start = get_time_us();
+            for (int i = 0; i < bst_n; i++) bst_root = bst_insert(bst_root, &bst_src[i]);
+            t->insert_us[in][0] += get_time_us() - start;
+            start = get_time_us();
+            for (int i = 0; i < count; i++) avl_root = avl_insert(avl_root, &src[i]);
+            t->insert_us[in][1] += get_time_us() - start;
+            start = get_time_us();
+            for (int i = 0; i < count; i++) rbt_root = rbt_insert(rbt_root, &src[i]);
+            t->insert_us[in][2] += get_time_us() - start;
+            bst_free(bst_root); bst_free(avl_root); rbt_free(rbt_root);
+
+            start = get_time_us();
+            bst_root = bst_bulk_build(bst_src, bst_n);
+            t->bulk_us[in][0] += get_time_us() - start;
+            start = get_time_us();
+            avl_root = avl_bulk_build(src, count);
+            t->bulk_us[in][1] += get_time_us() - start;
+            start = get_time_us();
+            rbt_root = rbt_bulk_build(src, count);
+            t->bulk_us[in][2] += get_time_us() - start;
+            bst_free(bst_root); bst_free(avl_root); rbt_free(rbt_root);
+        }
+        for (int k = 0; k < 3; k++) { t->insert_us[in][k] /= runs; t->bulk_us[in][k] /= runs; }
+    }
+    free(sorted); free(sorted_head);
+}
+
+void print_bulk_table(FILE *fp, BulkTimes *t) {
+    const char *names[3] = {"BST", "AVL", "RBT"};
+    const char *inputs[2] = {"random", "sorted"};
+    fprintf(fp, "%-6s %-8s %9s %12s %12s %9s\n", "Tree", "Input", "records", "insert us", "bulk us", "speedup");
+    fprintf(fp, "---------------------------------------------------------------\n");
+    for (int in = 0; in < 2; in++)
+        for (int k = 0; k < 3; k++) {
+            if (!t->records[in][k]) { fprintf(fp, "%-6s %-8s %9s\n", names[k], inputs[in], "skipped"); continue; }
+            fprintf(fp, "%-6s %-8s %9d %12.2f %12.2f %8.2fx\n", names[k], inputs[in], t->records[in][k], t->insert_us[in][k],
+                    t->bulk_us[in][k], t->bulk_us[in][k] > 0 ? t->insert_us[in][k] / t->bulk_us[in][k] : 0.0);
+        }
+}
+
+/* ============ Σύγκριση στιγμιοτύπων ============ */
+
+#define SNAP_LOOKUPS 200000
+#define SNAP_BENCH_PATH "bench_tree.snap"
+
+/* Επανεκκίνηση με έτοιμο δέντρο, για AVL [0] και RBT [1]: κατασκευή με
+ * insert και με bulk build, αποθήκευση στιγμιοτύπου, mmap με έλεγχο header
+ * και σωρευτικά + άθροισμα ελέγχου και + ανασύσταση του δέντρου (us), και
+ * ns ανά αναζήτηση στο δέντρο και κατευθείαν στο mapping */
+typedef struct {
+    double insert_us[2], bulk_us[2], save_us[2];
+    double open_us[2], verify_us[2], thaw_us[2];
+    double tree_ns[2], image_ns[2];
+    size_t image_bytes[2];
+    int failed;
+} SnapTimes;
+
+void bench_snapshot(Citizen citizens[], int count, int runs, SnapTimes *t) {
+    memset(t, 0, sizeof(*t));
+    char **names = (char**)malloc(SNAP_LOOKUPS * sizeof(char*));
+    for (int i = 0; i < SNAP_LOOKUPS; i++) names[i] = citizens[rand() % count].full_name;
+    volatile uintptr_t sink = 0;
+
+    for (int k = 0; k < 2; k++) {
+        for (int r = 0; r < runs && !t->failed; r++) {
+            BSTNode *avl_root = NULL, *avl_back = NULL;
+            RBTNode *rbt_root = NULL, *rbt_back = NULL;
+            Snapshot s;
+            double start = get_time_us();
+            if (k == 0) for (int i = 0; i < count; i++) avl_root = avl_insert(avl_root, &citizens[i]);
+            else for (int i = 0; i < count; i++) rbt_root = rbt_insert(rbt_root, &citizens[i]);
+            t->insert_us[k] += get_time_us() - start;
+            bst_free(avl_root); rbt_free(rbt_root);
+
+            start = get_time_us();
+            if (k == 0) avl_root = avl_bulk_build(citizens, count);
+            else rbt_root = rbt_bulk_build(citizens, count);
+            t->bulk_us[k] += get_time_us() - start;
+
+            start = get_time_us();
+            t->image_bytes[k] = k == 0 ? avl_snapshot_save(avl_root, SNAP_BENCH_PATH)
+                                       : rbt_snapshot_save(rbt_root, SNAP_BENCH_PATH);
+            t->save_us[k] += get_time_us() - start;
+            bst_free(avl_root); rbt_free(rbt_root);
+            if (!t->image_bytes[k]) { t->failed = 1; break; }
+
+            /* Το αρχείο μόλις γράφτηκε, άρα οι χρόνοι είναι με θερμή page cache */
+            start = get_time_us();
+            int ok = snapshot_open(&s, SNAP_BENCH_PATH, k == 0 ? SNAP_AVL : SNAP_RBT, 0) >= 0;
+            t->open_us[k] += get_time_us() - start;
+            if (ok) {
+                ok = snapshot_verify(&s);
+                t->verify_us[k] += get_time_us() - start;
+            }
+            if (ok) {
+                ok = (k == 0 ? avl_snapshot_load(&s, &avl_back) : rbt_snapshot_load(&s, &rbt_back)) >= 0;
+                t->thaw_us[k] += get_time_us() - start;
+            }
+            if (!ok) { snapshot_close(&s); t->failed = 1; break; }
+
+            start = get_time_us();
+            if (k == 0) for (int i = 0; i < SNAP_LOOKUPS; i++) sink += (uintptr_t)bst_search(avl_back, names[i]);
+            else for (int i = 0; i < SNAP_LOOKUPS; i++) sink += (uintptr_t)rbt_search(rbt_back, names[i]);
+            t->tree_ns[k] += get_time_us() - start;
+            start = get_time_us();
+            for (int i = 0; i < SNAP_LOOKUPS; i++) sink += (uintptr_t)snapshot_search(&s, names[i]);
+            t->image_ns[k] += get_time_us() - start;
+
+            snapshot_close(&s);
+            bst_free(avl_back); rbt_free(rbt_back);
+        }
+        t->insert_us[k] /= runs; t->bulk_us[k] /= runs; t->save_us[k] /= runs;
+        t->open_us[k] /= runs; t->verify_us[k] /= runs; t->thaw_us[k] /= runs;
+        t->tree_ns[k] = t->tree_ns[k] * 1000.0 / runs / SNAP_LOOKUPS;
+        t->image_ns[k] = t->image_ns[k] * 1000.0 / runs / SNAP_LOOKUPS;
+    }
+    (void)sink;
+    unlink(SNAP_BENCH_PATH);
+    free(names);
+}
+
+void print_snapshot_table(FILE *fp, SnapTimes *t) {
+    const char *names[2] = {"AVL", "RBT"};
+    if (t->failed) { fprintf(fp, "snapshot save/load failed\n"); return; }
+    fprintf(fp, "%-6s %9s %10s %10s %10s %10s %10s %10s %9s %9s\n", "Tree", "image MB", "insert ms", "bulk ms",
+            "save ms", "mmap ms", "+verify", "+thaw ms", "tree ns", "image ns");
+    fprintf(fp, "-----------------------------------------------------------------------------------------------------\n");
+    for (int k = 0; k < 2; k++)
+        fprintf(fp, "%-6s %9.1f %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %9.1f %9.1f\n", names[k],
+                t->image_bytes[k] / 1e6, t->insert_us[k] / 1000.0, t->bulk_us[k] / 1000.0, t->save_us[k] / 1000.0,
+                t->open_us[k] / 1000.0, t->verify_us[k] / 1000.0, t->thaw_us[k] / 1000.0, t->tree_ns[k], t->image_ns[k]);
+}
+
+/* ============ Σύγκριση επιπέδων ανθεκτικότητας ============ */
+
+#define WAL_BENCH_OPS 20000
+#define WAL_BENCH_LOG "bench_tree.wal"
+#define WAL_BENCH_SNAP "bench_tree_wal.snap"
+#define WAL_LEVELS 6
+
+/* Insert ops εγγραφών και delete των μισών σε RBT με log, για κάθε επίπεδο
+ * ανθεκτικότητας, και χρόνοι (us) replay του log, checkpoint και ανοίγματος
+ * μετά το checkpoint (στιγμιότυπο + άδειο log) */
+typedef struct {
+    int ops;
+    double us[WAL_LEVELS];
+    uint64_t syncs[WAL_LEVELS];
+    size_t log_bytes[WAL_LEVELS];
+    double replay_us, checkpoint_us, reopen_us;
+    uint64_t replayed;
+    int failed;
+} WalTimes;
+
+static const struct {
+    const char *name;
+    int logged;
+    WalPolicy policy;
+} wal_levels[WAL_LEVELS] = {
+    {"memory only",      0, {0, 0, 0}},
+    {"write, no fsync",  1, {1, 0, 0}},
+    {"group 10 ms",      1, {0, 10, 1}},
+    {"group 1000 ops",   1, {1000, 0, 1}},
+    {"group 64 ops",     1, {64, 0, 1}},
+    {"fsync every op",   1, {1, 0, 1}},
+};
+
+static void wal_bench_cleanup(void) {
+    unlink(WAL_BENCH_LOG); unlink(WAL_BENCH_LOG ".tmp");
+    unlink(WAL_BENCH_SNAP); unlink(WAL_BENCH_SNAP ".tmp");
+}
+
+void bench_wal(Citizen citizens[], int count, WalTimes *t) {
+    memset(t, 0, sizeof(*t));
+    int n = count < WAL_BENCH_OPS ? count : WAL_BENCH_OPS;
+    t->ops = n + n / 2;
+    WalTree w;
+    for (int k = 0; k < WAL_LEVELS && !t->failed; k++) {
+        wal_bench_cleanup();
+        if (wal_open(&w, SNAP_RBT, wal_levels[k].logged ? WAL_BENCH_LOG : NULL, WAL_BENCH_SNAP, wal_levels[k].policy) != 0) {
+            t->failed = 1;
+            break;
+        }
+        int err = 0;
+        double start = get_time_us();
+        for (int i = 0; i < n; i++) err |= wal_insert(&w, &citizens[i]);
+        for (int i = 0; i < n; i += 2) err |= wal_delete(&w, citizens[i].full_name);
+        err |= wal_commit(&w);
+        t->us[k] = get_time_us() - start;
+        t->syncs[k] = w.syncs;
+        t->log_bytes[k] = w.log_bytes;
+        if (err) t->failed = 1;
+        if (k < WAL_LEVELS - 1) wal_close(&w);
+    }
+    if (t->failed) { wal_bench_cleanup(); return; }
+
+    /* Το log του τελευταίου επιπέδου: replay, checkpoint και ξανά άνοιγμα */
+    wal_close(&w);
+    double start = get_time_us();
+    int rc = wal_open(&w, SNAP_RBT, WAL_BENCH_LOG, WAL_BENCH_SNAP, wal_levels[WAL_LEVELS - 1].policy);
+    t->replay_us = get_time_us() - start;
+    t->replayed = w.replayed;
+    start = get_time_us();
+    if (rc == 0) rc = wal_checkpoint(&w);
+    t->checkpoint_us = get_time_us() - start;
+    wal_close(&w);
+    start = get_time_us();
+    if (rc == 0) rc = wal_open(&w, SNAP_RBT, WAL_BENCH_LOG, WAL_BENCH_SNAP, wal_levels[WAL_LEVELS - 1].policy);
+    t->reopen_us = get_time_us() - start;
+    if (rc != 0) t->failed = 1;
+    wal_close(&w);
+    wal_bench_cleanup();
+}
+
+void print_wal_table(FILE *fp, WalTimes *t) {
+    if (t->failed) { fprintf(fp, "write-ahead log benchmark failed\n"); return; }
+    fprintf(fp, "%-18s %8s %12s %10s %9s %9s %11s\n", "Durability", "ops", "ops/s", "us/op", "syncs", "log MB", "vs memory");
+    fprintf(fp, "-------------------------------------------------------------------------------------\n");
+    for (int k = 0; k < WAL_LEVELS; k++)
+        fprintf(fp, "%-18s %8d %12.0f %10.3f %9llu %9.2f %10.2fx\n", wal_levels[k].name, t->ops,
+                t->us[k] > 0 ? t->ops / (t->us[k] / 1e6) : 0.0, t->us[k] / t->ops, (unsigned long long)t->syncs[k],
+                t->log_bytes[k] / 1e6, t->us[0] > 0 ? t->us[k] / t->us[0] : 0.0);
+    fprintf(fp, "Replay %llu records: %.2f ms | checkpoint (snapshot + new log): %.2f ms | reopen after checkpoint: %.2f ms\n",
+            (unsigned long long)t->replayed, t->replay_us / 1000.0, t->checkpoint_us / 1000.0, t->reopen_us / 1000.0);
+}
+
+/* ============ Κλιμάκωση αναγνώσεων ============ */
+
+#define SCALE_BENCH_MS 200
+#define SCALE_ROWS 8
+
+/* Αναζητήσεις/s από 1..N αναγνώστες ενώ ένας writer κάνει συνεχώς delete +
+ * insert, για RBT πίσω από rwlock [0] και copy-on-write RBT [1], και
+ * ενημερώσεις/s του writer στο ίδιο διάστημα */
+typedef struct {
+    int rows;
+    int threads[SCALE_ROWS];
+    double reads[SCALE_ROWS][2];
+    double writes[SCALE_ROWS][2];
+} ScaleTimes;
+
+typedef struct {
+    int cow;
+    CowTree *tree;
+    RBTNode **rbt;
+    pthread_rwlock_t *lock;
+    Citizen *citizens;
+    int count;
+    int *stop;
+    uint64_t seed, ops;
+    char pad[64];
+} ScaleWorker;
+
+/* Αναζήτηση RBT χωρίς τους μετρητές συγκρίσεων (τρέχει σε πολλά νήματα) */
+static RBTNode* rbt_search_mt(RBTNode *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    while (root && root != RBT_NIL) {
+        int cmp = key_cmp_mt(key, name, root->key, root->data.full_name);
+        if (cmp == 0) return root;
+        root = (cmp < 0) ? root->left : root->right;
+    }
+    return NULL;
+}
+
+static void* scale_reader(void *arg) {
+    ScaleWorker *w = (ScaleWorker*)arg;
+    int slot = w->cow ? cow_reader_register(w->tree) : -1;
+    uint64_t x = w->seed, ops = 0;
+    volatile uintptr_t sink = 0;
+    while (!__atomic_load_n(w->stop, __ATOMIC_RELAXED)) {
+        for (int k = 0; k < 64; k++) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            const char *name = w->citizens[x % (uint64_t)w->count].full_name;
+            if (w->cow) {
+                sink += (uintptr_t)cow_find(cow_read_begin(w->tree, slot), name);
+                cow_read_end(w->tree, slot);
+            } else {
+                pthread_rwlock_rdlock(w->lock);
+                sink += (uintptr_t)rbt_search_mt(*w->rbt, name);
+                pthread_rwlock_unlock(w->lock);
+            }
+        }
+        ops += 64;
+    }
+    (void)sink;
+    if (w->cow) cow_reader_unregister(w->tree, slot);
+    w->ops = ops;
+    return NULL;
+}
+
+/* Ο writer αφαιρεί και ξαναβάζει εγγραφές με τη σειρά, ώστε το μέγεθος μένει σταθερό */
+static void* scale_writer(void *arg) {
+    ScaleWorker *w = (ScaleWorker*)arg;
+    uint64_t ops = 0;
+    for (int j = 0; !__atomic_load_n(w->stop, __ATOMIC_RELAXED); j = (j + 1) % w->count, ops += 2) {
+        if (w->cow) {
+            cow_delete(w->tree, w->citizens[j].full_name);
+            cow_insert(w->tree, &w->citizens[j]);
+        } else {
+            pthread_rwlock_wrlock(w->lock);
+            *w->rbt = rbt_delete(*w->rbt, w->citizens[j].full_name);
+            *w->rbt = rbt_insert(*w->rbt, &w->citizens[j]);
+            pthread_rwlock_unlock(w->lock);
+        }
+    }
+    w->ops = ops;
+    return NULL;
+}
+
+void bench_read_scaling(Citizen citizens[], int count, int max_threads, ScaleTimes *t) {
+    memset(t, 0, sizeof(*t));
+    if (max_threads > COW_MAX_READERS) max_threads = COW_MAX_READERS;
+    for (int n = 1; t->rows < SCALE_ROWS - 1 && n < max_threads; n *= 2) t->threads[t->rows++] = n;
+    t->threads[t->rows++] = max_threads;
+
+    CowTree *tree = cow_create();
+    RBTNode *rbt = NULL;
+    for (int i = 0; i < count; i++) { cow_insert(tree, &citizens[i]); rbt = rbt_insert(rbt, &citizens[i]); }
+    /* Προτίμηση writer: με συνεχείς αναγνώστες η προεπιλογή του glibc θα τον λιμοκτονούσε */
+    pthread_rwlock_t lock;
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    pthread_rwlock_init(&lock, &attr);
+
+    ScaleWorker *w = (ScaleWorker*)calloc(max_threads + 1, sizeof(ScaleWorker));
+    pthread_t *th = (pthread_t*)malloc((max_threads + 1) * sizeof(pthread_t));
+    for (int row = 0; row < t->rows; row++) {
+        for (int cow = 0; cow < 2; cow++) {
+            int readers = t->threads[row], stop = 0;
+            for (int i = 0; i <= readers; i++) {
+                w[i] = (ScaleWorker){cow, tree, &rbt, &lock, citizens, count, &stop, 0x9E3779B97F4A7C15ULL * (i + 1), 0, {0}};
+            }
+            double start = get_time_us();
+            for (int i = 0; i < readers; i++) pthread_create(&th[i], NULL, scale_reader, &w[i]);
+            pthread_create(&th[readers], NULL, scale_writer, &w[readers]);
+            usleep(SCALE_BENCH_MS * 1000);
+            __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+            for (int i = 0; i <= readers; i++) pthread_join(th[i], NULL);
+            double secs = (get_time_us() - start) / 1e6;
+            uint64_t reads = 0;
+            for (int i = 0; i < readers; i++) reads += w[i].ops;
+            t->reads[row][cow] = reads / secs;
+            t->writes[row][cow] = w[readers].ops / secs;
+        }
+    }
+    free(w); free(th);
+    pthread_rwlock_destroy(&lock);
+    pthread_rwlockattr_destroy(&attr);
+    rbt_free(rbt);
+    cow_destroy(tree);
+}
+
+void print_scaling_table(FILE *fp, ScaleTimes *t) {
+    fprintf(fp, "%-8s %16s %16s %14s %14s %9s\n", "Readers", "rwlock reads/s", "COW reads/s", "rwlock wr/s", "COW wr/s",
+            "COW gain");
+    fprintf(fp, "---------------------------------------------------------------------------------\n");
+    for (int r = 0; r < t->rows; r++)
+        fprintf(fp, "%-8d %16.0f %16.0f %14.0f %14.0f %8.2fx\n", t->threads[r], t->reads[r][0], t->reads[r][1],
+                t->writes[r][0], t->writes[r][1], t->reads[r][0] > 0 ? t->reads[r][1] / t->reads[r][0] : 0.0);
+}
+
+/* ============ Κλιμάκωση μικτού φόρτου ============ */
+
+#define MIXED_SEARCH_PCT 80         /* τα υπόλοιπα μοιράζονται σε insert και delete */
+
+/* Λειτουργίες/s από 1..N νήματα που κάνουν όλα αναζητήσεις, inserts και
+ * deletes τυχαίων ονομάτων, για RBT πίσω από ένα mutex [0] και τη skip list
+ * χωρίς κλειδώματα [1]. Γεμίζουν οι μισές εγγραφές, οπότε περίπου τα μισά
+ * insert/delete αλλάζουν πράγματι τη δομή και το μέγεθος μένει σταθερό. */
+typedef struct {
+    int rows;
+    int threads[SCALE_ROWS];
+    double ops[SCALE_ROWS][2];
+} MixedTimes;
+
+typedef struct {
+    int skip;
+    SkipList *list;
+    RBTNode **rbt;
+    pthread_mutex_t *lock;
+    Citizen *citizens;
+    int count;
+    int *stop;
+    uint64_t seed, ops;
+    char pad[64];
+} MixedWorker;
+
+static void* mixed_worker(void *arg) {
+    MixedWorker *w = (MixedWorker*)arg;
+    int slot = w->skip ? skip_thread_register(w->list) : -1;
+    uint64_t x = w->seed, ops = 0;
+    volatile uintptr_t sink = 0;
+    while (!__atomic_load_n(w->stop, __ATOMIC_RELAXED)) {
+        for (int k = 0; k < 64; k++) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            const Citizen *c = &w->citizens[(x >> 8) % (uint64_t)w->count];
+            int op = (int)(x % 100);
+            if (w->skip) {
+                if (op < MIXED_SEARCH_PCT) {
+                    skip_enter(w->list, slot);
+                    sink += (uintptr_t)skip_find(w->list, c->full_name);
+                    skip_exit(w->list, slot);
+                } else if (op & 1) skip_insert(w->list, slot, c);
+                else skip_delete(w->list, slot, c->full_name);
+            } else {
+                pthread_mutex_lock(w->lock);
+                if (op < MIXED_SEARCH_PCT) sink += (uintptr_t)rbt_search_mt(*w->rbt, c->full_name);
+                else if (op & 1) *w->rbt = rbt_insert(*w->rbt, c);
+                else *w->rbt = rbt_delete(*w->rbt, c->full_name);
+                pthread_mutex_unlock(w->lock);
+            }
+        }
+        ops += 64;
+    }
+    (void)sink;
+    if (w->skip) skip_thread_unregister(w->list, slot);
+    w->ops = ops;
+    return NULL;
+}
+
+void bench_mixed_scaling(Citizen citizens[], int count, int max_threads, MixedTimes *t) {
+    memset(t, 0, sizeof(*t));
+    if (max_threads > SKIP_MAX_THREADS) max_threads = SKIP_MAX_THREADS;
+    for (int n = 1; t->rows < SCALE_ROWS - 1 && n < max_threads; n *= 2) t->threads[t->rows++] = n;
+    t->threads[t->rows++] = max_threads;
+
+    pthread_mutex_t lock;
+    pthread_mutex_init(&lock, NULL);
+    MixedWorker *w = (MixedWorker*)calloc(max_threads, sizeof(MixedWorker));
+    pthread_t *th = (pthread_t*)malloc(max_threads * sizeof(pthread_t));
+    for (int row = 0; row < t->rows; row++) {
+        for (int skip = 0; skip < 2; skip++) {
+            /* Ίδιο αρχικό περιεχόμενο σε κάθε γραμμή */
+            SkipList *list = skip_create();
+            RBTNode *rbt = NULL;
+            int slot = skip_thread_register(list);
+            for (int i = 0; i < count; i += 2) {
+                if (skip) skip_insert(list, slot, &citizens[i]);
+                else rbt = rbt_insert(rbt, &citizens[i]);
+            }
+            skip_thread_unregister(list, slot);
+
+            int threads = t->threads[row], stop = 0;
+            for (int i = 0; i < threads; i++)
+                w[i] = (MixedWorker){skip, list, &rbt, &lock, citizens, count, &stop, 0x9E3779B97F4A7C15ULL * (i + 1), 0, {0}};
+            double start = get_time_us();
+            for (int i = 0; i < threads; i++) pthread_create(&th[i], NULL, mixed_worker, &w[i]);
+            usleep(SCALE_BENCH_MS * 1000);
+            __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+            for (int i = 0; i < threads; i++) pthread_join(th[i], NULL);
+            double secs = (get_time_us() - start) / 1e6;
+            uint64_t ops = 0;
+            for (int i = 0; i < threads; i++) ops += w[i].ops;
+            t->ops[row][skip] = ops / secs;
+            rbt_free(rbt);
+            skip_destroy(list);
+        }
+    }
+    free(w); free(th);
+    pthread_mutex_destroy(&lock);
+}
+
+void print_mixed_table(FILE *fp, MixedTimes *t) {
+    fprintf(fp, "%-8s %16s %16s %9s\n", "Threads", "mutex RBT ops/s", "skip list ops/s", "Skip gain");
+    fprintf(fp, "--------------------------------------------------------\n");
+    for (int r = 0; r < t->rows; r++)
+        fprintf(fp, "%-8d %16.0f %16.0f %8.2fx\n", t->threads[r], t->ops[r][0], t->ops[r][1],
+                t->ops[r][0] > 0 ? t->ops[r][1] / t->ops[r][0] : 0.0);
+}
+
+/* ============ Κλιμάκωση εγγραφών σε shards ============ */
+
+#define SHARD_COLS 3
+static const int shard_bench_counts[SHARD_COLS] = {1, 8, SHARD_MAX};
+
+/* Ενημερώσεις/s από 1..N νήματα που κάνουν delete + insert, το καθένα στις
+ * δικές του εγγραφές, για AVL [0] και RBT [1] shards ανά πλήθος shards */
+typedef struct {
+    int rows;
+    int threads[SCALE_ROWS];
+    double writes[SCALE_ROWS][2][SHARD_COLS];
+} ShardTimes;
+
+typedef struct {
+    ShardStore *store;
+    Citizen *citizens;
+    int count, first, step;
+    int *stop;
+    uint64_t ops;
+    char pad[64];
+} ShardWorker;
+
+static void* shard_writer(void *arg) {
+    ShardWorker *w = (ShardWorker*)arg;
+    uint64_t ops = 0;
+    for (int j = w->first; !__atomic_load_n(w->stop, __ATOMIC_RELAXED); ops += 2) {
+        shard_delete(w->store, w->citizens[j].full_name);
+        shard_insert(w->store, &w->citizens[j]);
+        j += w->step;
+        if (j >= w->count) j = w->first;
+    }
+    w->ops = ops;
+    return NULL;
+}
+
+void bench_shard_scaling(Citizen citizens[], int count, int max_threads, ShardTimes *t) {
+    memset(t, 0, sizeof(*t));
+    if (max_threads > count) max_threads = count;
+    for (int n = 1; t->rows < SCALE_ROWS - 1 && n < max_threads; n *= 2) t->threads[t->rows++] = n;
+    t->threads[t->rows++] = max_threads;
+
+    ShardWorker *w = (ShardWorker*)calloc(max_threads, sizeof(ShardWorker));
+    pthread_t *th = (pthread_t*)malloc(max_threads * sizeof(pthread_t));
+    for (int k = 0; k < 2; k++) {
+        for (int col = 0; col < SHARD_COLS; col++) {
+            /* Ένα γέμισμα ανά αποθήκη: κάθε γραμμή αφήνει το ίδιο περιεχόμενο */
+            ShardStore store;
+            shard_store_init(&store, k ? SNAP_RBT : SNAP_AVL, shard_bench_counts[col]);
+            for (int i = 0; i < count; i++) shard_insert(&store, &citizens[i]);
+            for (int row = 0; row < t->rows; row++) {
+                int threads = t->threads[row], stop = 0;
+                for (int i = 0; i < threads; i++)
+                    w[i] = (ShardWorker){&store, citizens, count, i, threads, &stop, 0, {0}};
+                double start = get_time_us();
+                for (int i = 0; i < threads; i++) pthread_create(&th[i], NULL, shard_writer, &w[i]);
+                usleep(SCALE_BENCH_MS * 1000);
+                __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+                for (int i = 0; i < threads; i++) pthread_join(th[i], NULL);
+                double secs = (get_time_us() - start) / 1e6;
+                uint64_t ops = 0;
+                for (int i = 0; i < threads; i++) ops += w[i].ops;
+                t->writes[row][k][col] = ops / secs;
+            }
+            shard_store_destroy(&store);
+        }
+    }
+    free(w); free(th);
+}
+
+void print_shard_table(FILE *fp, ShardTimes *t) {
+    fprintf(fp, "%-8s", "Threads");
+    for (int k = 0; k < 2; k++)
+        for (int col = 0; col < SHARD_COLS; col++) {
+            char label[16];
+            snprintf(label, sizeof(label), "%s x%d", k ? "RBT" : "AVL", shard_bench_counts[col]);
+            fprintf(fp, " %12s", label);
+        }
+    fprintf(fp, "\n-------------------------------------------------------------------------------------\n");
+    for (int r = 0; r < t->rows; r++) {
+        fprintf(fp, "%-8d", t->threads[r]);
+        for (int k = 0; k < 2; k++)
+            for (int col = 0; col < SHARD_COLS; col++) fprintf(fp, " %12.0f", t->writes[r][k][col]);
+        fprintf(fp, "\n");
+    }
+}
+
+/* ============ Σύγκριση παράλληλης κατασκευής ============ */
+
+/* Χρόνος (us) της σειριακής μαζικής κατασκευής και της παράλληλης (ταξινόμηση
+ * + fork-join) με 1..N νήματα, για AVL [0] και RBT [1] από είσοδο σε τυχαία
+ * σειρά. Η επιτάχυνση μετριέται ως προς την παράλληλη με ένα νήμα. */
+typedef struct {
+    int rows;
+    int threads[SCALE_ROWS];
+    double par_us[SCALE_ROWS][2];
+    double bulk_us[2];
+} ParBuildTimes;
+
+void bench_parallel_build(Citizen citizens[], int count, int runs, int max_threads, ParBuildTimes *t) {
+    memset(t, 0, sizeof(*t));
+    if (max_threads > WS_MAX_THREADS) max_threads = WS_MAX_THREADS;
+    for (int n = 1; t->rows < SCALE_ROWS - 1 && n < max_threads; n *= 2) t->threads[t->rows++] = n;
+    t->threads[t->rows++] = max_threads;
+
+    for (int r = 0; r < runs; r++) {
+        double start = get_time_us();
+        BSTNode *avl = avl_bulk_build(citizens, count);
+        t->bulk_us[0] += get_time_us() - start;
+        start = get_time_us();
+        RBTNode *rbt = rbt_bulk_build(citizens, count);
+        t->bulk_us[1] += get_time_us() - start;
+        bst_free(avl); rbt_free(rbt);
+    }
+    for (int row = 0; row < t->rows; row++) {
+        WsPool *pool = ws_create(t->threads[row]);
+        for (int r = 0; r < runs; r++) {
+            double start = get_time_us();
+            BSTNode *avl = avl_parallel_build(pool, citizens, count);
+            t->par_us[row][0] += get_time_us() - start;
+            start = get_time_us();
+            RBTNode *rbt = rbt_parallel_build(pool, citizens, count);
+            t->par_us[row][1] += get_time_us() - start;
+            bst_free(avl); rbt_free(rbt);
+        }
+        ws_destroy(pool);
+        t->par_us[row][0] /= runs; t->par_us[row][1] /= runs;
+    }
+    t->bulk_us[0] /= runs; t->bulk_us[1] /= runs;
+}
+
+void print_parallel_build_table(FILE *fp, ParBuildTimes *t) {
+    fprintf(fp, "%-8s %12s %9s %12s %9s\n", "Threads", "AVL us", "speedup", "RBT us", "speedup");
+    fprintf(fp, "-------------------------------------------------------\n");
+    fprintf(fp, "%-8s %12.2f %9s %12.2f %9s\n", "bulk", t->bulk_us[0], "-", t->bulk_us[1], "-");
+    for (int r = 0; r < t->rows; r++)
+        fprintf(fp, "%-8d %12.2f %8.2fx %12.2f %8.2fx\n", t->threads[r], t->par_us[r][0],
+                t->par_us[r][0] > 0 ? t->par_us[0][0] / t->par_us[r][0] : 0.0, t->par_us[r][1],
+                t->par_us[r][1] > 0 ? t->par_us[0][1] / t->par_us[r][1] : 0.0);
+}
+
+/* ============ Σύγκριση αναδρομικών / επαναληπτικών ============ */
+
+/* Χρόνος (us) insert, search και delete όλων των εγγραφών για BST [0] και
+ * AVL [1], με είσοδο σε τυχαία [0] και ταξινομημένη [1] σειρά, με τις
+ * αναδρομικές εκδόσεις (Citizen by value) [0] και τις επαναληπτικές [1] */
+typedef struct {
+    double us[2][2][3][2];
+    int records[2][2];
+} IterTimes;
+
+/* Το BST με ταξινομημένη είσοδο τρέχει μόνο στις πρώτες cap εγγραφές: η
+ * αναδρομική έκδοση θα γέμιζε τη στοίβα (ένα Citizen ανά επίπεδο) και
+ * και οι δύο είναι O(n^2) */
+void bench_iterative(Citizen citizens[], int count, int runs, int cap, IterTimes *t) {
+    int head = count < cap ? count : cap;
+    Citizen *sorted = sorted_copy(citizens, count);
+    Citizen *sorted_head = sorted_copy(citizens, head);
+    memset(t, 0, sizeof(*t));
+    volatile uintptr_t sink = 0;
+
+    for (int in = 0; in < 2; in++) {
+        for (int tree = 0; tree < 2; tree++) t->records[tree][in] = (in && tree == 0) ? head : count;
+        for (int r = 0; r < runs; r++) {
+            for (int tree = 0; tree < 2; tree++) {
+                Citizen *src = !in ? citizens : tree ? sorted : sorted_head;
+                int n = t->records[tree][in];
+                BSTNode *rec_root = NULL, *it_root = NULL;
+                double start = get_time_us();
+                for (int i = 0; i < n; i++)
+                    rec_root = tree ? avl_insert_rec(rec_root, src[i]) : bst_insert_rec(rec_root, src[i]);
+                t->us[tree][in][0][0] += get_time_us() - start;
+                start = get_time_us();
+                for (int i = 0; i < n; i++)
+                    it_root = tree ? avl_insert(it_root, &src[i]) : bst_insert(it_root, &src[i]);
+                t->us[tree][in][0][1] += get_time_us() - start;
+
+                start = get_time_us();
+                for (int i = 0; i < n; i++) sink += (uintptr_t)bst_search_rec(rec_root, citizens[i].full_name);
+                t->us[tree][in][1][0] += get_time_us() - start;
+                start = get_time_us();
+                for (int i = 0; i < n; i++) sink += (uintptr_t)bst_search(it_root, citizens[i].full_name);
+                t->us[tree][in][1][1] += get_time_us() - start;
+
+                start = get_time_us();
+                for (int i = 0; i < n; i++)
+                    rec_root = tree ? avl_delete_rec(rec_root, citizens[i].full_name) : bst_delete_rec(rec_root, citizens[i].full_name);
+                t->us[tree][in][2][0] += get_time_us() - start;
+                start = get_time_us();
+                for (int i = 0; i < n; i++)
+                    it_root = tree ? avl_delete(it_root, citizens[i].full_name) : bst_delete(it_root, citizens[i].full_name);
+                t->us[tree][in][2][1] += get_time_us() - start;
+                bst_free(rec_root); bst_free(it_root);
+            }
+        }
+    }
+    (void)sink;
+    for (int tree = 0; tree < 2; tree++)
+        for (int in = 0; in < 2; in++)
+            for (int op = 0; op < 3; op++) { t->us[tree][in][op][0] /= runs; t->us[tree][in][op][1] /= runs; }
+    free(sorted); free(sorted_head);
+}
+
+void print_iterative_table(FILE *fp, IterTimes *t) {
+    const char *trees[2] = {"BST", "AVL"}, *inputs[2] = {"random", "sorted"};
+    const char *ops[3] = {"Insert", "Search", "Delete"};
+    fprintf(fp, "%-5s %-8s %-8s %9s %14s %14s %9s\n", "Tree", "Input", "Op", "records", "recursive us", "iterative us", "speedup");
+    fprintf(fp, "-----------------------------------------------------------------------------\n");
+    for (int tree = 0; tree < 2; tree++)
+        for (int in = 0; in < 2; in++)
+            for (int op = 0; op < 3; op++) {
+                double rec = t->us[tree][in][op][0], it = t->us[tree][in][op][1];
+                if (!t->records[tree][in]) { fprintf(fp, "%-5s %-8s %-8s %9s\n", trees[tree], inputs[in], ops[op], "skipped"); continue; }
+                fprintf(fp, "%-5s %-8s %-8s %9d %14.2f %14.2f %8.2fx\n", trees[tree], inputs[in], ops[op],
+                        t->records[tree][in], rec, it, it > 0 ? rec / it : 0.0);
+            }
+}
+
+/* ============ Σύγκριση συμπαγών κόμβων ============ */
+
+#define COMPACT_SEARCH_PASSES 20
+
+/* Χρόνος αναζήτησης όλων των ονομάτων COMPACT_SEARCH_PASSES φορές (us) */
+typedef struct {
+    double ptr_us[3];
+    double compact_us[3];
+} CompactTimes;
+
+void bench_compact(Citizen citizens[], int count, CompactTimes *t) {
+    BSTNode *bst_root = NULL, *avl_root = NULL;
+    RBTNode *rbt_root = NULL;
+    IndexPool pools[3];
+    uint32_t roots[3] = {0, 0, 0};
+    ipool_init(&pools[0], sizeof(CBSTNode));
+    ipool_init(&pools[1], sizeof(CAVLNode));
+    ipool_init(&pools[2], sizeof(CRBTNode));
+    for (int i = 0; i < count; i++) {
+        bst_root = bst_insert(bst_root, &citizens[i]);
+        avl_root = avl_insert(avl_root, &citizens[i]);
+        rbt_root = rbt_insert(rbt_root, &citizens[i]);
+        uint32_t r[3] = {cbst_insert(&pools[0], roots[0], &citizens[i]),
+                         cavl_insert(&pools[1], roots[1], &citizens[i]),
+                         crbt_insert(&pools[2], roots[2], &citizens[i])};
+        if (r[0] == IPOOL_FULL || r[1] == IPOOL_FULL || r[2] == IPOOL_FULL) {
+            printf("Σφάλμα: γέμισε ο πίνακας κόμβων - συμπαγή δέντρα με %d από %d εγγραφές\n", i, count);
+            count = i;      /* οι αναζητήσεις μόνο σε όσες μπήκαν */
+            break;
+        }
+        for (int k = 0; k < 3; k++) roots[k] = r[k];
+    }
+
+    volatile uintptr_t sink = 0;
+    double start;
+    memset(t, 0, sizeof(*t));
+    start = get_time_us();
+    for (int p = 0; p < COMPACT_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += (uintptr_t)bst_search(bst_root, citizens[i].full_name);
+    t->ptr_us[0] = get_time_us() - start;
+    start = get_time_us();
+    for (int p = 0; p < COMPACT_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += (uintptr_t)bst_search(avl_root, citizens[i].full_name);
+    t->ptr_us[1] = get_time_us() - start;
+    start = get_time_us();
+    for (int p = 0; p < COMPACT_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += (uintptr_t)rbt_search(rbt_root, citizens[i].full_name);
+    t->ptr_us[2] = get_time_us() - start;
+
+    start = get_time_us();
+    for (int p = 0; p < COMPACT_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += cbst_search(&pools[0], roots[0], citizens[i].full_name);
+    t->compact_us[0] = get_time_us() - start;
+    start = get_time_us();
+    for (int p = 0; p < COMPACT_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += cavl_search(&pools[1], roots[1], citizens[i].full_name);
+    t->compact_us[1] = get_time_us() - start;
+    start = get_time_us();
+    for (int p = 0; p < COMPACT_SEARCH_PASSES; p++)
+        for (int i = 0; i < count; i++) sink += crbt_search(&pools[2], roots[2], citizens[i].full_name);
+    t->compact_us[2] = get_time_us() - start;
+    (void)sink;
+
+    bst_free(bst_root); bst_free(avl_root); rbt_free(rbt_root);
+    for (int k = 0; k < 3; k++) ipool_destroy(&pools[k]);
+}
+
+void print_compact_table(FILE *fp, CompactTimes *t) {
+    const char *names[3] = {"BST", "AVL", "RBT"};
+    size_t ptr_size[3] = {sizeof(BSTNode), sizeof(BSTNode), sizeof(RBTNode)};
+    size_t compact_size[3] = {sizeof(CBSTNode), sizeof(CAVLNode), sizeof(CRBTNode)};
+    fprintf(fp, "%-6s %8s %8s %10s %10s %12s %12s %8s\n", "Tree", "node B", "meta B",
+            "cmp node B", "cmp meta B", "search us", "cmp search", "speedup");
+    fprintf(fp, "---------------------------------------------------------------------------------\n");
+    for (int k = 0; k < 3; k++)
+        fprintf(fp, "%-6s %8zu %8zu %10zu %10zu %12.2f %12.2f %7.2fx\n", names[k],
+                ptr_size[k], ptr_size[k] - sizeof(Citizen), compact_size[k], compact_size[k] - sizeof(Citizen),
+                t->ptr_us[k], t->compact_us[k], t->compact_us[k] > 0 ? t->ptr_us[k] / t->compact_us[k] : 0.0);
+}
+
+/* ============ Κόστος Συγκριτή ============ */
+
+/* Μεταφορά των μετρητών συγκρίσεων στα σύνολα μιας φάσης και μηδενισμός */
+static void key_stats_take(unsigned long long *calls, unsigned long long *full) {
+#if KEY_STATS
+    *calls += key_cmp_calls; *full += key_cmp_full;
+    key_cmp_calls = key_cmp_full = 0;
+#else
+    (void)calls; (void)full;
+#endif
+}
+
+static void key_stats_reset(void) {
+#if KEY_STATS
+    key_cmp_calls = key_cmp_full = 0;
+#endif
+}
+
+static int cmp_name_ptr(const void *a, const void *b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+#define CMP_BENCH_ROUNDS 200
+
+/* ns ανά σύγκριση για strcmp και key_cmp σε δύο είδη ζευγών: τυχαία
+ * ονόματα και διαδοχικά ονόματα σε αλφαβητική σειρά (κοινά προθέματα) */
+typedef struct {
+    double strcmp_ns[2];
+    double key_ns[2];
+} CmpCost;
+
+void bench_comparator(Citizen citizens[], int count, CmpCost *c) {
+    char **sorted = (char**)malloc(count * sizeof(char*));
+    uint64_t *keys = (uint64_t*)malloc(count * sizeof(uint64_t));
+    int *partner = (int*)malloc(count * sizeof(int));
+    for (int i = 0; i < count; i++) sorted[i] = citizens[i].full_name;
+    qsort(sorted, count, sizeof(char*), cmp_name_ptr);
+    for (int i = 0; i < count; i++) keys[i] = key_prefix(sorted[i]);
+
+    volatile int sink = 0;
+    for (int kind = 0; kind < 2; kind++) {
+        for (int i = 0; i < count; i++)
+            partner[i] = kind == 0 ? rand() % count : (i + 1) % count;
+        long long n = (long long)CMP_BENCH_ROUNDS * count;
+        double start = get_time_us();
+        for (int r = 0; r < CMP_BENCH_ROUNDS; r++)
+            for (int i = 0; i < count; i++) sink += strcmp(sorted[i], sorted[partner[i]]);
+        c->strcmp_ns[kind] = (get_time_us() - start) * 1000.0 / n;
+        start = get_time_us();
+        for (int r = 0; r < CMP_BENCH_ROUNDS; r++)
+            for (int i = 0; i < count; i++) sink += key_cmp(keys[i], sorted[i], keys[partner[i]], sorted[partner[i]]);
+        c->key_ns[kind] = (get_time_us() - start) * 1000.0 / n;
+    }
+    (void)sink;
+    free(sorted); free(keys); free(partner);
+}
+
+/* Μόνο τα τέσσερα δέντρα: η skip list συγκρίνει με την key_cmp_mt (χωρίς
+ * μετρητές), αφού τρέχει και σε πολλά νήματα */
+void print_cmp_tables(FILE *fp, unsigned long long calls[4][3], unsigned long long full[4][3],
+                      long long ops[3], CmpCost *c) {
+    const char *op_names[3] = {"Insert", "Search", "Delete"};
+    fprintf(fp, "Key comparisons per op (of which strcmp fallbacks)\n");
+    fprintf(fp, "%-10s %18s %18s %18s %18s\n", "Operation", "BST", "AVL", "RBT", "B+");
+    fprintf(fp, "-------------------------------------------------------------------------------------\n");
+    for (int op = 0; op < 3; op++) {
+        fprintf(fp, "%-10s", op_names[op]);
+        for (int t = 0; t < 4; t++)
+            fprintf(fp, " %9.2f (%6.2f)", (double)calls[t][op] / ops[op], (double)full[t][op] / ops[op]);
+        fprintf(fp, "\n");
+    }
+    fprintf(fp, "\nComparator cost (ns/compare)\n");
+    fprintf(fp, "%-10s %14s %14s\n", "Comparator", "random pairs", "sorted nbrs");
+    fprintf(fp, "------------------------------------------\n");
+    fprintf(fp, "%-10s %14.2f %14.2f\n", "strcmp", c->strcmp_ns[0], c->strcmp_ns[1]);
+    fprintf(fp, "%-10s %14.2f %14.2f\n", "key_cmp", c->key_ns[0], c->key_ns[1]);
+}
+
+/* ============ Ιστογράμματα Καθυστέρησης ============ */
+
+/* Λογαριθμικό-γραμμικό ιστόγραμμα (όπως το HdrHistogram): κάθε δύναμη του 2
+ * χωρίζεται σε HIST_SUB γραμμικούς κάδους, οπότε κάθε εκατοστημόριο έχει
+ * σχετικό σφάλμα το πολύ 1/HIST_SUB με σταθερή μνήμη, όσα δείγματα κι αν
+ * καταγραφούν. Μέσος όρος και τυπική απόκλιση υπολογίζονται ακριβώς. */
+#define HIST_SUB_BITS 5
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB)
+
+typedef struct {
+    uint64_t bucket[HIST_BUCKETS];
+    uint64_t n, min, max;
+    double sum, sumsq;
+} Histogram;
+
+static void hist_reset(Histogram *h) { memset(h, 0, sizeof(*h)); h->min = UINT64_MAX; }
+
+static inline int hist_index(uint64_t v) {
+    if (v < HIST_SUB) return (int)v;
+    int shift = 63 - __builtin_clzll(v) - HIST_SUB_BITS;
+    return (shift + 1) * HIST_SUB + (int)(v >> shift) - HIST_SUB;
+}
+
+static inline void hist_record(Histogram *h, uint64_t v) {
+    h->bucket[hist_index(v)]++;
+    h->n++;
+    h->sum += (double)v;
+    h->sumsq += (double)v * (double)v;
+    if (v < h->min) h->min = v;
+    if (v > h->max) h->max = v;
+}
+
+/* Τιμή στο εκατοστημόριο p: μέσο του κάδου, περιορισμένο στο [min, max] */
+static double hist_percentile(const Histogram *h, double p) {
+    if (h->n == 0) return 0;
+    uint64_t target = (uint64_t)(p / 100.0 * h->n + 0.5), seen = 0;
+    if (target < 1) target = 1;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->bucket[i];
+        if (seen < target) continue;
+        if (i < 2 * HIST_SUB) return i;
+        int shift = i / HIST_SUB - 1;
+        double v = (double)((uint64_t)(i % HIST_SUB + HIST_SUB) << shift) + (double)((uint64_t)1 << shift) / 2;
+        return v < h->min ? h->min : v > h->max ? h->max : v;
+    }
+    return (double)h->max;
+}
+
+static double hist_mean(const Histogram *h) { return h->n ? h->sum / h->n : 0; }
+
+static double hist_stddev(const Histogram *h) {
+    if (h->n < 2) return 0;
+    double mean = hist_mean(h), var = (h->sumsq - h->n * mean * mean) / (h->n - 1);
+    return var > 0 ? sqrt(var) : 0;
+}
+
+/* Κόστος μιας ανάγνωσης του ρολογιού (διάμεσος διαδοχικών διαφορών) - κάθε
+ * δείγμα καθυστέρησης το περιέχει μία φορά */
+static double clock_overhead_ns(void) {
+    Histogram h;
+    hist_reset(&h);
+    for (int i = 0; i < 100000; i++) { uint64_t a = now_ns(); hist_record(&h, now_ns() - a); }
+    return hist_percentile(&h, 50);
+}
+
+/* ============ Μετρητές Υλικού ============ */
+
+/* Προαιρετικοί μετρητές απόδοσης του επεξεργαστή μέσω perf_event_open (-p),
+ * γύρω από κάθε φάση insert/search/delete κάθε δέντρου. Κάθε μετρητής
+ * ανοίγει χωριστά, οπότε όσοι δεν υποστηρίζονται (container, VM,
+ * perf_event_paranoid) εμφανίζονται ως n/a και οι υπόλοιποι μετρούν κανονικά.
+ * Μεταγλώττιση με -DPERF_COUNTERS=0 για πλήρη απενεργοποίηση. */
+#ifndef PERF_COUNTERS
+#ifdef __linux__
+#define PERF_COUNTERS 1
+#else
+#define PERF_COUNTERS 0
+#endif
+#endif
+
+#if PERF_COUNTERS
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+enum { PMU_CYCLES, PMU_INSTR, PMU_L1D_MISS, PMU_LLC_MISS, PMU_DTLB_MISS, PMU_BR_MISS, PMU_COUNT };
+static const char *pmu_names[PMU_COUNT] = {"cycles", "instr", "L1D miss", "LLC miss", "dTLB miss", "br miss"};
+static const char *pmu_keys[PMU_COUNT] = {"cycles", "instructions", "l1d_misses", "llc_misses",
+                                          "dtlb_misses", "branch_misses"};
+
+typedef struct {
+    int fd[PMU_COUNT];      /* -1 = μη διαθέσιμος */
+    int available;          /* πλήθος μετρητών που άνοιξαν */
+    int error;              /* errno της πρώτης αποτυχίας */
+} PerfCounters;
+
+/* Συσσωρευμένες τιμές μιας φάσης (κλιμακωμένες αν έγινε multiplexing) */
+typedef struct {
+    double value[PMU_COUNT];
+    unsigned char have[PMU_COUNT];  /* 1 = ο μετρητής διαβάστηκε */
+    uint64_t ops;
+} PerfTotals;
+
+#if PERF_COUNTERS
+static int perf_open(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;    /* επιτρέπεται με perf_event_paranoid <= 2 */
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+#define PERF_CACHE_MISS(c) ((c) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+#endif
+
+void perf_init(PerfCounters *pc) {
+    pc->available = 0;
+    pc->error = 0;
+    for (int k = 0; k < PMU_COUNT; k++) pc->fd[k] = -1;
+#if PERF_COUNTERS
+    const uint32_t type[PMU_COUNT] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                      PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+    const uint64_t config[PMU_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                        PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_L1D), PERF_COUNT_HW_CACHE_MISSES,
+                                        PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_DTLB), PERF_COUNT_HW_BRANCH_MISSES};
+    for (int k = 0; k < PMU_COUNT; k++) {
+        pc->fd[k] = perf_open(type[k], config[k]);
+        if (pc->fd[k] >= 0) pc->available++;
+        else if (!pc->error) pc->error = errno;
+    }
+#endif
+}
+
+void perf_close(PerfCounters *pc) {
+#if PERF_COUNTERS
+    for (int k = 0; k < PMU_COUNT; k++)
+        if (pc->fd[k] >= 0) close(pc->fd[k]);
+#endif
+    for (int k = 0; k < PMU_COUNT; k++) pc->fd[k] = -1;
+    pc->available = 0;
+}
+
+/* Μηδενισμός και εκκίνηση όλων των διαθέσιμων μετρητών */
+static inline void perf_start(PerfCounters *pc) {
+#if PERF_COUNTERS
+    for (int k = 0; k < PMU_COUNT; k++)
+        if (pc->fd[k] >= 0) {
+            ioctl(pc->fd[k], PERF_EVENT_IOC_RESET, 0);
+            ioctl(pc->fd[k], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#else
+    (void)pc;
+#endif
+}
+
+/* Διακοπή και πρόσθεση των τιμών της φάσης στο t (ops λειτουργίες) */
+static inline void perf_stop(PerfCounters *pc, PerfTotals *t, uint64_t ops) {
+#if PERF_COUNTERS
+    for (int k = 0; k < PMU_COUNT; k++)
+        if (pc->fd[k] >= 0) ioctl(pc->fd[k], PERF_EVENT_IOC_DISABLE, 0);
+    for (int k = 0; k < PMU_COUNT; k++) {
+        uint64_t v[3]; /* τιμή, χρόνος ενεργός, χρόνος σε λειτουργία */
+        if (pc->fd[k] < 0 || read(pc->fd[k], v, sizeof(v)) != (ssize_t)sizeof(v)) continue;
+        t->value[k] += v[2] && v[2] < v[1] ? (double)v[0] * v[1] / v[2] : (double)v[0];
+        t->have[k] = 1;
+    }
+#else
+    (void)pc;
+#endif
+    t->ops += ops;
+}
+
+/* Τιμή ανά λειτουργία ή αρνητική αν ο μετρητής δεν είναι διαθέσιμος */
+static double perf_per_op(const PerfTotals *t, int k) {
+    return t->have[k] && t->ops ? t->value[k] / t->ops : -1.0;
+}
+
+static void perf_print_cell(FILE *fp, double v) {
+    if (v < 0) fprintf(fp, " %9s", "n/a");
+    else fprintf(fp, " %9.2f", v);
+}
+
+/* ============ Πίνακας Δέντρων ============ */
+
+/* Κοινή διεπαφή των τεσσάρων δέντρων και της skip list για το βασικό
+ * benchmark: η ρίζα περνά ως void* και κάθε δομή έχει τα δικά της wrappers */
+typedef struct {
+    const char *name;
+    void* (*insert)(void *root, const Citizen *c);
+    const void* (*search)(void *root, const char *name);
+    void* (*remove)(void *root, const char *name);
+    void (*destroy)(void *root);
+} Engine;
+
+static void* eng_bst_insert(void *r, const Citizen *c) { return bst_insert((BSTNode*)r, c); }
+static void* eng_avl_insert(void *r, const Citizen *c) { return avl_insert((BSTNode*)r, c); }
+static void* eng_rbt_insert(void *r, const Citizen *c) { return rbt_insert((RBTNode*)r, c); }
+static void* eng_bpt_insert(void *r, const Citizen *c) { return bpt_insert((BPTNode*)r, c); }
+static const void* eng_bst_search(void *r, const char *n) { return bst_search((BSTNode*)r, n); }
+static const void* eng_rbt_search(void *r, const char *n) { return rbt_search((RBTNode*)r, n); }
+static const void* eng_bpt_search(void *r, const char *n) { return bpt_search((BPTNode*)r, n); }
+static void* eng_bst_delete(void *r, const char *n) { return bst_delete((BSTNode*)r, n); }
+static void* eng_avl_delete(void *r, const char *n) { return avl_delete((BSTNode*)r, n); }
+static void* eng_rbt_delete(void *r, const char *n) { return rbt_delete((RBTNode*)r, n); }
+static void* eng_bpt_delete(void *r, const char *n) { return bpt_delete((BPTNode*)r, n); }
+static void eng_bst_free(void *r) { bst_free((BSTNode*)r); }
+static void eng_rbt_free(void *r) { rbt_free((RBTNode*)r); }
+static void eng_bpt_free(void *r) { bpt_free((BPTNode*)r); }
+
+/* Η skip list φτιάχνεται στο πρώτο insert και το βασικό benchmark τρέχει σε
+ * ένα νήμα, με τη θέση 0 */
+static void* eng_skip_insert(void *r, const Citizen *c) {
+    SkipList *l = (SkipList*)r;
+    if (!l) { l = skip_create(); skip_thread_register(l); }
+    skip_insert(l, 0, c);
+    return l;
+}
+static const void* eng_skip_search(void *r, const char *n) {
+    if (!r) return NULL;
+    skip_enter((SkipList*)r, 0);
+    const Citizen *c = skip_find((SkipList*)r, n);
+    skip_exit((SkipList*)r, 0);
+    return c;
+}
+static void* eng_skip_delete(void *r, const char *n) { if (r) skip_delete((SkipList*)r, 0, n); return r; }
+static void eng_skip_free(void *r) { skip_destroy((SkipList*)r); }
+
+#define ENGINE_COUNT 5
+static const Engine engines[ENGINE_COUNT] = {
+    {"BST", eng_bst_insert, eng_bst_search, eng_bst_delete, eng_bst_free},
+    {"AVL", eng_avl_insert, eng_bst_search, eng_avl_delete, eng_bst_free},
+    {"RBT", eng_rbt_insert, eng_rbt_search, eng_rbt_delete, eng_rbt_free},
+    {"B+", eng_bpt_insert, eng_bpt_search, eng_bpt_delete, eng_bpt_free},
+    {"Skip", eng_skip_insert, eng_skip_search, eng_skip_delete, eng_skip_free},
+};
+
+/* ============ Μνήμη ανά Δέντρο ============ */
+
+/* Για κάθε μέγεθος της σάρωσης και κάθε δέντρο (BST, AVL, RBT): χτίζεται το
+ * δέντρο σε ξεχωριστή διεργασία (fork), ώστε το peak RSS και ο heap να
+ * αφορούν μόνο αυτό, και μετά διαγράφονται τυχαία οι μισές εγγραφές για να φανεί
+ * πόση μνήμη κρατά ο allocator χωρίς να τη χρησιμοποιεί (κατακερματισμός). */
+#define MEM_TREES 3
+#define MEM_SWEEP_MAX 4
+
+/* mallinfo2 / malloc_trim (glibc >= 2.33) για τα bytes του heap */
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define MEM_MALLINFO 1
+#else
+#define MEM_MALLINFO 0
+#endif
+
+typedef struct {
+    int records;
+    size_t live_nodes, live_bytes;  /* από τη λογιστική των κόμβων */
+    long long heap_bytes;           /* bytes heap μαζί με headers του malloc (-1 = άγνωστο) */
+    long long peak_rss;             /* αύξηση peak RSS σε bytes (-1 = άγνωστο) */
+    size_t del_live_bytes;          /* ζωντανά bytes κόμβων μετά τη διαγραφή */
+    long long del_heap_bytes;       /* heap σε χρήση μετά τη διαγραφή (-1 = άγνωστο) */
+    long long del_held_bytes;       /* heap σε χρήση ή σε ελεύθερα κενά (-1 = άγνωστο) */
+} MemRow;
+
+typedef struct {
+    int sizes, size[MEM_SWEEP_MAX];
+    MemRow row[MEM_SWEEP_MAX][MEM_TREES];
+} MemReport;
+
+static MemStats *const mem_stats_of[MEM_TREES] = {&bst_mem, &bst_mem, &rbt_mem};
+static const size_t mem_node_size[MEM_TREES] = {sizeof(BSTNode), sizeof(BSTNode), sizeof(RBTNode)};
+
+/* Πεδίο "VmRSS" ή "VmHWM" (peak) του /proc/self/status σε bytes (-1 εκτός Linux) */
+static long long proc_status_bytes(const char *field) {
+    char line[128];
+    long long kib = -1;
+    size_t len = strlen(field);
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (!fp) return -1;
+    while (fgets(line, sizeof(line), fp))
+        if (!strncmp(line, field, len) && line[len] == ':') { kib = atoll(line + len + 1); break; }
+    fclose(fp);
+    return kib < 0 ? -1 : kib * 1024;
+}
+
+/* Μηδενισμός του peak RSS (VmHWM) στο τρέχον RSS - Linux >= 4.0 */
+static int reset_peak_rss(void) {
+    FILE *fp = fopen("/proc/self/clear_refs", "w");
+    if (!fp) return 0;
+    int ok = fputs("5", fp) >= 0;
+    return fclose(fp) == 0 && ok;
+}
+
+/* Bytes του heap σε χρήση (μαζί με headers) και σε χρήση ή σε ελεύθερα
+ * κενά ανάμεσά τους - η ελεύθερη κορυφή (keepcost) δεν μετρά, γιατί ο
+ * allocator μπορεί να την επιστρέψει στο σύστημα */
+static int heap_usage(long long *used, long long *held) {
+#if MEM_MALLINFO
+    struct mallinfo2 mi = mallinfo2();
+    *used = (long long)(mi.uordblks + mi.hblkhd);
+    *held = *used + (long long)(mi.fordblks - mi.keepcost);
+    return 1;
+#else
+    *used = *held = 0;
+    return 0;
+#endif
+}
+
+static void mem_measure(int tree, Citizen citizens[], int n, const int *order, MemRow *row) {
+    const Engine *E = &engines[tree];
+    MemStats *m = mem_stats_of[tree];
+    long long used0, held0, used1, held1, used2, held2;
+#if MEM_MALLINFO
+    malloc_trim(0);
+#endif
+    int have_heap = heap_usage(&used0, &held0);
+    /* Η πρώτη ανάγνωση μετά το fork προκαλεί copy-on-write σελίδες του
+     * allocator και του stdio - γίνεται πριν τον μηδενισμό του peak */
+    proc_status_bytes("VmRSS");
+    long long rss0 = reset_peak_rss() ? proc_status_bytes("VmRSS") : -1;
+    memset(m, 0, sizeof(*m));
+
+    void *root = NULL;
+    for (int i = 0; i < n; i++) root = E->insert(root, &citizens[i]);
+    heap_usage(&used1, &held1);
+    row->records = n;
+    row->live_nodes = m->live_nodes;
+    row->live_bytes = m->live_bytes;
+    row->heap_bytes = have_heap ? used1 - used0 : -1;
+
+    long long peak = proc_status_bytes("VmHWM");
+    row->peak_rss = rss0 >= 0 && peak >= 0 ? peak - rss0 : -1;
+
+    for (int i = 0; i < n / 2; i++) root = E->remove(root, citizens[order[i]].full_name);
+    heap_usage(&used2, &held2);
+    row->del_live_bytes = m->live_bytes;
+    row->del_heap_bytes = have_heap ? used2 - used0 : -1;
+    row->del_held_bytes = have_heap ? held2 - held0 : -1;
+    E->destroy(root);
+}
+
+void bench_memory(Citizen citizens[], int count, MemReport *rep) {
+    int *order = (int*)malloc(count * sizeof(int));
+    memset(rep, 0, sizeof(*rep));
+    for (int s = MEM_SWEEP_MAX - 1; s >= 0; s--) {
+        int n = count >> s;
+        if (n > 0 && (rep->sizes == 0 || rep->size[rep->sizes - 1] != n)) rep->size[rep->sizes++] = n;
+    }
+    for (int si = 0; si < rep->sizes; si++) {
+        int n = rep->size[si];
+        for (int i = 0; i < n; i++) order[i] = i;
+        for (int i = n - 1; i > 0; i--) { int j = rand() % (i + 1), t = order[i]; order[i] = order[j]; order[j] = t; }
+
+        for (int tree = 0; tree < MEM_TREES; tree++) {
+            MemRow *row = &rep->row[si][tree];
+            int fds[2];
+            pid_t pid = -1;
+            fflush(stdout);
+            int piped = pipe(fds) == 0;
+            if (piped && (pid = fork()) == 0) {
+                close(fds[0]);
+                mem_measure(tree, citizens, n, order, row);
+                ssize_t w = write(fds[1], row, sizeof(*row));
+                _exit(w == (ssize_t)sizeof(*row) ? 0 : 1);
+            }
+            if (piped && pid < 0) { close(fds[0]); close(fds[1]); }   /* αποτυχία fork */
+            if (pid > 0) {
+                close(fds[1]);
+                ssize_t got = read(fds[0], row, sizeof(*row));
+                close(fds[0]);
+                waitpid(pid, NULL, 0);
+                if (got == (ssize_t)sizeof(*row)) continue;
+            }
+            /* Χωρίς fork: μέτρηση στην ίδια διεργασία (το peak RSS δεν ισχύει) */
+            mem_measure(tree, citizens, n, order, row);
+            row->peak_rss = -1;
+        }
+    }
+    free(order);
+}
+
+static void mem_print_kib(FILE *fp, long long bytes, int width) {
+    if (bytes < 0) fprintf(fp, " %*s", width, "n/a");
+    else fprintf(fp, " %*.1f", width, bytes / 1024.0);
+}
+
+void print_memory_table(FILE *fp, MemReport *rep) {
+    fprintf(fp, "%-5s %8s %6s %9s %9s %8s %10s %9s | %9s %9s %6s\n", "Tree", "records", "node B",
+            "live B/r", "heap B/r", "overhd", "peakRSS K", "RSS B/r", "live K", "held K", "frag");
+    fprintf(fp, "----------------------------------------------------------------------------------------------------------\n");
+    for (int si = 0; si < rep->sizes; si++)
+        for (int tree = 0; tree < MEM_TREES; tree++) {
+            MemRow *r = &rep->row[si][tree];
+            double n = r->records;
+            fprintf(fp, "%-5s %8d %6zu %9.1f", engines[tree].name, r->records, mem_node_size[tree], r->live_bytes / n);
+            if (r->heap_bytes < 0) fprintf(fp, " %9s %8s", "n/a", "n/a");
+            else fprintf(fp, " %9.1f %7.1f%%", r->heap_bytes / n, (r->heap_bytes / n / sizeof(Citizen) - 1) * 100);
+            mem_print_kib(fp, r->peak_rss, 10);
+            if (r->peak_rss < 0) fprintf(fp, " %9s", "n/a");
+            else fprintf(fp, " %9.1f", r->peak_rss / n);
+            fprintf(fp, " |");
+            mem_print_kib(fp, (long long)r->del_live_bytes, 9);
+            mem_print_kib(fp, r->del_held_bytes, 9);
+            /* Κατακερματισμός: ποσοστό του heap του δέντρου που είναι ελεύθερο */
+            if (r->del_held_bytes <= 0) fprintf(fp, " %6s", "n/a");
+            else fprintf(fp, " %5.1f%%", r->del_heap_bytes >= r->del_held_bytes ? 0.0
+                         : (1.0 - (double)r->del_heap_bytes / r->del_held_bytes) * 100);
+            fprintf(fp, "\n");
+        }
+}
+
+/* ============ Βασικό Benchmark ============ */
+
+enum { OP_INSERT, OP_SEARCH, OP_DELETE, OP_COUNT };
+static const char *op_names[OP_COUNT] = {"Insert", "Search", "Delete"};
+
+/* Παράμετροι από τη γραμμή εντολών */
+typedef struct {
+    int records;        /* -n: μέγιστο πλήθος εγγραφών από το citizens.txt (0 = όλες) */
+    int searches;       /* -q: τυχαίες αναζητήσεις ανά επανάληψη */
+    int deletes;        /* -d: διαγραφές διαφορετικών ονομάτων (-1 = όλα) */
+    int runs;           /* -r: μετρούμενες επαναλήψεις */
+    int warmup;         /* -w: επαναλήψεις ζεστάματος (δεν μετρούν) */
+    unsigned seed;      /* -s: seed επιλογής ονομάτων */
+    int core_only;      /* -c: μόνο ο βασικός πίνακας */
+    int perf;           /* -p: μετρητές υλικού ανά φάση */
+    const char *bin_path;   /* -b: δυαδικό αρχείο αντί για citizens.txt */
+    int threads;        /* -t: μέγιστο πλήθος νημάτων στα benchmarks κλιμάκωσης */
+    int degenerate_max; /* -m: εγγραφές για ταξινομημένη είσοδο σε BST (0 = παράλειψη) */
+    const char *csv_path, *json_path;
+} BenchConfig;
+
+/* Αποτελέσματα ανά [δέντρο][λειτουργία]: ιστόγραμμα καθυστέρησης ανά
+ * λειτουργία και συνολικός χρόνος βρόχου χωρίς χρονομέτρηση ανά λειτουργία */
+typedef struct {
+    Histogram lat;
+    uint64_t loop_ns, loop_ops;
+} OpResult;
+
+typedef struct {
+    OpResult r[ENGINE_COUNT][OP_COUNT];
+    PerfTotals pmu[ENGINE_COUNT][OP_COUNT];
+    int perf_requested, perf_available, perf_error;
+    unsigned long long cmp_calls[ENGINE_COUNT][OP_COUNT], cmp_full[ENGINE_COUNT][OP_COUNT];
+    long long cmp_ops[OP_COUNT];
+    int searches, deletes;
+    double clock_ns;
+} CoreResults;
+
+static void usage(const char *prog) {
+    printf("Χρήση: %s [-n εγγραφές] [-q αναζητήσεις] [-d διαγραφές] [-r επαναλήψεις] [-w ζέσταμα]\n"
+           "          [-s seed] [-c] [-p] [-t νήματα] [-m εγγραφές] [-b citizens.bin] [--csv αρχείο] [--json αρχείο]\n"
+           "  -n  μέγιστο πλήθος εγγραφών (0 = όλες, προεπιλογή)\n"
+           "  -b  φόρτωση από δυαδικό αρχείο (generate_citizens -f bin) αντί για citizens.txt\n"
+           "  -c  μόνο ο βασικός πίνακας (χωρίς τις συγκρίσεις παραλλαγών)\n"
+           "  -p  μετρητές υλικού (perf_event_open) ανά φάση\n"
+           "  -t  μέγιστο πλήθος νημάτων στα benchmarks κλιμάκωσης (προεπιλογή: όλοι οι πυρήνες)\n"
+           "  -m  ταξινομημένη είσοδος σε απλό BST (O(n^2), αναδρομή βάθους n) μόνο στις πρώτες\n"
+           "      τόσες εγγραφές (προεπιλογή %d, 0 = παράλειψη)\n", prog, DEGENERATE_MAX);
+}
+
+static int parse_args(int argc, char *argv[], BenchConfig *cfg) {
+    cfg->records = 0; cfg->searches = 100000; cfg->deletes = -1;
+    cfg->runs = 5; cfg->warmup = 1; cfg->seed = 42; cfg->core_only = 0; cfg->perf = 0;
+    cfg->csv_path = "results.csv"; cfg->json_path = "results.json"; cfg->bin_path = NULL;
+    cfg->degenerate_max = DEGENERATE_MAX;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    cfg->threads = cpus > 0 ? (int)cpus : 1;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i], *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(a, "-c")) { cfg->core_only = 1; continue; }
+        if (!strcmp(a, "-p")) { cfg->perf = 1; continue; }
+        if (!v) return 0;
+        if (!strcmp(a, "-n")) cfg->records = (int)strtod(v, NULL);
+        else if (!strcmp(a, "-q")) cfg->searches = (int)strtod(v, NULL);
+        else if (!strcmp(a, "-d")) cfg->deletes = (int)strtod(v, NULL);
+        else if (!strcmp(a, "-r")) cfg->runs = atoi(v);
+        else if (!strcmp(a, "-w")) cfg->warmup = atoi(v);
+        else if (!strcmp(a, "-s")) cfg->seed = (unsigned)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "-b")) cfg->bin_path = v;
+        else if (!strcmp(a, "-t")) cfg->threads = atoi(v);
+        else if (!strcmp(a, "-m")) cfg->degenerate_max = (int)strtod(v, NULL);
+        else if (!strcmp(a, "--csv")) cfg->csv_path = v;
+        else if (!strcmp(a, "--json")) cfg->json_path = v;
+        else return 0;
+        i++;
+    }
+    return cfg->records >= 0 && cfg->searches >= 0 && cfg->runs > 0 && cfg->warmup >= 0 && cfg->threads > 0 &&
+           cfg->degenerate_max >= 0;
+}
+
+/* Κάθε επανάληψη, για κάθε δέντρο: insert όλων των εγγραφών, τυχαίες
+ * αναζητήσεις και διαγραφές διαφορετικών ονομάτων σε τυχαία σειρά, πρώτα με
+ * χρονομέτρηση κάθε λειτουργίας (ιστόγραμμα) και μετά ως ενιαίος βρόχος
+ * (ns/op και ops/s χωρίς το κόστος του ρολογιού, και μετρητές υλικού με -p).
+ * Οι πρώτες cfg->warmup επαναλήψεις ζεσταίνουν caches και allocator και
+ * απορρίπτονται. */
+void bench_core(const BenchConfig *cfg, Citizen citizens[], int count, CoreResults *res) {
+    static OpResult scratch[OP_COUNT];
+    int searches = cfg->searches;
+    int deletes = cfg->deletes < 0 || cfg->deletes > count ? count : cfg->deletes;
+    int *search_idx = (int*)malloc((searches > 0 ? searches : 1) * sizeof(int));
+    int *delete_idx = (int*)malloc(count * sizeof(int));
+    for (int i = 0; i < searches; i++) search_idx[i] = rand() % count;
+    for (int i = 0; i < count; i++) delete_idx[i] = i;
+    for (int i = count - 1; i > 0; i--) {
+        int j = rand() % (i + 1), t = delete_idx[i];
+        delete_idx[i] = delete_idx[j]; delete_idx[j] = t;
+    }
+
+    memset(res, 0, sizeof(*res));
+    for (int e = 0; e < ENGINE_COUNT; e++)
+        for (int op = 0; op < OP_COUNT; op++) hist_reset(&res->r[e][op].lat);
+    res->searches = searches;
+    res->deletes = deletes;
+    res->clock_ns = clock_overhead_ns();
+
+    static PerfTotals perf_scratch[OP_COUNT];
+    PerfCounters pc;
+    perf_init(&pc);
+    if (!cfg->perf) perf_close(&pc);
+    res->perf_requested = cfg->perf;
+    res->perf_available = pc.available;
+    res->perf_error = cfg->perf ? pc.error : 0;
+
+    volatile uintptr_t sink = 0;
+    unsigned long long drop_calls = 0, drop_full = 0;
+    for (int run = 0; run < cfg->warmup + cfg->runs; run++) {
+        int measured = run >= cfg->warmup;
+        if (measured) printf("Επανάληψη %d/%d...\n", run - cfg->warmup + 1, cfg->runs);
+        else printf("Ζέσταμα %d/%d...\n", run + 1, cfg->warmup);
+
+        for (int e = 0; e < ENGINE_COUNT; e++) {
+            const Engine *E = &engines[e];
+            OpResult *out = measured ? res->r[e] : scratch;
+            PerfTotals *pmu = measured ? res->pmu[e] : perf_scratch;
+            void *root = NULL;
+            uint64_t t0, t1;
+
+            /* Χρονομέτρηση ανά λειτουργία */
+            key_stats_reset();
+            for (int i = 0; i < count; i++) {
+                t0 = now_ns(); root = E->insert(root, &citizens[i]); t1 = now_ns();
+                hist_record(&out[OP_INSERT].lat, t1 - t0);
+            }
+            key_stats_take(measured ? &res->cmp_calls[e][OP_INSERT] : &drop_calls,
+                           measured ? &res->cmp_full[e][OP_INSERT] : &drop_full);
+            for (int i = 0; i < searches; i++) {
+                t0 = now_ns(); sink += (uintptr_t)E->search(root, citizens[search_idx[i]].full_name); t1 = now_ns();
+                hist_record(&out[OP_SEARCH].lat, t1 - t0);
+            }
+            key_stats_take(measured ? &res->cmp_calls[e][OP_SEARCH] : &drop_calls,
+                           measured ? &res->cmp_full[e][OP_SEARCH] : &drop_full);
+            for (int i = 0; i < deletes; i++) {
+                t0 = now_ns(); root = E->remove(root, citizens[delete_idx[i]].full_name); t1 = now_ns();
+                hist_record(&out[OP_DELETE].lat, t1 - t0);
+            }
+            key_stats_take(measured ? &res->cmp_calls[e][OP_DELETE] : &drop_calls,
+                           measured ? &res->cmp_full[e][OP_DELETE] : &drop_full);
+            E->destroy(root);
+            root = NULL;
+
+            /* Ίδιες λειτουργίες ως ενιαίοι βρόχοι */
+            perf_start(&pc);
+            t0 = now_ns();
+            for (int i = 0; i < count; i++) root = E->insert(root, &citizens[i]);
+            t1 = now_ns();
+            perf_stop(&pc, &pmu[OP_INSERT], count);
+            out[OP_INSERT].loop_ns += t1 - t0; out[OP_INSERT].loop_ops += count;
+            perf_start(&pc);
+            t0 = now_ns();
+            for (int i = 0; i < searches; i++) sink += (uintptr_t)E->search(root, citizens[search_idx[i]].full_name);
+            t1 = now_ns();
+            perf_stop(&pc, &pmu[OP_SEARCH], searches);
+            out[OP_SEARCH].loop_ns += t1 - t0; out[OP_SEARCH].loop_ops += searches;
+            perf_start(&pc);
+            t0 = now_ns();
+            for (int i = 0; i < deletes; i++) root = E->remove(root, citizens[delete_idx[i]].full_name);
+            t1 = now_ns();
+            perf_stop(&pc, &pmu[OP_DELETE], deletes);
+            out[OP_DELETE].loop_ns += t1 - t0; out[OP_DELETE].loop_ops += deletes;
+            E->destroy(root);
+            key_stats_take(&drop_calls, &drop_full);
+        }
+    }
+    (void)sink;
+    res->cmp_ops[OP_INSERT] = (long long)count * cfg->runs;
+    res->cmp_ops[OP_SEARCH] = (long long)searches * cfg->runs;
+    res->cmp_ops[OP_DELETE] = (long long)deletes * cfg->runs;
+    perf_close(&pc);
+    free(search_idx);
+    free(delete_idx);
+}
+
+static double loop_ns_per_op(const OpResult *r) { return r->loop_ops ? (double)r->loop_ns / r->loop_ops : 0; }
+
+void print_core_table(FILE *fp, const CoreResults *res) {
+    fprintf(fp, "%-5s %-7s %10s %9s %9s %9s %9s %9s %9s %12s\n", "Tree", "Op", "samples",
+            "mean ns", "stddev", "median", "p99", "p99.9", "ns/op", "ops/s");
+    fprintf(fp, "-----------------------------------------------------------------------------------------------\n");
+    for (int e = 0; e < ENGINE_COUNT; e++)
+        for (int op = 0; op < OP_COUNT; op++) {
+            const OpResult *r = &res->r[e][op];
+            double ns = loop_ns_per_op(r);
+            fprintf(fp, "%-5s %-7s %10llu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %12.0f\n", engines[e].name,
+                    op_names[op], (unsigned long long)r->lat.n, hist_mean(&r->lat), hist_stddev(&r->lat),
+                    hist_percentile(&r->lat, 50), hist_percentile(&r->lat, 99), hist_percentile(&r->lat, 99.9),
+                    ns, ns > 0 ? 1e9 / ns : 0.0);
+        }
+}
+
+/* Μετρητές υλικού ανά λειτουργία (ενιαίοι βρόχοι της bench_core) */
+void print_perf_table(FILE *fp, const CoreResults *res) {
+    fprintf(fp, "%-5s %-7s", "Tree", "Op");
+    for (int k = 0; k < PMU_COUNT; k++) fprintf(fp, " %9s", pmu_names[k]);
+    fprintf(fp, " %9s\n", "IPC");
+    fprintf(fp, "-----------------------------------------------------------------------------------------\n");
+    for (int e = 0; e < ENGINE_COUNT; e++)
+        for (int op = 0; op < OP_COUNT; op++) {
+            const PerfTotals *t = &res->pmu[e][op];
+            fprintf(fp, "%-5s %-7s", engines[e].name, op_names[op]);
+            for (int k = 0; k < PMU_COUNT; k++) perf_print_cell(fp, perf_per_op(t, k));
+            double cyc = perf_per_op(t, PMU_CYCLES), ins = perf_per_op(t, PMU_INSTR);
+            perf_print_cell(fp, cyc > 0 && ins >= 0 ? ins / cyc : -1.0);
+            fprintf(fp, "\n");
+        }
+}
+
+void write_core_csv(const char *path, const CoreResults *res) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) { printf("Σφάλμα: δεν δημιουργείται το %s\n", path); return; }
+    fprintf(fp, "tree,op,samples,mean_ns,stddev_ns,median_ns,p99_ns,p999_ns,min_ns,max_ns,ns_per_op,ops_per_sec");
+    for (int k = 0; k < PMU_COUNT; k++) fprintf(fp, ",%s_per_op", pmu_keys[k]);
+    fprintf(fp, "\n");
+    for (int e = 0; e < ENGINE_COUNT; e++)
+        for (int op = 0; op < OP_COUNT; op++) {
+            const OpResult *r = &res->r[e][op];
+            double ns = loop_ns_per_op(r);
+            fprintf(fp, "%s,%s,%llu,%.2f,%.2f,%.1f,%.1f,%.1f,%llu,%llu,%.2f,%.0f", engines[e].name, op_names[op],
+                    (unsigned long long)r->lat.n, hist_mean(&r->lat), hist_stddev(&r->lat),
+                    hist_percentile(&r->lat, 50), hist_percentile(&r->lat, 99), hist_percentile(&r->lat, 99.9),
+                    (unsigned long long)(r->lat.n ? r->lat.min : 0), (unsigned long long)r->lat.max,
+                    ns, ns > 0 ? 1e9 / ns : 0.0);
+            /* Κενό πεδίο για μετρητή που δεν μετρήθηκε */
+            for (int k = 0; k < PMU_COUNT; k++) {
+                double v = perf_per_op(&res->pmu[e][op], k);
+                if (v < 0) fprintf(fp, ",");
+                else fprintf(fp, ",%.3f", v);
+            }
+            fprintf(fp, "\n");
+        }
+    fclose(fp);
+}
+
+void write_core_json(const char *path, const BenchConfig *cfg, int count, const CoreResults *res) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) { printf("Σφάλμα: δεν δημιουργείται το %s\n", path); return; }
+    fprintf(fp, "{\n  \"config\": {\"records\": %d, \"searches\": %d, \"deletes\": %d, \"runs\": %d, "
+            "\"warmup\": %d, \"seed\": %u, \"bpt_order\": %d, \"clock_overhead_ns\": %.1f},\n  \"results\": [\n",
+            count, res->searches, res->deletes, cfg->runs, cfg->warmup, cfg->seed, BPT_ORDER, res->clock_ns);
+    for (int e = 0; e < ENGINE_COUNT; e++)
+        for (int op = 0; op < OP_COUNT; op++) {
+            const OpResult *r = &res->r[e][op];
+            double ns = loop_ns_per_op(r);
+            fprintf(fp, "    {\"tree\": \"%s\", \"op\": \"%s\", \"samples\": %llu, \"mean_ns\": %.2f, "
+                    "\"stddev_ns\": %.2f, \"median_ns\": %.1f, \"p99_ns\": %.1f, \"p999_ns\": %.1f, "
+                    "\"min_ns\": %llu, \"max_ns\": %llu, \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f",
+                    engines[e].name, op_names[op], (unsigned long long)r->lat.n, hist_mean(&r->lat),
+                    hist_stddev(&r->lat), hist_percentile(&r->lat, 50), hist_percentile(&r->lat, 99),
+                    hist_percentile(&r->lat, 99.9), (unsigned long long)(r->lat.n ? r->lat.min : 0),
+                    (unsigned long long)r->lat.max, ns, ns > 0 ? 1e9 / ns : 0.0);
+            /* null για μετρητή που δεν μετρήθηκε */
+            for (int k = 0; k < PMU_COUNT; k++) {
+                double v = perf_per_op(&res->pmu[e][op], k);
+                if (v < 0) fprintf(fp, ", \"%s_per_op\": null", pmu_keys[k]);
+                else fprintf(fp, ", \"%s_per_op\": %.3f", pmu_keys[k], v);
+            }
+            fprintf(fp, "}%s\n", e == ENGINE_COUNT - 1 && op == OP_COUNT - 1 ? "" : ",");
+        }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+}
+
+/* ============ Κύριο Πρόγραμμα Benchmark ============ */
+
+int main(int argc, char *argv[]) {
+    BenchConfig cfg;
+    if (!parse_args(argc, argv, &cfg)) { usage(argv[0]); return 1; }
+
+    /* Φόρτωση από citizens.txt ή, με -b, από δυαδικό αρχείο */
+    LoadTimes load;
+    int count = 0;
+    Citizen *citizens = cfg.bin_path ? load_binary_timed(cfg.bin_path, cfg.records, &count, &load)
+                                     : load_text_timed(cfg.records, &count, &load);
+    if (!citizens) return 1;
+
+    printf("Φορτώθηκαν %d εγγραφές πολιτών (%.1f MB)\n", count, load.bytes / 1e6);
+    print_load_table(stdout, &load);
+    printf("\n");
+
+    srand(cfg.seed);
+
+    /* Μνήμη ανά δέντρο - πρώτο, πριν ο heap γεμίσει από τα υπόλοιπα benchmarks */
+    MemReport mem_report;
+    if (!cfg.core_only) bench_memory(citizens, count, &mem_report);
+
+    /* Βασικό benchmark: καθυστέρηση ανά λειτουργία και ρυθμαπόδοση */
+    static CoreResults core;
+    bench_core(&cfg, citizens, count, &core);
+
+    /* Εκτύπωση αποτελεσμάτων */
+    printf("\n=====================================================\n");
+    printf("             ΑΠΟΤΕΛΕΣΜΑΤΑ BENCHMARK\n");
+    printf("   (%d επαναλήψεις + %d ζέσταμα, B+ fanout %d, ρολόι ~%.0f ns/ανάγνωση)\n",
+           cfg.runs, cfg.warmup, BPT_ORDER, core.clock_ns);
+    printf("   Insert: %d | Search: %d | Delete: %d ανά επανάληψη\n", count, core.searches, core.deletes);
+    printf("=====================================================\n");
+    print_core_table(stdout, &core);
+    if (core.perf_requested && core.perf_available) {
+        printf("\nΜετρητές υλικού ανά λειτουργία (%d/%d διαθέσιμοι)\n", core.perf_available, PMU_COUNT);
+        print_perf_table(stdout, &core);
+    } else if (core.perf_requested) {
+        printf("\nΜετρητές υλικού μη διαθέσιμοι (%s) - συνέχεια χωρίς αυτούς\n",
+               PERF_COUNTERS ? strerror(core.perf_error) : "-DPERF_COUNTERS=0");
+    }
+    write_core_csv(cfg.csv_path, &core);
+    write_core_json(cfg.json_path, &cfg, count, &core);
+
+    /* Συγκρίσεις ανά λειτουργία και κόστος συγκριτή */
+    CmpCost cmp_cost;
+    bench_comparator(citizens, count, &cmp_cost);
+#if KEY_STATS
+    printf("\n");
+    print_cmp_tables(stdout, core.cmp_calls, core.cmp_full, core.cmp_ops, &cmp_cost);
+#endif
+
+    AllocTimes heap_times, arena_times;
+    HotColdTimes hc_times;
+    FrozenTimes frozen_times;
+    BulkTimes bulk_times;
+    SnapTimes snap_times;
+    WalTimes wal_times;
+    ScaleTimes scale_times;
+    MixedTimes mixed_times;
+    ShardTimes shard_times;
+    ParBuildTimes par_times;
+    BatchTimes batch_times;
+    ScanTimes scan_times;
+    OrderStatTimes os_times;
+    MidxTimes midx_times;
+    AggTimes agg_times;
+    IterTimes iter_times;
+    CompactTimes compact_times;
+    if (!cfg.core_only && count > cfg.degenerate_max) {
+        if (cfg.degenerate_max)
+            printf("\nΤαξινομημένη είσοδος σε απλό BST: μόνο οι πρώτες %d από %d εγγραφές (-m)\n", cfg.degenerate_max, count);
+        else
+            printf("\nΤαξινομημένη είσοδος σε απλό BST: παραλείπεται (-m 0)\n");
+    }
+    if (!cfg.core_only) {
+        /* Σύγκριση δέσμευσης κόμβων: malloc ανά κόμβο έναντι arena ανά δέντρο */
+        bench_allocator(citizens, count, 0, cfg.runs, &heap_times);
+        bench_allocator(citizens, count, 1, cfg.runs, &arena_times);
+        printf("\nInsert / teardown ολόκληρου δέντρου (us)\n");
+        print_alloc_table(stdout, &heap_times, &arena_times);
+
+        /* Σύγκριση κόμβων με ενσωματωμένη εγγραφή έναντι hot/cold διάταξης */
+        bench_hot_cold(citizens, count, &hc_times);
+        printf("\nHot/cold: αναζήτηση όλων των ονομάτων x%d\n", HC_SEARCH_PASSES);
+        print_hot_cold_table(stdout, &hc_times);
+
+        /* Σύγκριση αναζήτησης στα δέντρα έναντι του παγωμένου ευρετηρίου */
+        bench_frozen(citizens, count, &frozen_times);
+        printf("\nΠαγωμένο ευρετήριο Eytzinger: %d τυχαίες αναζητήσεις\n", FROZEN_LOOKUPS);
+        print_frozen_table(stdout, &frozen_times);
+
+        /* Ομαδικές αναζητήσεις με prefetch ανά μέγεθος παρτίδας */
+        bench_batch(citizens, count, &batch_times);
+        printf("\nΟμαδικές αναζητήσεις (AMAC, %d σε εξέλιξη): ns ανά αναζήτηση, %d αναζητήσεις\n", BATCH_GROUP, BATCH_LOOKUPS);
+        print_batch_table(stdout, &batch_times);
+
+        /* Διατεταγμένες σαρώσεις με iterators: πλήρης, εύρους και προθέματος */
+        bench_scan(citizens, count, &scan_times);
+        printf("\nΔιατεταγμένες σαρώσεις: εκατ. εγγραφές/s (%d ερωτήματα, εύρος %d ονομάτων, πρόθεμα %d χαρακτήρων)\n",
+               SCAN_QUERIES, SCAN_WINDOW, SCAN_PREFIX);
+        print_scan_table(stdout, &scan_times);
+
+        /* Μεγέθη υποδέντρων: κόστος εγγραφής και rank/select/εύρος σε O(log n) */
+        bench_order_stats(citizens, count, cfg.runs, &os_times);
+        printf("\nΣτατιστικά διάταξης: κόστος εγγραφής (us) και ερωτήματα (ns, %d / %d με διάσχιση)\n",
+               OS_QUERIES, OS_SCAN_QUERIES);
+        print_order_stats_table(stdout, &os_times);
+
+        /* Αποθήκη με ευρετήρια σε εισόδημα, ηλικία και πολιτεία */
+        bench_multi_index(citizens, count, cfg.runs, &midx_times);
+        printf("\nΠολλαπλά ευρετήρια: κόστος συντήρησης (us) και επιλεκτικά ερωτήματα (%d / %d με σάρωση)\n",
+               MIDX_QUERIES, MIDX_SCAN_QUERIES);
+        print_multi_index_table(stdout, &midx_times);
+
+        /* Συναθροίσεις εισοδήματος από τα αθροίσματα των κόμβων */
+        bench_aggregate(citizens, count, &agg_times);
+        printf("\nΣυναθροίσεις εύρους: us ανά συνάθροιση (%d / %d με σάρωση) και αλλαγή εισοδήματος (ns, %d)\n",
+               AGG_QUERIES, AGG_SCAN_QUERIES, AGG_UPDATES);
+        print_aggregate_table(stdout, &agg_times);
+
+        /* Σύγκριση διαδοχικών insert έναντι μαζικής κατασκευής */
+        bench_bulk(citizens, count, cfg.runs, cfg.degenerate_max, &bulk_times);
+        printf("\nΚατασκευή ολόκληρου δέντρου: insert έναντι bulk build (us)\n");
+        print_bulk_table(stdout, &bulk_times);
+
+        /* Παράλληλη ταξινόμηση + fork-join κατασκευή με 1..N νήματα */
+        bench_parallel_build(citizens, count, cfg.runs, cfg.threads, &par_times);
+        printf("\nΠαράλληλη κατασκευή (work stealing) ανά πλήθος νημάτων (us)\n");
+        print_parallel_build_table(stdout, &par_times);
+
+        /* Σύγκριση ξαναχτισίματος έναντι φόρτωσης στιγμιοτύπου */
+        bench_snapshot(citizens, count, cfg.runs, &snap_times);
+        printf("\nΣτιγμιότυπα: ξαναχτίσιμο έναντι mmap (θερμή page cache, αναζητήσεις x%d)\n", SNAP_LOOKUPS);
+        print_snapshot_table(stdout, &snap_times);
+
+        /* Κόστος ανθεκτικότητας: log με group commit ανά επίπεδο */
+        bench_wal(citizens, count, &wal_times);
+        printf("\nWrite-ahead log: insert + delete μισών σε RBT ανά επίπεδο ανθεκτικότητας\n");
+        print_wal_table(stdout, &wal_times);
+
+        /* Αναγνώσεις από 1..N νήματα με έναν writer σε εξέλιξη */
+        bench_read_scaling(citizens, count, cfg.threads, &scale_times);
+        printf("\nΚλιμάκωση αναγνώσεων με έναν writer (%d ms ανά γραμμή)\n", SCALE_BENCH_MS);
+        print_scaling_table(stdout, &scale_times);
+
+        /* Αναζητήσεις, inserts και deletes από 1..N νήματα */
+        bench_mixed_scaling(citizens, count, cfg.threads, &mixed_times);
+        printf("\nΚλιμάκωση μικτού φόρτου (%d%% αναζητήσεις, %d ms ανά γραμμή)\n", MIXED_SEARCH_PCT, SCALE_BENCH_MS);
+        print_mixed_table(stdout, &mixed_times);
+
+        /* Ενημερώσεις ανά πλήθος νημάτων και shards */
+        bench_shard_scaling(citizens, count, cfg.threads, &shard_times);
+        printf("\nΑποθήκη σε shards: ενημερώσεις/s ανά νήματα και shards (%d ms ανά κελί)\n", SCALE_BENCH_MS);
+        print_shard_table(stdout, &shard_times);
+
+        /* Σύγκριση αναδρομικών (Citizen by value) και επαναληπτικών BST/AVL */
+        bench_iterative(citizens, count, cfg.runs, cfg.degenerate_max, &iter_times);
+        printf("\nBST/AVL: αναδρομικές έναντι επαναληπτικών λειτουργιών (us)\n");
+        print_iterative_table(stdout, &iter_times);
+
+        /* Σύγκριση διάταξης με pointers και συμπαγών κόμβων (32-bit θέσεις) */
+        bench_compact(citizens, count, &compact_times);
+        printf("\nΣυμπαγείς κόμβοι: μέγεθος και αναζήτηση όλων των ονομάτων x%d\n", COMPACT_SEARCH_PASSES);
+        print_compact_table(stdout, &compact_times);
+
+        printf("\nΜνήμη ανά δέντρο (Citizen = %zu B, διαγραφή μισών εγγραφών μετά το peak)\n", sizeof(Citizen));
+        print_memory_table(stdout, &mem_report);
+    }
+
+    /* Εγγραφή αποτελεσμάτων σε results.txt */
+    FILE *fp = fopen("results.txt", "w");
+    if (fp) {
+        fprintf(fp, "Benchmark Results (%d runs + %d warmup, B+ fanout %d, clock ~%.0f ns/read)\n",
+                cfg.runs, cfg.warmup, BPT_ORDER, core.clock_ns);
+        fprintf(fp, "Insert: %d records | Search: %d names | Delete: %d names (per run)\n\n",
+                count, core.searches, core.deletes);
+        print_core_table(fp, &core);
+        fprintf(fp, "\nLoading %s (%zu bytes)\n", cfg.bin_path ? cfg.bin_path : "citizens.txt", load.bytes);
+        print_load_table(fp, &load);
+        if (core.perf_requested && core.perf_available) {
+            fprintf(fp, "\nHardware counters per operation (%d/%d available)\n", core.perf_available, PMU_COUNT);
+            print_perf_table(fp, &core);
+        } else if (core.perf_requested) {
+            fprintf(fp, "\nHardware counters unavailable (%s)\n",
+                    PERF_COUNTERS ? strerror(core.perf_error) : "-DPERF_COUNTERS=0");
+        }
+#if KEY_STATS
+        fprintf(fp, "\n");
+        print_cmp_tables(fp, core.cmp_calls, core.cmp_full, core.cmp_ops, &cmp_cost);
+#endif
+        if (!cfg.core_only && count > cfg.degenerate_max) {
+            if (cfg.degenerate_max)
+                fprintf(fp, "\nSorted input into a plain BST: first %d of %d records only (-m)\n", cfg.degenerate_max, count);
+            else
+                fprintf(fp, "\nSorted input into a plain BST: skipped (-m 0)\n");
+        }
+        if (!cfg.core_only) {
+            fprintf(fp, "\nInsert / teardown of the whole tree (us)\n");
+            print_alloc_table(fp, &heap_times, &arena_times);
+            fprintf(fp, "\nHot/cold layout: search all names x%d\n", HC_SEARCH_PASSES);
+            print_hot_cold_table(fp, &hc_times);
+            fprintf(fp, "\nFrozen Eytzinger index: %d random lookups\n", FROZEN_LOOKUPS);
+            print_frozen_table(fp, &frozen_times);
+            fprintf(fp, "\nBatched lookups (AMAC, %d in flight): ns per lookup, %d lookups\n", BATCH_GROUP, BATCH_LOOKUPS);
+            print_batch_table(fp, &batch_times);
+            fprintf(fp, "\nOrdered scans: million records/s (%d queries, %d-name ranges, %d-char prefixes)\n",
+                    SCAN_QUERIES, SCAN_WINDOW, SCAN_PREFIX);
+            print_scan_table(fp, &scan_times);
+            fprintf(fp, "\nOrder statistics: write-path cost (us) and queries (ns, %d / %d by traversal)\n",
+                    OS_QUERIES, OS_SCAN_QUERIES);
+            print_order_stats_table(fp, &os_times);
+            fprintf(fp, "\nMulti-index store: maintenance cost (us) and selective queries (%d / %d by scan)\n",
+                    MIDX_QUERIES, MIDX_SCAN_QUERIES);
+            print_multi_index_table(fp, &midx_times);
+            fprintf(fp, "\nRange aggregates: us per aggregate (%d / %d by scan) and income changes (ns, %d)\n",
+                    AGG_QUERIES, AGG_SCAN_QUERIES, AGG_UPDATES);
+            print_aggregate_table(fp, &agg_times);
+            fprintf(fp, "\nWhole-tree build: repeated insert vs bulk build (us)\n");
+            print_bulk_table(fp, &bulk_times);
+            fprintf(fp, "\nParallel build (work stealing) per thread count (us)\n");
+            print_parallel_build_table(fp, &par_times);
+            fprintf(fp, "\nSnapshots: rebuild vs mmap (warm page cache, %d lookups)\n", SNAP_LOOKUPS);
+            print_snapshot_table(fp, &snap_times);
+            fprintf(fp, "\nWrite-ahead log: insert + delete half on RBT per durability level\n");
+            print_wal_table(fp, &wal_times);
+            fprintf(fp, "\nRead scaling with one writer (%d ms per row)\n", SCALE_BENCH_MS);
+            print_scaling_table(fp, &scale_times);
+            fprintf(fp, "\nMixed workload scaling (%d%% searches, %d ms per row)\n", MIXED_SEARCH_PCT, SCALE_BENCH_MS);
+            print_mixed_table(fp, &mixed_times);
+            fprintf(fp, "\nSharded store: writes/s per threads and shards (%d ms per cell)\n", SCALE_BENCH_MS);
+            print_shard_table(fp, &shard_times);
+            fprintf(fp, "\nBST/AVL: recursive vs iterative operations (us)\n");
+            print_iterative_table(fp, &iter_times);
+            fprintf(fp, "\nCompact nodes: size and search all names x%d\n", COMPACT_SEARCH_PASSES);
+            print_compact_table(fp, &compact_times);
+            fprintf(fp, "\nMemory per tree (Citizen = %zu B, half of the records deleted after the peak)\n", sizeof(Citizen));
+            print_memory_table(fp, &mem_report);
+        }
         fclose(fp);
-        printf("\nΤα αποτελέσματα αποθηκεύτηκαν στο results.txt\n");
+        printf("\nΤα αποτελέσματα αποθηκεύτηκαν στα results.txt, %s και %s\n", cfg.csv_path, cfg.json_path);
     }
 
+    free(citizens);
     return 0;
 }
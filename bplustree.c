@@ -0,0 +1,519 @@
+/*
+ * bplustree.c
+ * Υλοποίηση B+ Δέντρου με κλειδί το full_name
+ * Κάθε κόμβος κρατά έως BPT_ORDER - 1 κλειδιά, όλες οι εγγραφές βρίσκονται
+ * στα φύλλα και τα φύλλα συνδέονται μεταξύ τους για διάσχιση σε σειρά
+ *
+ * Ιδιότητες B+:
+ * 1. Όλα τα φύλλα βρίσκονται στο ίδιο βάθος
+ * 2. Κάθε κόμβος εκτός της ρίζας έχει τουλάχιστον BPT_MIN_KEYS κλειδιά
+ * 3. Εσωτερικός κόμβος με n κλειδιά έχει n + 1 παιδιά
+ * 4. Τα κλειδιά του παιδιού i βρίσκονται στο [sep[i-1], sep[i])
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* Δομή πολίτη */
+typedef struct {
+    char full_name[100];
+    int age;
+    char state[50];
+    int annual_income;
+} Citizen;
+
+/* Μέγιστος αριθμός παιδιών εσωτερικού κόμβου (fanout) - ρυθμίζεται με
+ * -DBPT_ORDER=N κατά τη μεταγλώττιση */
+#ifndef BPT_ORDER
+#define BPT_ORDER 16
+#endif
+#if BPT_ORDER < 4
+#error "BPT_ORDER πρέπει να είναι τουλάχιστον 4"
+#endif
+#define BPT_MAX_KEYS (BPT_ORDER - 1)
+#define BPT_MIN_KEYS ((BPT_ORDER - 1) / 2)
+#define BPT_MAX_DEPTH 64
+
+/* Δομή κόμβου δέντρου - τα 8-byte προθέματα των κλειδιών βρίσκονται
+ * συνεχόμενα στην αρχή του κόμβου (ευθυγραμμισμένου σε cache line) ώστε η
+ * αναζήτηση μέσα στον κόμβο να διαβάζει λίγες γραμμές */
+typedef struct Node {
+    uint64_t keys[BPT_ORDER];   /* +1 θέση για προσωρινή υπερχείλιση */
+    int is_leaf;
+    int n;                      /* Πλήθος κλειδιών */
+    union {
+        struct {
+            struct Node *child[BPT_ORDER + 1];
+            char *sep[BPT_ORDER];   /* Αντίγραφα διαχωριστικών κλειδιών */
+        } in;
+        struct {
+            Citizen *rec[BPT_ORDER];
+            struct Node *next;      /* Επόμενο φύλλο σε αλφαβητική σειρά */
+        } leaf;
+    } u;
+} Node;
+
+/* ---------- Κλειδιά σύγκρισης ---------- */
+
+/* Τα πρώτα 8 bytes του full_name ως big-endian ακέραιος. Η σύγκριση
+ * ακεραίων δίνει την ίδια διάταξη με την strcmp, οπότε η strcmp καλείται
+ * (από το 9ο byte) μόνο όταν τα προθέματα ταυτίζονται. */
+static inline uint64_t key_prefix(const char *name) {
+    uint64_t k = 0;
+    int i = 0;
+    for (; i < 8 && name[i]; i++)
+        k = (k << 8) | (unsigned char)name[i];
+    return i ? k << (8 * (8 - i)) : 0;
+}
+
+static inline int key_cmp(uint64_t ka, const char *a, uint64_t kb, const char *b) {
+    if (ka != kb)
+        return ka < kb ? -1 : 1;
+    if ((ka & 0xFF) == 0)
+        return 0; /* όνομα μικρότερο των 8 bytes: ίσα */
+    return strcmp(a + 8, b + 8);
+}
+
+/* Δημιουργία νέου κόμβου (φύλλου ή εσωτερικού) */
+Node* create_node(int is_leaf) {
+    void *mem;
+    if (posix_memalign(&mem, 64, sizeof(Node))) {
+        printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
+        return NULL;
+    }
+    Node *node = (Node*)mem;
+    node->is_leaf = is_leaf;
+    node->n = 0;
+    if (is_leaf)
+        node->u.leaf.next = NULL;
+    return node;
+}
+
+/* Παιδί προς το οποίο κατεβαίνουμε: πλήθος διαχωριστικών <= όνομα */
+static int child_index(Node *x, uint64_t key, const char *name) {
+    int i = 0;
+    while (i < x->n && key_cmp(key, name, x->keys[i], x->u.in.sep[i]) >= 0)
+        i++;
+    return i;
+}
+
+/* Θέση στο φύλλο: πρώτο κλειδί >= όνομα */
+static int leaf_pos(Node *x, uint64_t key, const char *name, int *found) {
+    for (int i = 0; i < x->n; i++) {
+        int cmp = key_cmp(key, name, x->keys[i], x->u.leaf.rec[i]->full_name);
+        if (cmp <= 0) {
+            *found = (cmp == 0);
+            return i;
+        }
+    }
+    *found = 0;
+    return x->n;
+}
+
+/* Εισαγωγή κόμβου στο B+ δέντρο */
+Node* insert_bpt(Node *root, const Citizen *data) {
+    uint64_t key = key_prefix(data->full_name);
+    Node *path[BPT_MAX_DEPTH];
+    int pidx[BPT_MAX_DEPTH], depth = 0;
+
+    if (root == NULL)
+        root = create_node(1);
+
+    /* Κατάβαση ως το φύλλο, κρατώντας το μονοπάτι */
+    Node *x = root;
+    while (!x->is_leaf) {
+        int i = child_index(x, key, data->full_name);
+        path[depth] = x;
+        pidx[depth++] = i;
+        x = x->u.in.child[i];
+    }
+    int found, pos = leaf_pos(x, key, data->full_name, &found);
+    if (found)
+        return root; /* Διπλότυπο - δεν εισάγεται */
+
+    Citizen *rec = (Citizen*)malloc(sizeof(Citizen));
+    *rec = *data;
+    memmove(&x->keys[pos + 1], &x->keys[pos], (x->n - pos) * sizeof(uint64_t));
+    memmove(&x->u.leaf.rec[pos + 1], &x->u.leaf.rec[pos], (x->n - pos) * sizeof(Citizen*));
+    x->keys[pos] = key;
+    x->u.leaf.rec[pos] = rec;
+    x->n++;
+    if (x->n <= BPT_MAX_KEYS)
+        return root;
+
+    /* Διάσπαση φύλλου - το πρώτο κλειδί του δεξιού ανεβαίνει ως αντίγραφο */
+    Node *right = create_node(1);
+    int half = x->n / 2;
+    right->n = x->n - half;
+    memcpy(right->keys, &x->keys[half], right->n * sizeof(uint64_t));
+    memcpy(right->u.leaf.rec, &x->u.leaf.rec[half], right->n * sizeof(Citizen*));
+    x->n = half;
+    right->u.leaf.next = x->u.leaf.next;
+    x->u.leaf.next = right;
+
+    uint64_t up_key = right->keys[0];
+    char *up_sep = strdup(right->u.leaf.rec[0]->full_name);
+    Node *up_child = right;
+
+    /* Εισαγωγή διαχωριστικού στους προγόνους, με διάσπαση όπου γεμίζουν */
+    while (depth > 0) {
+        Node *p = path[--depth];
+        int i = pidx[depth];
+        memmove(&p->keys[i + 1], &p->keys[i], (p->n - i) * sizeof(uint64_t));
+        memmove(&p->u.in.sep[i + 1], &p->u.in.sep[i], (p->n - i) * sizeof(char*));
+        memmove(&p->u.in.child[i + 2], &p->u.in.child[i + 1], (p->n - i) * sizeof(Node*));
+        p->keys[i] = up_key;
+        p->u.in.sep[i] = up_sep;
+        p->u.in.child[i + 1] = up_child;
+        p->n++;
+        if (p->n <= BPT_MAX_KEYS)
+            return root;
+
+        /* Διάσπαση εσωτερικού κόμβου - το μεσαίο κλειδί ανεβαίνει */
+        Node *r = create_node(0);
+        int mid = p->n / 2;
+        r->n = p->n - mid - 1;
+        memcpy(r->keys, &p->keys[mid + 1], r->n * sizeof(uint64_t));
+        memcpy(r->u.in.sep, &p->u.in.sep[mid + 1], r->n * sizeof(char*));
+        memcpy(r->u.in.child, &p->u.in.child[mid + 1], (r->n + 1) * sizeof(Node*));
+        up_key = p->keys[mid];
+        up_sep = p->u.in.sep[mid];
+        p->n = mid;
+        up_child = r;
+    }
+
+    /* Διάσπαση ρίζας - το δέντρο ψηλώνει κατά ένα επίπεδο */
+    Node *new_root = create_node(0);
+    new_root->n = 1;
+    new_root->keys[0] = up_key;
+    new_root->u.in.sep[0] = up_sep;
+    new_root->u.in.child[0] = root;
+    new_root->u.in.child[1] = up_child;
+    return new_root;
+}
+
+/* Αφαίρεση του διαχωριστικού k και του παιδιού k + 1 από εσωτερικό κόμβο */
+static void remove_entry(Node *p, int k) {
+    int tail = p->n - k - 1;
+    memmove(&p->keys[k], &p->keys[k + 1], tail * sizeof(uint64_t));
+    memmove(&p->u.in.sep[k], &p->u.in.sep[k + 1], tail * sizeof(char*));
+    memmove(&p->u.in.child[k + 1], &p->u.in.child[k + 2], tail * sizeof(Node*));
+    p->n--;
+}
+
+/* Συγχώνευση φύλλου b στο αριστερό του a */
+static void merge_leaves(Node *a, Node *b) {
+    memcpy(&a->keys[a->n], b->keys, b->n * sizeof(uint64_t));
+    memcpy(&a->u.leaf.rec[a->n], b->u.leaf.rec, b->n * sizeof(Citizen*));
+    a->n += b->n;
+    a->u.leaf.next = b->u.leaf.next;
+    free(b);
+}
+
+/* Συγχώνευση εσωτερικού b στο a - το διαχωριστικό k του γονέα κατεβαίνει */
+static void merge_internal(Node *a, Node *p, int k, Node *b) {
+    a->keys[a->n] = p->keys[k];
+    a->u.in.sep[a->n] = p->u.in.sep[k];
+    memcpy(&a->keys[a->n + 1], b->keys, b->n * sizeof(uint64_t));
+    memcpy(&a->u.in.sep[a->n + 1], b->u.in.sep, b->n * sizeof(char*));
+    memcpy(&a->u.in.child[a->n + 1], b->u.in.child, (b->n + 1) * sizeof(Node*));
+    a->n += b->n + 1;
+    free(b);
+}
+
+/* Διαγραφή κόμβου από το B+ δέντρο */
+Node* delete_bpt(Node *root, const char *name) {
+    if (root == NULL)
+        return NULL;
+
+    uint64_t key = key_prefix(name);
+    Node *path[BPT_MAX_DEPTH];
+    int pidx[BPT_MAX_DEPTH], depth = 0;
+
+    Node *x = root;
+    while (!x->is_leaf) {
+        int i = child_index(x, key, name);
+        path[depth] = x;
+        pidx[depth++] = i;
+        x = x->u.in.child[i];
+    }
+    int found, pos = leaf_pos(x, key, name, &found);
+    if (!found)
+        return root; /* Δεν βρέθηκε */
+
+    free(x->u.leaf.rec[pos]);
+    memmove(&x->keys[pos], &x->keys[pos + 1], (x->n - pos - 1) * sizeof(uint64_t));
+    memmove(&x->u.leaf.rec[pos], &x->u.leaf.rec[pos + 1], (x->n - pos - 1) * sizeof(Citizen*));
+    x->n--;
+
+    /* Επανισορρόπηση από κάτω προς τα πάνω: δανεισμός ή συγχώνευση */
+    while (depth > 0 && x->n < BPT_MIN_KEYS) {
+        Node *p = path[--depth];
+        int i = pidx[depth];
+        Node *l = i > 0 ? p->u.in.child[i - 1] : NULL;
+        Node *r = i < p->n ? p->u.in.child[i + 1] : NULL;
+
+        if (x->is_leaf) {
+            if (l && l->n > BPT_MIN_KEYS) {
+                /* Περίπτωση 1: δανεισμός του τελευταίου κλειδιού του αριστερού */
+                memmove(&x->keys[1], x->keys, x->n * sizeof(uint64_t));
+                memmove(&x->u.leaf.rec[1], x->u.leaf.rec, x->n * sizeof(Citizen*));
+                x->keys[0] = l->keys[l->n - 1];
+                x->u.leaf.rec[0] = l->u.leaf.rec[l->n - 1];
+                x->n++;
+                l->n--;
+                free(p->u.in.sep[i - 1]);
+                p->keys[i - 1] = x->keys[0];
+                p->u.in.sep[i - 1] = strdup(x->u.leaf.rec[0]->full_name);
+                return root;
+            }
+            if (r && r->n > BPT_MIN_KEYS) {
+                /* Περίπτωση 2: δανεισμός του πρώτου κλειδιού του δεξιού */
+                x->keys[x->n] = r->keys[0];
+                x->u.leaf.rec[x->n] = r->u.leaf.rec[0];
+                x->n++;
+                r->n--;
+                memmove(r->keys, &r->keys[1], r->n * sizeof(uint64_t));
+                memmove(r->u.leaf.rec, &r->u.leaf.rec[1], r->n * sizeof(Citizen*));
+                free(p->u.in.sep[i]);
+                p->keys[i] = r->keys[0];
+                p->u.in.sep[i] = strdup(r->u.leaf.rec[0]->full_name);
+                return root;
+            }
+            /* Περίπτωση 3: συγχώνευση με αδελφό - το διαχωριστικό χάνεται */
+            if (l) {
+                free(p->u.in.sep[i - 1]);
+                merge_leaves(l, x);
+                remove_entry(p, i - 1);
+            } else {
+                free(p->u.in.sep[i]);
+                merge_leaves(x, r);
+                remove_entry(p, i);
+            }
+        } else {
+            if (l && l->n > BPT_MIN_KEYS) {
+                /* Το διαχωριστικό του γονέα κατεβαίνει, το τελευταίο του l ανεβαίνει */
+                memmove(&x->keys[1], x->keys, x->n * sizeof(uint64_t));
+                memmove(&x->u.in.sep[1], x->u.in.sep, x->n * sizeof(char*));
+                memmove(&x->u.in.child[1], x->u.in.child, (x->n + 1) * sizeof(Node*));
+                x->keys[0] = p->keys[i - 1];
+                x->u.in.sep[0] = p->u.in.sep[i - 1];
+                x->u.in.child[0] = l->u.in.child[l->n];
+                p->keys[i - 1] = l->keys[l->n - 1];
+                p->u.in.sep[i - 1] = l->u.in.sep[l->n - 1];
+                x->n++;
+                l->n--;
+                return root;
+            }
+            if (r && r->n > BPT_MIN_KEYS) {
+                /* Το διαχωριστικό του γονέα κατεβαίνει, το πρώτο του r ανεβαίνει */
+                x->keys[x->n] = p->keys[i];
+                x->u.in.sep[x->n] = p->u.in.sep[i];
+                x->u.in.child[x->n + 1] = r->u.in.child[0];
+                p->keys[i] = r->keys[0];
+                p->u.in.sep[i] = r->u.in.sep[0];
+                x->n++;
+                r->n--;
+                memmove(r->keys, &r->keys[1], r->n * sizeof(uint64_t));
+                memmove(r->u.in.sep, &r->u.in.sep[1], r->n * sizeof(char*));
+                memmove(r->u.in.child, &r->u.in.child[1], (r->n + 1) * sizeof(Node*));
+                return root;
+            }
+            if (l) {
+                merge_internal(l, p, i - 1, x);
+                remove_entry(p, i - 1);
+            } else {
+                merge_internal(x, p, i, r);
+                remove_entry(p, i);
+            }
+        }
+        x = p;
+    }
+
+    /* Άδεια ρίζα: το δέντρο χαμηλώνει ή αδειάζει */
+    if (root->n == 0) {
+        Node *child = root->is_leaf ? NULL : root->u.in.child[0];
+        free(root);
+        return child;
+    }
+    return root;
+}
+
+/* Αναζήτηση εγγραφής με βάση το όνομα */
+Citizen* search(Node *root, const char *name) {
+    if (root == NULL)
+        return NULL;
+
+    uint64_t key = key_prefix(name);
+    Node *x = root;
+    while (!x->is_leaf)
+        x = x->u.in.child[child_index(x, key, name)];
+    int found, pos = leaf_pos(x, key, name, &found);
+    return found ? x->u.leaf.rec[pos] : NULL;
+}
+
+#define BATCH_GROUP 16     /* αναζητήσεις σε εξέλιξη ταυτόχρονα */
+
+typedef struct {
+    Node *node;
+    uint64_t key;
+    int idx;
+} BatchState;
+
+/* Η επόμενη αναζήτηση στη θέση st - 0 αν δεν υπάρχουν άλλες */
+static int batch_next(BatchState *st, Node *root, const char *const *names, int n, int *next) {
+    if (*next >= n)
+        return 0;
+    st->node = root;
+    st->key = key_prefix(names[*next]);
+    st->idx = (*next)++;
+    return 1;
+}
+
+/* Prefetch των cache lines που διαβάζει η κατάβαση: κλειδιά, πλήθος, παιδιά */
+static void prefetch_node(const Node *x) {
+    const char *p = (const char*)x;
+    for (size_t off = 0; off < offsetof(Node, u) + sizeof(x->u.in.child); off += 64)
+        __builtin_prefetch(p + off);
+}
+
+/* Ομαδική αναζήτηση με AMAC (όπως η bpt_search_batch του benchmark.c):
+ * out[i] η εγγραφή του names[i] ή NULL */
+void search_batch(Node *root, const char *const *names, int n, Citizen **out) {
+    BatchState st[BATCH_GROUP];
+    int next = 0, active = 0;
+    while (active < BATCH_GROUP && batch_next(&st[active], root, names, n, &next))
+        active++;
+
+    while (active > 0) {
+        for (int s = 0; s < active;) {
+            Node *x = st[s].node;
+            const char *name = names[st[s].idx];
+            if (x != NULL && !x->is_leaf) {
+                x = x->u.in.child[child_index(x, st[s].key, name)];
+                prefetch_node(x);
+                st[s++].node = x;
+                continue;
+            }
+            int found = 0, pos = 0;
+            if (x != NULL)
+                pos = leaf_pos(x, st[s].key, name, &found);
+            out[st[s].idx] = found ? x->u.leaf.rec[pos] : NULL;
+            if (!batch_next(&st[s], root, names, n, &next))
+                st[s] = st[--active];
+        }
+    }
+}
+
+/* Αριστερότερο φύλλο - αρχή της διάσχισης */
+static Node* first_leaf(Node *root) {
+    while (root && !root->is_leaf)
+        root = root->u.in.child[0];
+    return root;
+}
+
+/* Διάσχιση φύλλων - εκτύπωση πολιτών σε αλφαβητική σειρά */
+void traversal(Node *root) {
+    for (Node *x = first_leaf(root); x; x = x->u.leaf.next)
+        for (int i = 0; i < x->n; i++)
+            printf("%s,%d,%s,%d\n", x->u.leaf.rec[i]->full_name, x->u.leaf.rec[i]->age,
+                   x->u.leaf.rec[i]->state, x->u.leaf.rec[i]->annual_income);
+}
+
+/* Διάσχιση φύλλων - εγγραφή σε αρχείο */
+void traversal_to_file(Node *root, FILE *fp) {
+    for (Node *x = first_leaf(root); x; x = x->u.leaf.next)
+        for (int i = 0; i < x->n; i++)
+            fprintf(fp, "%s,%d,%s,%d\n", x->u.leaf.rec[i]->full_name, x->u.leaf.rec[i]->age,
+                    x->u.leaf.rec[i]->state, x->u.leaf.rec[i]->annual_income);
+}
+
+/* Απελευθέρωση μνήμης δέντρου (κόμβοι, διαχωριστικά και εγγραφές) */
+void free_tree(Node *root) {
+    if (root == NULL)
+        return;
+    if (root->is_leaf) {
+        for (int i = 0; i < root->n; i++)
+            free(root->u.leaf.rec[i]);
+    } else {
+        for (int i = 0; i < root->n; i++)
+            free(root->u.in.sep[i]);
+        for (int i = 0; i <= root->n; i++)
+            free_tree(root->u.in.child[i]);
+    }
+    free(root);
+}
+
+/* ---------- Διατεταγμένη προσπέλαση ---------- */
+
+/* Iterator φύλλων: τρέχον φύλλο και θέση μέσα σε αυτό. Η τοποθέτηση
+ * κατεβαίνει μία φορά από τη ρίζα και από εκεί η σάρωση ακολουθεί τη
+ * λίστα next των φύλλων. */
+typedef struct {
+    Node *leaf;
+    int pos;
+} TreeIter;
+
+/* Τοποθέτηση στην πρώτη εγγραφή με όνομα >= lo (NULL = στην αρχή) */
+void iter_seek(TreeIter *it, Node *root, const char *lo) {
+    it->pos = 0;
+    if (root == NULL || lo == NULL) {
+        it->leaf = first_leaf(root);
+        return;
+    }
+
+    uint64_t key = key_prefix(lo);
+    Node *x = root;
+    while (!x->is_leaf)
+        x = x->u.in.child[child_index(x, key, lo)];
+    int found;
+    it->leaf = x;
+    it->pos = leaf_pos(x, key, lo, &found);
+}
+
+/* Επόμενη εγγραφή σε αλφαβητική σειρά ή NULL στο τέλος */
+Citizen* iter_next(TreeIter *it) {
+    while (it->leaf && it->pos == it->leaf->n) {
+        it->leaf = it->leaf->u.leaf.next;
+        it->pos = 0;
+    }
+    if (it->leaf == NULL)
+        return NULL;
+    return it->leaf->u.leaf.rec[it->pos++];
+}
+
+/* Αντιγραφή των εγγραφών με lo <= όνομα <= hi (NULL = χωρίς όριο) στο out,
+ * έως limit - επιστρέφει το πλήθος τους */
+int range_query(Node *root, const char *lo, const char *hi, Citizen *out, int limit) {
+    TreeIter it;
+    int count = 0;
+    iter_seek(&it, root, lo);
+
+    Citizen *rec;
+    while (count < limit && (rec = iter_next(&it)) != NULL) {
+        if (hi && strcmp(rec->full_name, hi) > 0)
+            break;
+        out[count++] = *rec;
+    }
+    return count;
+}
+
+/* Αντιγραφή των εγγραφών που το όνομά τους αρχίζει από prefix στο out, έως
+ * limit - επιστρέφει το πλήθος τους */
+int prefix_query(Node *root, const char *prefix, Citizen *out, int limit) {
+    TreeIter it;
+    int count = 0;
+    size_t len = strlen(prefix);
+    iter_seek(&it, root, prefix);
+
+    Citizen *rec;
+    while (count < limit && (rec = iter_next(&it)) != NULL) {
+        if (strncmp(rec->full_name, prefix, len) != 0)
+            break;
+        out[count++] = *rec;
+    }
+    return count;
+}
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 /* Δομή πολίτη */
 typedef struct {
@@ -16,23 +17,176 @@ typedef struct {
     int annual_income;
 } Citizen;
 
-/* Δομή κόμβου δέντρου */
+/* Δομή κόμβου δέντρου - τα πεδία της αναζήτησης (key, παιδιά) προηγούνται
+ * ώστε να βρίσκονται στην ίδια cache line με την αρχή του ονόματος */
 typedef struct Node {
-    Citizen data;
+    uint64_t key; /* Πρόθεμα 8 bytes του full_name */
     struct Node *left;
     struct Node *right;
     int height;   /* Χρησιμοποιείται από AVL */
     char color;   /* Χρησιμοποιείται από Red-Black ('R' ή 'B') */
+    Citizen data;
 } Node;
 
-/* Δημιουργία νέου κόμβου */
-Node* create_node(Citizen data) {
-    Node *node = (Node*)malloc(sizeof(Node));
+/* ---------- Κλειδιά σύγκρισης ---------- */
+
+/* Κάθε κόμβος κρατά τα πρώτα 8 bytes του full_name ως big-endian ακέραιο.
+ * Η σύγκριση ακεραίων δίνει την ίδια διάταξη με την strcmp, οπότε η strcmp
+ * καλείται (από το 9ο byte) μόνο όταν τα προθέματα ταυτίζονται. */
+static inline uint64_t key_prefix(const char *name) {
+    uint64_t k = 0;
+    int i = 0;
+    for (; i < 8 && name[i]; i++)
+        k = (k << 8) | (unsigned char)name[i];
+    return i ? k << (8 * (8 - i)) : 0;
+}
+
+static inline int key_cmp(uint64_t ka, const char *a, uint64_t kb, const char *b) {
+    if (ka != kb)
+        return ka < kb ? -1 : 1;
+    if ((ka & 0xFF) == 0)
+        return 0; /* όνομα μικρότερο των 8 bytes: ίσα */
+    return strcmp(a + 8, b + 8);
+}
+
+/* ---------- Δεξαμενή κόμβων (arena) ---------- */
+
+/* Οι κόμβοι μπορούν να δεσμεύονται από μια arena: κόβονται διαδοχικά από
+ * slabs του 1 MiB, οι διαγραμμένοι κόμβοι μπαίνουν σε free list και όλο
+ * το δέντρο ελευθερώνεται με pool_reset/pool_destroy χωρίς διάσχιση. */
+
+#define POOL_SLAB_BYTES (1u << 20)
+#define POOL_SLAB_HEADER 64
+
+typedef struct PoolSlab {
+    struct PoolSlab *next;
+} PoolSlab;
+
+typedef struct {
+    size_t node_size;
+    PoolSlab *head, *cur;   /* λίστα slabs και τρέχον slab */
+    char *bump, *end;       /* ελεύθερη περιοχή τρέχοντος slab */
+    void *free_list;        /* κόμβοι που επιστράφηκαν με pool_free */
+    size_t live, slabs;
+} NodePool;
+
+/* Αρχικοποίηση arena για κόμβους μεγέθους node_size */
+void pool_init(NodePool *p, size_t node_size) {
+    memset(p, 0, sizeof(*p));
+    p->node_size = (node_size + 7) & ~(size_t)7;
+}
+
+/* Μετάβαση στο επόμενο slab (επαναχρησιμοποίηση μετά από reset ή νέο) */
+static int pool_next_slab(NodePool *p) {
+    PoolSlab *s = p->cur ? p->cur->next : p->head;
+    if (!s) {
+        s = (PoolSlab*)malloc(POOL_SLAB_BYTES);
+        if (!s)
+            return 0;
+        s->next = NULL;
+        if (p->cur)
+            p->cur->next = s;
+        else
+            p->head = s;
+        p->slabs++;
+    }
+    p->cur = s;
+    p->bump = (char*)s + POOL_SLAB_HEADER;
+    p->end = (char*)s + POOL_SLAB_BYTES;
+    return 1;
+}
+
+/* Δέσμευση κόμβου: πρώτα από τη free list, αλλιώς από το τρέχον slab */
+void* pool_alloc(NodePool *p) {
+    void *n = p->free_list;
+    if (n) {
+        p->free_list = *(void**)n;
+        p->live++;
+        return n;
+    }
+    if ((size_t)(p->end - p->bump) < p->node_size && !pool_next_slab(p))
+        return NULL;
+    n = p->bump;
+    p->bump += p->node_size;
+    p->live++;
+    return n;
+}
+
+/* Επιστροφή κόμβου στη free list */
+void pool_free(NodePool *p, void *n) {
+    *(void**)n = p->free_list;
+    p->free_list = n;
+    p->live--;
+}
+
+/* Ελευθέρωση όλων των κόμβων - τα slabs κρατιούνται για επαναχρησιμοποίηση */
+void pool_reset(NodePool *p) {
+    p->cur = NULL;
+    p->bump = p->end = NULL;
+    p->free_list = NULL;
+    p->live = 0;
+}
+
+/* Επιστροφή όλων των slabs στο σύστημα */
+void pool_destroy(NodePool *p) {
+    PoolSlab *s = p->head;
+    while (s) {
+        PoolSlab *next = s->next;
+        free(s);
+        s = next;
+    }
+    pool_init(p, p->node_size);
+}
+
+/* Ενεργή arena του δέντρου (NULL = malloc/free) */
+static NodePool *node_pool = NULL;
+
+/* Επιλογή arena για τις επόμενες εισαγωγές/διαγραφές */
+void use_node_pool(NodePool *pool) {
+    node_pool = pool;
+}
+
+/* Λογιστική μνήμης για κόμβους με malloc: ζωντανοί κόμβοι και bytes.
+ * Με arena τα ίδια στοιχεία δίνουν τα live, node_size και slabs της NodePool. */
+static size_t live_nodes = 0;
+static size_t live_bytes = 0;
+
+/* Επιστρέφει το πλήθος και τα bytes των κόμβων που δεν έχουν ελευθερωθεί */
+void tree_memory(size_t *nodes, size_t *bytes) {
+    *nodes = live_nodes;
+    *bytes = live_bytes;
+}
+
+static void* node_alloc(size_t size) {
+    if (node_pool)
+        return pool_alloc(node_pool);
+    void *n = malloc(size);
+    if (n) {
+        live_nodes++;
+        live_bytes += size;
+    }
+    return n;
+}
+
+static void node_free(void *n) {
+    if (node_pool) {
+        pool_free(node_pool, n);
+        return;
+    }
+    live_nodes--;
+    live_bytes -= sizeof(Node);
+    free(n);
+}
+
+/* Δημιουργία νέου κόμβου - η εγγραφή αντιγράφεται μία φορά, εδώ */
+Node* create_node(const Citizen *data) {
+    Node *node = (Node*)node_alloc(sizeof(Node));
     if (!node) {
         printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
         return NULL;
     }
-    node->data = data;
+    node->key = key_prefix(data->full_name);
+    node->data = *data;
     node->left = NULL;
     node->right = NULL;
     node->height = 1;
@@ -40,18 +194,21 @@ Node* create_node(Citizen data) {
     return node;
 }
 
-/* Εισαγωγή κόμβου στο BST - σύγκριση με βάση το full_name */
-Node* insert_bst(Node *root, Citizen data) {
-    if (root == NULL)
-        return create_node(data);
-
-    int cmp = strcmp(data.full_name, root->data.full_name);
-    if (cmp < 0)
-        root->left = insert_bst(root->left, data);
-    else if (cmp > 0)
-        root->right = insert_bst(root->right, data);
-    /* Αν cmp == 0, το όνομα υπάρχει ήδη - δεν εισάγεται */
+/* Εισαγωγή κόμβου στο BST - σύγκριση με βάση το full_name.
+ * Επαναληπτική: το link δείχνει στον δείκτη (root, left ή right) που θα
+ * δείξει στον νέο κόμβο, οπότε δεν υπάρχει αναδρομή ούτε σε εκφυλισμένο
+ * δέντρο (π.χ. ταξινομημένη είσοδος) */
+Node* insert_bst(Node *root, const Citizen *data) {
+    uint64_t key = key_prefix(data->full_name);
+    Node **link = &root;
 
+    while (*link != NULL) {
+        int cmp = key_cmp(key, data->full_name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0)
+            return root; /* Το όνομα υπάρχει ήδη - δεν εισάγεται */
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+    *link = create_node(data);
     return root;
 }
 
@@ -62,49 +219,156 @@ Node* find_min(Node *root) {
     return root;
 }
 
-/* Διαγραφή κόμβου από το BST με βάση το όνομα */
-Node* delete_bst(Node *root, char *name) {
-    if (root == NULL)
-        return NULL;
+/* Διαγραφή κόμβου από το BST με βάση το όνομα (επαναληπτική) */
+Node* delete_bst(Node *root, const char *name) {
+    uint64_t key = key_prefix(name);
+    Node **link = &root;
 
-    int cmp = strcmp(name, root->data.full_name);
-    if (cmp < 0) {
-        root->left = delete_bst(root->left, name);
-    } else if (cmp > 0) {
-        root->right = delete_bst(root->right, name);
+    while (*link != NULL) {
+        int cmp = key_cmp(key, name, (*link)->key, (*link)->data.full_name);
+        if (cmp == 0)
+            break;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+
+    Node *target = *link;
+    if (target == NULL)
+        return root; /* Δεν βρέθηκε */
+
+    if (target->left == NULL) {
+        /* Κόμβος με 0 ή 1 παιδί (δεξί) */
+        *link = target->right;
+    } else if (target->right == NULL) {
+        /* Κόμβος με 1 παιδί (αριστερό) */
+        *link = target->left;
     } else {
-        /* Βρέθηκε ο κόμβος προς διαγραφή */
-        if (root->left == NULL) {
-            /* Κόμβος με 0 ή 1 παιδί (δεξί) */
-            Node *temp = root->right;
-            free(root);
-            return temp;
-        } else if (root->right == NULL) {
-            /* Κόμβος με 1 παιδί (αριστερό) */
-            Node *temp = root->left;
-            free(root);
-            return temp;
-        }
-        /* Κόμβος με 2 παιδιά - αντικατάσταση με τον inorder successor */
-        Node *successor = find_min(root->right);
-        root->data = successor->data;
-        root->right = delete_bst(root->right, successor->data.full_name);
+        /* Κόμβος με 2 παιδιά - ο inorder successor αποσυνδέεται και παίρνει
+         * τη θέση του κόμβου (αλλαγή δεικτών, χωρίς αντιγραφή δεδομένων) */
+        Node **succ_link = &target->right;
+        while ((*succ_link)->left != NULL)
+            succ_link = &(*succ_link)->left;
+        Node *successor = *succ_link;
+        *succ_link = successor->right;
+        successor->left = target->left;
+        successor->right = target->right;
+        *link = successor;
     }
+    node_free(target);
     return root;
 }
 
-/* Αναζήτηση κόμβου με βάση το όνομα */
-Node* search(Node *root, char *name) {
-    if (root == NULL)
+/* Αναζήτηση κόμβου με βάση το όνομα (επαναληπτική) */
+Node* search(Node *root, const char *name) {
+    uint64_t key = key_prefix(name);
+
+    while (root != NULL) {
+        int cmp = key_cmp(key, name, root->key, root->data.full_name);
+        if (cmp == 0)
+            return root;
+        root = (cmp < 0) ? root->left : root->right;
+    }
+    return NULL;
+}
+
+/* ---------- Ομαδική αναζήτηση ---------- */
+
+#define BATCH_GROUP 16     /* αναζητήσεις σε εξέλιξη ταυτόχρονα */
+
+typedef struct {
+    Node *node;
+    uint64_t key;
+    int idx;
+} BatchState;
+
+/* Η επόμενη αναζήτηση στη θέση st - 0 αν δεν υπάρχουν άλλες */
+static int batch_next(BatchState *st, Node *root, const char *const *names, int n, int *next) {
+    if (*next >= n)
+        return 0;
+    st->node = root;
+    st->key = key_prefix(names[*next]);
+    st->idx = (*next)++;
+    return 1;
+}
+
+/* Ομαδική αναζήτηση με AMAC (όπως η bst_search_batch του benchmark.c):
+ * out[i] ο κόμβος του names[i] ή NULL */
+void search_batch(Node *root, const char *const *names, int n, Node **out) {
+    BatchState st[BATCH_GROUP];
+    int next = 0, active = 0;
+    while (active < BATCH_GROUP && batch_next(&st[active], root, names, n, &next))
+        active++;
+
+    while (active > 0) {
+        for (int s = 0; s < active;) {
+            Node *x = st[s].node;
+            int cmp = 0;
+            if (x != NULL)
+                cmp = key_cmp(st[s].key, names[st[s].idx], x->key, x->data.full_name);
+            if (cmp != 0) {
+                x = (cmp < 0) ? x->left : x->right;
+                __builtin_prefetch(x);
+                st[s++].node = x;
+                continue;
+            }
+            out[st[s].idx] = x;
+            if (!batch_next(&st[s], root, names, n, &next))
+                st[s] = st[--active];
+        }
+    }
+}
+
+/* ---------- Μαζική κατασκευή ---------- */
+
+/* Αλφαβητική σειρά και, για ίδια ονόματα, σειρά εμφάνισης στον πίνακα */
+static int compare_citizen_ptr(const void *a, const void *b) {
+    const Citizen *x = *(const Citizen* const*)a;
+    const Citizen *y = *(const Citizen* const*)b;
+    int cmp = strcmp(x->full_name, y->full_name);
+    if (cmp != 0)
+        return cmp;
+    return (x > y) - (x < y);
+}
+
+/* Ταξινόμηση (αν ο πίνακας δεν είναι ήδη ταξινομημένος) και αφαίρεση
+ * διπλοτύπων - κρατείται η πρώτη εμφάνιση, όπως στην εισαγωγή */
+static int sort_unique(Citizen citizens[], int count, Citizen ***out) {
+    Citizen **v = (Citizen**)malloc((count > 0 ? count : 1) * sizeof(Citizen*));
+    int sorted = 1;
+    for (int i = 0; i < count; i++) {
+        v[i] = &citizens[i];
+        if (i > 0 && strcmp(citizens[i - 1].full_name, citizens[i].full_name) > 0)
+            sorted = 0;
+    }
+    if (!sorted)
+        qsort(v, count, sizeof(Citizen*), compare_citizen_ptr);
+
+    int m = 0;
+    for (int i = 0; i < count; i++)
+        if (m == 0 || strcmp(v[m - 1]->full_name, v[i]->full_name) != 0)
+            v[m++] = v[i];
+    *out = v;
+    return m;
+}
+
+/* Ρίζα κάθε υποδέντρου είναι το μεσαίο στοιχείο του διαστήματος */
+static Node* build_range(Citizen **v, int lo, int hi) {
+    if (lo > hi)
         return NULL;
+    int mid = lo + (hi - lo) / 2;
+    Node *node = create_node(v[mid]);
+    node->left = build_range(v, lo, mid - 1);
+    node->right = build_range(v, mid + 1, hi);
+    return node;
+}
 
-    int cmp = strcmp(name, root->data.full_name);
-    if (cmp == 0)
-        return root;
-    else if (cmp < 0)
-        return search(root->left, name);
-    else
-        return search(root->right, name);
+/* Κατασκευή τέλεια ισοζυγισμένου BST από πίνακα πολιτών σε O(n) μετά την
+ * ταξινόμηση - αντί για count διαδοχικές εισαγωγές */
+Node* build_bst(Citizen citizens[], int count) {
+    Citizen **v;
+    int m = sort_unique(citizens, count, &v);
+    Node *root = build_range(v, 0, m - 1);
+    free(v);
+    return root;
 }
 
 /* Inorder traversal - εκτύπωση πολιτών σε αλφαβητική σειρά */
@@ -127,11 +391,133 @@ void traversal_to_file(Node *root, FILE *fp) {
     traversal_to_file(root->right, fp);
 }
 
-/* Απελευθέρωση μνήμης όλου του δέντρου */
+/* Απελευθέρωση μνήμης όλου του δέντρου χωρίς αναδρομή (το εκφυλισμένο
+ * δέντρο μιας ταξινομημένης εισόδου έχει βάθος n): όσο η ρίζα έχει
+ * αριστερό παιδί, δεξιά περιστροφή. Αλλιώς η ρίζα ελευθερώνεται και
+ * συνεχίζουμε στο δεξί της. Κάθε κόμβος περιστρέφεται το πολύ μία φορά,
+ * άρα O(n) χωρίς στοίβα */
 void free_tree(Node *root) {
-    if (root == NULL)
-        return;
-    free_tree(root->left);
-    free_tree(root->right);
-    free(root);
+    while (root != NULL) {
+        Node *next = root->left;
+        if (next != NULL) {
+            root->left = next->right;
+            next->right = root;
+        } else {
+            next = root->right;
+            node_free(root);
+        }
+        root = next;
+    }
+}
+
+/* ---------- Διατεταγμένη προσπέλαση ---------- */
+
+/* Iterator με ρητή στοίβα: η στοίβα κρατά τους προγόνους που απομένουν να
+ * επισκεφθούμε (αυτούς από τους οποίους κατεβήκαμε αριστερά). Σε
+ * εκφυλισμένο δέντρο το βάθος μπορεί να φτάσει το n, οπότε πάνω από
+ * ITER_FIXED_DEPTH επίπεδα η στοίβα μεταφέρεται στον heap. Ο iterator δεν
+ * πρέπει να αντιγράφεται (η stack μπορεί να δείχνει στο fixed). Αν αποτύχει
+ * η επέκταση της στοίβας, ο iterator σημειώνεται failed και η iter_next
+ * επιστρέφει NULL, οπότε ο καλών ελέγχει το failed όταν πάρει NULL. */
+#define ITER_FIXED_DEPTH 64
+
+typedef struct {
+    Node **stack;
+    int top;
+    int cap;
+    int failed;
+    Node *fixed[ITER_FIXED_DEPTH];
+} TreeIter;
+
+/* 0 αν αποτύχει η δέσμευση μεγαλύτερης στοίβας */
+static int iter_push(TreeIter *it, Node *node) {
+    if (it->top == it->cap) {
+        int cap = it->cap * 2;
+        Node **stack = (Node**)malloc(cap * sizeof(Node*));
+        if (!stack) {
+            printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
+            it->failed = 1;
+            return 0;
+        }
+        memcpy(stack, it->stack, it->top * sizeof(Node*));
+        if (it->stack != it->fixed)
+            free(it->stack);
+        it->stack = stack;
+        it->cap = cap;
+    }
+    it->stack[it->top++] = node;
+    return 1;
+}
+
+/* Τοποθέτηση στο πρώτο όνομα >= lo (NULL = στην αρχή) σε O(ύψος) */
+void iter_seek(TreeIter *it, Node *root, const char *lo) {
+    it->stack = it->fixed;
+    it->top = 0;
+    it->cap = ITER_FIXED_DEPTH;
+    it->failed = 0;
+    uint64_t key = lo ? key_prefix(lo) : 0;
+
+    while (root != NULL) {
+        if (lo == NULL || key_cmp(key, lo, root->key, root->data.full_name) <= 0) {
+            if (!iter_push(it, root))
+                return;
+            root = root->left;
+        } else {
+            root = root->right;
+        }
+    }
+}
+
+/* Επόμενος κόμβος σε αλφαβητική σειρά ή NULL στο τέλος και σε αποτυχία */
+Node* iter_next(TreeIter *it) {
+    if (it->top == 0 || it->failed)
+        return NULL;
+    Node *node = it->stack[--it->top];
+    for (Node *x = node->right; x != NULL; x = x->left)
+        if (!iter_push(it, x))
+            return NULL;
+    return node;
+}
+
+void iter_done(TreeIter *it) {
+    if (it->stack != it->fixed)
+        free(it->stack);
+    it->stack = it->fixed;
+    it->top = 0;
+}
+
+/* Αντιγραφή των εγγραφών με lo <= όνομα <= hi (NULL = χωρίς όριο) στο out,
+ * έως limit - επιστρέφει το πλήθος τους ή -1 αν αποτύχει η δέσμευση μνήμης */
+int range_query(Node *root, const char *lo, const char *hi, Citizen *out, int limit) {
+    TreeIter it;
+    int count = 0;
+    uint64_t key = hi ? key_prefix(hi) : 0;
+    iter_seek(&it, root, lo);
+
+    Node *node;
+    while (count < limit && (node = iter_next(&it)) != NULL) {
+        if (hi && key_cmp(key, hi, node->key, node->data.full_name) < 0)
+            break;
+        out[count++] = node->data;
+    }
+    iter_done(&it);
+    return it.failed ? -1 : count;
+}
+
+/* Αντιγραφή των εγγραφών που το όνομά τους αρχίζει από prefix στο out, έως
+ * limit - επιστρέφει το πλήθος τους ή -1 αν αποτύχει η δέσμευση μνήμης */
+int prefix_query(Node *root, const char *prefix, Citizen *out, int limit) {
+    TreeIter it;
+    int count = 0;
+    size_t len = strlen(prefix);
+    iter_seek(&it, root, prefix);
+
+    Node *node;
+    while (count < limit && (node = iter_next(&it)) != NULL) {
+        if (strncmp(node->data.full_name, prefix, len) != 0)
+            break;
+        out[count++] = node->data;
+    }
+    iter_done(&it);
+    return it.failed ? -1 : count;
 }
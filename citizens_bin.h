@@ -0,0 +1,79 @@
+/*
+ * citizens_bin.h
+ * Η δυαδική μορφή citizens.bin, κοινή για τον writer (generate_citizens.c)
+ * και τον loader (benchmark.c) ώστε να μην μπορούν να αποκλίνουν.
+ *
+ * Header 64 bytes και στήλες ευθυγραμμισμένες στα 64 bytes, σε σειρά byte
+ * του host (little-endian σε x86):
+ *   λεξικό πολιτειών   state_count x 64 bytes (NUL-terminated)
+ *   offsets ονομάτων   (count + 1) x uint64 - το όνομα i είναι στο heap + off[i]
+ *   heap ονομάτων      heap_bytes (κάθε όνομα NUL-terminated)
+ *   ηλικία             count x uint8
+ *   πολιτεία           count x uint8 (θέση στο λεξικό)
+ *   εισόδημα           count x int32
+ * Ο loader κάνει mmap και χρησιμοποιεί τις στήλες όπως είναι.
+ */
+
+#ifndef CITIZENS_BIN_H
+#define CITIZENS_BIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define BIN_MAGIC "CITZBIN1"
+#define BIN_VERSION 1
+#define BIN_HEADER_SIZE 64
+#define BIN_STATE_LEN 64
+#define BIN_ALIGN(x) (((x) + 63) & ~(uint64_t)63)
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t state_count;
+    uint64_t count;
+    uint64_t heap_bytes;
+    uint64_t file_size;
+    uint64_t data_checksum;     /* όλα τα bytes μετά το header */
+    uint64_t reserved;
+    uint64_t header_checksum;   /* τα πρώτα 56 bytes του header */
+} BinHeader;
+
+/* Θέσεις των στηλών - υπολογίζονται από το header */
+typedef struct {
+    uint64_t dict, offsets, heap, age, state, income, end;
+} BinLayout;
+
+static inline void bin_layout(const BinHeader *h, BinLayout *l) {
+    l->dict = BIN_HEADER_SIZE;
+    l->offsets = BIN_ALIGN(l->dict + (uint64_t)h->state_count * BIN_STATE_LEN);
+    l->heap = BIN_ALIGN(l->offsets + (h->count + 1) * sizeof(uint64_t));
+    l->age = BIN_ALIGN(l->heap + h->heap_bytes);
+    l->state = BIN_ALIGN(l->age + h->count);
+    l->income = BIN_ALIGN(l->state + h->count);
+    l->end = l->income + h->count * sizeof(int32_t);
+}
+
+/* Άθροισμα ελέγχου 64 bit: λέξεις των 8 bytes με πολλαπλασιασμό και
+ * περιστροφή (μερικά GB/s), ανακάτεμα splitmix64 με το μήκος στο τέλος */
+static inline uint64_t bin_checksum(const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char*)data;
+    uint64_t h = 0x9E3779B97F4A7C15ULL, w;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        memcpy(&w, p + i, 8);
+        h ^= w * 0xBF58476D1CE4E5B9ULL;
+        h = ((h << 31) | (h >> 33)) * 0x94D049BB133111EBULL;
+    }
+    w = 0;
+    memcpy(&w, p + i, len - i);
+    h ^= w * 0xBF58476D1CE4E5B9ULL;
+    h = ((h << 31) | (h >> 33)) * 0x94D049BB133111EBULL;
+    h ^= len;
+    h += 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+#endif /* CITIZENS_BIN_H */
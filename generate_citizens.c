@@ -1,71 +1,755 @@
 /*
  * generate_citizens.c
  * Διαβάζει ονόματα από names.txt και πολιτείες από states.txt,
- * δημιουργεί τυχαίες εγγραφές πολιτών και τις γράφει στο citizens.txt.
+ * δημιουργεί εγγραφές πολιτών και τις γράφει στο citizens.txt.
  * Κάθε πολίτης έχει: full_name, age [1-100], state, annual_income [0-1000000]
+ *
+ * Τα ονόματα συντίθενται από τα μικρά ονόματα και τα επώνυμα του names.txt
+ * ("Μικρό Επώνυμο" ή "Μικρό Επώνυμο Επώνυμο" για μεγάλα πλήθη), οπότε το
+ * πλήθος δεν περιορίζεται από τις γραμμές του αρχείου και κάθε όνομα είναι
+ * μοναδικό. Η έξοδος είναι ντετερμινιστική: ίδιο seed, πλήθος και κατανομή
+ * δίνουν ίδιο αρχείο, ανεξάρτητα από τον αριθμό νημάτων.
+ *
+ * Χρήση: ./generate_citizens [-n πλήθος] [-s seed] [-d κατανομή] [-t νήματα] [-o αρχείο]
+ *   κατανομή: random (προεπιλογή), sorted, reverse, nearly, zipf
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
 #include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "citizens_bin.h"
 
 #define MAX_NAMES 1000
 #define MAX_STATES 50
 #define NAME_LEN 100
 #define STATE_LEN 50
 
-int main(void) {
-    char names[MAX_NAMES][NAME_LEN];
-    char states[MAX_STATES][STATE_LEN];
-    int name_count = 0, state_count = 0;
+#define DEFAULT_COUNT 1000
+#define DEFAULT_SEED 42
+#define GEN_BLOCK 65536         /* εγγραφές ανά μπλοκ εξόδου */
+#define GEN_LINE_MAX 256        /* μέγιστο μήκος γραμμής */
+#define MAX_THREADS 64
+#define NEARLY_BLOCK 16         /* μέγεθος ομάδας ανακατέματος στο nearly */
+#define NEARLY_PERCENT 5        /* ποσοστό ομάδων που ανακατεύονται */
+
+/* Κατανομή: σειρά εγγραφών στο αρχείο και πυκνότητα ονομάτων */
+enum { DIST_RANDOM, DIST_SORTED, DIST_REVERSE, DIST_NEARLY, DIST_ZIPF };
+static const char *dist_names[] = {"random", "sorted", "reverse", "nearly", "zipf"};
+
+/* Τμήμα ονόματος με προϋπολογισμένο μήκος (για memcpy χωρίς strlen) */
+typedef struct {
+    char text[NAME_LEN];
+    int len;
+} NamePart;
+
+/* Κοινή κατάσταση όλων των νημάτων */
+typedef struct {
+    NamePart first[MAX_NAMES], last[MAX_NAMES];
+    NamePart states[MAX_STATES];
+    int first_count, last_count, state_count;
+
+    long long count;            /* πλήθος εγγραφών */
+    uint64_t seed;
+    int dist;
+    int parts;                  /* 2 = Μικρό Επώνυμο, 3 = Μικρό Επώνυμο Επώνυμο */
+    unsigned __int128 space;    /* πλήθος διαθέσιμων ονομάτων */
+
+    /* Feistel μετάθεση του [0, count) για random/zipf */
+    int half_bits;
+    uint64_t half_mask;
+
+    /* zipf: εγγραφές ανά μικρό όνομα και αθροίσματα προθέματος */
+    long long *zipf_start;      /* first_count + 1 στοιχεία */
+
+    /* Εγγραφή μπλοκ με τη σειρά */
+    FILE *out;
+    long long blocks, next_block;
+    pthread_mutex_t lock;
+    pthread_cond_t turn;
+    int threads;
+} Generator;
+
+/* ---------- Ψευδοτυχαίοι αριθμοί ---------- */
+
+/* splitmix64: γρήγορο hash 64-bit, αρκετό για ντετερμινιστική παραγωγή */
+static inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static inline uint64_t hash2(uint64_t seed, uint64_t a, uint64_t b) {
+    return mix64(seed ^ mix64(a ^ mix64(b)));
+}
+
+/* Μετάθεση του [0, count) με δίκτυο Feistel 4 γύρων σε 2 * half_bits bits
+ * και cycle-walking: αντιστρέψιμη, άρα κάθε τάξη εμφανίζεται ακριβώς μία
+ * φορά, χωρίς πίνακα μεγέθους count */
+static uint64_t permute(const Generator *g, uint64_t i) {
+    do {
+        uint64_t l = i >> g->half_bits, r = i & g->half_mask;
+        for (int round = 0; round < 4; round++) {
+            uint64_t t = l ^ (hash2(g->seed, round, r) & g->half_mask);
+            l = r;
+            r = t;
+        }
+        i = (l << g->half_bits) | r;
+    } while (i >= (uint64_t)g->count);
+    return i;
+}
+
+/* ---------- Θέση στο αρχείο -> τάξη ονόματος ---------- */
+
+/* Η τάξη r είναι η θέση του ονόματος στην αλφαβητική σειρά της εξόδου */
+static uint64_t position_to_rank(const Generator *g, uint64_t i) {
+    switch (g->dist) {
+    case DIST_SORTED:
+        return i;
+    case DIST_REVERSE:
+        return (uint64_t)g->count - 1 - i;
+    case DIST_NEARLY: {
+        /* Ταξινομημένα, εκτός από λίγες ομάδες των NEARLY_BLOCK εγγραφών όπου
+         * οι θέσεις ανακατεύονται με XOR (αντιστρέψιμο μέσα στην ομάδα) */
+        uint64_t block = i / NEARLY_BLOCK;
+        if ((block + 1) * NEARLY_BLOCK > (uint64_t)g->count)
+            return i;
+        uint64_t h = hash2(g->seed, 0x6E65, block);
+        if (h % 100 >= NEARLY_PERCENT)
+            return i;
+        return block * NEARLY_BLOCK + ((i % NEARLY_BLOCK) ^ ((h >> 32) % NEARLY_BLOCK));
+    }
+    default:
+        return permute(g, i);
+    }
+}
+
+/* ---------- Τάξη -> όνομα ---------- */
+
+/* Δείκτης στον χώρο ονομάτων (μικτή βάση: μικρό, [επώνυμο,] επώνυμο) για
+ * την τάξη r. Η αντιστοίχιση είναι γνησίως αύξουσα, άρα οι τάξεις δίνουν
+ * διαφορετικά ονόματα στη σωστή αλφαβητική σειρά (το κενό είναι μικρότερο
+ * από κάθε γράμμα, οπότε η σειρά των συνδυασμών είναι και σειρά strcmp). */
+static void rank_to_parts(const Generator *g, uint64_t r, int *f, int *m, int *l) {
+    uint64_t per_first = (g->parts == 3) ? (uint64_t)g->last_count * g->last_count : (uint64_t)g->last_count;
+    uint64_t t;
+
+    if (g->dist == DIST_ZIPF) {
+        /* Δυαδική αναζήτηση του μικρού ονόματος στα αθροίσματα προθέματος */
+        int lo = 0, hi = g->first_count;
+        while (hi - lo > 1) {
+            int mid = (lo + hi) / 2;
+            if (g->zipf_start[mid] <= (long long)r)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        uint64_t j = r - g->zipf_start[lo];
+        uint64_t n = g->zipf_start[lo + 1] - g->zipf_start[lo];
+        *f = lo;
+        t = (uint64_t)((unsigned __int128)j * per_first / n);
+    } else {
+        unsigned __int128 x = (unsigned __int128)r * g->space / (uint64_t)g->count;
+        *f = (int)(x / per_first);
+        t = (uint64_t)(x % per_first);
+    }
+
+    if (g->parts == 3) {
+        *m = (int)(t / g->last_count);
+        *l = (int)(t % g->last_count);
+    } else {
+        *m = -1;
+        *l = (int)t;
+    }
+}
+
+/* Γρήγορη μετατροπή μη αρνητικού ακεραίου σε κείμενο */
+static inline char* put_uint(char *p, unsigned v) {
+    char tmp[12];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n)
+        *p++ = tmp[--n];
+    return p;
+}
+
+static inline char* put_part(char *p, const NamePart *part) {
+    memcpy(p, part->text, part->len);
+    return p + part->len;
+}
+
+/* Όνομα της τάξης r στο p - επιστρέφει το τέλος του */
+static char* put_name(const Generator *g, uint64_t r, char *p) {
+    int f, m, l;
+    rank_to_parts(g, r, &f, &m, &l);
+    p = put_part(p, &g->first[f]);
+    *p++ = ' ';
+    if (m >= 0) {
+        p = put_part(p, &g->last[m]);
+        *p++ = ' ';
+    }
+    return put_part(p, &g->last[l]);
+}
+
+/* Τα πεδία εξαρτώνται μόνο από την τάξη, οπότε ένα όνομα έχει τα ίδια
+ * στοιχεία σε κάθε κατανομή και μορφή εξόδου */
+static void record_fields(const Generator *g, uint64_t r, int *age, int *state, int *income) {
+    uint64_t h = hash2(g->seed, 0x6369, r);
+    *age = (int)(h % 100) + 1;                          /* [1, 100] */
+    *state = (int)((h >> 8) % g->state_count);
+    *income = (int)((h >> 24) % 1000001);               /* [0, 1000000] */
+}
+
+/* Μορφοποίηση μιας γραμμής κειμένου */
+static char* format_record(const Generator *g, uint64_t r, char *p) {
+    int age, state, income;
+    record_fields(g, r, &age, &state, &income);
+    p = put_name(g, r, p);
+    *p++ = ',';
+    p = put_uint(p, (unsigned)age);
+    *p++ = ',';
+    p = put_part(p, &g->states[state]);
+    *p++ = ',';
+    p = put_uint(p, (unsigned)income);
+    *p++ = '\n';
+    return p;
+}
+
+/* ---------- Παράλληλη παραγωγή ---------- */
+
+typedef struct {
+    Generator *g;
+    int id;
+} Worker;
+
+/* Κάθε νήμα μορφοποιεί τα μπλοκ id, id + threads, ... στον δικό του buffer
+ * και τα γράφει όταν έρθει η σειρά τους, ώστε το αρχείο να μένει στη σωστή
+ * σειρά με σταθερή μνήμη (ένας buffer ανά νήμα) */
+static void* worker_run(void *arg) {
+    Worker *w = (Worker*)arg;
+    Generator *g = w->g;
+    char *buf = (char*)malloc((size_t)GEN_BLOCK * GEN_LINE_MAX);
+
+    for (long long b = w->id; b < g->blocks; b += g->threads) {
+        long long start = b * GEN_BLOCK;
+        long long end = start + GEN_BLOCK < g->count ? start + GEN_BLOCK : g->count;
+        char *p = buf;
+        for (long long i = start; i < end; i++)
+            p = format_record(g, position_to_rank(g, (uint64_t)i), p);
+
+        pthread_mutex_lock(&g->lock);
+        while (g->next_block != b)
+            pthread_cond_wait(&g->turn, &g->lock);
+        fwrite(buf, 1, p - buf, g->out);
+        g->next_block++;
+        pthread_cond_broadcast(&g->turn);
+        pthread_mutex_unlock(&g->lock);
+    }
+    free(buf);
+    return NULL;
+}
+
+/* ---------- Δυαδική στηλοθετημένη μορφή ---------- */
+
+/* Πηγή εγγραφών για τον writer: πεδία και όνομα στο buf (χωρίς NUL) -
+ * με buf NULL μόνο τα πεδία. Επιστρέφει το μήκος του ονόματος. */
+typedef struct {
+    int age, state, income;
+} BinFields;
+
+typedef int (*RecordSource)(void *ctx, uint64_t i, char *buf, BinFields *f);
+
+/* Buffer εξόδου με μέτρηση bytes για τις ευθυγραμμίσεις. Μια αποτυχημένη
+ * fwrite (π.χ. γεμάτος δίσκος) σημειώνεται στο failed και οι επόμενες
+ * εγγραφές παραλείπονται. */
+typedef struct {
     FILE *fp;
-    
-    /* Ανάγνωση ονομάτων από names.txt */
-    fp = fopen("names.txt", "r");
+    char *buf;
+    size_t len;
+    uint64_t written;
+    int failed;
+} BinOut;
+
+#define BIN_OUT_BUF (1 << 20)
+
+static void bin_flush(BinOut *o) {
+    if (!o->failed && o->len > 0 && fwrite(o->buf, 1, o->len, o->fp) != o->len)
+        o->failed = 1;
+    o->len = 0;
+}
+
+static void bin_put(BinOut *o, const void *data, size_t n) {
+    if (o->len + n > BIN_OUT_BUF)
+        bin_flush(o);
+    memcpy(o->buf + o->len, data, n);
+    o->len += n;
+    o->written += n;
+}
+
+static void bin_pad(BinOut *o, uint64_t to) {
+    static const char zero[64];
+    while (o->written < to) {
+        uint64_t n = to - o->written < 64 ? to - o->written : 64;
+        bin_put(o, zero, (size_t)n);
+    }
+}
+
+/* Εγγραφή count εγγραφών σε δυαδική μορφή. Κάθε στήλη γράφεται σε δικό της
+ * πέρασμα πάνω στην πηγή, οπότε η μνήμη μένει σταθερή για κάθε count.
+ * Στο τέλος το αρχείο γίνεται mmap για το άθροισμα ελέγχου και γράφεται
+ * το header. Επιστρέφει το μέγεθος του αρχείου ή 0 σε σφάλμα. */
+static uint64_t write_binary(const char *path, uint64_t count, const NamePart *states, int state_count,
+                        RecordSource src, void *ctx) {
+    char name[GEN_LINE_MAX];
+    BinFields f;
+    BinHeader h;
+    BinLayout l;
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, BIN_MAGIC, 8);
+    h.version = BIN_VERSION;
+    h.state_count = (uint32_t)state_count;
+    h.count = count;
+    bin_layout(&h, &l); /* λεξικό, offsets και heap δεν εξαρτώνται από το heap_bytes */
+
+    BinOut o = {fopen(path, "wb+"), (char*)malloc(BIN_OUT_BUF), 0, 0, 0};
+    if (!o.fp || !o.buf) {
+        printf("Σφάλμα: δεν μπορεί να δημιουργηθεί το %s\n", path);
+        if (o.fp)
+            fclose(o.fp);
+        free(o.buf);
+        return 0;
+    }
+    bin_pad(&o, l.dict);
+    for (int s = 0; s < state_count; s++) {
+        char entry[BIN_STATE_LEN] = {0};
+        memcpy(entry, states[s].text, states[s].len < BIN_STATE_LEN ? states[s].len : BIN_STATE_LEN - 1);
+        bin_put(&o, entry, BIN_STATE_LEN);
+    }
+    bin_pad(&o, l.offsets);
+    uint64_t off = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        bin_put(&o, &off, sizeof(off));
+        off += (uint64_t)src(ctx, i, name, &f) + 1;
+    }
+    bin_put(&o, &off, sizeof(off));
+    h.heap_bytes = off;
+    bin_layout(&h, &l);
+    h.file_size = l.end;
+    bin_pad(&o, l.heap);
+    for (uint64_t i = 0; i < count; i++) {
+        int len = src(ctx, i, name, &f);
+        name[len] = '\0';
+        bin_put(&o, name, (size_t)len + 1);
+    }
+    bin_pad(&o, l.age);
+    for (uint64_t i = 0; i < count; i++) {
+        src(ctx, i, NULL, &f);
+        uint8_t age = (uint8_t)(f.age < 0 ? 0 : f.age > 255 ? 255 : f.age);
+        bin_put(&o, &age, 1);
+    }
+    bin_pad(&o, l.state);
+    for (uint64_t i = 0; i < count; i++) {
+        src(ctx, i, NULL, &f);
+        uint8_t st = (uint8_t)f.state;
+        bin_put(&o, &st, 1);
+    }
+    bin_pad(&o, l.income);
+    for (uint64_t i = 0; i < count; i++) {
+        src(ctx, i, NULL, &f);
+        int32_t inc = f.income;
+        bin_put(&o, &inc, sizeof(inc));
+    }
+    bin_flush(&o);
+    free(o.buf);
+
+    /* Άθροισμα ελέγχου των δεδομένων και εγγραφή του header. Το mmap γίνεται
+     * μόνο αν γράφτηκαν όλα τα bytes: σε κοντύτερο αρχείο η ανάγνωση πέρα
+     * από το τέλος του θα έδινε SIGBUS. */
+    int ok = !o.failed && fflush(o.fp) == 0 && !ferror(o.fp);
+    void *map = ok ? mmap(NULL, h.file_size, PROT_READ, MAP_SHARED, fileno(o.fp), 0) : MAP_FAILED;
+    if (map == MAP_FAILED) {
+        ok = 0;
+    } else {
+        h.data_checksum = bin_checksum((const char*)map + BIN_HEADER_SIZE, h.file_size - BIN_HEADER_SIZE);
+        munmap(map, h.file_size);
+    }
+    h.header_checksum = bin_checksum(&h, offsetof(BinHeader, header_checksum));
+    if (ok && (fseek(o.fp, 0, SEEK_SET) != 0 || fwrite(&h, sizeof(h), 1, o.fp) != 1))
+        ok = 0;
+    if (fclose(o.fp) != 0)
+        ok = 0;
+    if (!ok)
+        printf("Σφάλμα: αποτυχία εγγραφής του %s\n", path);
+    return ok ? h.file_size : 0;
+}
+
+/* Πηγή για την παραγωγή: η θέση i αντιστοιχεί σε τάξη όπως στο κείμενο */
+static int generator_source(void *ctx, uint64_t i, char *buf, BinFields *f) {
+    const Generator *g = (const Generator*)ctx;
+    uint64_t r = position_to_rank(g, i);
+    record_fields(g, r, &f->age, &f->state, &f->income);
+    return buf ? (int)(put_name(g, r, buf) - buf) : 0;
+}
+
+/* ---------- Μετατροπή κειμένου σε δυαδική μορφή ---------- */
+
+/* Εγγραφές ενός citizens.txt σε στήλες στη μνήμη */
+typedef struct {
+    char *heap;
+    uint64_t *off;
+    int *age, *state, *income;
+    uint64_t count, cap;
+    size_t heap_len, heap_cap;
+    NamePart states[256];
+    int state_count;
+} TextColumns;
+
+static int text_source(void *ctx, uint64_t i, char *buf, BinFields *f) {
+    const TextColumns *t = (const TextColumns*)ctx;
+    int len = (int)(t->off[i + 1] - t->off[i] - 1);
+    if (buf)
+        memcpy(buf, t->heap + t->off[i], (size_t)len);
+    f->age = t->age[i];
+    f->state = t->state[i];
+    f->income = t->income[i];
+    return len;
+}
+
+static int text_state_id(TextColumns *t, const char *state) {
+    for (int i = 0; i < t->state_count; i++)
+        if (strcmp(t->states[i].text, state) == 0)
+            return i;
+    if (t->state_count == 256)
+        return -1;
+    snprintf(t->states[t->state_count].text, NAME_LEN, "%s", state);
+    t->states[t->state_count].len = (int)strlen(t->states[t->state_count].text);
+    return t->state_count++;
+}
+
+/* Ανάγνωση citizens.txt (όνομα,ηλικία,πολιτεία,εισόδημα) σε στήλες */
+static int read_text(const char *path, TextColumns *t) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        printf("Σφάλμα: δεν μπορεί να ανοίξει το %s\n", path);
+        return 0;
+    }
+    memset(t, 0, sizeof(*t));
+    char line[GEN_LINE_MAX];
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *name = strtok(line, ",");
+        if (!name)
+            continue;
+        char *age = strtok(NULL, ","), *state = strtok(NULL, ","), *income = strtok(NULL, ",");
+        if (t->count + 1 >= t->cap) {
+            t->cap = t->cap ? t->cap * 2 : 1024;
+            t->off = (uint64_t*)realloc(t->off, (t->cap + 1) * sizeof(uint64_t));
+            t->age = (int*)realloc(t->age, t->cap * sizeof(int));
+            t->state = (int*)realloc(t->state, t->cap * sizeof(int));
+            t->income = (int*)realloc(t->income, t->cap * sizeof(int));
+        }
+        size_t len = strlen(name) + 1;
+        if (t->heap_len + len > t->heap_cap) {
+            t->heap_cap = t->heap_cap ? t->heap_cap * 2 : 65536;
+            t->heap = (char*)realloc(t->heap, t->heap_cap);
+        }
+        int sid = text_state_id(t, state ? state : "");
+        if (sid < 0) {
+            printf("Σφάλμα: περισσότερες από 256 πολιτείες στο %s\n", path);
+            fclose(fp);
+            return 0;
+        }
+        memcpy(t->heap + t->heap_len, name, len);
+        t->off[t->count] = t->heap_len;
+        t->heap_len += len;
+        t->age[t->count] = age ? atoi(age) : 0;
+        t->state[t->count] = sid;
+        t->income[t->count] = income ? atoi(income) : 0;
+        t->count++;
+    }
+    if (t->off)
+        t->off[t->count] = t->heap_len;
+    fclose(fp);
+    return 1;
+}
+
+static void free_text(TextColumns *t) {
+    free(t->heap);
+    free(t->off);
+    free(t->age);
+    free(t->state);
+    free(t->income);
+}
+
+/* ---------- Προετοιμασία ---------- */
+
+static int compare_parts(const void *a, const void *b) {
+    return strcmp(((const NamePart*)a)->text, ((const NamePart*)b)->text);
+}
+
+/* Ταξινόμηση και αφαίρεση διπλοτύπων - επιστρέφει το νέο πλήθος */
+static int sort_unique_parts(NamePart *parts, int n) {
+    qsort(parts, n, sizeof(NamePart), compare_parts);
+    int m = 0;
+    for (int i = 0; i < n; i++)
+        if (m == 0 || strcmp(parts[m - 1].text, parts[i].text) != 0)
+            parts[m++] = parts[i];
+    for (int i = 0; i < m; i++)
+        parts[i].len = (int)strlen(parts[i].text);
+    return m;
+}
+
+/* Εγγραφές ανά μικρό όνομα με βάρος 1 / (θέση δημοτικότητας + 1): η σειρά
+ * δημοτικότητας είναι τυχαία (από το seed) και κάθε όνομα χωρά το πολύ
+ * per_first εγγραφές - ό,τι περισσεύει πάει στα πιο δημοφιλή με χώρο */
+static void build_zipf(Generator *g, uint64_t per_first) {
+    int n = g->first_count;
+    int *order = (int*)malloc(n * sizeof(int));
+    long long *cnt = (long long*)calloc(n, sizeof(long long));
+    double harmonic = 0;
+
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+        harmonic += 1.0 / (i + 1);
+    }
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(hash2(g->seed, 0x7a69, i) % (uint64_t)(i + 1));
+        int t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+
+    long long total = 0;
+    for (int k = 0; k < n; k++) {
+        long long c = (long long)(g->count / harmonic / (k + 1));
+        if ((uint64_t)c > per_first)
+            c = (long long)per_first;
+        cnt[order[k]] = c;
+        total += c;
+    }
+    for (int k = 0; total < g->count; k = (k + 1) % n) {
+        long long room = (long long)per_first - cnt[order[k]];
+        long long add = room < g->count - total ? room : g->count - total;
+        cnt[order[k]] += add;
+        total += add;
+    }
+
+    g->zipf_start = (long long*)malloc((n + 1) * sizeof(long long));
+    g->zipf_start[0] = 0;
+    for (int i = 0; i < n; i++)
+        g->zipf_start[i + 1] = g->zipf_start[i] + cnt[i];
+    free(order);
+    free(cnt);
+}
+
+/* Ανάγνωση names.txt: πρώτη λέξη = μικρό όνομα, τελευταία = επώνυμο */
+static int load_names(Generator *g) {
+    FILE *fp = fopen("names.txt", "r");
     if (!fp) {
         printf("Σφάλμα: δεν μπορεί να ανοίξει το names.txt\n");
-        return 1;
+        return 0;
     }
-    while (name_count < MAX_NAMES && fgets(names[name_count], NAME_LEN, fp)) {
+    char line[NAME_LEN];
+    int n = 0;
+    while (n < MAX_NAMES && fgets(line, NAME_LEN, fp)) {
         /* Αφαίρεση χαρακτήρα νέας γραμμής */
-        names[name_count][strcspn(names[name_count], "\r\n")] = '\0';
-        if (strlen(names[name_count]) > 0)
-            name_count++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char *space = strchr(line, ' ');
+        char *last_space = strrchr(line, ' ');
+        if (!space || last_space[1] == '\0')
+            continue;
+        *space = '\0';
+        snprintf(g->first[n].text, NAME_LEN, "%s", line);
+        snprintf(g->last[n].text, NAME_LEN, "%s", last_space + 1);
+        n++;
     }
     fclose(fp);
+    g->first_count = sort_unique_parts(g->first, n);
+    g->last_count = sort_unique_parts(g->last, n);
+    return g->first_count > 0;
+}
 
-    /* Ανάγνωση πολιτειών από states.txt */
-    fp = fopen("states.txt", "r");
+/* Ανάγνωση πολιτειών από states.txt */
+static int load_states(Generator *g) {
+    FILE *fp = fopen("states.txt", "r");
     if (!fp) {
         printf("Σφάλμα: δεν μπορεί να ανοίξει το states.txt\n");
-        return 1;
+        return 0;
     }
-    while (state_count < MAX_STATES && fgets(states[state_count], STATE_LEN, fp)) {
-        states[state_count][strcspn(states[state_count], "\r\n")] = '\0';
-        if (strlen(states[state_count]) > 0)
-            state_count++;
+    int n = 0;
+    while (n < MAX_STATES && fgets(g->states[n].text, STATE_LEN, fp)) {
+        g->states[n].text[strcspn(g->states[n].text, "\r\n")] = '\0';
+        g->states[n].len = (int)strlen(g->states[n].text);
+        if (g->states[n].len > 0)
+            n++;
     }
     fclose(fp);
+    g->state_count = n;
+    return n > 0;
+}
+
+int main(int argc, char *argv[]) {
+    static Generator g;
+    const char *out_path = NULL, *in_path = NULL;
+    int binary = 0;
+    g.count = DEFAULT_COUNT;
+    g.seed = DEFAULT_SEED;
+    g.dist = DIST_RANDOM;
+    g.threads = 1;
+
+    /* Ανάγνωση παραμέτρων - το πλήθος δέχεται και μορφή 1e8 */
+    for (int i = 1; i < argc; i++) {
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!strcmp(argv[i], "-n") && val) {
+            g.count = (long long)strtod(val, NULL);
+            i++;
+        } else if (!strcmp(argv[i], "-s") && val) {
+            g.seed = strtoull(val, NULL, 10);
+            i++;
+        } else if (!strcmp(argv[i], "-t") && val) {
+            g.threads = atoi(val);
+            i++;
+        } else if (!strcmp(argv[i], "-o") && val) {
+            out_path = val;
+            i++;
+        } else if (!strcmp(argv[i], "-f") && val) {
+            if (!strcmp(val, "bin"))
+                binary = 1;
+            else if (strcmp(val, "text") != 0)
+                g.dist = -1;
+            i++;
+        } else if (!strcmp(argv[i], "-i") && val) {
+            in_path = val;
+            i++;
+        } else if (!strcmp(argv[i], "-d") && val) {
+            g.dist = -1;
+            for (int d = 0; d < 5; d++)
+                if (!strcmp(val, dist_names[d]))
+                    g.dist = d;
+            i++;
+        } else {
+            g.dist = -1;
+        }
+        if (g.dist < 0) {
+            printf("Χρήση: %s [-n πλήθος] [-s seed] [-d random|sorted|reverse|nearly|zipf] [-t νήματα]\n"
+                   "          [-f text|bin] [-o αρχείο]\n"
+                   "       %s -i citizens.txt [-o citizens.bin]   (μετατροπή σε δυαδική μορφή)\n", argv[0], argv[0]);
+            return 1;
+        }
+    }
+    if (in_path)
+        binary = 1;
+    if (!out_path)
+        out_path = binary ? "citizens.bin" : "citizens.txt";
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    /* Μετατροπή υπάρχοντος αρχείου κειμένου σε δυαδική μορφή */
+    if (in_path) {
+        TextColumns text;
+        if (!read_text(in_path, &text))
+            return 1;
+        uint64_t bytes = write_binary(out_path, text.count, text.states, text.state_count, text_source, &text);
+        free_text(&text);
+        if (!bytes)
+            return 1;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+        printf("Μετατράπηκαν %llu εγγραφές από το %s στο %s (%.1f MB)\n", (unsigned long long)text.count,
+               in_path, out_path, bytes / 1e6);
+        printf("%.2f s, %.1f MB/s\n", secs, secs > 0 ? bytes / 1e6 / secs : 0.0);
+        return 0;
+    }
+    if (g.threads < 1)
+        g.threads = 1;
+    if (g.threads > MAX_THREADS)
+        g.threads = MAX_THREADS;
 
-    printf("Φορτώθηκαν %d ονόματα και %d πολιτείες\n", name_count, state_count);
+    if (!load_names(&g) || !load_states(&g))
+        return 1;
+    printf("Φορτώθηκαν %d μικρά ονόματα, %d επώνυμα και %d πολιτείες\n",
+           g.first_count, g.last_count, g.state_count);
+
+    /* Δύο τμήματα αν χωρούν με περιθώριο x4 (ώστε το zipf να έχει χώρο),
+     * αλλιώς τρία */
+    uint64_t two = (uint64_t)g.first_count * g.last_count;
+    g.parts = ((uint64_t)g.count * 4 <= two) ? 2 : 3;
+    g.space = (unsigned __int128)two * (g.parts == 3 ? (uint64_t)g.last_count : 1);
+    if (g.count < 1 || (unsigned __int128)g.count > g.space) {
+        printf("Σφάλμα: το πλήθος πρέπει να είναι από 1 έως %llu\n", (unsigned long long)g.space);
+        return 1;
+    }
+    if (g.dist == DIST_ZIPF)
+        build_zipf(&g, g.parts == 3 ? (uint64_t)g.last_count * g.last_count : (uint64_t)g.last_count);
+
+    int bits = 1;
+    while (bits < 64 && ((uint64_t)1 << bits) < (uint64_t)g.count)
+        bits++;
+    g.half_bits = (bits + 1) / 2;
+    g.half_mask = ((uint64_t)1 << g.half_bits) - 1;
+
+    /* Δυαδική μορφή: μία στήλη ανά πέρασμα, χωρίς νήματα */
+    if (binary) {
+        uint64_t bytes = write_binary(out_path, (uint64_t)g.count, g.states, g.state_count, generator_source, &g);
+        free(g.zipf_start);
+        if (!bytes)
+            return 1;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+        printf("Δημιουργήθηκαν %lld εγγραφές πολιτών στο %s (δυαδική μορφή, %s, seed %llu)\n",
+               g.count, out_path, dist_names[g.dist], (unsigned long long)g.seed);
+        printf("%.2f s, %.1f MB/s\n", secs, secs > 0 ? bytes / 1e6 / secs : 0.0);
+        return 0;
+    }
 
     /* Δημιουργία citizens.txt */
-    srand((unsigned int)time(NULL));
-    fp = fopen("citizens.txt", "w");
-    if (!fp) {
-        printf("Σφάλμα: δεν μπορεί να δημιουργηθεί το citizens.txt\n");
+    g.out = fopen(out_path, "w");
+    if (!g.out) {
+        printf("Σφάλμα: δεν μπορεί να δημιουργηθεί το %s\n", out_path);
         return 1;
     }
+    g.blocks = (g.count + GEN_BLOCK - 1) / GEN_BLOCK;
+    g.next_block = 0;
+    pthread_mutex_init(&g.lock, NULL);
+    pthread_cond_init(&g.turn, NULL);
 
-    for (int i = 0; i < name_count; i++) {
-        int age = (rand() % 100) + 1;            /* [1, 100] */
-        int income = rand() % 1000001;            /* [0, 1000000] */
-        int state_idx = rand() % state_count;
-        fprintf(fp, "%s,%d,%s,%d\n", names[i], age, states[state_idx], income);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    Worker workers[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    for (int t = 0; t < g.threads; t++) {
+        workers[t].g = &g;
+        workers[t].id = t;
     }
+    if (g.threads == 1) {
+        worker_run(&workers[0]);
+    } else {
+        for (int t = 0; t < g.threads; t++)
+            pthread_create(&tids[t], NULL, worker_run, &workers[t]);
+        for (int t = 0; t < g.threads; t++)
+            pthread_join(tids[t], NULL);
+    }
+    long bytes = ftell(g.out);
+    fclose(g.out);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
 
-    fclose(fp);
-    printf("Δημιουργήθηκαν %d εγγραφές πολιτών στο citizens.txt\n", name_count);
+    pthread_mutex_destroy(&g.lock);
+    pthread_cond_destroy(&g.turn);
+    free(g.zipf_start);
+
+    printf("Δημιουργήθηκαν %lld εγγραφές πολιτών στο %s (%s, seed %llu, %d νήματα)\n",
+           g.count, out_path, dist_names[g.dist], (unsigned long long)g.seed, g.threads);
+    printf("%.2f s, %.1f MB/s\n", secs, secs > 0 ? bytes / 1e6 / secs : 0.0);
     return 0;
 }
@@ -14,6 +14,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
 
 /* Δομή πολίτη */
 typedef struct {
@@ -23,32 +25,187 @@ typedef struct {
     int annual_income;
 } Citizen;
 
-/* Δομή κόμβου δέντρου */
+/* Δομή κόμβου δέντρου - τα πεδία της αναζήτησης (key, παιδιά) προηγούνται
+ * ώστε να βρίσκονται στην ίδια cache line με την αρχή του ονόματος */
 typedef struct Node {
-    Citizen data;
+    uint64_t key; /* Πρόθεμα 8 bytes του full_name */
     struct Node *left;
     struct Node *right;
     struct Node *parent;
     int height;
+    int size;   /* Κόμβοι του υποδέντρου (για rank/select) - 0 στον NIL */
     char color; /* 'R' = Κόκκινο, 'B' = Μαύρο */
+    Citizen data;
 } Node;
 
+/* ---------- Κλειδιά σύγκρισης ---------- */
+
+/* Κάθε κόμβος κρατά τα πρώτα 8 bytes του full_name ως big-endian ακέραιο.
+ * Η σύγκριση ακεραίων δίνει την ίδια διάταξη με την strcmp, οπότε η strcmp
+ * καλείται (από το 9ο byte) μόνο όταν τα προθέματα ταυτίζονται. */
+static inline uint64_t key_prefix(const char *name) {
+    uint64_t k = 0;
+    int i = 0;
+    for (; i < 8 && name[i]; i++)
+        k = (k << 8) | (unsigned char)name[i];
+    return i ? k << (8 * (8 - i)) : 0;
+}
+
+static inline int key_cmp(uint64_t ka, const char *a, uint64_t kb, const char *b) {
+    if (ka != kb)
+        return ka < kb ? -1 : 1;
+    if ((ka & 0xFF) == 0)
+        return 0; /* όνομα μικρότερο των 8 bytes: ίσα */
+    return strcmp(a + 8, b + 8);
+}
+
+/* ---------- Δεξαμενή κόμβων (arena) ---------- */
+
+/* Οι κόμβοι μπορούν να δεσμεύονται από μια arena: κόβονται διαδοχικά από
+ * slabs του 1 MiB, οι διαγραμμένοι κόμβοι μπαίνουν σε free list και όλο
+ * το δέντρο ελευθερώνεται με pool_reset/pool_destroy χωρίς διάσχιση. */
+
+#define POOL_SLAB_BYTES (1u << 20)
+#define POOL_SLAB_HEADER 64
+
+typedef struct PoolSlab {
+    struct PoolSlab *next;
+} PoolSlab;
+
+typedef struct {
+    size_t node_size;
+    PoolSlab *head, *cur;   /* λίστα slabs και τρέχον slab */
+    char *bump, *end;       /* ελεύθερη περιοχή τρέχοντος slab */
+    void *free_list;        /* κόμβοι που επιστράφηκαν με pool_free */
+    size_t live, slabs;
+} NodePool;
+
+/* Αρχικοποίηση arena για κόμβους μεγέθους node_size */
+void pool_init(NodePool *p, size_t node_size) {
+    memset(p, 0, sizeof(*p));
+    p->node_size = (node_size + 7) & ~(size_t)7;
+}
+
+/* Μετάβαση στο επόμενο slab (επαναχρησιμοποίηση μετά από reset ή νέο) */
+static int pool_next_slab(NodePool *p) {
+    PoolSlab *s = p->cur ? p->cur->next : p->head;
+    if (!s) {
+        s = (PoolSlab*)malloc(POOL_SLAB_BYTES);
+        if (!s)
+            return 0;
+        s->next = NULL;
+        if (p->cur)
+            p->cur->next = s;
+        else
+            p->head = s;
+        p->slabs++;
+    }
+    p->cur = s;
+    p->bump = (char*)s + POOL_SLAB_HEADER;
+    p->end = (char*)s + POOL_SLAB_BYTES;
+    return 1;
+}
+
+/* Δέσμευση κόμβου: πρώτα από τη free list, αλλιώς από το τρέχον slab */
+void* pool_alloc(NodePool *p) {
+    void *n = p->free_list;
+    if (n) {
+        p->free_list = *(void**)n;
+        p->live++;
+        return n;
+    }
+    if ((size_t)(p->end - p->bump) < p->node_size && !pool_next_slab(p))
+        return NULL;
+    n = p->bump;
+    p->bump += p->node_size;
+    p->live++;
+    return n;
+}
+
+/* Επιστροφή κόμβου στη free list */
+void pool_free(NodePool *p, void *n) {
+    *(void**)n = p->free_list;
+    p->free_list = n;
+    p->live--;
+}
+
+/* Ελευθέρωση όλων των κόμβων - τα slabs κρατιούνται για επαναχρησιμοποίηση */
+void pool_reset(NodePool *p) {
+    p->cur = NULL;
+    p->bump = p->end = NULL;
+    p->free_list = NULL;
+    p->live = 0;
+}
+
+/* Επιστροφή όλων των slabs στο σύστημα */
+void pool_destroy(NodePool *p) {
+    PoolSlab *s = p->head;
+    while (s) {
+        PoolSlab *next = s->next;
+        free(s);
+        s = next;
+    }
+    pool_init(p, p->node_size);
+}
+
+/* Ενεργή arena του δέντρου (NULL = malloc/free) */
+static NodePool *node_pool = NULL;
+
+/* Επιλογή arena για τις επόμενες εισαγωγές/διαγραφές */
+void use_node_pool(NodePool *pool) {
+    node_pool = pool;
+}
+
+/* Λογιστική μνήμης για κόμβους με malloc: ζωντανοί κόμβοι και bytes.
+ * Με arena τα ίδια στοιχεία δίνουν τα live, node_size και slabs της NodePool. */
+static size_t live_nodes = 0;
+static size_t live_bytes = 0;
+
+/* Επιστρέφει το πλήθος και τα bytes των κόμβων που δεν έχουν ελευθερωθεί */
+void tree_memory(size_t *nodes, size_t *bytes) {
+    *nodes = live_nodes;
+    *bytes = live_bytes;
+}
+
+static void* node_alloc(size_t size) {
+    if (node_pool)
+        return pool_alloc(node_pool);
+    void *n = malloc(size);
+    if (n) {
+        live_nodes++;
+        live_bytes += size;
+    }
+    return n;
+}
+
+static void node_free(void *n) {
+    if (node_pool) {
+        pool_free(node_pool, n);
+        return;
+    }
+    live_nodes--;
+    live_bytes -= sizeof(Node);
+    free(n);
+}
+
 /* Φρουρός NIL κόμβος - αντικαθιστά τα NULL φύλλα */
-static Node NIL_NODE = {{""}, NULL, NULL, NULL, 0, 'B'};
+static Node NIL_NODE = {.color = 'B'};
 static Node *NIL = &NIL_NODE;
 
-/* Δημιουργία νέου κόμβου (κόκκινος αρχικά) */
-Node* create_node(Citizen data) {
-    Node *node = (Node*)malloc(sizeof(Node));
+/* Δημιουργία νέου κόμβου (κόκκινος αρχικά) - η εγγραφή αντιγράφεται εδώ */
+Node* create_node(const Citizen *data) {
+    Node *node = (Node*)node_alloc(sizeof(Node));
     if (!node) {
         printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
         return NULL;
     }
-    node->data = data;
+    node->key = key_prefix(data->full_name);
+    node->data = *data;
     node->left = NIL;
     node->right = NIL;
     node->parent = NIL;
     node->height = 1;
+    node->size = 1;
     node->color = 'R'; /* Νέος κόμβος πάντα κόκκινος */
     return node;
 }
@@ -68,6 +225,8 @@ Node* rotate_left(Node *root, Node *x) {
         x->parent->right = y;
     y->left = x;
     x->parent = y;
+    y->size = x->size;
+    x->size = x->left->size + x->right->size + 1;
     return root;
 }
 
@@ -86,6 +245,8 @@ Node* rotate_right(Node *root, Node *y) {
         y->parent->right = x;
     x->right = y;
     y->parent = x;
+    x->size = y->size;
+    y->size = y->left->size + y->right->size + 1;
     return root;
 }
 
@@ -135,32 +296,36 @@ Node* insert_fixup(Node *root, Node *z) {
 }
 
 /* Εισαγωγή κόμβου στο Red-Black δέντρο */
-Node* insert_rbt(Node *root, Citizen data) {
-    Node *z = create_node(data);
+Node* insert_rbt(Node *root, const Citizen *data) {
+    uint64_t key = key_prefix(data->full_name);
     Node *y = NIL;
     Node *x = (root == NULL) ? NIL : root;
 
+    int cmp = 0;
+
     /* Εύρεση θέσης εισαγωγής (όπως BST) */
     while (x != NIL) {
         y = x;
-        int cmp = strcmp(data.full_name, x->data.full_name);
+        cmp = key_cmp(key, data->full_name, x->key, x->data.full_name);
         if (cmp < 0)
             x = x->left;
         else if (cmp > 0)
             x = x->right;
-        else {
-            free(z); /* Διπλότυπο - δεν εισάγεται */
-            return root;
-        }
+        else
+            return root; /* Διπλότυπο - δεν εισάγεται */
     }
 
+    /* Ο κόμβος δημιουργείται μόνο αφού βρεθεί θέση (όχι για διπλότυπα) */
+    Node *z = create_node(data);
     z->parent = y;
     if (y == NIL)
         root = z;
-    else if (strcmp(data.full_name, y->data.full_name) < 0)
+    else if (cmp < 0)
         y->left = z;
     else
         y->right = z;
+    for (Node *p = y; p != NIL; p = p->parent)
+        p->size++;
 
     /* Διόρθωση ιδιοτήτων */
     return insert_fixup(root, z);
@@ -248,17 +413,24 @@ Node* delete_fixup(Node *root, Node *x) {
 }
 
 /* Διαγραφή κόμβου από το Red-Black δέντρο */
-Node* delete_rbt(Node *root, char *name) {
+Node* delete_rbt(Node *root, const char *name) {
     /* Εύρεση κόμβου */
+    uint64_t key = key_prefix(name);
     Node *z = (root == NULL) ? NIL : root;
     while (z != NIL) {
-        int cmp = strcmp(name, z->data.full_name);
+        int cmp = key_cmp(key, name, z->key, z->data.full_name);
         if (cmp == 0) break;
         z = (cmp < 0) ? z->left : z->right;
     }
     if (z == NIL)
         return root; /* Δεν βρέθηκε */
 
+    /* Από τη θέση του φεύγει ο z ή, με δύο παιδιά, ο διάδοχός του: όλοι οι
+     * πρόγονοί του χάνουν έναν κόμβο από το υποδέντρο τους */
+    Node *removed = (z->left == NIL || z->right == NIL) ? z : find_min(z->right);
+    for (Node *p = removed->parent; p != NIL; p = p->parent)
+        p->size--;
+
     Node *y = z;
     Node *x;
     char y_original_color = y->color;
@@ -271,7 +443,7 @@ Node* delete_rbt(Node *root, char *name) {
         root = transplant(root, z, z->left);
     } else {
         /* Κόμβος με δύο παιδιά */
-        y = find_min(z->right);
+        y = removed;
         y_original_color = y->color;
         x = y->right;
         if (y->parent == z) {
@@ -285,8 +457,9 @@ Node* delete_rbt(Node *root, char *name) {
         y->left = z->left;
         y->left->parent = y;
         y->color = z->color;
+        y->size = z->size;
     }
-    free(z);
+    node_free(z);
 
     /* Διόρθωση αν διαγράφηκε μαύρος κόμβος */
     if (y_original_color == 'B')
@@ -295,18 +468,138 @@ Node* delete_rbt(Node *root, char *name) {
     return root;
 }
 
-/* Αναζήτηση κόμβου με βάση το όνομα */
-Node* search(Node *root, char *name) {
-    if (root == NULL || root == NIL)
+/* Αναζήτηση κόμβου με βάση το όνομα (επαναληπτική) */
+Node* search(Node *root, const char *name) {
+    uint64_t key = key_prefix(name);
+
+    while (root != NULL && root != NIL) {
+        int cmp = key_cmp(key, name, root->key, root->data.full_name);
+        if (cmp == 0)
+            return root;
+        root = (cmp < 0) ? root->left : root->right;
+    }
+    return NULL;
+}
+
+/* ---------- Ομαδική αναζήτηση ---------- */
+
+#define BATCH_GROUP 16     /* αναζητήσεις σε εξέλιξη ταυτόχρονα */
+
+typedef struct {
+    Node *node;
+    uint64_t key;
+    int idx;
+} BatchState;
+
+/* Η επόμενη αναζήτηση στη θέση st - 0 αν δεν υπάρχουν άλλες */
+static int batch_next(BatchState *st, Node *root, const char *const *names, int n, int *next) {
+    if (*next >= n)
+        return 0;
+    st->node = root;
+    st->key = key_prefix(names[*next]);
+    st->idx = (*next)++;
+    return 1;
+}
+
+/* Ομαδική αναζήτηση με AMAC (όπως η rbt_search_batch του benchmark.c):
+ * out[i] ο κόμβος του names[i] ή NULL - ο NIL δεν επιστρέφεται ποτέ */
+void search_batch(Node *root, const char *const *names, int n, Node **out) {
+    BatchState st[BATCH_GROUP];
+    int next = 0, active = 0;
+    if (root == NIL)
+        root = NULL;
+    while (active < BATCH_GROUP && batch_next(&st[active], root, names, n, &next))
+        active++;
+
+    while (active > 0) {
+        for (int s = 0; s < active;) {
+            Node *x = st[s].node;
+            int cmp = 0;
+            if (x != NULL)
+                cmp = key_cmp(st[s].key, names[st[s].idx], x->key, x->data.full_name);
+            if (cmp != 0) {
+                x = (cmp < 0) ? x->left : x->right;
+                if (x == NIL)
+                    x = NULL;
+                __builtin_prefetch(x);
+                st[s++].node = x;
+                continue;
+            }
+            out[st[s].idx] = x;
+            if (!batch_next(&st[s], root, names, n, &next))
+                st[s] = st[--active];
+        }
+    }
+}
+
+/* ---------- Μαζική κατασκευή ---------- */
+
+/* Αλφαβητική σειρά και, για ίδια ονόματα, σειρά εμφάνισης στον πίνακα */
+static int compare_citizen_ptr(const void *a, const void *b) {
+    const Citizen *x = *(const Citizen* const*)a;
+    const Citizen *y = *(const Citizen* const*)b;
+    int cmp = strcmp(x->full_name, y->full_name);
+    if (cmp != 0)
+        return cmp;
+    return (x > y) - (x < y);
+}
+
+/* Ταξινόμηση (αν ο πίνακας δεν είναι ήδη ταξινομημένος) και αφαίρεση
+ * διπλοτύπων - κρατείται η πρώτη εμφάνιση, όπως στην εισαγωγή */
+static int sort_unique(Citizen citizens[], int count, Citizen ***out) {
+    Citizen **v = (Citizen**)malloc((count > 0 ? count : 1) * sizeof(Citizen*));
+    int sorted = 1;
+    for (int i = 0; i < count; i++) {
+        v[i] = &citizens[i];
+        if (i > 0 && strcmp(citizens[i - 1].full_name, citizens[i].full_name) > 0)
+            sorted = 0;
+    }
+    if (!sorted)
+        qsort(v, count, sizeof(Citizen*), compare_citizen_ptr);
+
+    int m = 0;
+    for (int i = 0; i < count; i++)
+        if (m == 0 || strcmp(v[m - 1]->full_name, v[i]->full_name) != 0)
+            v[m++] = v[i];
+    *out = v;
+    return m;
+}
+
+/* Ρίζα κάθε υποδέντρου είναι το μεσαίο στοιχείο, άρα όλα τα φύλλα βρίσκονται
+ * στα δύο τελευταία επίπεδα. Οι κόμβοι του βαθύτερου επιπέδου (red_depth)
+ * γίνονται κόκκινοι και οι υπόλοιποι μαύροι, ώστε κάθε μονοπάτι προς NIL να
+ * περνά από τον ίδιο αριθμό μαύρων κόμβων. */
+static Node* build_range(Citizen **v, int lo, int hi, int depth, int red_depth, Node *parent) {
+    if (lo > hi)
+        return NIL;
+    int mid = lo + (hi - lo) / 2;
+    Node *node = create_node(v[mid]);
+    node->parent = parent;
+    node->color = (depth == red_depth) ? 'R' : 'B';
+    node->left = build_range(v, lo, mid - 1, depth + 1, red_depth, node);
+    node->right = build_range(v, mid + 1, hi, depth + 1, red_depth, node);
+    node->height = (node->left->height > node->right->height ? node->left->height : node->right->height) + 1;
+    node->size = hi - lo + 1;
+    return node;
+}
+
+/* Κατασκευή έγκυρου Red-Black δέντρου (χρώματα και γονείς) από πίνακα
+ * πολιτών σε O(n) μετά την ταξινόμηση */
+Node* build_rbt(Citizen citizens[], int count) {
+    Citizen **v;
+    int m = sort_unique(citizens, count, &v);
+    if (m == 0) {
+        free(v);
         return NULL;
+    }
 
-    int cmp = strcmp(name, root->data.full_name);
-    if (cmp == 0)
-        return root;
-    else if (cmp < 0)
-        return search(root->left, name);
-    else
-        return search(root->right, name);
+    /* Ύψος του ισοζυγισμένου δέντρου - η ρίζα (βάθος 0) μένει πάντα μαύρη */
+    int h = 0;
+    while (((1LL << h) - 1) < m)
+        h++;
+    Node *root = build_range(v, 0, m - 1, 0, (h > 1) ? h - 1 : -1, NIL);
+    free(v);
+    return root;
 }
 
 /* Inorder traversal - εκτύπωση σε αλφαβητική σειρά */
@@ -331,9 +624,401 @@ void traversal_to_file(Node *root, FILE *fp) {
 
 /* Απελευθέρωση μνήμης δέντρου */
 void free_tree(Node *root) {
+    /* Χωρίς αναδρομή: δεξιές περιστροφές ως τη δεξιά ράχη, όπως στο bst.c.
+     * Οι δείκτες γονέα δεν χρειάζονται πια και δεν ενημερώνονται */
+    while (root != NULL && root != NIL) {
+        Node *next = root->left;
+        if (next != NULL && next != NIL) {
+            root->left = next->right;
+            next->right = root;
+        } else {
+            next = root->right;
+            node_free(root);
+        }
+        root = next;
+    }
+}
+
+/* ---------- Διατεταγμένη προσπέλαση ---------- */
+
+/* Οι κόμβοι έχουν δείκτη γονέα, οπότε ο iterator είναι απλώς ο επόμενος
+ * κόμβος: ο διάδοχος βρίσκεται κατεβαίνοντας στο αριστερότερο του δεξιού
+ * υποδέντρου ή ανεβαίνοντας μέχρι τον πρώτο πρόγονο από αριστερά - O(1)
+ * αποσβεσμένο ανά βήμα, χωρίς στοίβα. */
+
+/* Πρώτος κόμβος με όνομα >= lo (NULL = ο μικρότερος) σε O(log n) ή NIL */
+Node* iter_seek(Node *root, const char *lo) {
+    Node *found = NIL;
+    uint64_t key = lo ? key_prefix(lo) : 0;
+
+    while (root != NULL && root != NIL) {
+        if (lo == NULL || key_cmp(key, lo, root->key, root->data.full_name) <= 0) {
+            found = root;
+            root = root->left;
+        } else {
+            root = root->right;
+        }
+    }
+    return found;
+}
+
+/* Διάδοχος σε αλφαβητική σειρά ή NIL μετά τον τελευταίο */
+Node* iter_next(Node *node) {
+    if (node->right != NIL)
+        return find_min(node->right);
+
+    Node *parent = node->parent;
+    while (parent != NIL && node == parent->right) {
+        node = parent;
+        parent = parent->parent;
+    }
+    return parent;
+}
+
+/* Αντιγραφή των εγγραφών με lo <= όνομα <= hi (NULL = χωρίς όριο) στο out,
+ * έως limit - επιστρέφει το πλήθος τους */
+int range_query(Node *root, const char *lo, const char *hi, Citizen *out, int limit) {
+    int count = 0;
+    uint64_t key = hi ? key_prefix(hi) : 0;
+
+    for (Node *node = iter_seek(root, lo); count < limit && node != NIL; node = iter_next(node)) {
+        if (hi && key_cmp(key, hi, node->key, node->data.full_name) < 0)
+            break;
+        out[count++] = node->data;
+    }
+    return count;
+}
+
+/* Αντιγραφή των εγγραφών που το όνομά τους αρχίζει από prefix στο out, έως
+ * limit - επιστρέφει το πλήθος τους */
+int prefix_query(Node *root, const char *prefix, Citizen *out, int limit) {
+    int count = 0;
+    size_t len = strlen(prefix);
+
+    for (Node *node = iter_seek(root, prefix); count < limit && node != NIL; node = iter_next(node)) {
+        if (strncmp(node->data.full_name, prefix, len) != 0)
+            break;
+        out[count++] = node->data;
+    }
+    return count;
+}
+
+/* ---------- Στατιστικά διάταξης ---------- */
+
+/* Κάθε κόμβος κρατά το μέγεθος του υποδέντρου του (ο NIL έχει 0), οπότε η
+ * θέση ενός ονόματος και ο k-οστός κόμβος βρίσκονται με μία κατάβαση, σε
+ * O(log n). */
+
+/* Πλήθος ονομάτων < name ή, με inclusive = 1, <= name */
+static int count_below(Node *root, const char *name, int inclusive) {
+    uint64_t key = key_prefix(name);
+    int count = 0;
+
+    while (root != NULL && root != NIL) {
+        int cmp = key_cmp(key, name, root->key, root->data.full_name);
+        if (cmp == 0)
+            return count + root->left->size + inclusive;
+        if (cmp < 0) {
+            root = root->left;
+        } else {
+            count += root->left->size + 1;
+            root = root->right;
+        }
+    }
+    return count;
+}
+
+/* Θέση του name σε αλφαβητική σειρά (0 = πρώτο) - αν δεν υπάρχει, η θέση
+ * στην οποία θα έμπαινε */
+int rank(Node *root, const char *name) {
+    return count_below(root, name, 0);
+}
+
+/* Ο k-οστός κόμβος σε αλφαβητική σειρά (k από 0) ή NULL αν k εκτός ορίων.
+ * Το εκατοστημόριο p είναι select_kth(root, p * (n - 1) / 100). */
+Node* select_kth(Node *root, int k) {
+    while (root != NULL && root != NIL) {
+        int left = root->left->size;
+        if (k == left)
+            return root;
+        if (k < left) {
+            root = root->left;
+        } else {
+            k -= left + 1;
+            root = root->right;
+        }
+    }
+    return NULL;
+}
+
+/* Πλήθος εγγραφών με lo <= όνομα <= hi */
+int count_range(Node *root, const char *lo, const char *hi) {
+    int count = count_below(root, hi, 1) - count_below(root, lo, 0);
+    return count > 0 ? count : 0;
+}
+
+/* ---------- Στιγμιότυπο σε αρχείο ---------- */
+
+/* Το δέντρο αποθηκεύεται χωρίς δείκτες: οι κόμβοι αριθμούνται σε in-order
+ * σειρά και παιδιά/γονέας είναι θέσεις 32-bit (SNAP_NONE για κενό). Το αρχείο
+ * έχει header 64 bytes (έκδοση, πλήθη, αθροίσματα ελέγχου), τον πίνακα
+ * κόμβων και, ευθυγραμμισμένο στα 64 bytes, τον πίνακα εγγραφών. Είναι ίδια
+ * μορφή με τα στιγμιότυπα του benchmark.c (σειρά bytes του host), οπότε η
+ * φόρτωση ξαναστήνει το δέντρο σε O(n) χωρίς συγκρίσεις και περιστροφές. */
+
+#define SNAP_MAGIC "CITZSNP1"
+#define SNAP_VERSION 1
+#define SNAP_KIND 2 /* Red-Black */
+#define SNAP_NONE UINT32_MAX
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint64_t count;
+    uint32_t root;
+    uint32_t height;
+    uint32_t node_size;
+    uint32_t record_size;
+    uint64_t file_size;
+    uint64_t data_checksum;   /* όλα τα bytes μετά το header */
+    uint64_t header_checksum; /* τα πρώτα 56 bytes του header */
+} SnapHeader;
+
+typedef struct {
+    uint64_t key;
+    uint32_t left, right, parent;
+    uint8_t height;
+    char color;
+    uint16_t pad;
+} SnapNode;
+
+static uint64_t snap_records_offset(uint64_t count) {
+    return (sizeof(SnapHeader) + count * sizeof(SnapNode) + 63) & ~(uint64_t)63;
+}
+
+/* Άθροισμα ελέγχου ανά λέξη 8 bytes (ίδιο με το generate_citizens.c) */
+static uint64_t snap_checksum(const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char*)data;
+    uint64_t h = 0x9E3779B97F4A7C15ULL, w;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        memcpy(&w, p + i, 8);
+        h ^= w * 0xBF58476D1CE4E5B9ULL;
+        h = ((h << 31) | (h >> 33)) * 0x94D049BB133111EBULL;
+    }
+    w = 0;
+    memcpy(&w, p + i, len - i);
+    h ^= w * 0xBF58476D1CE4E5B9ULL;
+    h = ((h << 31) | (h >> 33)) * 0x94D049BB133111EBULL;
+    h ^= len;
+    h += 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+static uint64_t count_nodes(Node *root) {
     if (root == NULL || root == NIL)
-        return;
-    free_tree(root->left);
-    free_tree(root->right);
-    free(root);
+        return 0;
+    return 1 + count_nodes(root->left) + count_nodes(root->right);
+}
+
+/* In-order γέμισμα των πινάκων - επιστρέφει τη θέση του κόμβου */
+static uint32_t snap_fill(Node *n, SnapNode *nodes, Citizen *recs, uint32_t *next, uint32_t depth, uint32_t *levels) {
+    if (n == NULL || n == NIL)
+        return SNAP_NONE;
+    uint32_t l = snap_fill(n->left, nodes, recs, next, depth + 1, levels);
+    uint32_t i = (*next)++;
+    uint32_t r = snap_fill(n->right, nodes, recs, next, depth + 1, levels);
+
+    nodes[i].key = n->key;
+    nodes[i].left = l;
+    nodes[i].right = r;
+    nodes[i].parent = SNAP_NONE; /* τον ορίζει ο γονέας */
+    nodes[i].height = (uint8_t)(n->height > 255 ? 255 : n->height);
+    nodes[i].color = n->color;
+    recs[i] = n->data;
+    if (l != SNAP_NONE)
+        nodes[l].parent = i;
+    if (r != SNAP_NONE)
+        nodes[r].parent = i;
+    if (depth + 1 > *levels)
+        *levels = depth + 1;
+    return i;
+}
+
+/* Αποθήκευση του δέντρου στο path (μέσω path.tmp και μετονομασίας, ώστε ένα
+ * προηγούμενο στιγμιότυπο να μη μείνει ποτέ μισό). Επιστρέφει 0 ή -1. */
+int save_rbt(Node *root, const char *path) {
+    uint64_t count = count_nodes(root);
+    if (count >= SNAP_NONE) {
+        printf("Σφάλμα: πάρα πολλοί κόμβοι για στιγμιότυπο\n");
+        return -1;
+    }
+    uint64_t rec_off = snap_records_offset(count);
+    size_t size = (size_t)(rec_off + count * sizeof(Citizen));
+    unsigned char *buf = (unsigned char*)calloc(1, size);
+    if (!buf) {
+        printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
+        return -1;
+    }
+
+    SnapHeader h;
+    memset(&h, 0, sizeof(h));
+    uint32_t next = 0, levels = 0;
+    h.root = snap_fill(root, (SnapNode*)(buf + sizeof(SnapHeader)), (Citizen*)(buf + rec_off), &next, 0, &levels);
+    memcpy(h.magic, SNAP_MAGIC, 8);
+    h.version = SNAP_VERSION;
+    h.kind = SNAP_KIND;
+    h.count = count;
+    h.height = levels;
+    h.node_size = sizeof(SnapNode);
+    h.record_size = sizeof(Citizen);
+    h.file_size = size;
+    h.data_checksum = snap_checksum(buf + sizeof(SnapHeader), size - sizeof(SnapHeader));
+    h.header_checksum = snap_checksum(&h, offsetof(SnapHeader, header_checksum));
+    memcpy(buf, &h, sizeof(h));
+
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *fp = fopen(tmp, "wb");
+    int ok = fp != NULL && fwrite(buf, 1, size, fp) == size;
+    if (fp != NULL && fclose(fp) != 0)
+        ok = 0;
+    free(buf);
+    if (!ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        printf("Σφάλμα: αποτυχία εγγραφής του %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/* Ανασύσταση από τη ρίζα - κάθε σύνδεσμος ελέγχεται (θέση εντός ορίων, ίδιος
+ * γονέας και στις δύο πλευρές, βάθος έως το ύψος), άρα κάθε κόμβος
+ * επισκέπτεται το πολύ μία φορά */
+/* Ανώτατο ύψος ισορροπημένου δέντρου n κόμβων: 2 log2(n+1) + 2, με
+ * περιθώριο πάνω από το όριο 2 log2(n+1) του Red-Black. Ένα μεγαλύτερο ύψος
+ * απορρίπτεται πριν την ανασύσταση, οπότε η αναδρομή της μένει ρηχή */
+static uint32_t snap_max_height(uint64_t count) {
+    uint32_t log2 = 0;
+    while ((count + 1) >> (log2 + 1))
+        log2++;
+    return 2 * log2 + 2;
+}
+
+/* Οι κόμβοι είναι αριθμημένοι in-order, άρα οι εγγραφές πρέπει να είναι
+ * αυστηρά αύξουσες, με τερματισμένα strings και σωστό πρόθεμα - έλεγχος σε
+ * O(n) πριν την ανασύσταση */
+static int snap_order_ok(const SnapNode *nodes, const Citizen *recs, uint64_t count) {
+    for (uint64_t i = 0; i < count; i++) {
+        const Citizen *c = &recs[i];
+        if (!memchr(c->full_name, 0, sizeof(c->full_name)) || !memchr(c->state, 0, sizeof(c->state)))
+            return 0;
+        if (nodes[i].key != key_prefix(c->full_name))
+            return 0;
+        if (i > 0 && key_cmp(nodes[i - 1].key, recs[i - 1].full_name, nodes[i].key, c->full_name) >= 0)
+            return 0;
+    }
+    return 1;
+}
+
+static Node* snap_thaw(const SnapHeader *h, const SnapNode *nodes, const Citizen *recs, uint32_t i,
+                       uint32_t parent, Node *up, uint32_t lo, uint32_t hi, uint32_t depth,
+                       uint64_t *made, int *black, int *bad) {
+    *black = 0;
+    if (i == SNAP_NONE || *bad)
+        return NIL;
+    if (i < lo || i >= hi || nodes[i].parent != parent || depth >= h->height) {
+        *bad = 1;
+        return NIL;
+    }
+    Node *node = create_node(&recs[i]);
+    if (!node) {
+        *bad = 1;
+        return NIL;
+    }
+    node->parent = up;
+    node->height = nodes[i].height;
+    node->color = (nodes[i].color == 'R') ? 'R' : 'B';
+    (*made)++;
+    int bl, br;
+    node->left = snap_thaw(h, nodes, recs, nodes[i].left, i, node, lo, i, depth + 1, made, &bl, bad);
+    node->right = snap_thaw(h, nodes, recs, nodes[i].right, i, node, i + 1, hi, depth + 1, made, &br, bad);
+    node->size = node->left->size + node->right->size + 1;
+    /* Κόκκινος κόμβος χωρίς κόκκινο παιδί, ίδιο μαύρο ύψος και στις δύο πλευρές */
+    if (bl != br || (node->color == 'R' && (node->left->color == 'R' || node->right->color == 'R')))
+        *bad = 1;
+    *black = bl + (node->color == 'B');
+    return node;
+}
+
+/* Φόρτωση στιγμιοτύπου: έλεγχος header, μεγέθους και αθροίσματος ελέγχου,
+ * και μετά το δέντρο στο *root. Επιστρέφει το πλήθος κόμβων ή -1. */
+int load_rbt(const char *path, Node **root) {
+    *root = NULL;
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        printf("Σφάλμα: δεν ανοίγει το %s\n", path);
+        return -1;
+    }
+    unsigned char *buf = NULL;
+    long size = -1;
+    if (fseek(fp, 0, SEEK_END) == 0)
+        size = ftell(fp);
+    if (size >= (long)sizeof(SnapHeader) && fseek(fp, 0, SEEK_SET) == 0) {
+        buf = (unsigned char*)malloc((size_t)size);
+        if (buf && fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+            free(buf);
+            buf = NULL;
+        }
+    }
+    fclose(fp);
+    if (!buf) {
+        printf("Σφάλμα: το %s δεν διαβάζεται\n", path);
+        return -1;
+    }
+
+    SnapHeader h;
+    memcpy(&h, buf, sizeof(h));
+    const char *why = NULL;
+    if (memcmp(h.magic, SNAP_MAGIC, 8) != 0 || h.kind != SNAP_KIND)
+        why = "δεν είναι στιγμιότυπο Red-Black";
+    else if (h.version != SNAP_VERSION)
+        why = "άγνωστη έκδοση μορφής";
+    else if (snap_checksum(&h, offsetof(SnapHeader, header_checksum)) != h.header_checksum)
+        why = "αλλοιωμένο header";
+    else if (h.node_size != sizeof(SnapNode) || h.record_size != sizeof(Citizen) || h.count > INT32_MAX)
+        why = "μη έγκυρο header";
+    else if (h.height > snap_max_height(h.count))
+        why = "ύψος μεγαλύτερο από ισορροπημένου δέντρου";
+    else if (h.file_size != (uint64_t)size || snap_records_offset(h.count) + h.count * sizeof(Citizen) != h.file_size)
+        why = "λάθος μέγεθος αρχείου";
+    else if (snap_checksum(buf + sizeof(SnapHeader), (size_t)size - sizeof(SnapHeader)) != h.data_checksum)
+        why = "λάθος άθροισμα ελέγχου δεδομένων";
+
+    uint64_t made = 0;
+    int bad = 0;
+    if (!why) {
+        const SnapNode *nodes = (const SnapNode*)(buf + sizeof(SnapHeader));
+        const Citizen *recs = (const Citizen*)(buf + snap_records_offset(h.count));
+        int black;
+        if (!snap_order_ok(nodes, recs, h.count))
+            why = "εγγραφές εκτός σειράς";
+        else
+            *root = snap_thaw(&h, nodes, recs, h.root, SNAP_NONE, NIL, 0, (uint32_t)h.count, 0, &made, &black, &bad);
+        if (*root == NIL)
+            *root = NULL;
+        if (!why && (bad || made != h.count || (*root && (*root)->color != 'B')))
+            why = "μη έγκυρη δομή δέντρου";
+    }
+    free(buf);
+    if (why) {
+        free_tree(*root);
+        *root = NULL;
+        printf("Σφάλμα: %s: %s\n", path, why);
+        return -1;
+    }
+    return (int)made;
 }
@@ -0,0 +1,448 @@
+/*
+ * skiplist.c
+ * Υλοποίηση Skip List χωρίς κλειδώματα (Harris, Fraser) με κλειδί το full_name
+ * Πολλά νήματα μπορούν να εισάγουν, να διαγράφουν και να αναζητούν ταυτόχρονα
+ *
+ * Ιδιότητες Skip List:
+ * 1. Το επίπεδο 0 περιέχει όλους τους κόμβους σε αλφαβητική σειρά
+ * 2. Κάθε ψηλότερο επίπεδο είναι υποσύνολο του αμέσως χαμηλότερου
+ * 3. Ο πύργος κάθε κόμβου έχει γεωμετρικό ύψος με p = 1/2
+ * 4. Ένας κόμβος ανήκει στο σύνολο όσο ο δείκτης του επιπέδου 0 δεν είναι σημαδεμένος
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* Δομή πολίτη */
+typedef struct {
+    char full_name[100];
+    int age;
+    char state[50];
+    int annual_income;
+} Citizen;
+
+/* ---------- Κλειδιά σύγκρισης ---------- */
+
+/* Κάθε κόμβος κρατά τα πρώτα 8 bytes του full_name ως big-endian ακέραιο.
+ * Η σύγκριση ακεραίων δίνει την ίδια διάταξη με την strcmp, οπότε η strcmp
+ * καλείται (από το 9ο byte) μόνο όταν τα προθέματα ταυτίζονται. */
+static inline uint64_t key_prefix(const char *name) {
+    uint64_t k = 0;
+    int i = 0;
+    for (; i < 8 && name[i]; i++)
+        k = (k << 8) | (unsigned char)name[i];
+    return i ? k << (8 * (8 - i)) : 0;
+}
+
+static inline int key_cmp(uint64_t ka, const char *a, uint64_t kb, const char *b) {
+    if (ka != kb)
+        return ka < kb ? -1 : 1;
+    if ((ka & 0xFF) == 0)
+        return 0; /* όνομα μικρότερο των 8 bytes: ίσα */
+    return strcmp(a + 8, b + 8);
+}
+
+/* ---------- Δομές ---------- */
+
+/* Κάθε κόμβος έχει πύργο από next[] ύψους 1..SKIP_MAX_LEVEL και το χαμηλότερο
+ * bit κάθε δείκτη είναι σημάδι διαγραφής.
+ *
+ * Ένας κόμβος μπορεί να συνδεθεί σε ψηλό επίπεδο ενώ ήδη διαγράφεται, οπότε
+ * αποσύρεται μόνο όταν τελειώσουν και ο insert και ο delete (refs 2 -> 0):
+ * όποιος τελειώνει δεύτερος έχει δει ή κάνει skip_locate μετά την τελευταία
+ * σύνδεση, άρα ο κόμβος δεν είναι πια προσβάσιμος από κανένα επίπεδο.
+ *
+ * Ανακύκλωση με εποχές (EBR) και λίστα αποσυρμένων ανά νήμα: κάθε λειτουργία
+ * δηλώνει την καθολική εποχή στη θέση του νήματος. Ένας κόμβος παίρνει την
+ * εποχή τη στιγμή της απόσυρσης και ελευθερώνεται όταν όλες οι ενεργές θέσεις
+ * έχουν δηλώσει μεγαλύτερη. */
+#define SKIP_MAX_LEVEL 24           /* p = 1/2: αρκεί για ~16M κλειδιά */
+#define SKIP_MAX_THREADS 64
+#define SKIP_RECLAIM_BATCH 256      /* αποσυρμένοι ανά νήμα πριν από ανακύκλωση */
+
+typedef struct SkipNode {
+    uint64_t key;                   /* Πρόθεμα 8 bytes του full_name */
+    Citizen data;
+    int level;                      /* ύψος πύργου */
+    int refs;                       /* insert + delete που δεν έχουν τελειώσει */
+    uintptr_t next[];               /* bit 0 = σημάδι διαγραφής */
+} SkipNode;
+
+typedef struct {
+    void *ptr;
+    uint64_t epoch;
+} SkipRetired;
+
+/* Μία cache line ανά νήμα: η εποχή διαβάζεται από όλους, τα υπόλοιπα μόνο από
+ * το νήμα που κατέχει τη θέση */
+typedef struct {
+    uint64_t epoch;                 /* 0 = εκτός λειτουργίας */
+    int used;
+    uint64_t rng;
+    SkipRetired *limbo;
+    size_t limbo_len, limbo_cap;
+    char pad[64 - 6 * sizeof(uint64_t)];
+} SkipThread;
+
+typedef struct {
+    SkipNode *head;                 /* φρουρός με πύργο SKIP_MAX_LEVEL */
+    int level;                      /* ψηλότερο επίπεδο σε χρήση (μόνο αυξάνεται) */
+    char pad[64 - sizeof(SkipNode*) - sizeof(int)];
+    uint64_t epoch;                 /* καθολική εποχή, ξεκινά από 1 */
+    char pad2[64 - sizeof(uint64_t)];
+    SkipThread threads[SKIP_MAX_THREADS];
+} SkipList;
+
+#define SKIP_MARKED(p) ((p) & 1)
+
+static inline SkipNode* skip_ptr(uintptr_t p) {
+    return (SkipNode*)(p & ~(uintptr_t)1);
+}
+
+static inline uintptr_t skip_next(SkipNode *n, int i) {
+    return __atomic_load_n(&n->next[i], __ATOMIC_SEQ_CST);
+}
+
+static inline int skip_cas(uintptr_t *p, uintptr_t expected, uintptr_t desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/* ---------- Δημιουργία και νήματα ---------- */
+
+static SkipNode* skip_node_new(int level) {
+    SkipNode *n = (SkipNode*)malloc(sizeof(SkipNode) + level * sizeof(uintptr_t));
+    if (n == NULL) {
+        printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
+        return NULL;
+    }
+    n->level = level;
+    n->refs = 2;
+    return n;
+}
+
+/* Δημιουργία κενής λίστας - NULL αν αποτύχει η δέσμευση */
+SkipList* skip_create(void) {
+    void *mem;
+    if (posix_memalign(&mem, 64, sizeof(SkipList))) {
+        printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
+        return NULL;
+    }
+    SkipList *l = (SkipList*)memset(mem, 0, sizeof(SkipList));
+    l->head = skip_node_new(SKIP_MAX_LEVEL);
+    if (l->head == NULL) {
+        free(l);
+        return NULL;
+    }
+    for (int i = 0; i < SKIP_MAX_LEVEL; i++)
+        l->head->next[i] = 0;
+    l->level = 1;
+    l->epoch = 1;
+    return l;
+}
+
+/* Μία θέση ανά νήμα - όλες οι λειτουργίες παίρνουν τη θέση του νήματος.
+ * Επιστρέφει -1 αν όλες οι SKIP_MAX_THREADS θέσεις είναι πιασμένες. */
+int skip_thread_register(SkipList *l) {
+    for (int i = 0; i < SKIP_MAX_THREADS; i++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&l->threads[i].used, &expected, 1, 0, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED)) {
+            if (!l->threads[i].rng)
+                l->threads[i].rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Οι αποσυρμένοι της θέσης μένουν εκεί για τον επόμενο κάτοχο ή τη skip_destroy */
+void skip_thread_unregister(SkipList *l, int slot) {
+    __atomic_store_n(&l->threads[slot].used, 0, __ATOMIC_RELEASE);
+}
+
+/* Ό,τι βρεθεί ανάμεσα σε skip_enter και skip_exit μένει έγκυρο ως το skip_exit */
+void skip_enter(SkipList *l, int slot) {
+    __atomic_store_n(&l->threads[slot].epoch, __atomic_load_n(&l->epoch, __ATOMIC_SEQ_CST),
+                     __ATOMIC_SEQ_CST);
+}
+
+void skip_exit(SkipList *l, int slot) {
+    __atomic_store_n(&l->threads[slot].epoch, 0, __ATOMIC_RELEASE);
+}
+
+/* ---------- Ανακύκλωση κόμβων ---------- */
+
+/* Η εποχή προχωρά εδώ και όχι σε κάθε απόσυρση, ώστε ο κοινός μετρητής να
+ * αγγίζεται μία φορά ανά SKIP_RECLAIM_BATCH διαγραφές */
+static void skip_reclaim(SkipList *l, SkipThread *t) {
+    __atomic_fetch_add(&l->epoch, 1, __ATOMIC_SEQ_CST);
+    uint64_t min = UINT64_MAX;
+    for (int i = 0; i < SKIP_MAX_THREADS; i++) {
+        uint64_t e = __atomic_load_n(&l->threads[i].epoch, __ATOMIC_SEQ_CST);
+        if (e && e < min)
+            min = e;
+    }
+    size_t k = 0;
+    for (size_t i = 0; i < t->limbo_len; i++) {
+        if (t->limbo[i].epoch < min)
+            free(t->limbo[i].ptr);
+        else
+            t->limbo[k++] = t->limbo[i];
+    }
+    t->limbo_len = k;
+}
+
+/* Κάθε insert/delete αποσύρει το πολύ έναν κόμβο, οπότε η θέση του
+ * κρατείται πριν από την αλλαγή: έτσι η skip_retire δεν δεσμεύει ποτέ μνήμη
+ * και μια αποτυχία αναφέρεται ενώ η λίστα είναι ακόμη ανέγγιχτη. 0 αν
+ * αποτύχει η δέσμευση. */
+static int skip_reserve(SkipThread *t) {
+    if (t->limbo_len < t->limbo_cap)
+        return 1;
+    size_t cap = t->limbo_cap ? t->limbo_cap * 2 : SKIP_RECLAIM_BATCH * 2;
+    SkipRetired *limbo = (SkipRetired*)realloc(t->limbo, cap * sizeof(SkipRetired));
+    if (limbo == NULL) {
+        printf("Σφάλμα: αποτυχία δέσμευσης μνήμης\n");
+        return 0;
+    }
+    t->limbo = limbo;
+    t->limbo_cap = cap;
+    return 1;
+}
+
+static void skip_retire(SkipList *l, int slot, SkipNode *n) {
+    SkipThread *t = &l->threads[slot];
+    t->limbo[t->limbo_len].ptr = n;
+    t->limbo[t->limbo_len++].epoch = __atomic_load_n(&l->epoch, __ATOMIC_SEQ_CST);
+    if (t->limbo_len >= SKIP_RECLAIM_BATCH)
+        skip_reclaim(l, t);
+}
+
+static void skip_release(SkipList *l, int slot, SkipNode *n) {
+    if (__atomic_sub_fetch(&n->refs, 1, __ATOMIC_ACQ_REL) == 0)
+        skip_retire(l, slot, n);
+}
+
+/* ---------- Εισαγωγή και διαγραφή ---------- */
+
+/* Γεωμετρικό ύψος πύργου με p = 1/2 από xorshift ανά νήμα */
+static int skip_random_level(SkipThread *t) {
+    uint64_t x = t->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    t->rng = x;
+    return 1 + __builtin_ctzll(x | (1ULL << (SKIP_MAX_LEVEL - 1)));
+}
+
+/* Για κάθε επίπεδο: preds[i] ο τελευταίος κόμβος με κλειδί < name και succs[i]
+ * ο επόμενός του. Οι σημαδεμένοι κόμβοι στη διαδρομή αποσυνδέονται με CAS και
+ * αν το CAS αποτύχει (ο pred άλλαξε ή σημαδεύτηκε) η αναζήτηση ξεκινά πάλι.
+ * 1 αν το succs[0] έχει το name. */
+static int skip_locate(SkipList *l, uint64_t key, const char *name, SkipNode **preds, SkipNode **succs) {
+    int top = __atomic_load_n(&l->level, __ATOMIC_SEQ_CST);
+retry:;
+    SkipNode *pred = l->head, *curr = NULL;
+    int cmp = 1;
+    for (int i = SKIP_MAX_LEVEL - 1; i >= top; i--) {
+        preds[i] = pred;
+        succs[i] = NULL;
+    }
+    for (int i = top - 1; i >= 0; i--) {
+        curr = skip_ptr(skip_next(pred, i));
+        cmp = 1;
+        while (curr != NULL) {
+            uintptr_t succ = skip_next(curr, i);
+            if (SKIP_MARKED(succ)) {
+                if (!skip_cas(&pred->next[i], (uintptr_t)curr, succ & ~(uintptr_t)1))
+                    goto retry;
+                curr = skip_ptr(succ);
+                continue;
+            }
+            cmp = key_cmp(key, name, curr->key, curr->data.full_name);
+            if (cmp <= 0)
+                break;
+            pred = curr;
+            curr = skip_ptr(succ);
+        }
+        preds[i] = pred;
+        succs[i] = curr;
+    }
+    return curr != NULL && cmp == 0;
+}
+
+/* Εισαγωγή: σύνδεση με CAS στο επίπεδο 0 (εκεί γίνεται ορατός) και μετά στα
+ * ψηλότερα. Επιστρέφει 1 αν προστέθηκε, 0 αν το όνομα υπάρχει και -1 αν
+ * αποτύχει η δέσμευση μνήμης (η λίστα μένει ως είχε). */
+int skip_insert(SkipList *l, int slot, const Citizen *c) {
+    uint64_t key = key_prefix(c->full_name);
+    SkipNode *preds[SKIP_MAX_LEVEL], *succs[SKIP_MAX_LEVEL];
+    SkipNode *n = NULL;
+    if (!skip_reserve(&l->threads[slot]))
+        return -1;
+    skip_enter(l, slot);
+    for (;;) {
+        if (skip_locate(l, key, c->full_name, preds, succs)) {
+            skip_exit(l, slot);
+            free(n); /* δεν δημοσιεύτηκε ποτέ */
+            return 0;
+        }
+        if (n == NULL) {
+            n = skip_node_new(skip_random_level(&l->threads[slot]));
+            if (n == NULL) {
+                skip_exit(l, slot);
+                return -1;
+            }
+            n->key = key;
+            n->data = *c;
+        }
+        for (int i = 0; i < n->level; i++)
+            n->next[i] = (uintptr_t)succs[i];
+        if (skip_cas(&preds[0]->next[0], (uintptr_t)succs[0], (uintptr_t)n))
+            break;
+    }
+
+    int top = __atomic_load_n(&l->level, __ATOMIC_SEQ_CST);
+    while (top < n->level && !__atomic_compare_exchange_n(&l->level, &top, n->level, 0,
+                                                          __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+    }
+    /* Ψηλότερα επίπεδα: πρώτα ο δικός μας δείκτης (αποτυγχάνει αν σημαδεύτηκε)
+     * και μετά ο pred. Σταματά μόλις ο κόμβος αρχίσει να διαγράφεται. */
+    for (int i = 1; i < n->level; i++) {
+        for (;;) {
+            uintptr_t cur = skip_next(n, i);
+            if (SKIP_MARKED(cur))
+                goto linked;
+            if (skip_ptr(cur) != succs[i] && !skip_cas(&n->next[i], cur, (uintptr_t)succs[i]))
+                goto linked;
+            if (skip_cas(&preds[i]->next[i], (uintptr_t)succs[i], (uintptr_t)n))
+                break;
+            if (!skip_locate(l, key, c->full_name, preds, succs) || succs[0] != n)
+                goto linked;
+        }
+    }
+linked:
+    if (SKIP_MARKED(skip_next(n, 0)))
+        skip_locate(l, key, c->full_name, preds, succs);
+    skip_release(l, slot, n);
+    skip_exit(l, slot);
+    return 1;
+}
+
+/* Διαγραφή: σημάδι σε όλα τα επίπεδα από πάνω προς τα κάτω - όποιος σημαδέψει
+ * το επίπεδο 0 κερδίζει τη διαγραφή - και η αποσύνδεση γίνεται από την
+ * skip_locate. Επιστρέφει 1 αν βρέθηκε και το νήμα αυτό κέρδισε τη διαγραφή, 0
+ * αλλιώς και -1 αν αποτύχει η δέσμευση μνήμης (η λίστα μένει ως είχε). */
+int skip_delete(SkipList *l, int slot, const char *name) {
+    uint64_t key = key_prefix(name);
+    SkipNode *preds[SKIP_MAX_LEVEL], *succs[SKIP_MAX_LEVEL];
+    if (!skip_reserve(&l->threads[slot]))
+        return -1;
+    skip_enter(l, slot);
+    if (!skip_locate(l, key, name, preds, succs)) {
+        skip_exit(l, slot);
+        return 0;
+    }
+    SkipNode *n = succs[0];
+    for (int i = n->level - 1; i >= 1; i--)
+        __atomic_fetch_or(&n->next[i], 1, __ATOMIC_SEQ_CST);
+    if (SKIP_MARKED(__atomic_fetch_or(&n->next[0], 1, __ATOMIC_SEQ_CST))) {
+        skip_exit(l, slot);
+        return 0;
+    }
+    skip_locate(l, key, name, preds, succs); /* αποσύνδεση από όλα τα επίπεδα */
+    skip_release(l, slot, n);
+    skip_exit(l, slot);
+    return 1;
+}
+
+/* ---------- Αναζήτηση ---------- */
+
+/* Αναζήτηση χωρίς εγγραφές στη μνήμη - προσπερνά τους σημαδεμένους κόμβους.
+ * Μόνο μέσα σε skip_enter/skip_exit. */
+const Citizen* skip_find(SkipList *l, const char *name) {
+    uint64_t key = key_prefix(name);
+    SkipNode *pred = l->head;
+    for (int i = __atomic_load_n(&l->level, __ATOMIC_SEQ_CST) - 1; i >= 0; i--) {
+        SkipNode *curr = skip_ptr(skip_next(pred, i));
+        while (curr != NULL) {
+            uintptr_t succ = skip_next(curr, i);
+            if (!SKIP_MARKED(succ)) {
+                int cmp = key_cmp(key, name, curr->key, curr->data.full_name);
+                if (cmp < 0)
+                    break;
+                if (cmp == 0 && !SKIP_MARKED(skip_next(curr, 0)))
+                    return &curr->data;
+                if (cmp > 0)
+                    pred = curr;
+            }
+            curr = skip_ptr(succ);
+        }
+    }
+    return NULL;
+}
+
+/* Αναζήτηση με αντιγραφή της εγγραφής - 1 αν βρέθηκε */
+int skip_search(SkipList *l, int slot, const char *name, Citizen *out) {
+    skip_enter(l, slot);
+    const Citizen *c = skip_find(l, name);
+    if (c != NULL)
+        *out = *c;
+    skip_exit(l, slot);
+    return c != NULL;
+}
+
+/* ---------- Διάσχιση ---------- */
+
+/* Ενδοδιατεταγμένη διάσχιση στο επίπεδο 0 - επιστρέφει το πλήθος. Με
+ * ταυτόχρονες αλλαγές βλέπει κάθε κλειδί που υπήρχε σε όλη τη διάρκεια και
+ * κανένα που έλειπε σε όλη τη διάρκεια. */
+size_t skip_inorder(SkipList *l, int slot, void (*visit)(const Citizen*, void*), void *arg) {
+    size_t n = 0;
+    skip_enter(l, slot);
+    for (SkipNode *curr = skip_ptr(skip_next(l->head, 0)); curr != NULL;) {
+        uintptr_t succ = skip_next(curr, 0);
+        if (!SKIP_MARKED(succ)) {
+            if (visit != NULL)
+                visit(&curr->data, arg);
+            n++;
+        }
+        curr = skip_ptr(succ);
+    }
+    skip_exit(l, slot);
+    return n;
+}
+
+static void print_citizen(const Citizen *c, void *fp) {
+    fprintf((FILE*)fp, "%s,%d,%s,%d\n", c->full_name, c->age, c->state, c->annual_income);
+}
+
+/* Ενδοδιατεταγμένη διάσχιση - εκτύπωση */
+void traversal(SkipList *l, int slot) {
+    skip_inorder(l, slot, print_citizen, stdout);
+}
+
+/* Ενδοδιατεταγμένη διάσχιση - εγγραφή σε αρχείο */
+void traversal_to_file(SkipList *l, int slot, FILE *fp) {
+    skip_inorder(l, slot, print_citizen, fp);
+}
+
+/* Απελευθέρωση μνήμης - μόνο όταν δεν τρέχει πια κανένα νήμα */
+void skip_destroy(SkipList *l) {
+    if (l == NULL)
+        return;
+    for (SkipNode *curr = l->head; curr != NULL;) {
+        SkipNode *next = skip_ptr(curr->next[0]);
+        free(curr);
+        curr = next;
+    }
+    for (int i = 0; i < SKIP_MAX_THREADS; i++) {
+        for (size_t k = 0; k < l->threads[i].limbo_len; k++)
+            free(l->threads[i].limbo[k].ptr);
+        free(l->threads[i].limbo);
+    }
+    free(l);
+}